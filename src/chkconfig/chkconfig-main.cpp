@@ -25,8 +25,10 @@
 
 
 #include <errno.h>
+#include <fnmatch.h>
 #include <getopt.h>
 #include <libgen.h>
+#include <regex.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,14 +50,26 @@
 #define CHKCONFIG_OPT_USE_DEFAULT_DIRECTORY            'd'
 #define CHKCONFIG_OPT_FORCE                            'f'
 #define CHKCONFIG_OPT_HELP                             'h'
+#define CHKCONFIG_OPT_LIST                             'l'
 #define CHKCONFIG_OPT_ORIGIN                           'o'
 #define CHKCONFIG_OPT_QUIET                            'q'
 #define CHKCONFIG_OPT_STATE                            's'
 #define CHKCONFIG_OPT_VERSION                          'V'
 #define CHKCONFIG_OPT_DEFAULT_DIRECTORY                (CHKCONFIG_OPT_BASE +  1)
 #define CHKCONFIG_OPT_STATE_DIRECTORY                  (CHKCONFIG_OPT_BASE +  2)
-
-#define CHKCONFIG_SHORT_OPTIONS                        "+dfhoqsV"
+#define CHKCONFIG_OPT_SHARDED_LAYOUT                   (CHKCONFIG_OPT_BASE +  3)
+#define CHKCONFIG_OPT_MIGRATE_LAYOUT                   (CHKCONFIG_OPT_BASE +  4)
+#define CHKCONFIG_OPT_MATCH                            (CHKCONFIG_OPT_BASE +  5)
+#define CHKCONFIG_OPT_REGEX                            (CHKCONFIG_OPT_BASE +  6)
+#define CHKCONFIG_OPT_ON                               (CHKCONFIG_OPT_BASE +  7)
+#define CHKCONFIG_OPT_OFF                              (CHKCONFIG_OPT_BASE +  8)
+#define CHKCONFIG_OPT_SUMMARY                          (CHKCONFIG_OPT_BASE +  9)
+#define CHKCONFIG_OPT_DIFF                             (CHKCONFIG_OPT_BASE + 10)
+#define CHKCONFIG_OPT_EXPORT                           (CHKCONFIG_OPT_BASE + 11)
+#define CHKCONFIG_OPT_IMPORT                           (CHKCONFIG_OPT_BASE + 12)
+#define CHKCONFIG_OPT_PRUNE                            (CHKCONFIG_OPT_BASE + 13)
+
+#define CHKCONFIG_SHORT_OPTIONS                        "+dfhl:oqsV"
 
 // MARK: List Output Formatting
 
@@ -109,6 +123,67 @@
     CHKCONFIG_LIST_ROW_ORIGIN_FORMAT                   \
     "\n"
 
+// MARK: Summary Output Formatting
+
+#define CHKCONFIG_SUMMARY_ORIGIN_FORMAT                "%-10s"
+#define CHKCONFIG_SUMMARY_COLUMN_SEPARATOR             "  "
+
+#define CHKCONFIG_SUMMARY_HEADER_FORMAT                \
+    CHKCONFIG_SUMMARY_ORIGIN_FORMAT                    \
+    CHKCONFIG_SUMMARY_COLUMN_SEPARATOR                 \
+    "%8s"                                              \
+    CHKCONFIG_SUMMARY_COLUMN_SEPARATOR                 \
+    "%8s"                                              \
+    CHKCONFIG_SUMMARY_COLUMN_SEPARATOR                 \
+    "%8s"                                              \
+    "\n"
+
+#define CHKCONFIG_SUMMARY_ROW_FORMAT                   \
+    CHKCONFIG_SUMMARY_ORIGIN_FORMAT                    \
+    CHKCONFIG_SUMMARY_COLUMN_SEPARATOR                 \
+    "%8zu"                                             \
+    CHKCONFIG_SUMMARY_COLUMN_SEPARATOR                 \
+    "%8zu"                                             \
+    CHKCONFIG_SUMMARY_COLUMN_SEPARATOR                 \
+    "%8zu"                                             \
+    "\n"
+
+#define CHKCONFIG_SUMMARY_HEADER_ON_VALUE              "On"
+#define CHKCONFIG_SUMMARY_HEADER_ON_SEPARATOR_VALUE    "=="
+#define CHKCONFIG_SUMMARY_HEADER_OFF_VALUE             "Off"
+#define CHKCONFIG_SUMMARY_HEADER_OFF_SEPARATOR_VALUE   "==="
+#define CHKCONFIG_SUMMARY_HEADER_TOTAL_VALUE           "Total"
+#define CHKCONFIG_SUMMARY_HEADER_TOTAL_SEPARATOR_VALUE "====="
+#define CHKCONFIG_SUMMARY_ROW_TOTAL_VALUE              "total"
+
+// MARK: Diff Output Formatting
+
+#define CHKCONFIG_DIFF_DEFAULT_FORMAT                  "%-7s"
+#define CHKCONFIG_DIFF_DIFF_FORMAT                     "%-12s"
+
+#define CHKCONFIG_DIFF_FORMAT                          \
+    CHKCONFIG_LIST_FLAG_FORMAT                         \
+    CHKCONFIG_LIST_COLUMN_SEPARATOR                    \
+    CHKCONFIG_LIST_STATE_FORMAT                        \
+    CHKCONFIG_LIST_COLUMN_SEPARATOR                    \
+    CHKCONFIG_DIFF_DEFAULT_FORMAT                      \
+    CHKCONFIG_LIST_COLUMN_SEPARATOR                    \
+    CHKCONFIG_DIFF_DIFF_FORMAT                         \
+    "\n"
+
+#define CHKCONFIG_DIFF_HEADER_DEFAULT_VALUE            "Default"
+#define CHKCONFIG_DIFF_HEADER_DEFAULT_SEPARATOR_VALUE  "======="
+#define CHKCONFIG_DIFF_HEADER_DIFF_VALUE               "Difference"
+#define CHKCONFIG_DIFF_HEADER_DIFF_SEPARATOR_VALUE     "=========="
+#define CHKCONFIG_DIFF_ROW_ABSENT_VALUE                "-"
+
+// MARK: Export / Import Formatting
+
+#define CHKCONFIG_TRANSFER_STANDARD_PATH               "-"
+#define CHKCONFIG_TRANSFER_COMMENT                     '#'
+#define CHKCONFIG_TRANSFER_SEPARATORS                  " \t\r\n"
+#define CHKCONFIG_TRANSFER_ROW_FORMAT                  "%s %s\n"
+
 namespace nuovations
 {
 
@@ -128,7 +203,28 @@ enum
     kChkconfigOptFlagState                = 0x00000010,
     kChkconfigOptFlagUseDefaultDirectory  = 0x00000020,
     kChkconfigOptFlagWantDefaultDirectory = 0x00000040,
-    kChkconfigOptFlagWantStateDirectory   = 0x00000080
+    kChkconfigOptFlagWantStateDirectory   = 0x00000080,
+    kChkconfigOptFlagShardedLayout        = 0x00000100,
+    kChkconfigOptFlagMigrateLayout        = 0x00000200,
+    kChkconfigOptFlagListPattern          = 0x00000400,
+    kChkconfigOptFlagMatchGlob            = 0x00000800,
+    kChkconfigOptFlagMatchRegex           = 0x00001000,
+    kChkconfigOptFlagWhereOn              = 0x00002000,
+    kChkconfigOptFlagWhereOff             = 0x00004000,
+    kChkconfigOptFlagSummary              = 0x00008000,
+    kChkconfigOptFlagDiff                 = 0x00010000,
+    kChkconfigOptFlagExport               = 0x00020000,
+    kChkconfigOptFlagImport               = 0x00040000,
+    kChkconfigOptFlagPrune                = 0x00080000,
+
+    kChkconfigOptFlagTransfers            = (kChkconfigOptFlagExport |
+                                             kChkconfigOptFlagImport),
+
+    kChkconfigOptFlagListFilters          = (kChkconfigOptFlagListPattern |
+                                             kChkconfigOptFlagMatchGlob   |
+                                             kChkconfigOptFlagMatchRegex),
+    kChkconfigOptFlagWhere                = (kChkconfigOptFlagWhereOn |
+                                             kChkconfigOptFlagWhereOff)
 };
 
 // MARK: Global Variables
@@ -175,6 +271,13 @@ static const struct option sOptions[]          = {
         CHKCONFIG_OPT_STATE_DIRECTORY
     },
 
+    {
+        "sharded-layout",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_SHARDED_LAYOUT
+    },
+
     // Check / Get / List Options
 
     {
@@ -184,6 +287,55 @@ static const struct option sOptions[]          = {
         CHKCONFIG_OPT_USE_DEFAULT_DIRECTORY
     },
 
+    {
+        "list",
+        required_argument,
+        nullptr,
+        CHKCONFIG_OPT_LIST
+    },
+
+    {
+        "match",
+        required_argument,
+        nullptr,
+        CHKCONFIG_OPT_MATCH
+    },
+
+    {
+        "regex",
+        required_argument,
+        nullptr,
+        CHKCONFIG_OPT_REGEX
+    },
+
+    {
+        "on",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_ON
+    },
+
+    {
+        "off",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_OFF
+    },
+
+    {
+        "summary",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_SUMMARY
+    },
+
+    {
+        "diff",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_DIFF
+    },
+
     {
         "origin",
         no_argument,
@@ -207,6 +359,38 @@ static const struct option sOptions[]          = {
         CHKCONFIG_OPT_FORCE
     },
 
+    // Export / Import Options
+
+    {
+        "export",
+        required_argument,
+        nullptr,
+        CHKCONFIG_OPT_EXPORT
+    },
+
+    {
+        "import",
+        required_argument,
+        nullptr,
+        CHKCONFIG_OPT_IMPORT
+    },
+
+    {
+        "prune",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_PRUNE
+    },
+
+    // Migrate Options
+
+    {
+        "migrate-layout",
+        no_argument,
+        nullptr,
+        CHKCONFIG_OPT_MIGRATE_LAYOUT
+    },
+
     // Sentinel Terminator Option
 
     {
@@ -219,9 +403,14 @@ static const struct option sOptions[]          = {
 
 static const char * const  sShortUsageString =
 "Usage: %1$s [ -hV ]\n"
-"       %1$s [ <directory options> ] [ -dosq ]\n"
+"       %1$s [ <directory options> ] [ -dosq ] [ -l <pattern> | --match <glob> | --regex <re> ] [ --on | --off ]\n"
+"       %1$s [ <directory options> ] [ -dq ] --summary\n"
+"       %1$s [ <directory options> ] [ -q ] --diff\n"
 "       %1$s [ <directory options> ] [ -dq ] <flag>\n"
-"       %1$s [ <directory options> ] [ -fq ] <flag> <on | off>\n";
+"       %1$s [ <directory options> ] [ -fq ] <flag> <on | off>\n"
+"       %1$s [ <directory options> ] [ -dq ] --export <file>\n"
+"       %1$s [ <directory options> ] [ -dfq ] --import <file> [ --prune ]\n"
+"       %1$s [ <directory options> ] [ -q ] --migrate-layout\n";
 
 static const char * const  sLongUsageString  =
 "\n"
@@ -239,10 +428,28 @@ static const char * const  sLongUsageString  =
 "                               " CHKCONFIG_DEFAULTDIR_DEFAULT ").\n"
 "  --state-directory DIR        Use DIR directory as the read-write flag state\n"
 "                               directory (default: " CHKCONFIG_STATEDIR_DEFAULT ").\n"
+"  --sharded-layout             The flag state directories have a sharded\n"
+"                               layout, with each flag state file in a\n"
+"                               subdirectory chosen by a hash of the flag.\n"
 "\n"
 " Check / Get / List Options:\n"
 "\n"
 "  -d, --use-default-directory  Include the default directory as a fallback.\n"
+"  -l, --list PATTERN           List only those configuration flags matching\n"
+"                               PATTERN, a flag prefix followed by '*' (for\n"
+"                               example, 'net.*').\n"
+"  --match GLOB                 List only those configuration flags matching\n"
+"                               the shell wildcard pattern GLOB.\n"
+"  --regex RE                   List only those configuration flags matching\n"
+"                               the POSIX extended regular expression RE.\n"
+"  --on                         List only those configuration flags that are on.\n"
+"  --off                        List only those configuration flags that are off.\n"
+"  --summary                    Print the count of configuration flags that are\n"
+"                               on and off for each origin, then in total.\n"
+"  --diff                       Print every configuration flag in the state\n"
+"                               or default directory, with its state in each\n"
+"                               and whether it differs from or shadows the\n"
+"                               default or exists in only one.\n"
 "  -o, --origin                 Print the origin of every configuration flag.\n"
 "  -s, --state                  Print the state of every configuration flag,\n"
 "                               sorting by state, then by flag.\n"
@@ -251,10 +458,32 @@ static const char * const  sLongUsageString  =
 "\n"
 "  -f, --force                  Forcibly create the specified flag state file\n"
 "                               if it does not exist.\n"
+"\n"
+" Export / Import Options:\n"
+"\n"
+"  --export FILE                Write the state of every configuration flag to\n"
+"                               FILE, or to standard output if FILE is '-', one\n"
+"                               '<flag> <on | off>' line per flag.\n"
+"  --import FILE                Set the state of every configuration flag in\n"
+"                               FILE, or in standard input if FILE is '-', as\n"
+"                               written by --export, setting only those flags\n"
+"                               whose state changes.\n"
+"  --prune                      With --import, also set off every configuration\n"
+"                               flag in the state directory that is on but is\n"
+"                               not in FILE.\n"
+"\n"
+" Migrate Options:\n"
+"\n"
+"  --migrate-layout             Migrate the flag state files in the state\n"
+"                               directory to the flat layout or, with\n"
+"                               --sharded-layout, to the sharded layout.\n"
 "\n";
 
 static const char *        sDefaultDirectory = CHKCONFIG_DEFAULTDIR_DEFAULT;
+static const char *        sTransferPath     = nullptr;
 static const char *        sFlagString       = nullptr;
+static const char *        sListPattern      = nullptr;
+static const char *        sMatchPattern     = nullptr;
 static bool                sState            = false;
 static const char *        sStateDirectory   = CHKCONFIG_STATEDIR_DEFAULT;
 static const char *        sStateString      = nullptr;
@@ -339,6 +568,7 @@ static void ProcessArguments(
     const char * const        p = short_options;
     int                       c;
     unsigned int              errors = 0;
+    size_t                    length;
     chkconfig_status_t        status;
 
     // Start parsing invocation options
@@ -361,6 +591,94 @@ static void ProcessArguments(
             PrintUsage(inProgram, EXIT_SUCCESS);
             break;
 
+        case CHKCONFIG_OPT_LIST:
+            if (sOptFlags & kChkconfigOptFlagListFilters)
+            {
+                PrintError("The '-l/--list', '--match', and '--regex' options are mutually exclusive; please use only one.\n");
+
+                errors++;
+                break;
+            }
+
+            sOptFlags |= (kChkconfigOptFlagListAll | kChkconfigOptFlagListPattern);
+            sListPattern = optarg;
+
+            // Only a flag prefix followed by a single, trailing
+            // wildcard is supported.
+
+            length = strlen(sListPattern);
+
+            if ((length == 0) ||
+                (strpbrk(sListPattern, "*?[") != &sListPattern[length - 1]) ||
+                (sListPattern[length - 1] != '*'))
+            {
+                PrintError("Unrecognized or unsupported list pattern: \"%s\"; please use a flag prefix followed by '*'.\n", sListPattern);
+
+                errors++;
+            }
+            break;
+
+        case CHKCONFIG_OPT_MATCH:
+        case CHKCONFIG_OPT_REGEX:
+            if (sOptFlags & kChkconfigOptFlagListFilters)
+            {
+                PrintError("The '-l/--list', '--match', and '--regex' options are mutually exclusive; please use only one.\n");
+
+                errors++;
+                break;
+            }
+
+            sOptFlags |= (kChkconfigOptFlagListAll |
+                          ((c == CHKCONFIG_OPT_MATCH) ?
+                           kChkconfigOptFlagMatchGlob :
+                           kChkconfigOptFlagMatchRegex));
+            sMatchPattern = optarg;
+            break;
+
+        case CHKCONFIG_OPT_ON:
+        case CHKCONFIG_OPT_OFF:
+            if (sOptFlags & kChkconfigOptFlagWhere)
+            {
+                PrintError("The '--on' and '--off' options are mutually exclusive; please use only one.\n");
+
+                errors++;
+                break;
+            }
+
+            sOptFlags |= (kChkconfigOptFlagListAll |
+                          ((c == CHKCONFIG_OPT_ON) ?
+                           kChkconfigOptFlagWhereOn :
+                           kChkconfigOptFlagWhereOff));
+            break;
+
+        case CHKCONFIG_OPT_SUMMARY:
+            sOptFlags |= (kChkconfigOptFlagListAll | kChkconfigOptFlagSummary);
+            break;
+
+        case CHKCONFIG_OPT_DIFF:
+            sOptFlags |= (kChkconfigOptFlagListAll | kChkconfigOptFlagDiff);
+            break;
+
+        case CHKCONFIG_OPT_EXPORT:
+        case CHKCONFIG_OPT_IMPORT:
+            if (sOptFlags & kChkconfigOptFlagTransfers)
+            {
+                PrintError("The '--export' and '--import' options are mutually exclusive; please use only one.\n");
+
+                errors++;
+                break;
+            }
+
+            sOptFlags |= ((c == CHKCONFIG_OPT_EXPORT) ?
+                          kChkconfigOptFlagExport :
+                          kChkconfigOptFlagImport);
+            sTransferPath = optarg;
+            break;
+
+        case CHKCONFIG_OPT_PRUNE:
+            sOptFlags |= kChkconfigOptFlagPrune;
+            break;
+
         case CHKCONFIG_OPT_ORIGIN:
             sOptFlags |= (kChkconfigOptFlagListAll | kChkconfigOptFlagOrigin);
             break;
@@ -387,6 +705,14 @@ static void ProcessArguments(
             sStateDirectory = optarg;
             break;
 
+        case CHKCONFIG_OPT_SHARDED_LAYOUT:
+            sOptFlags |= kChkconfigOptFlagShardedLayout;
+            break;
+
+        case CHKCONFIG_OPT_MIGRATE_LAYOUT:
+            sOptFlags |= kChkconfigOptFlagMigrateLayout;
+            break;
+
         default:
             fprintf(stderr, "Unknown chkconfig option '%c' (%d)!\n", optopt, optopt);
             errors++;
@@ -424,12 +750,60 @@ static void ProcessArguments(
     {
 
     case 0:
-        if (sOptFlags & kChkconfigOptFlagForce)
+        if ((sOptFlags & kChkconfigOptFlagForce) && !(sOptFlags & kChkconfigOptFlagImport))
         {
             PrintError("The '-f/--force' option is mutually exclusive with the check or list usage; please use one or the other.\n");
 
             errors++;
         }
+        else if ((sOptFlags & kChkconfigOptFlagPrune) && !(sOptFlags & kChkconfigOptFlagImport))
+        {
+            PrintError("The '--prune' option may only be used with the '--import' option.\n");
+
+            errors++;
+        }
+        else if (sOptFlags & kChkconfigOptFlagTransfers)
+        {
+            if (sOptFlags & (kChkconfigOptFlagListAll       |
+                             kChkconfigOptFlagListFilters   |
+                             kChkconfigOptFlagWhere         |
+                             kChkconfigOptFlagMigrateLayout))
+            {
+                PrintError("The '--export' and '--import' options are mutually exclusive with the list and migrate usages; please use one or the other.\n");
+
+                errors++;
+            }
+        }
+        else if (sOptFlags & kChkconfigOptFlagMigrateLayout)
+        {
+            if (sOptFlags & kChkconfigOptFlagListAll)
+            {
+                PrintError("The '--migrate-layout' option is mutually exclusive with the list usage; please use one or the other.\n");
+
+                errors++;
+            }
+        }
+        else if ((sOptFlags & kChkconfigOptFlagSummary) &&
+                 (sOptFlags & (kChkconfigOptFlagListFilters |
+                               kChkconfigOptFlagWhere       |
+                               kChkconfigOptFlagOrigin      |
+                               kChkconfigOptFlagState)))
+        {
+            PrintError("The '--summary' option is mutually exclusive with the other list options; please use one or the other.\n");
+
+            errors++;
+        }
+        else if ((sOptFlags & kChkconfigOptFlagDiff) &&
+                 (sOptFlags & (kChkconfigOptFlagListFilters |
+                               kChkconfigOptFlagWhere       |
+                               kChkconfigOptFlagOrigin      |
+                               kChkconfigOptFlagState       |
+                               kChkconfigOptFlagSummary)))
+        {
+            PrintError("The '--diff' option is mutually exclusive with the other list options; please use one or the other.\n");
+
+            errors++;
+        }
         else
         {
             // If there are no positional parameters, then list usage
@@ -441,7 +815,49 @@ static void ProcessArguments(
 
     case 1:
     case 2:
-        if (sOptFlags & kChkconfigOptFlagOrigin)
+        if (sOptFlags & kChkconfigOptFlagMigrateLayout)
+        {
+            PrintError("The '--migrate-layout' option is mutually exclusive with the check or set usage; please use one or the other.\n");
+
+            errors++;
+            break;
+        }
+        else if (sOptFlags & kChkconfigOptFlagListFilters)
+        {
+            PrintError("The '-l/--list', '--match', and '--regex' options are mutally exclusive with the check usage; please use one or the other.\n");
+
+            errors++;
+            break;
+        }
+        else if (sOptFlags & kChkconfigOptFlagSummary)
+        {
+            PrintError("The '--summary' option is mutually exclusive with the check usage; please use one or the other.\n");
+
+            errors++;
+            break;
+        }
+        else if (sOptFlags & kChkconfigOptFlagDiff)
+        {
+            PrintError("The '--diff' option is mutually exclusive with the check usage; please use one or the other.\n");
+
+            errors++;
+            break;
+        }
+        else if (sOptFlags & (kChkconfigOptFlagTransfers | kChkconfigOptFlagPrune))
+        {
+            PrintError("The '--export', '--import', and '--prune' options are mutually exclusive with the check usage; please use one or the other.\n");
+
+            errors++;
+            break;
+        }
+        else if (sOptFlags & kChkconfigOptFlagWhere)
+        {
+            PrintError("The '--on' and '--off' options are mutually exclusive with the check usage; please use one or the other.\n");
+
+            errors++;
+            break;
+        }
+        else if (sOptFlags & kChkconfigOptFlagOrigin)
         {
             PrintError("The '-o/--origin' option is mutally exclusive with the check usage; please use one or the other.\n");
 
@@ -498,30 +914,6 @@ exit:
     return;
 }
 
-static chkconfig_status_t SortAllFlags(chkconfig_flag_state_tuple_t *&inFlagStateTuples,
-                                       const size_t &inFlagStateTuplesCount,
-                                       const uint32_t &inOptFlags)
-{
-    int (* lSortFunction)(const void *, const void *);
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
-
-    if (inOptFlags & kChkconfigOptFlagState)
-    {
-        lSortFunction = chkconfig_flag_state_tuple_state_compare_function;
-    }
-    else
-    {
-        lSortFunction = chkconfig_flag_state_tuple_flag_compare_function;
-    }
-
-    qsort(&inFlagStateTuples[0],
-          inFlagStateTuplesCount,
-          sizeof(chkconfig_flag_state_tuple_t),
-          lSortFunction);
-
-    return (lRetval);
-}
-
 static void ListFlagStateHeader(void)
 {
     fprintf(stdout,
@@ -587,9 +979,30 @@ static chkconfig_status_t ListFlagStateOriginOne(const chkconfig_flag_state_tupl
     return (lRetval);
 }
 
+static bool MatchGlob(chkconfig_flag_t inFlag, void *inPattern)
+{
+    return (fnmatch(static_cast<const char *>(inPattern), inFlag, 0) == 0);
+}
+
+static bool MatchRegex(chkconfig_flag_t inFlag, void *inRegex)
+{
+    return (regexec(static_cast<const regex_t *>(inRegex), inFlag, 0, nullptr, 0) == 0);
+}
+
 static chkconfig_status_t ListAllFlags(chkconfig_context_t &inContext,
+                                       const char *inListPattern,
+                                       const char *inMatchPattern,
                                        const uint32_t &inOptFlags)
 {
+    const chkconfig_sort_order_t         lSortOrder       = ((inOptFlags & kChkconfigOptFlagState) ?
+                                                             CHKCONFIG_SORT_ORDER_STATE :
+                                                             CHKCONFIG_SORT_ORDER_FLAG);
+    const bool                           lWhere           = ((inOptFlags & kChkconfigOptFlagWhere) != 0);
+    const chkconfig_state_t              lWhereState      = ((inOptFlags & kChkconfigOptFlagWhereOn) != 0);
+    char *                               lPrefix          = nullptr;
+    regex_t                              lRegex;
+    bool                                 lHaveRegex       = false;
+    char                                 lRegexError[128];
     chkconfig_flag_state_tuple_t *       lFlagStateTuples = nullptr;
     size_t                               lFlagStateTuplesCount;
     const chkconfig_flag_state_tuple_t * lFirst;
@@ -598,17 +1011,85 @@ static chkconfig_status_t ListAllFlags(chkconfig_context_t &inContext,
     chkconfig_status_t                   lStatus;
     chkconfig_status_t                   lRetval  = CHKCONFIG_STATUS_SUCCESS;
 
-    lRetval = chkconfig_state_copy_all(&inContext,
-                                       &lFlagStateTuples,
-                                       &lFlagStateTuplesCount);
-    nlREQUIRE_SUCCESS(lRetval, done);
-
-    // Sort the flags according to the command line options
+    // Copy the flags sorted according to the command line options
     // specified. By default, flags are shown sorted by flag name; if
     // the '-s' option is asserted, then sort them by state.
+    //
+    // If the '-l' option is asserted, then only those flags
+    // beginning with the pattern, less its trailing wildcard, are
+    // copied, which the library matches as it enumerates the flags.
+    // Likewise, with the '--match' or '--regex' option, the library
+    // offers each flag to a filter as it enumerates them, such that
+    // only the flags that match are ever read or copied.
+    //
+    // If the '--on' or '--off' option is asserted on its own, then
+    // the library selects only those flags with that state as it
+    // copies them out; otherwise, in combination with one of the
+    // above, the flags with the other state are skipped below.
+
+    if (inOptFlags & kChkconfigOptFlagListPattern)
+    {
+        lPrefix = strndup(inListPattern, strlen(inListPattern) - 1);
+        nlREQUIRE_ACTION(lPrefix != nullptr, done, lRetval = -ENOMEM);
+
+        lRetval = chkconfig_state_copy_prefix(&inContext,
+                                              lPrefix,
+                                              lSortOrder,
+                                              &lFlagStateTuples,
+                                              &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+    else if (inOptFlags & kChkconfigOptFlagMatchGlob)
+    {
+        lRetval = chkconfig_state_copy_filtered(&inContext,
+                                                MatchGlob,
+                                                const_cast<char *>(inMatchPattern),
+                                                lSortOrder,
+                                                &lFlagStateTuples,
+                                                &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+    else if (inOptFlags & kChkconfigOptFlagMatchRegex)
+    {
+        lStatus = regcomp(&lRegex, inMatchPattern, (REG_EXTENDED | REG_NOSUB));
 
-    lRetval = SortAllFlags(lFlagStateTuples, lFlagStateTuplesCount, inOptFlags);
-    nlREQUIRE_SUCCESS(lRetval, done);
+        if (lStatus != 0)
+        {
+            regerror(lStatus, &lRegex, lRegexError, sizeof (lRegexError));
+
+            PrintError("Invalid regular expression \"%s\": %s\n", inMatchPattern, lRegexError);
+
+            lRetval = -EINVAL;
+            goto done;
+        }
+
+        lHaveRegex = true;
+
+        lRetval = chkconfig_state_copy_filtered(&inContext,
+                                                MatchRegex,
+                                                &lRegex,
+                                                lSortOrder,
+                                                &lFlagStateTuples,
+                                                &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+    else if (lWhere)
+    {
+        lRetval = chkconfig_state_copy_where(&inContext,
+                                             lWhereState,
+                                             lSortOrder,
+                                             &lFlagStateTuples,
+                                             &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+    else
+    {
+        lRetval = chkconfig_state_copy_all_sorted(&inContext,
+                                                  lSortOrder,
+                                                  &lFlagStateTuples,
+                                                  &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
 
     if (inOptFlags & kChkconfigOptFlagOrigin)
     {
@@ -625,6 +1106,12 @@ static chkconfig_status_t ListAllFlags(chkconfig_context_t &inContext,
 
     while (lCurrent != lLast)
     {
+        if (lWhere && (lCurrent->m_state != lWhereState))
+        {
+            lCurrent++;
+            continue;
+        }
+
         if (inOptFlags & kChkconfigOptFlagOrigin)
         {
             lRetval = ListFlagStateOriginOne(*lCurrent);
@@ -646,6 +1133,136 @@ static chkconfig_status_t ListAllFlags(chkconfig_context_t &inContext,
         nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
     }
 
+    if (lPrefix != nullptr)
+    {
+        free(lPrefix);
+    }
+
+    if (lHaveRegex)
+    {
+        regfree(&lRegex);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t SummarizeFlags(chkconfig_context_t &inContext)
+{
+    size_t                    lOn;
+    size_t                    lOff;
+    chkconfig_origin_counts_t lByOrigin;
+    const char *              lDefaultString;
+    const char *              lStateString;
+    chkconfig_status_t        lRetval  = CHKCONFIG_STATUS_SUCCESS;
+
+    // The library counts the flags in a single pass, without copying
+    // any of them.
+
+    lRetval = chkconfig_state_get_counts(&inContext, &lOn, &lOff, &lByOrigin);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_origin_get_origin_string(CHKCONFIG_ORIGIN_DEFAULT, &lDefaultString);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_origin_get_origin_string(CHKCONFIG_ORIGIN_STATE, &lStateString);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    fprintf(stdout,
+            CHKCONFIG_SUMMARY_HEADER_FORMAT,
+            CHKCONFIG_LIST_HEADER_ORIGIN_VALUE,
+            CHKCONFIG_SUMMARY_HEADER_ON_VALUE,
+            CHKCONFIG_SUMMARY_HEADER_OFF_VALUE,
+            CHKCONFIG_SUMMARY_HEADER_TOTAL_VALUE);
+    fprintf(stdout,
+            CHKCONFIG_SUMMARY_HEADER_FORMAT,
+            CHKCONFIG_LIST_HEADER_ORIGIN_SEPARATOR_VALUE,
+            CHKCONFIG_SUMMARY_HEADER_ON_SEPARATOR_VALUE,
+            CHKCONFIG_SUMMARY_HEADER_OFF_SEPARATOR_VALUE,
+            CHKCONFIG_SUMMARY_HEADER_TOTAL_SEPARATOR_VALUE);
+
+    fprintf(stdout,
+            CHKCONFIG_SUMMARY_ROW_FORMAT,
+            lDefaultString,
+            lByOrigin.m_default.m_on,
+            lByOrigin.m_default.m_off,
+            lByOrigin.m_default.m_on + lByOrigin.m_default.m_off);
+    fprintf(stdout,
+            CHKCONFIG_SUMMARY_ROW_FORMAT,
+            lStateString,
+            lByOrigin.m_state.m_on,
+            lByOrigin.m_state.m_off,
+            lByOrigin.m_state.m_on + lByOrigin.m_state.m_off);
+    fprintf(stdout,
+            CHKCONFIG_SUMMARY_ROW_FORMAT,
+            CHKCONFIG_SUMMARY_ROW_TOTAL_VALUE,
+            lOn,
+            lOff,
+            lOn + lOff);
+
+ done:
+    return (lRetval);
+}
+
+static void DiffFlagOne(chkconfig_flag_t inFlag,
+                        chkconfig_diff_t inDiff,
+                        chkconfig_state_t inState,
+                        chkconfig_state_t inDefaultState,
+                        void *inContext __attribute__((unused)))
+{
+    static const char * const sDiffStrings[] = {
+        [CHKCONFIG_DIFF_STATE_ONLY]   = "state-only",
+        [CHKCONFIG_DIFF_DEFAULT_ONLY] = "default-only",
+        [CHKCONFIG_DIFF_SHADOWS]      = "shadows",
+        [CHKCONFIG_DIFF_DIFFERS]      = "differs"
+    };
+    const char *              lStateString        = CHKCONFIG_DIFF_ROW_ABSENT_VALUE;
+    const char *              lDefaultStateString = CHKCONFIG_DIFF_ROW_ABSENT_VALUE;
+
+    // The state of a flag absent from one of the directories is
+    // shown as such rather than as the off it is reported as.
+
+    if (inDiff != CHKCONFIG_DIFF_DEFAULT_ONLY)
+    {
+        chkconfig_state_get_state_string(inState, &lStateString);
+    }
+
+    if (inDiff != CHKCONFIG_DIFF_STATE_ONLY)
+    {
+        chkconfig_state_get_state_string(inDefaultState, &lDefaultStateString);
+    }
+
+    fprintf(stdout,
+            CHKCONFIG_DIFF_FORMAT,
+            inFlag,
+            lStateString,
+            lDefaultStateString,
+            sDiffStrings[inDiff]);
+}
+
+static chkconfig_status_t DiffFlags(chkconfig_context_t &inContext)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    fprintf(stdout,
+            CHKCONFIG_DIFF_FORMAT,
+            CHKCONFIG_LIST_HEADER_FLAG_VALUE,
+            CHKCONFIG_LIST_HEADER_STATE_VALUE,
+            CHKCONFIG_DIFF_HEADER_DEFAULT_VALUE,
+            CHKCONFIG_DIFF_HEADER_DIFF_VALUE);
+    fprintf(stdout,
+            CHKCONFIG_DIFF_FORMAT,
+            CHKCONFIG_LIST_HEADER_FLAG_SEPARATOR_VALUE,
+            CHKCONFIG_LIST_HEADER_STATE_SEPARATOR_VALUE,
+            CHKCONFIG_DIFF_HEADER_DEFAULT_SEPARATOR_VALUE,
+            CHKCONFIG_DIFF_HEADER_DIFF_SEPARATOR_VALUE);
+
+    // The library compares the directories in a single pass,
+    // producing each row as it goes.
+
+    lRetval = chkconfig_state_diff(&inContext, DiffFlagOne, nullptr);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
     return (lRetval);
 }
 
@@ -688,6 +1305,207 @@ static chkconfig_status_t SetOrGetOneFlag(chkconfig_context_t &inContext,
     return (lRetval);
 }
 
+static chkconfig_status_t ExportFlags(chkconfig_context_t &inContext,
+                                      const char *inPath)
+{
+    const bool                           lStandard        = (strcmp(inPath, CHKCONFIG_TRANSFER_STANDARD_PATH) == 0);
+    FILE *                               lFile            = nullptr;
+    chkconfig_flag_state_tuple_t *       lFlagStateTuples = nullptr;
+    size_t                               lFlagStateTuplesCount;
+    const char *                         lStateString;
+    chkconfig_status_t                   lStatus;
+    chkconfig_status_t                   lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    // Export every flag, sorted by flag, such that exports of the
+    // same flags compare equal, one '<flag> <state>' line each.
+
+    lRetval = chkconfig_state_copy_all_sorted(&inContext,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuples,
+                                              &lFlagStateTuplesCount);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lFile = (lStandard ? stdout : fopen(inPath, "w"));
+
+    if (lFile == nullptr)
+    {
+        lRetval = -errno;
+
+        PrintError("Failed to open \"%s\" for export: %s\n", inPath, strerror(-lRetval));
+
+        goto done;
+    }
+
+    for (size_t lIndex = 0; lIndex < lFlagStateTuplesCount; lIndex++)
+    {
+        lRetval = chkconfig_state_get_state_string(lFlagStateTuples[lIndex].m_state, &lStateString);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        fprintf(lFile,
+                CHKCONFIG_TRANSFER_ROW_FORMAT,
+                lFlagStateTuples[lIndex].m_flag,
+                lStateString);
+    }
+
+ done:
+    if ((lFile != nullptr) && ((lStandard ? fflush(lFile) : fclose(lFile)) != 0) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+    {
+        lRetval = -errno;
+
+        PrintError("Failed to write \"%s\": %s\n", inPath, strerror(-lRetval));
+    }
+
+    if (lFlagStateTuples != nullptr)
+    {
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t ImportFlags(chkconfig_context_t &inContext,
+                                      const char *inPath,
+                                      const uint32_t &inOptFlags)
+{
+    const bool                           lStandard        = (strcmp(inPath, CHKCONFIG_TRANSFER_STANDARD_PATH) == 0);
+    FILE *                               lFile            = nullptr;
+    char *                               lLine            = nullptr;
+    size_t                               lLineSize        = 0;
+    size_t                               lLineNumber      = 0;
+    char *                               lSaved;
+    const char *                         lFlag;
+    const char *                         lStateString;
+    chkconfig_state_t                    lState;
+    chkconfig_flag_state_tuple_t *       lFlagStateTuples = nullptr;
+    chkconfig_flag_state_tuple_t *       lGrown;
+    size_t                               lFlagStateTuplesCount = 0;
+    size_t                               lFlagStateTuplesCapacity = 0;
+    chkconfig_status_t                   lStatus;
+    chkconfig_status_t                   lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lFile = (lStandard ? stdin : fopen(inPath, "r"));
+
+    if (lFile == nullptr)
+    {
+        lRetval = -errno;
+
+        PrintError("Failed to open \"%s\" for import: %s\n", inPath, strerror(-lRetval));
+
+        goto done;
+    }
+
+    // Read and check every line before setting any flag, such that
+    // a malformed file changes nothing. Blank lines and those
+    // beginning with '#' are ignored.
+
+    while (getline(&lLine, &lLineSize, lFile) != -1)
+    {
+        lLineNumber++;
+
+        lFlag        = strtok_r(lLine, CHKCONFIG_TRANSFER_SEPARATORS, &lSaved);
+
+        if ((lFlag == nullptr) || (lFlag[0] == CHKCONFIG_TRANSFER_COMMENT))
+        {
+            continue;
+        }
+
+        lStateString = strtok_r(nullptr, CHKCONFIG_TRANSFER_SEPARATORS, &lSaved);
+
+        if ((lStateString == nullptr) ||
+            (strtok_r(nullptr, CHKCONFIG_TRANSFER_SEPARATORS, &lSaved) != nullptr) ||
+            (chkconfig_state_string_get_state(lStateString, &lState) < CHKCONFIG_STATUS_SUCCESS))
+        {
+            PrintError("%s:%zu: Expected '<flag> <on | off>'.\n", inPath, lLineNumber);
+
+            lRetval = -EINVAL;
+            goto done;
+        }
+
+        if ((strchr(lFlag, '/') != nullptr) || (strcmp(lFlag, ".") == 0) || (strcmp(lFlag, "..") == 0))
+        {
+            PrintError("%s:%zu: Invalid flag \"%s\".\n", inPath, lLineNumber, lFlag);
+
+            lRetval = -EINVAL;
+            goto done;
+        }
+
+        if (lFlagStateTuplesCount == lFlagStateTuplesCapacity)
+        {
+            lFlagStateTuplesCapacity = ((lFlagStateTuplesCapacity == 0) ? 64 : (lFlagStateTuplesCapacity * 2));
+
+            lGrown = static_cast<chkconfig_flag_state_tuple_t *>(realloc(lFlagStateTuples,
+                                                                         lFlagStateTuplesCapacity * sizeof (chkconfig_flag_state_tuple_t)));
+            nlREQUIRE_ACTION(lGrown != nullptr, done, lRetval = -ENOMEM);
+
+            lFlagStateTuples = lGrown;
+        }
+
+        lFlagStateTuples[lFlagStateTuplesCount].m_flag   = strdup(lFlag);
+        nlREQUIRE_ACTION(lFlagStateTuples[lFlagStateTuplesCount].m_flag != nullptr, done, lRetval = -ENOMEM);
+
+        lFlagStateTuples[lFlagStateTuplesCount].m_state  = lState;
+        lFlagStateTuples[lFlagStateTuplesCount].m_origin = CHKCONFIG_ORIGIN_STATE;
+
+        lFlagStateTuplesCount++;
+    }
+
+    nlREQUIRE_ACTION(!ferror(lFile), done, lRetval = -EIO);
+
+    // The library compares the flags with the current state of every
+    // flag and sets, in a single batch, only those that change. If
+    // any change would create a flag without force, nothing is set.
+
+    lRetval = chkconfig_state_import(&inContext,
+                                     lFlagStateTuples,
+                                     lFlagStateTuplesCount,
+                                     ((inOptFlags & kChkconfigOptFlagPrune) == kChkconfigOptFlagPrune),
+                                     nullptr);
+    nlEXPECT_SUCCESS_ACTION(lRetval,
+                            done,
+                            PrintError("Failed to import \"%s\": %s%s\n",
+                                       inPath,
+                                       strerror(-lRetval),
+                                       ((lRetval == -ENOENT) ? "; use '-f/--force' to create the flags that do not exist" : "")));
+
+ done:
+    if ((lFile != nullptr) && !lStandard)
+    {
+        fclose(lFile);
+    }
+
+    if (lLine != nullptr)
+    {
+        free(lLine);
+    }
+
+    if (lFlagStateTuplesCount > 0)
+    {
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+    }
+    else if (lFlagStateTuples != nullptr)
+    {
+        free(lFlagStateTuples);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t MigrateLayout(chkconfig_context_t &inContext)
+{
+    chkconfig_status_t lRetval  = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = chkconfig_state_migrate_layout(&inContext);
+    nlEXPECT_SUCCESS_ACTION(lRetval,
+                            done,
+                            PrintError("Failed to migrate the flag state layout: %s\n",
+                                       strerror(-lRetval)));
+
+ done:
+    return (lRetval);
+}
+
 static chkconfig_status_t Init(chkconfig_context_pointer_t &inContextPointer,
                                chkconfig_options_pointer_t &inOptionsPointer,
                                const uint32_t &inOptFlags)
@@ -740,6 +1558,15 @@ static chkconfig_status_t Init(chkconfig_context_pointer_t &inContextPointer,
         nlREQUIRE_SUCCESS(lRetval, done);
     }
 
+    if (inOptFlags & kChkconfigOptFlagShardedLayout)
+    {
+        lRetval = chkconfig_options_set(inContextPointer,
+                                        inOptionsPointer,
+                                        CHKCONFIG_OPTION_SHARDED_LAYOUT,
+                                        ((inOptFlags & kChkconfigOptFlagShardedLayout) == kChkconfigOptFlagShardedLayout));
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
  done:
     return (lRetval);
 }
@@ -786,9 +1613,29 @@ static chkconfig_status_t Main(int &argc, char * const argv[])
 
     // Depending on the mode, do the requested work.
 
-    if ((sOptFlags & kChkconfigOptFlagListAll) && (sFlagString == nullptr))
+    if (sOptFlags & kChkconfigOptFlagMigrateLayout)
+    {
+        lRetval = MigrateLayout(*lContextPointer);
+    }
+    else if (sOptFlags & kChkconfigOptFlagExport)
+    {
+        lRetval = ExportFlags(*lContextPointer, sTransferPath);
+    }
+    else if (sOptFlags & kChkconfigOptFlagImport)
+    {
+        lRetval = ImportFlags(*lContextPointer, sTransferPath, sOptFlags);
+    }
+    else if (sOptFlags & kChkconfigOptFlagSummary)
+    {
+        lRetval = SummarizeFlags(*lContextPointer);
+    }
+    else if (sOptFlags & kChkconfigOptFlagDiff)
+    {
+        lRetval = DiffFlags(*lContextPointer);
+    }
+    else if ((sOptFlags & kChkconfigOptFlagListAll) && (sFlagString == nullptr))
     {
-        lRetval = ListAllFlags(*lContextPointer, sOptFlags);
+        lRetval = ListAllFlags(*lContextPointer, sListPattern, sMatchPattern, sOptFlags);
     }
     else if (sFlagString != nullptr)
     {
@@ -25,384 +25,978 @@
 
 #include "chkconfig.h"
 
-#include <algorithm>
-#include <iterator>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <unistd.h>
 
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #if defined(__APPLE__)
 #include <sys/syslimits.h>
 #endif
 
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#if __has_include(<sys/inotify.h>)
+#include <sys/inotify.h>
+#endif
+#endif
+
 #include "chkconfig-assert.h"
 
+// Batched flag I/O requires io_uring with sparse, direct file
+// descriptor tables (Linux 5.19 or later at run time); where the
+// headers do not describe that, the library builds without it.
+
+#if defined(IORING_RSRC_REGISTER_SPARSE) && defined(__NR_io_uring_setup)
+#define CHKCONFIG_HAVE_IO_URING 1
+#else
+#define CHKCONFIG_HAVE_IO_URING 0
+#endif
+
+// Existence filters are kept current by inotify(7) file system
+// change notifications; where the headers do not describe those,
+// the library builds without them and the option enabling them has
+// no effect.
+
+#if defined(IN_NONBLOCK) && defined(IN_Q_OVERFLOW)
+#define CHKCONFIG_HAVE_INOTIFY 1
+#else
+#define CHKCONFIG_HAVE_INOTIFY 0
+#endif
+
 
 using namespace std;
 
 
 // MARK: Type Declarations
 
+/**
+ *  @brief
+ *    An asynchronous flag observation or mutation request, queued
+ *    first for the context worker thread to perform and then for the
+ *    client to dispatch its completion.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_async_request
+{
+    _chkconfig_async_request * m_next;             //!< A pointer to the next
+                                                   //!< request in the same
+                                                   //!< queue.
+    bool                       m_mutate;           //!< When asserted, set
+                                                   //!< rather than get the
+                                                   //!< flag state.
+    char *                     m_flag;             //!< A pointer to a copy of
+                                                   //!< the flag.
+    chkconfig_state_t          m_state;            //!< The state to set or,
+                                                   //!< once performed, that
+                                                   //!< observed.
+    chkconfig_origin_t         m_origin;           //!< Once performed, the
+                                                   //!< origin of the state.
+    chkconfig_status_t         m_status;           //!< Once performed, the
+                                                   //!< status of the request.
+    chkconfig_state_callback_t m_callback;         //!< The client completion
+                                                   //!< function.
+    void *                     m_callback_context; //!< The client completion
+                                                   //!< function context.
+};
+
+typedef struct _chkconfig_async_request chkconfig_async_request_t;
+
+struct _chkconfig_state_log;
+struct _chkconfig_memory_store;
+struct _chkconfig_existence_filter;
+struct _chkconfig_existence_filters;
+
 /**
  *  @brief
  *    A client-opaque type for chkconfig library context.
  *
  *  Most chkconfig library interfaces take a pointer to this context.
  *
+ *  A context may be shared among threads. The runtime options in
+ *  effect for it are published as an immutable snapshot, a private
+ *  copy of the client's runtime options, by swapping an atomic
+ *  pointer. Observers and mutators take no lock: they announce
+ *  themselves by counting in and out of the context and use the
+ *  snapshot they loaded for the duration of the call. Changes to
+ *  runtime options are serialized by a lock and replace, rather than
+ *  modify, the snapshot; the one replaced is retired and reclaimed
+ *  once the context is next observed to have no readers, whether by
+ *  a change or by the last reader counting itself out, and at the
+ *  latest when the context is destroyed.
+ *
  *  @private
  *
  */
 struct _chkconfig_context
 {
-    const chkconfig_options_t * m_options; //!< A pointer to the current
-                                           //!< immutable library runtime
-                                           //!< options.
+    atomic<const chkconfig_options_t *> m_options;              //!< A pointer to the
+                                                                //!< current immutable
+                                                                //!< library runtime
+                                                                //!< options snapshot.
+    atomic<size_t>                      m_readers;              //!< The number of calls
+                                                                //!< that may be using a
+                                                                //!< runtime options
+                                                                //!< snapshot.
+    mutex                               m_writer;               //!< The lock serializing
+                                                                //!< changes to runtime
+                                                                //!< options.
+    const chkconfig_options_t *         m_source;               //!< A pointer to the
+                                                                //!< client runtime options
+                                                                //!< from which the current
+                                                                //!< snapshot was published
+                                                                //!< or null for the
+                                                                //!< defaults.
+    chkconfig_options_t *               m_retired;              //!< A pointer to the first
+                                                                //!< retired runtime
+                                                                //!< options snapshot
+                                                                //!< awaiting reclamation.
+    mutex                               m_async_lock;           //!< The lock protecting
+                                                                //!< the asynchronous
+                                                                //!< request queues and
+                                                                //!< worker thread state.
+    condition_variable                  m_async_ready;          //!< The condition signaled
+                                                                //!< when a request is
+                                                                //!< queued or the worker
+                                                                //!< thread is to stop.
+    chkconfig_async_request_t *         m_async_pending;        //!< A pointer to the
+                                                                //!< oldest request yet to
+                                                                //!< be performed.
+    chkconfig_async_request_t **        m_async_pending_tail;   //!< A pointer to the link
+                                                                //!< at which to queue the
+                                                                //!< next request to be
+                                                                //!< performed.
+    chkconfig_async_request_t *         m_async_completed;      //!< A pointer to the
+                                                                //!< oldest performed
+                                                                //!< request yet to be
+                                                                //!< dispatched.
+    chkconfig_async_request_t **        m_async_completed_tail; //!< A pointer to the link
+                                                                //!< at which to queue the
+                                                                //!< next performed
+                                                                //!< request.
+    int                                 m_async_signal[2];      //!< The read and write
+                                                                //!< descriptors of the
+                                                                //!< pipe made readable
+                                                                //!< when performed
+                                                                //!< requests await
+                                                                //!< dispatch or -1 until
+                                                                //!< first needed.
+    pthread_t                           m_async_thread;         //!< The worker thread
+                                                                //!< performing requests.
+    bool                                m_async_started;        //!< Asserted once the
+                                                                //!< worker thread has been
+                                                                //!< started.
+    bool                                m_async_stopping;       //!< Asserted when the
+                                                                //!< worker thread is to
+                                                                //!< stop.
+    _chkconfig_state_log *              m_logs;                 //!< A pointer to the first
+                                                                //!< flag state log opened
+                                                                //!< for the context, each
+                                                                //!< shared by every
+                                                                //!< runtime options
+                                                                //!< snapshot naming it.
+    _chkconfig_memory_store *           m_memory;               //!< A pointer to the
+                                                                //!< in-memory flag store
+                                                                //!< of the context or
+                                                                //!< null until first
+                                                                //!< used.
+    _chkconfig_existence_filters *      m_filters;              //!< A pointer to the
+                                                                //!< existence filters
+                                                                //!< of the context or
+                                                                //!< null until first
+                                                                //!< used.
 };
 
+// The number of layers that may be pushed between the state store
+// and the default directory, which, with those two, bounds the
+// number of stores overlaid.
+
+static constexpr size_t kChkconfigLayersMaximum = 14;
+static constexpr size_t kChkconfigStoresMaximum = (kChkconfigLayersMaximum + 2);
+
 /**
  *  @brief
- *    A client-opaque type for chkconfig library runtime options.
+ *    A flag state backing file directory layered between the state
+ *    store and the default directory.
  *
  *  @private
  *
  */
-struct _chkconfig_options
+struct _chkconfig_layer
 {
-    const char * m_state_dir;       //!< A pointer to an immutable null-
-                                    //!< terminated C string containing
-                                    //!< the read/write flag state backing
-                                    //!< file directory.
-    bool         m_force_state;     //!< When asserted, create backing
-                                    //!< state files that do not already
-                                    //!< exist.
-    bool         m_use_default_dir; //!< When asserted, use the read-only
-                                    //!< flag state fallback default
-                                    //!< directory when a flag does not
-                                    //!< exist in the state directory.
-    const char * m_default_dir;     //!< A pointer to an immutable null-
-                                    //!< terminated C string containing
-                                    //!< read-only flag state fallback
-                                    //!< 'default' backing file directory
-                                    //!< to use when a flag does not exist
-                                    //!< in the 'state' directory.
+    const char *                  m_directory; //!< A pointer to an immutable
+                                               //!< null-terminated C string
+                                               //!< containing the layer
+                                               //!< backing file directory.
+    bool                          m_writable;  //!< When asserted, flags that
+                                               //!< exist in the layer are set
+                                               //!< there.
+    _chkconfig_existence_filter * m_filter;    //!< For a published snapshot
+                                               //!< with existence filters, a
+                                               //!< pointer to the context
+                                               //!< filter for the layer
+                                               //!< directory; otherwise, null.
 };
 
-// MARK: C++
-
-static bool operator <(const chkconfig_flag_state_tuple_t &inLeftTuple,
-                       const chkconfig_flag_state_tuple_t &inRightTuple)
-{
-    const bool lRetval = (strcmp(inLeftTuple.m_flag, inRightTuple.m_flag) < 0);
-
-    return (lRetval);
-}
+typedef struct _chkconfig_layer chkconfig_layer_t;
 
-namespace nuovations
+/**
+ *  @brief
+ *    A client-opaque type for chkconfig library runtime options.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_options
 {
+    const char *                   m_state_dir;         //!< A pointer to an immutable null-
+                                                        //!< terminated C string containing
+                                                        //!< the read/write flag state
+                                                        //!< backing file directory.
+    bool                           m_force_state;       //!< When asserted, create backing
+                                                        //!< state files that do not already
+                                                        //!< exist.
+    bool                           m_use_default_dir;   //!< When asserted, use the read-only
+                                                        //!< flag state fallback default
+                                                        //!< directory when a flag does not
+                                                        //!< exist in the state directory.
+    const char *                   m_default_dir;       //!< A pointer to an immutable null-
+                                                        //!< terminated C string containing
+                                                        //!< read-only flag state fallback
+                                                        //!< 'default' backing file directory
+                                                        //!< to use when a flag does not
+                                                        //!< exist in the 'state' directory.
+    bool                           m_sync_state;        //!< When asserted, flush backing
+                                                        //!< state files to stable storage
+                                                        //!< before closing them.
+    uint32_t                       m_io_queue_depth;    //!< The maximum number of flags for
+                                                        //!< which backing file I/O is
+                                                        //!< submitted at once or zero to
+                                                        //!< perform it synchronously.
+    uint32_t                       m_threads;           //!< The maximum number of threads,
+                                                        //!< including the caller, with which
+                                                        //!< to enumerate directories and
+                                                        //!< read backing files.
+    const char *                   m_state_log;         //!< A pointer to an immutable null-
+                                                        //!< terminated C string containing
+                                                        //!< the path of the flag state log
+                                                        //!< to use in place of the state
+                                                        //!< directory or null.
+    _chkconfig_state_log *         m_log;               //!< For a published snapshot, a
+                                                        //!< pointer to the context flag
+                                                        //!< state log for 'm_state_log' or
+                                                        //!< null.
+    bool                           m_memory_state;      //!< When asserted, store flag states
+                                                        //!< in memory in place of the state
+                                                        //!< directory or log.
+    _chkconfig_memory_store *      m_memory;            //!< For a published snapshot with
+                                                        //!< 'm_memory_state' asserted, a
+                                                        //!< pointer to the context in-memory
+                                                        //!< flag store; otherwise, null.
+    chkconfig_layer_t *            m_layers;            //!< A pointer to the layers between
+                                                        //!< the state store and the default
+                                                        //!< directory, in the order pushed,
+                                                        //!< or null.
+    size_t                         m_layer_count;       //!< The number of layers pushed.
+    bool                           m_sharded_layout;    //!< When asserted, every backing
+                                                        //!< file directory has a sharded
+                                                        //!< layout.
+    bool                           m_existence_filters; //!< When asserted, keep an existence
+                                                        //!< filter for each backing file
+                                                        //!< directory.
+    _chkconfig_existence_filters * m_filters;           //!< For a published snapshot with
+                                                        //!< 'm_existence_filters' asserted,
+                                                        //!< a pointer to the context
+                                                        //!< existence filters; otherwise,
+                                                        //!< null.
+    _chkconfig_existence_filter *  m_state_filter;      //!< For a published snapshot with
+                                                        //!< existence filters and a state
+                                                        //!< directory, a pointer to the
+                                                        //!< filter for it; otherwise, null.
+    _chkconfig_existence_filter *  m_default_filter;    //!< For a published snapshot with
+                                                        //!< existence filters and the
+                                                        //!< default directory in use, a
+                                                        //!< pointer to the filter for it;
+                                                        //!< otherwise, null.
+    chkconfig_options_t *          m_next;              //!< For a retired snapshot, a
+                                                        //!< pointer to the next retired
+                                                        //!< snapshot awaiting reclamation.
+};
 
-namespace Detail
+/**
+ *  @brief
+ *    A compact, structure-of-arrays flag/state table.
+ *
+ *  This is the internal representation on which the library sorts,
+ *  merges, and looks up flags. Rather than a scattered array of
+ *  heap-allocated flag strings, each with a padded state and origin,
+ *  the flags are packed into a single string pool and addressed by
+ *  offset; states are packed one bit per flag; and origins are
+ *  packed two bits per flag.
+ *
+ *  Each flag also carries a key: its first eight bytes, big-endian
+ *  and zero-padded, such that most comparisons are resolved by a
+ *  single integer comparison without touching the string pool.
+ *
+ *  Tables are converted to the public flag/state tuple array only at
+ *  the API boundary.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_flag_state_table
 {
+    char *     m_pool;      //!< A pointer to the string pool of
+                            //!< null-terminated flags.
+    size_t     m_pool_size; //!< The allocated size, in bytes, of
+                            //!< the string pool.
+    size_t     m_pool_used; //!< The used size, in bytes, of the
+                            //!< string pool.
+    uint32_t * m_offsets;   //!< A pointer to the per-flag offsets
+                            //!< into the string pool.
+    uint64_t * m_keys;      //!< A pointer to the per-flag comparison
+                            //!< keys.
+    uint64_t * m_states;    //!< A pointer to the per-flag state
+                            //!< bitset.
+    uint8_t *  m_origins;   //!< A pointer to the per-flag packed
+                            //!< two-bit origins.
+    size_t     m_count;     //!< The number of flags in the table.
+    size_t     m_capacity;  //!< The number of flags for which the
+                            //!< per-flag arrays are allocated.
+};
 
-// MARK: Type Declarations
+typedef struct _chkconfig_flag_state_table chkconfig_flag_state_table_t;
 
 /**
- *  This defines a basis class for iterating over flag/state tuple
- *  plain old data (POD) C style arrays.
+ *  @brief
+ *    A criterion against which flags are matched as a flag store is
+ *    enumerated.
+ *
+ *  A flag matches when it begins with the prefix and, if there is a
+ *  filter, the filter includes it. Flags are matched by name alone,
+ *  before any backing file is opened or any flag is copied, such
+ *  that the cost of a query beyond enumeration is proportional to
+ *  the matches rather than to every flag.
  *
  *  @private
+ *
  */
-class FlagStateTupleIteratorBasis
+struct _chkconfig_flag_match
 {
-protected:
-    // MARK: Constructors
-
-    FlagStateTupleIteratorBasis(void) = delete;
-
-    explicit FlagStateTupleIteratorBasis(const chkconfig_flag_state_tuple_t * inFlagStateTuplePointer);
-    explicit FlagStateTupleIteratorBasis(chkconfig_flag_state_tuple_t * inFlagStateTuplePointer);
-
-public:
-    // MARK: Increment Operator
-
-    FlagStateTupleIteratorBasis & operator ++(void);
-
-protected:
-    chkconfig_flag_state_tuple_t * mFlagStateTuplePointer;
+    const char *            m_prefix;         //!< A pointer to the null-
+                                              //!< terminated prefix flags
+                                              //!< must begin with.
+    size_t                  m_prefix_length;  //!< The length, in bytes, of
+                                              //!< the prefix.
+    chkconfig_flag_filter_t m_filter;         //!< An optional function
+                                              //!< flags must also pass.
+    void *                  m_filter_context; //!< The caller context
+                                              //!< pointer for the filter.
 };
 
+typedef struct _chkconfig_flag_match chkconfig_flag_match_t;
+
 /**
- *  This defines a derived class for iterating input from flag/state
- *  tuple plain old data (POD) C style arrays.
+ *  @brief
+ *    An in-memory index of flags and their states.
+ *
+ *  The index is a flag/state table holding one entry per flag, in
+ *  the order first indexed, addressed by an open-addressed hash of
+ *  slots.
  *
  *  @private
  *
  */
-class FlagStateTupleInputIterator :
-        public FlagStateTupleIteratorBasis,
-        public std::iterator<std::input_iterator_tag,
-                             chkconfig_flag_state_tuple_t>
+struct _chkconfig_flag_index
 {
-public:
-    // MARK: Constructors
-
-    explicit FlagStateTupleInputIterator(const chkconfig_flag_state_tuple_t * inFlagStateTuplePointer);
-    explicit FlagStateTupleInputIterator(chkconfig_flag_state_tuple_t * inFlagStateTuplePointer);
-
-    // MARK: Dereferencing Operator
-
-    const chkconfig_flag_state_tuple_t & operator *(void) const;
-
-    // MARK: Comparison Operators
-
-    bool operator ==(const FlagStateTupleInputIterator & inFlagStateTupleInputIterator) const;
-    bool operator !=(const FlagStateTupleInputIterator & inFlagStateTupleInputIterator) const;
+    chkconfig_flag_state_table_t m_table;      //!< The flags and their
+                                               //!< states.
+    uint32_t *                   m_slots;      //!< A pointer to the hash
+                                               //!< slots, each the index of a
+                                               //!< table entry plus one or
+                                               //!< zero if empty.
+    size_t                       m_slot_count; //!< The number of hash slots,
+                                               //!< a power of two.
 };
 
+typedef struct _chkconfig_flag_index chkconfig_flag_index_t;
+
 /**
- *  This defines a derived class for iterating assigned output from
- *  flag/state tuple plain old data (POD) C style arrays.
+ *  @brief
+ *    A single-file, append-only flag state log and its in-memory
+ *    index.
  *
- *  This class explicitly allows a custom assignment operator that
- *  correctly handles the deep, management memory string pointer
- *  manipulation otherwise mishandled by the compiler-generated
- *  default, shallow-copy assignment.
+ *  The log is a header followed by checksummed (flag, state)
+ *  records, the last record for a flag being its state. The index
+ *  is kept current with the file, including appends and compactions
+ *  by other processes, by rescanning any records past those already
+ *  indexed.
  *
  *  @private
  *
  */
-class FlagStateTupleOutputAssignmentIterator :
-        public FlagStateTupleIteratorBasis,
-        public std::iterator<std::output_iterator_tag,
-                             void,
-                             std::ptrdiff_t,
-                             chkconfig_flag_state_tuple_t *,
-                             chkconfig_flag_state_tuple_t &>
+struct _chkconfig_state_log
 {
-public:
-    // MARK: Constructors
-
-    FlagStateTupleOutputAssignmentIterator(void) = delete;
-
-    explicit FlagStateTupleOutputAssignmentIterator(chkconfig_flag_state_tuple_t * inFlagStateTuplePointer);
-
-    // MARK: Assignment Operator
-
-    FlagStateTupleOutputAssignmentIterator & operator =(const chkconfig_flag_state_tuple_t & inFlagStateTuple);
+    char *                       m_path;       //!< A pointer to the path of
+                                               //!< the log file.
+    mutex                        m_lock;       //!< The lock serializing
+                                               //!< access to the log.
+    int                          m_descriptor; //!< The open log file
+                                               //!< descriptor or -1.
+    bool                         m_writable;   //!< Asserted when the log
+                                               //!< file is open for writing.
+    dev_t                        m_device;     //!< The device of the open
+                                               //!< log file.
+    ino_t                        m_inode;      //!< The inode of the open
+                                               //!< log file.
+    off_t                        m_size;       //!< The offset just past the
+                                               //!< last valid record indexed.
+    size_t                       m_records;    //!< The number of valid
+                                               //!< records indexed.
+    chkconfig_flag_index_t       m_index;      //!< The index of flags and
+                                               //!< their states, in the order
+                                               //!< first logged.
+    _chkconfig_state_log *       m_next;       //!< A pointer to the next log
+                                               //!< of the same context.
+};
 
-    // MARK: Dereferencing Operator
+typedef struct _chkconfig_state_log chkconfig_state_log_t;
 
-    FlagStateTupleOutputAssignmentIterator & operator *(void);
+/**
+ *  @brief
+ *    An in-memory flag store, private to a library context.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_memory_store
+{
+    mutex                  m_lock;  //!< The lock serializing access
+                                    //!< to the store.
+    chkconfig_flag_index_t m_index; //!< The index of flags and their
+                                    //!< states, in the order first
+                                    //!< set.
 };
 
+typedef struct _chkconfig_memory_store chkconfig_memory_store_t;
+
 /**
- *  This defines a derived class for iterating assigned output from
- *  flag/state tuple plain old data (POD) C style arrays.
+ *  @brief
+ *    An existence filter: the exact set of names in a flag state
+ *    backing file directory.
  *
- *  This class explicitly allows a custom assignment operator that
- *  allows for counting the number of elements that would have
- *  otherwise been assigned.
+ *  The set is built by enumerating the directory and thereafter kept
+ *  current by file system change notifications for it. A name
+ *  removed from the directory remains in the index with its state
+ *  cleared, such that a name is in the directory if, and only if,
+ *  it is indexed with its state set.
  *
  *  @private
  *
  */
-class FlagStateTupleOutputNullAssignmentIterator :
-        public std::iterator<std::output_iterator_tag,
-                             void,
-                             std::ptrdiff_t,
-                             chkconfig_flag_state_tuple_t *,
-                             chkconfig_flag_state_tuple_t &>
+struct _chkconfig_existence_filter
 {
-public:
-    // MARK: Constructors
-
-    FlagStateTupleOutputNullAssignmentIterator(void);
-
-    // MARK: Assignment Operator
-
-    FlagStateTupleOutputNullAssignmentIterator & operator =(const chkconfig_flag_state_tuple_t & inFlagStateTuple);
-
-    // MARK: Dereferencing Operator
-
-    FlagStateTupleOutputNullAssignmentIterator & operator *(void);
-
-    // MARK: Increment Operator
-
-    FlagStateTupleOutputNullAssignmentIterator & operator ++(void);
-
-    // MARK: Subtraction Operator
-
-    size_t operator -(const FlagStateTupleOutputNullAssignmentIterator &inFlagStateTupleOutputNullAssignmentIterator) const;
-
-private:
-    size_t mCount;
+    char *                         m_directory; //!< A pointer to the
+                                                //!< null-terminated
+                                                //!< directory.
+    size_t                         m_length;    //!< The length, in bytes,
+                                                //!< of the directory.
+    int                            m_watch;     //!< The watch descriptor
+                                                //!< for the directory or
+                                                //!< -1.
+    bool                           m_valid;     //!< Asserted when the
+                                                //!< index is complete and
+                                                //!< current.
+    chkconfig_flag_index_t         m_index;     //!< The index of names in
+                                                //!< the directory.
+    _chkconfig_existence_filters * m_filters;   //!< A pointer to the
+                                                //!< existence filters to
+                                                //!< which the filter
+                                                //!< belongs.
+    _chkconfig_existence_filter *  m_next;      //!< A pointer to the next
+                                                //!< filter of the same
+                                                //!< context.
 };
 
-// MARK: Global Variables
+typedef struct _chkconfig_existence_filter chkconfig_existence_filter_t;
 
-static const chkconfig_options_t sChkconfigOptionsDefault =
-{
-    .m_state_dir        = CHKCONFIG_STATEDIR_DEFAULT,
-    .m_force_state      = false,
-    .m_use_default_dir  = false,
-    .m_default_dir      = CHKCONFIG_DEFAULTDIR_DEFAULT
-};
-static const char * const        sOffStateString          = "off";
-static const char * const        sOnStateString           = "on";
-static const char * const        sOriginStrings[]         =
+/**
+ *  @brief
+ *    The existence filters of a library context, one for each flag
+ *    state backing file directory named by any of its runtime
+ *    options snapshots, sharing a single change notification
+ *    descriptor.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_existence_filters
 {
-    [CHKCONFIG_ORIGIN_UNKNOWN] = "unknown",
-    [CHKCONFIG_ORIGIN_NONE]    = "none",
-    [CHKCONFIG_ORIGIN_DEFAULT] = "default",
-    [CHKCONFIG_ORIGIN_STATE]   = "state"
+    mutex                          m_lock;       //!< The lock serializing
+                                                 //!< access to the
+                                                 //!< descriptor and every
+                                                 //!< filter.
+    int                            m_descriptor; //!< The change
+                                                 //!< notification
+                                                 //!< descriptor or -1
+                                                 //!< until first needed.
+    chkconfig_existence_filter_t * m_first;      //!< A pointer to the first
+                                                 //!< filter.
 };
 
-// MARK: Flag/State Tuple Iterator Basis
+typedef struct _chkconfig_existence_filters chkconfig_existence_filters_t;
 
-// MARK: Constructors
+struct _chkconfig_store_operations;
 
-FlagStateTupleIteratorBasis :: FlagStateTupleIteratorBasis(const chkconfig_flag_state_tuple_t * inFlagStateTuplePointer) :
-    mFlagStateTuplePointer(const_cast<chkconfig_flag_state_tuple_t *>(inFlagStateTuplePointer))
+/**
+ *  @brief
+ *    A flag store: one layer of the flag overlay, such as the state
+ *    or default directory, along with the operations implementing
+ *    it.
+ *
+ *  Only the members used by its operations are meaningful for any
+ *  given store.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_store
 {
-    return;
-}
+    const _chkconfig_store_operations * m_operations; //!< A pointer to the
+                                                      //!< operations
+                                                      //!< implementing the
+                                                      //!< store.
+    chkconfig_origin_t                  m_origin;     //!< The origin of the
+                                                      //!< flags in the store.
+    const char *                        m_directory;  //!< For a directory
+                                                      //!< store, a pointer to
+                                                      //!< the null-terminated
+                                                      //!< C string of the
+                                                      //!< directory.
+    chkconfig_state_log_t *             m_log;        //!< For a flag state log
+                                                      //!< store, a pointer to
+                                                      //!< the log.
+    chkconfig_memory_store_t *          m_memory;     //!< For an in-memory
+                                                      //!< store, a pointer to
+                                                      //!< the store.
+    chkconfig_existence_filter_t *      m_filter;     //!< For a directory
+                                                      //!< store, a pointer to
+                                                      //!< its existence filter
+                                                      //!< or null.
+    bool                                m_sharded;    //!< For a directory
+                                                      //!< store, whether it
+                                                      //!< has a sharded
+                                                      //!< layout.
+};
 
-FlagStateTupleIteratorBasis :: FlagStateTupleIteratorBasis(chkconfig_flag_state_tuple_t * inFlagStateTuplePointer) :
-    mFlagStateTuplePointer(inFlagStateTuplePointer)
-{
-    return;
-}
+typedef struct _chkconfig_store chkconfig_store_t;
 
-FlagStateTupleIteratorBasis & FlagStateTupleIteratorBasis :: operator ++(void)
+/**
+ *  @brief
+ *    The flag stores overlaid to resolve flags, in order of
+ *    precedence.
+ *
+ *  The state store is always first and the default store, if in
+ *  use, always last, with any layers, most recently pushed first,
+ *  between them.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_overlay
 {
-    ++mFlagStateTuplePointer;
-
-    return (*this);
-}
-
-// MARK: Flag/State Tuple Input Iterator
-
-// MARK: Constructors
+    chkconfig_store_t m_stores[kChkconfigStoresMaximum]; //!< The stores, in
+                                                         //!< order of
+                                                         //!< precedence.
+    size_t            m_count;                           //!< The number of
+                                                         //!< stores.
+};
 
-FlagStateTupleInputIterator :: FlagStateTupleInputIterator(const chkconfig_flag_state_tuple_t * inFlagStateTuplePointer) :
-    FlagStateTupleIteratorBasis(inFlagStateTuplePointer)
-{
-    return;
-}
+typedef struct _chkconfig_overlay chkconfig_overlay_t;
 
-FlagStateTupleInputIterator :: FlagStateTupleInputIterator(chkconfig_flag_state_tuple_t * inFlagStateTuplePointer) :
-    FlagStateTupleIteratorBasis(inFlagStateTuplePointer)
+/**
+ *  @brief
+ *    A cursor over the flags in a single flag store.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_store_cursor
 {
-    return;
-}
+    chkconfig_store_t m_store;              //!< The store over which the
+                                            //!< cursor runs.
+    DIR *             m_directory;          //!< For a directory store,
+                                            //!< the directory stream
+                                            //!< or, for one with a
+                                            //!< sharded layout, that
+                                            //!< of the current shard.
+    DIR *             m_shards;             //!< For a directory store
+                                            //!< with a sharded layout,
+                                            //!< the directory stream of
+                                            //!< its shards.
+    size_t            m_next;               //!< For a flag state log
+                                            //!< store, the index of the
+                                            //!< next entry to produce.
+    char              m_flag[NAME_MAX + 1]; //!< For a flag state log
+                                            //!< store, the most recently
+                                            //!< produced flag.
+};
 
-// MARK: Dereferencing Operator
+typedef struct _chkconfig_store_cursor chkconfig_store_cursor_t;
+
+typedef chkconfig_status_t (* chkconfig_store_get_t)(const chkconfig_store_t &inStore,
+                                                     const chkconfig_options_t &inOptions,
+                                                     chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                     const size_t &inCount,
+                                                     chkconfig_status_t *outStatuses);
+typedef chkconfig_status_t (* chkconfig_store_set_t)(const chkconfig_store_t &inStore,
+                                                     const chkconfig_options_t &inOptions,
+                                                     const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                     const size_t &inCount,
+                                                     chkconfig_status_t *outStatuses);
+typedef chkconfig_status_t (* chkconfig_store_copy_all_t)(const chkconfig_store_t &inStore,
+                                                          const chkconfig_flag_match_t *inMatch,
+                                                          const bool &inReadState,
+                                                          const uint32_t &inThreads,
+                                                          chkconfig_flag_state_table_t &inTable);
+typedef chkconfig_status_t (* chkconfig_store_get_count_t)(const chkconfig_store_t &inStore,
+                                                           size_t &outCount);
+typedef chkconfig_status_t (* chkconfig_store_contains_t)(const chkconfig_store_t &inStore,
+                                                          const char *inFlag,
+                                                          bool &outContains);
+typedef chkconfig_status_t (* chkconfig_store_cursor_open_t)(chkconfig_store_cursor_t &inCursor);
+typedef chkconfig_status_t (* chkconfig_store_cursor_next_t)(chkconfig_store_cursor_t &inCursor,
+                                                             const chkconfig_store_t *inShadows,
+                                                             const size_t &inShadowCount,
+                                                             chkconfig_flag_state_tuple_t &outFlagStateTuple);
+typedef void (* chkconfig_store_cursor_close_t)(chkconfig_store_cursor_t &inCursor);
 
-const chkconfig_flag_state_tuple_t & FlagStateTupleInputIterator :: operator *(void) const
+/**
+ *  @brief
+ *    The operations implementing a flag store.
+ *
+ *  Each operation applies to its store alone; overlaying the state
+ *  store on the default store is left to the caller. A flag absent
+ *  from a store is not an error: it is returned with a state of off
+ *  and an origin of CHKCONFIG_ORIGIN_NONE.
+ *
+ *  Gets and sets are batched. Given per-flag statuses, they attempt
+ *  every flag and return the first failure; otherwise, they stop at
+ *  the first failure. A cursor skips any flag also in one of its
+ *  shadow stores, if any, without reading its state.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_store_operations
 {
-    return (*mFlagStateTuplePointer);
-}
-
-// MARK: Comparison Operators
+    chkconfig_store_get_t          m_get;          //!< Get the states of
+                                                   //!< flags.
+    chkconfig_store_set_t          m_set;          //!< Set the states of
+                                                   //!< flags.
+    chkconfig_store_copy_all_t     m_copy_all;     //!< Append all flags,
+                                                   //!< or all matching
+                                                   //!< ones, to a table.
+    chkconfig_store_get_count_t    m_get_count;    //!< Count all flags.
+    chkconfig_store_contains_t     m_contains;     //!< Determine whether
+                                                   //!< a flag is in the
+                                                   //!< store.
+    chkconfig_store_cursor_open_t  m_cursor_open;  //!< Open a cursor.
+    chkconfig_store_cursor_next_t  m_cursor_next;  //!< Advance a cursor.
+    chkconfig_store_cursor_close_t m_cursor_close; //!< Close a cursor.
+};
 
-bool FlagStateTupleInputIterator :: operator ==(const FlagStateTupleInputIterator & inFlagStateTupleInputIterator) const
-{
-    return mFlagStateTuplePointer == inFlagStateTupleInputIterator.mFlagStateTuplePointer;
-}
+typedef struct _chkconfig_store_operations chkconfig_store_operations_t;
 
-bool FlagStateTupleInputIterator :: operator !=(const FlagStateTupleInputIterator & inFlagStateTupleInputIterator) const
+/**
+ *  @brief
+ *    A chunk of flags enumerated from a flag backing file directory,
+ *    the states of which are read from their backing files by
+ *    whichever reader thread claims the chunk.
+ *
+ *  Each chunk carries its own flag/state table, into whose slots the
+ *  claiming thread, alone, writes the states and origins it reads.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_read_chunk
 {
-    const bool lRetval = !operator ==(inFlagStateTupleInputIterator);
-
-    return (lRetval);
-}
+    _chkconfig_read_chunk *      m_next;   //!< A pointer to the next
+                                           //!< chunk, in enumeration
+                                           //!< order.
+    _chkconfig_read_chunk *      m_newer;  //!< A pointer to the next
+                                           //!< newer chunk in the
+                                           //!< reader queue holding it.
+    _chkconfig_read_chunk *      m_older;  //!< A pointer to the next
+                                           //!< older chunk in the
+                                           //!< reader queue holding it.
+    chkconfig_flag_state_table_t m_table;  //!< The flags in the chunk
+                                           //!< and, once read, their
+                                           //!< states and origins.
+    chkconfig_status_t           m_status; //!< The status of reading
+                                           //!< the chunk.
+};
 
-// MARK: Flag/State Tuple Output Assignment Iterator
+typedef struct _chkconfig_read_chunk chkconfig_read_chunk_t;
 
-// MARK: Constructors
+struct _chkconfig_read_pool;
 
-FlagStateTupleOutputAssignmentIterator :: FlagStateTupleOutputAssignmentIterator(chkconfig_flag_state_tuple_t * inFlagStateTuplePointer) :
-    FlagStateTupleIteratorBasis(inFlagStateTuplePointer)
+/**
+ *  @brief
+ *    A double-ended queue of flag chunks awaiting reading, owned by
+ *    one reader thread.
+ *
+ *  The owner takes the newest chunk; other readers, once out of work
+ *  of their own, steal the oldest.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_read_queue
 {
-    return;
-}
+    _chkconfig_read_pool *   m_pool;   //!< A pointer to the pool to
+                                       //!< which the queue belongs.
+    mutex                    m_lock;   //!< The lock serializing
+                                       //!< access to the queue.
+    chkconfig_read_chunk_t * m_oldest; //!< A pointer to the oldest
+                                       //!< chunk in the queue.
+    chkconfig_read_chunk_t * m_newest; //!< A pointer to the newest
+                                       //!< chunk in the queue.
+};
 
-// MARK: Assignment Operator
+typedef struct _chkconfig_read_queue chkconfig_read_queue_t;
 
-FlagStateTupleOutputAssignmentIterator & FlagStateTupleOutputAssignmentIterator :: operator =(const chkconfig_flag_state_tuple_t & inFlagStateTuple)
+/**
+ *  @brief
+ *    A pool of reader threads, each with its own queue, that read the
+ *    states of flags enumerated from a flag backing file directory.
+ *
+ *  The enumerating thread distributes chunks among the queues and
+ *  posts one unit of work for each, and a final one for each reader
+ *  once enumeration is complete.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_read_pool
 {
-    if (mFlagStateTuplePointer != &inFlagStateTuple)
-    {
-        if (mFlagStateTuplePointer->m_flag != nullptr)
-        {
-            free(const_cast<char *>(mFlagStateTuplePointer->m_flag));
-        }
-
-        mFlagStateTuplePointer->m_flag   = strdup(inFlagStateTuple.m_flag);
-        mFlagStateTuplePointer->m_state  = inFlagStateTuple.m_state;
-        mFlagStateTuplePointer->m_origin = inFlagStateTuple.m_origin;
-    }
-
-    return (*this);
-}
+    int                      m_directory; //!< The descriptor of the
+                                          //!< directory containing
+                                          //!< the backing files.
+    chkconfig_origin_t       m_origin;    //!< The origin of the flags
+                                          //!< in the directory.
+    chkconfig_read_queue_t * m_queues;    //!< A pointer to the reader
+                                          //!< queues.
+    size_t                   m_readers;   //!< The number of reader
+                                          //!< queues.
+    mutex                    m_lock;      //!< The lock protecting the
+                                          //!< posted work count.
+    condition_variable       m_ready;     //!< The condition signaled
+                                          //!< when work is posted.
+    size_t                   m_posted;    //!< The number of units of
+                                          //!< work posted but not yet
+                                          //!< taken.
+    atomic<bool>             m_done;      //!< Asserted once the
+                                          //!< directory has been
+                                          //!< enumerated and every
+                                          //!< chunk queued.
+};
 
-// MARK: Dereferencing Operator
+typedef struct _chkconfig_read_pool chkconfig_read_pool_t;
 
-FlagStateTupleOutputAssignmentIterator & FlagStateTupleOutputAssignmentIterator :: operator *(void)
+/**
+ *  @brief
+ *    A flag store, or layer, to be copied into a flag/state table,
+ *    sorted by flag, by one thread, along with any threads of its
+ *    own for reading backing files.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_layer_copy
 {
-    return (*this);
-}
+    chkconfig_store_t              m_store;      //!< The flag store to copy.
+    const chkconfig_flag_match_t * m_match;      //!< A pointer to the criterion
+                                                 //!< flags must match to be
+                                                 //!< copied or null to copy
+                                                 //!< all flags.
+    bool                           m_read_state; //!< When asserted, read the
+                                                 //!< state of each flag from
+                                                 //!< its backing file.
+    uint32_t                       m_threads;    //!< The maximum number of
+                                                 //!< threads with which to
+                                                 //!< copy the layer.
+    chkconfig_flag_state_table_t * m_table;      //!< A pointer to the table
+                                                 //!< to copy into.
+    chkconfig_status_t             m_status;     //!< The status of copying
+                                                 //!< the layer.
+};
 
-// MARK: Flag/State Tuple Null Output Assignment Iterator
+typedef struct _chkconfig_layer_copy chkconfig_layer_copy_t;
 
-// MARK: Constructors
+/**
+ *  @brief
+ *    A client-opaque type for a cursor over all flags with a backing
+ *    file, produced directly from a scan of each flag store.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_state_cursor
+{
+    chkconfig_overlay_t      m_overlay;                          //!< The stores over
+                                                                 //!< which the cursor
+                                                                 //!< runs.
+    chkconfig_store_cursor_t m_layers[kChkconfigStoresMaximum]; //!< The store
+                                                                 //!< cursors, one for
+                                                                 //!< each store.
+    size_t                   m_count;                            //!< The number of
+                                                                 //!< store cursors
+                                                                 //!< open.
+    size_t                   m_layer;                            //!< The index of the
+                                                                 //!< store cursor
+                                                                 //!< being read.
+    char *                   m_directories[kChkconfigStoresMaximum]; //!< The cursor-owned
+                                                                 //!< copies of the
+                                                                 //!< store directories,
+                                                                 //!< or null.
+};
 
-FlagStateTupleOutputNullAssignmentIterator :: FlagStateTupleOutputNullAssignmentIterator(void) :
-    mCount(0)
+#if CHKCONFIG_HAVE_IO_URING
+/**
+ *  @brief
+ *    A minimal io_uring submission and completion queue pair.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_io_ring
 {
-    return;
-}
+    int                   m_descriptor;   //!< The ring file descriptor.
+    uint8_t *             m_sq_ring;      //!< A pointer to the mapped
+                                          //!< submission queue ring.
+    size_t                m_sq_ring_size; //!< The size, in bytes, of
+                                          //!< the submission queue ring.
+    uint8_t *             m_cq_ring;      //!< A pointer to the mapped
+                                          //!< completion queue ring,
+                                          //!< which may be the same
+                                          //!< mapping as the submission
+                                          //!< queue ring.
+    size_t                m_cq_ring_size; //!< The size, in bytes, of
+                                          //!< the completion queue ring.
+    struct io_uring_sqe * m_sqes;         //!< A pointer to the mapped
+                                          //!< submission queue entries.
+    size_t                m_sqes_size;    //!< The size, in bytes, of
+                                          //!< the submission queue
+                                          //!< entries.
+    unsigned *            m_sq_tail;      //!< A pointer to the
+                                          //!< submission queue tail.
+    unsigned              m_sq_mask;      //!< The submission queue
+                                          //!< index mask.
+    unsigned *            m_cq_head;      //!< A pointer to the
+                                          //!< completion queue head.
+    unsigned *            m_cq_tail;      //!< A pointer to the
+                                          //!< completion queue tail.
+    unsigned              m_cq_mask;      //!< The completion queue
+                                          //!< index mask.
+    struct io_uring_cqe * m_cqes;         //!< A pointer to the
+                                          //!< completion queue entries.
+};
 
-// MARK: Assignment Operator
+typedef struct _chkconfig_io_ring chkconfig_io_ring_t;
 
-FlagStateTupleOutputNullAssignmentIterator & FlagStateTupleOutputNullAssignmentIterator :: operator =(const chkconfig_flag_state_tuple_t & inFlagStateTuple)
+/**
+ *  @brief
+ *    The submission parameters and completion results for reading
+ *    or writing a single flag backing file with io_uring.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_io_file
 {
-    (void)inFlagStateTuple;
-
-    mCount++;
+    size_t  m_path;        //!< The offset of the flag backing file
+                           //!< path in the batch path pool.
+    int32_t m_results[4];  //!< The open, read or write, sync, and
+                           //!< close results, indexed by operation:
+                           //!< non-negative if successful; otherwise,
+                           //!< a negative errno.
+    char    m_data[5];     //!< Storage for the leading bytes read
+                           //!< from, or the state string written to,
+                           //!< the file: enough for the longest state
+                           //!< string, "off", a newline, and a null
+                           //!< terminator.
+};
 
-    return (*this);
-}
+typedef struct _chkconfig_io_file chkconfig_io_file_t;
+#endif // CHKCONFIG_HAVE_IO_URING
 
-// MARK: Dereferencing Operator
+// MARK: C++
 
-FlagStateTupleOutputNullAssignmentIterator & FlagStateTupleOutputNullAssignmentIterator :: operator *(void)
+namespace nuovations
 {
-    return (*this);
-}
 
-// MARK: Increment Operator
-
-FlagStateTupleOutputNullAssignmentIterator & FlagStateTupleOutputNullAssignmentIterator :: operator ++(void)
+namespace Detail
 {
-    return (*this);
-}
 
-// MARK: Subtraction Operator
+// MARK: Global Variables
+
+static constexpr uint32_t kChkconfigIoQueueDepthMaximum = 4096;
+static constexpr uint32_t kChkconfigThreadsMaximum      = 64;
+static constexpr size_t   kChkconfigReadChunkFlags      = 64;
+static constexpr size_t   kChkconfigShardsMaximum       = 256;
 
-size_t FlagStateTupleOutputNullAssignmentIterator :: operator -(const FlagStateTupleOutputNullAssignmentIterator &inFlagStateTupleOutputNullAssignmentIterator) const
+static const chkconfig_options_t sChkconfigOptionsDefault =
 {
-    const size_t lRetval = (mCount - inFlagStateTupleOutputNullAssignmentIterator.mCount);
-
-    return (lRetval);
-}
+    .m_state_dir         = CHKCONFIG_STATEDIR_DEFAULT,
+    .m_force_state       = false,
+    .m_use_default_dir   = false,
+    .m_default_dir       = CHKCONFIG_DEFAULTDIR_DEFAULT,
+    .m_sync_state        = false,
+    .m_io_queue_depth    = 0,
+    .m_threads           = 1,
+    .m_state_log         = nullptr,
+    .m_log               = nullptr,
+    .m_memory_state      = false,
+    .m_memory            = nullptr,
+    .m_layers            = nullptr,
+    .m_layer_count       = 0,
+    .m_sharded_layout    = false,
+    .m_existence_filters = false,
+    .m_filters           = nullptr,
+    .m_state_filter      = nullptr,
+    .m_default_filter    = nullptr,
+    .m_next              = nullptr
+};
+static const char * const        sOffStateString          = "off";
+static const char * const        sOnStateString           = "on";
+static const char * const        sOriginStrings[]         =
+{
+    [CHKCONFIG_ORIGIN_UNKNOWN] = "unknown",
+    [CHKCONFIG_ORIGIN_NONE]    = "none",
+    [CHKCONFIG_ORIGIN_DEFAULT] = "default",
+    [CHKCONFIG_ORIGIN_STATE]   = "state"
+};
 
 // MARK: Utility
 
@@ -484,14 +1078,15 @@ static chkconfig_status_t chkconfigFlagStateTuplesInit(chkconfig_flag_state_tupl
 static chkconfig_status_t chkconfigFlagStateTuplesDestroy(chkconfig_flag_state_tuple_t *&inFlagStateTuples,
                                                           const size_t &inFlagStateTupleCount)
 {
-    chkconfig_flag_state_tuple_t * const lFirst   = &inFlagStateTuples[0];
-    chkconfig_flag_state_tuple_t * const lLast    = (lFirst + inFlagStateTupleCount);
-    chkconfig_flag_state_tuple_t *       lCurrent = lFirst;
+    chkconfig_flag_state_tuple_t *       lCurrent = inFlagStateTuples;
+    chkconfig_flag_state_tuple_t *       lLast;
     chkconfig_status_t                   lRetval  = CHKCONFIG_STATUS_SUCCESS;
 
     nlREQUIRE_ACTION(inFlagStateTuples != nullptr, done, lRetval = -EINVAL);
     nlREQUIRE_ACTION(inFlagStateTupleCount > 0,    done, lRetval = -EINVAL);
 
+    lLast = (lCurrent + inFlagStateTupleCount);
+
     while (lCurrent != lLast)
     {
         if (lCurrent->m_flag != nullptr)
@@ -540,993 +1135,9499 @@ static int chkconfigFlagStateTupleStateSortFunction(const chkconfig_flag_state_t
     return (lRetval);
 }
 
-static size_t chkconfigFlagStateTupleCountUnion(const chkconfig_flag_state_tuple_t * inLeftFirst,
-                                                const chkconfig_flag_state_tuple_t * inLeftLast,
-                                                const chkconfig_flag_state_tuple_t * inRightFirst,
-                                                const chkconfig_flag_state_tuple_t * inRightLast)
+/**
+ *  @brief
+ *    Determine whether a flag begins with the prefix of a criterion.
+ *
+ *  @param[in]  inMatch  A pointer to the criterion to match or null,
+ *                       which every flag matches.
+ *  @param[in]  inFlag   A pointer to the null-terminated flag to
+ *                       match.
+ *
+ *  @returns
+ *    True if the flag matches; otherwise, false.
+ *
+ *  @private
+ *
+ */
+static inline bool chkconfigFlagMatchesPrefix(const chkconfig_flag_match_t *inMatch,
+                                              const char *inFlag)
 {
-    const FlagStateTupleInputIterator          lLeftFirst(inLeftFirst);
-    const FlagStateTupleInputIterator          lLeftLast(inLeftLast);
-    const FlagStateTupleInputIterator          lRightFirst(inRightFirst);
-    const FlagStateTupleInputIterator          lRightLast(inRightLast);
-    FlagStateTupleOutputNullAssignmentIterator lUnionFirst;
-    FlagStateTupleOutputNullAssignmentIterator lUnionLast;
+    return ((inMatch == nullptr) ||
+            (strncmp(inFlag, inMatch->m_prefix, inMatch->m_prefix_length) == 0));
+}
 
-    lUnionLast = std::set_union(lLeftFirst,  lLeftLast,
-                                lRightFirst, lRightLast,
-                                lUnionFirst);
+/**
+ *  @brief
+ *    Determine whether a flag passes the filter, if any, of a
+ *    criterion.
+ *
+ *  @param[in]  inMatch  A pointer to the criterion to match or null,
+ *                       which every flag matches.
+ *  @param[in]  inFlag   A pointer to the null-terminated flag to
+ *                       match.
+ *
+ *  @returns
+ *    True if the flag matches; otherwise, false.
+ *
+ *  @private
+ *
+ */
+static inline bool chkconfigFlagMatchesFilter(const chkconfig_flag_match_t *inMatch,
+                                              const char *inFlag)
+{
+    return ((inMatch == nullptr) ||
+            (inMatch->m_filter == nullptr) ||
+            inMatch->m_filter(inFlag, inMatch->m_filter_context));
+}
 
-    return (lUnionLast - lUnionFirst);
+/**
+ *  @brief
+ *    Determine whether a flag matches a criterion.
+ *
+ *  @param[in]  inMatch  A pointer to the criterion to match or null,
+ *                       which every flag matches.
+ *  @param[in]  inFlag   A pointer to the null-terminated flag to
+ *                       match.
+ *
+ *  @returns
+ *    True if the flag matches; otherwise, false.
+ *
+ *  @private
+ *
+ */
+static inline bool chkconfigFlagMatches(const chkconfig_flag_match_t *inMatch,
+                                        const char *inFlag)
+{
+    return (chkconfigFlagMatchesPrefix(inMatch, inFlag) &&
+            chkconfigFlagMatchesFilter(inMatch, inFlag));
 }
 
-static void chkconfigFlagStateTupleCopyUnion(const chkconfig_flag_state_tuple_t * inLeftFirst,
-                                             const chkconfig_flag_state_tuple_t * inLeftLast,
-                                             const chkconfig_flag_state_tuple_t * inRightFirst,
-                                             const chkconfig_flag_state_tuple_t * inRightLast,
-                                             chkconfig_flag_state_tuple_t * inUnionFirst)
+// MARK: Flag/State Tables
+
+static constexpr size_t kChkconfigStatesPerWord  = 64;
+static constexpr size_t kChkconfigOriginsPerByte = 4;
+static constexpr size_t kChkconfigKeySize        = sizeof (uint64_t);
+
+static uint64_t chkconfigFlagKey(const char *inFlag)
 {
-    const FlagStateTupleInputIterator      lLeftFirst(inLeftFirst);
-    const FlagStateTupleInputIterator      lLeftLast(inLeftLast);
-    const FlagStateTupleInputIterator      lRightFirst(inRightFirst);
-    const FlagStateTupleInputIterator      lRightLast(inRightLast);
-    FlagStateTupleOutputAssignmentIterator lUnionFirst(inUnionFirst);
+    uint64_t lRetval = 0;
+
+    // Pack the leading bytes big-endian and zero-padded, such that
+    // unsigned integer order matches strcmp(3) order on those bytes.
+
+    for (size_t lIndex = 0; (lIndex < kChkconfigKeySize) && (inFlag[lIndex] != '\0'); lIndex++)
+    {
+        lRetval |= (static_cast<uint64_t>(static_cast<uint8_t>(inFlag[lIndex])) <<
+                    ((kChkconfigKeySize - 1 - lIndex) * 8));
+    }
 
-    std::set_union(lLeftFirst,  lLeftLast,
-                   lRightFirst, lRightLast,
-                   lUnionFirst);
+    return (lRetval);
 }
 
-static chkconfig_status_t chkconfigFlagStateTupleCopyUnion(chkconfig_flag_state_tuple_t *&inLeftFlagStateTuples,
-                                                           const size_t &inLeftCount,
-                                                           chkconfig_flag_state_tuple_t *&inRightFlagStateTuples,
-                                                           const size_t &inRightCount,
-                                                           chkconfig_flag_state_tuple_t *&outUnionFlagStateTuples,
-                                                           size_t &outUnionCount)
+static int chkconfigFlagCompare(const uint64_t &inFirstKey,
+                                const char *inFirstFlag,
+                                const uint64_t &inSecondKey,
+                                const char *inSecondFlag)
 {
-    const chkconfig_flag_state_tuple_t * lLeftFirst            = &inLeftFlagStateTuples[0];
-    const chkconfig_flag_state_tuple_t * lLeftLast             = (lLeftFirst + inLeftCount);
-    const chkconfig_flag_state_tuple_t * lRightFirst           = &inRightFlagStateTuples[0];
-    const chkconfig_flag_state_tuple_t * lRightLast            = (lRightFirst + inRightCount);
-    size_t                               lUnionCount           = 0;
-    chkconfig_flag_state_tuple_t *       lUnionFlagStateTuples = nullptr;
-    chkconfig_status_t                   lRetval               = CHKCONFIG_STATUS_SUCCESS;
+    int lRetval;
+
+    if (inFirstKey != inSecondKey)
+    {
+        lRetval = ((inFirstKey < inSecondKey) ? -1 : 1);
+    }
+    else if ((inFirstKey & 0xFF) == 0)
+    {
+        // The keys are equal and the terminator falls within them,
+        // so the flags are equal, too.
+
+        lRetval = 0;
+    }
+    else
+    {
+        lRetval = strcmp(inFirstFlag + kChkconfigKeySize,
+                         inSecondFlag + kChkconfigKeySize);
+    }
 
-    // Sort the "left" flag/state tuples by flag.
+    return (lRetval);
+}
 
-    qsort(&inLeftFlagStateTuples[0],
-          inLeftCount,
-          sizeof(chkconfig_flag_state_tuple_t),
-          chkconfig_flag_state_tuple_flag_compare_function);
+/**
+ *  @brief
+ *    An entry for sorting flags by their names.
+ *
+ *  @private
+ *
+ */
+struct chkconfigFlagSortEntry
+{
+    uint64_t     m_key;   //!< The eight flag bytes at the current
+                          //!< sort depth, big-endian and zero-padded.
+    const char * m_flag;  //!< A pointer to the null-terminated flag.
+    size_t       m_index; //!< The index of the flag in its source.
+};
 
-    // Sort the "right" flag/state tuples by flag.
+static void chkconfigFlagInsertionSort(chkconfigFlagSortEntry *inEntries,
+                                       const size_t &inCount,
+                                       const size_t &inDepth)
+{
+    for (size_t lIndex = 1; lIndex < inCount; lIndex++)
+    {
+        const chkconfigFlagSortEntry lEntry = inEntries[lIndex];
+        size_t                       lHole  = lIndex;
+
+        while ((lHole > 0) &&
+               (chkconfigFlagCompare(lEntry.m_key,
+                                     lEntry.m_flag + inDepth,
+                                     inEntries[lHole - 1].m_key,
+                                     inEntries[lHole - 1].m_flag + inDepth) < 0))
+        {
+            inEntries[lHole] = inEntries[lHole - 1];
+            lHole--;
+        }
 
-    qsort(&inRightFlagStateTuples[0],
-          inRightCount,
-          sizeof(chkconfig_flag_state_tuple_t),
-          chkconfig_flag_state_tuple_flag_compare_function);
+        inEntries[lHole] = lEntry;
+    }
+}
 
-    // Run the union to get the count, which might very well be zero.
+/**
+ *  @brief
+ *    A range of flag sort entries awaiting a radix sort pass.
+ *
+ *  @private
+ *
+ */
+struct chkconfigFlagSortBucket
+{
+    size_t m_first; //!< The index of the first entry in the range.
+    size_t m_count; //!< The number of entries in the range.
+    size_t m_depth; //!< The flag byte offset at which the entry keys
+                    //!< were loaded.
+    size_t m_byte;  //!< The key byte on which to distribute.
+};
 
-    lUnionCount = chkconfigFlagStateTupleCountUnion(lLeftFirst,
-                                                    lLeftLast,
-                                                    lRightFirst,
-                                                    lRightLast);
+/**
+ *  @brief
+ *    Sort flag sort entries by flag using a most-significant-digit
+ *    radix sort.
+ *
+ *  Each pass distributes the entries of a bucket by one byte of
+ *  their cached keys into 256 buckets, each of which is then sorted
+ *  on the next byte. Once all eight key bytes are exhausted for a
+ *  bucket, its keys are reloaded from the next eight flag bytes. A
+ *  zero byte means the flags in that bucket have ended and are,
+ *  thus, equal and need no further sorting. Small buckets are
+ *  finished with an insertion sort.
+ *
+ *  Flags may share arbitrarily long prefixes, each byte of which
+ *  costs a pass. Rather than recursing once per pass, the buckets
+ *  yet to be sorted are kept on a caller-allocated work stack, such
+ *  that the sort uses the same, small amount of call stack on any
+ *  thread. Those buckets are disjoint and each holds at least two
+ *  entries, so there are never more than half as many of them as
+ *  there are entries.
+ *
+ *  @param[in,out]  inEntries  A pointer to the entries to sort.
+ *  @param[in]      inScratch  A pointer to scratch storage for at
+ *                             least @a inCount entries.
+ *  @param[in]      inBuckets  A pointer to work stack storage for
+ *                             at least half of @a inCount buckets.
+ *  @param[in]      inCount    The number of entries to sort, at
+ *                             least two.
+ *  @param[in]      inDepth    The flag byte offset at which the
+ *                             entry keys were loaded.
+ *
+ *  @private
+ *
+ */
+static void chkconfigFlagRadixSort(chkconfigFlagSortEntry *inEntries,
+                                   chkconfigFlagSortEntry *inScratch,
+                                   chkconfigFlagSortBucket *inBuckets,
+                                   const size_t &inCount,
+                                   const size_t &inDepth)
+{
+    static constexpr size_t kBuckets                = 256;
+    static constexpr size_t kInsertionSortThreshold = 32;
+    size_t                  lCounts[kBuckets];
+    size_t                  lOffsets[kBuckets];
+    size_t                  lPending                = 0;
 
-    // If the union count was non-zero, allocate a new flag/state
-    // tuple array for the union result and populate the union.
+    inBuckets[lPending++] = { 0, inCount, inDepth, 0 };
 
-    if (lUnionCount > 0)
+    while (lPending > 0)
     {
-        // Allocate a new flag/state tuple array for the union result.
+        const chkconfigFlagSortBucket lBucket  = inBuckets[--lPending];
+        chkconfigFlagSortEntry *      lEntries = &inEntries[lBucket.m_first];
+        const unsigned                lShift   = static_cast<unsigned>((kChkconfigKeySize - 1 - lBucket.m_byte) * 8);
+        size_t                        lOffset  = 0;
+        size_t                        lFirstBucket;
 
-        lRetval = chkconfigFlagStateTuplesInit(lUnionFlagStateTuples, lUnionCount);
-        nlREQUIRE_SUCCESS(lRetval, done);
+        if (lBucket.m_count < kInsertionSortThreshold)
+        {
+            chkconfigFlagInsertionSort(lEntries, lBucket.m_count, lBucket.m_depth);
+            continue;
+        }
 
-        // Run the union again to populate the union result.
+        memset(lCounts, 0, sizeof (lCounts));
 
-        chkconfigFlagStateTupleCopyUnion(lLeftFirst,
-                                         lLeftLast,
-                                         lRightFirst,
-                                         lRightLast,
-                                         &lUnionFlagStateTuples[0]);
-    }
+        for (size_t lIndex = 0; lIndex < lBucket.m_count; lIndex++)
+        {
+            lCounts[(lEntries[lIndex].m_key >> lShift) & 0xFF]++;
+        }
 
-    outUnionFlagStateTuples = lUnionFlagStateTuples;
-    outUnionCount           = lUnionCount;
+        // Only distribute if the entries span more than one bucket;
+        // otherwise, they are already in place for this byte.
 
- done:
-    return (lRetval);
-}
+        lFirstBucket = ((lEntries[0].m_key >> lShift) & 0xFF);
 
-// MARK: Lifetime Management
+        if (lCounts[lFirstBucket] != lBucket.m_count)
+        {
+            for (size_t lIndex = 0; lIndex < kBuckets; lIndex++)
+            {
+                lOffsets[lIndex]  = lOffset;
+                lOffset          += lCounts[lIndex];
+            }
+
+            for (size_t lIndex = 0; lIndex < lBucket.m_count; lIndex++)
+            {
+                inScratch[lOffsets[(lEntries[lIndex].m_key >> lShift) & 0xFF]++] = lEntries[lIndex];
+            }
+
+            memcpy(lEntries, inScratch, lBucket.m_count * sizeof (chkconfigFlagSortEntry));
+        }
 
-static chkconfig_status_t chkconfigInit(chkconfig_context_pointer_t &outContextPointer)
-{
-    chkconfig_context_pointer_t lContextPointer;
-    chkconfig_status_t          lRetval = CHKCONFIG_STATUS_SUCCESS;
+        // Sort every bucket with more than one entry on the next
+        // byte, except for bucket zero, whose flags have all ended
+        // and are equal.
 
-    lContextPointer = new chkconfig_context_t;
-    nlREQUIRE_ACTION(lContextPointer != nullptr, done, lRetval = -ENOMEM);
+        lOffset = (lBucket.m_first + lCounts[0]);
 
-    lContextPointer->m_options = &sChkconfigOptionsDefault;
+        for (size_t lIndex = 1; lIndex < kBuckets; lIndex++)
+        {
+            const size_t lCount = lCounts[lIndex];
+
+            if (lCount > 1)
+            {
+                if ((lBucket.m_byte + 1) < kChkconfigKeySize)
+                {
+                    inBuckets[lPending++] = { lOffset, lCount, lBucket.m_depth, lBucket.m_byte + 1 };
+                }
+                else
+                {
+                    const size_t lDepth = (lBucket.m_depth + kChkconfigKeySize);
+
+                    for (size_t lEntry = lOffset; lEntry < (lOffset + lCount); lEntry++)
+                    {
+                        inEntries[lEntry].m_key = chkconfigFlagKey(inEntries[lEntry].m_flag + lDepth);
+                    }
 
-    outContextPointer = lContextPointer;
+                    inBuckets[lPending++] = { lOffset, lCount, lDepth, 0 };
+                }
+            }
 
- done:
-    return (lRetval);
+            lOffset += lCount;
+        }
+    }
 }
 
-static chkconfig_status_t chkconfigOptionsInit(chkconfig_context_t &inContext,
-                                               chkconfig_options_pointer_t &outOptionsPointer)
+/**
+ *  @brief
+ *    Sort flag sort entries by flag.
+ *
+ *  @param[in,out]  inEntries  A pointer to the entries to sort, whose
+ *                             flag and index members are set.
+ *  @param[in]      inCount    The number of entries to sort.
+ *  @param[in]      inDepth    The number of leading bytes known to
+ *                             be common to all of the flags and,
+ *                             consequently, that may be skipped.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the sort.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagSort(chkconfigFlagSortEntry *inEntries,
+                                            const size_t &inCount,
+                                            const size_t &inDepth)
 {
-    chkconfig_options_pointer_t lOptionsPointer;
-    chkconfig_status_t          lRetval = CHKCONFIG_STATUS_SUCCESS;
-
-    lOptionsPointer = new chkconfig_options_t;
-    nlREQUIRE_ACTION(lOptionsPointer != nullptr, done, lRetval = -ENOMEM);
+    chkconfigFlagSortEntry *  lScratch = nullptr;
+    chkconfigFlagSortBucket * lBuckets = nullptr;
+    chkconfig_status_t        lRetval  = CHKCONFIG_STATUS_SUCCESS;
 
-    // Start by initializing the newly-allocations options to the defaults.
-
-    lOptionsPointer->m_state_dir       = strdup(sChkconfigOptionsDefault.m_state_dir);
-    nlREQUIRE_ACTION(lOptionsPointer->m_state_dir != nullptr, done, lRetval = -ENOMEM);
+    if (inCount <= 1)
+    {
+        goto done;
+    }
 
-    lOptionsPointer->m_force_state     = sChkconfigOptionsDefault.m_force_state;
-    lOptionsPointer->m_use_default_dir = sChkconfigOptionsDefault.m_use_default_dir;
-    lOptionsPointer->m_default_dir     = strdup(sChkconfigOptionsDefault.m_default_dir);
-    nlREQUIRE_ACTION(lOptionsPointer->m_default_dir != nullptr, done, lRetval = -ENOMEM);
+    lScratch = static_cast<chkconfigFlagSortEntry *>(malloc(inCount * sizeof (chkconfigFlagSortEntry)));
+    nlREQUIRE_ACTION(lScratch != nullptr, done, lRetval = -ENOMEM);
 
+    lBuckets = static_cast<chkconfigFlagSortBucket *>(malloc((inCount / 2) * sizeof (chkconfigFlagSortBucket)));
+    nlREQUIRE_ACTION(lBuckets != nullptr, done, lRetval = -ENOMEM);
 
-    inContext.m_options = lOptionsPointer;
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        inEntries[lIndex].m_key = chkconfigFlagKey(inEntries[lIndex].m_flag + inDepth);
+    }
 
-    outOptionsPointer = lOptionsPointer;
+    chkconfigFlagRadixSort(inEntries, lScratch, lBuckets, inCount, inDepth);
 
  done:
+    free(lScratch);
+    free(lBuckets);
+
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigOptionsDestroy(chkconfig_context_t &inContext,
-                                                  chkconfig_options_pointer_t &inOptionsPointer)
+/**
+ *  @brief
+ *    Sort a flag/state tuple array in the specified order.
+ *
+ *  @param[in,out]  inFlagStateTuples      A pointer to the tuples
+ *                                         to sort.
+ *  @param[in]      inFlagStateTupleCount  The number of tuples in
+ *                                         @a inFlagStateTuples.
+ *  @param[in]      inOrder                The order in which to
+ *                                         sort the tuples.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inFlagStateTuples or any
+ *                                     of its flags was null or if
+ *                                     @a inOrder was invalid.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the sort.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagStateTuplesSort(chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                       const size_t &inFlagStateTupleCount,
+                                                       const chkconfig_sort_order_t &inOrder)
 {
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
-
-    nlREQUIRE_ACTION(inOptionsPointer != nullptr, done, lRetval = -EINVAL);
-
-    // If the current context has options that match those being
-    // destroyed, then reset the current context to the default
-    // options.
+    chkconfigFlagSortEntry *       lEntries     = nullptr;
+    chkconfig_flag_state_tuple_t * lSorted      = nullptr;
+    size_t                         lOnCount     = 0;
+    size_t                         lOnIndex     = 0;
+    size_t                         lOffIndex;
+    chkconfig_status_t             lRetval      = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION((inOrder == CHKCONFIG_SORT_ORDER_FLAG) ||
+                     (inOrder == CHKCONFIG_SORT_ORDER_STATE),
+                     done,
+                     lRetval = -EINVAL);
 
-    if (inContext.m_options == inOptionsPointer)
+    if (inFlagStateTupleCount <= 1)
     {
-        inContext.m_options = &sChkconfigOptionsDefault;
+        goto done;
     }
 
-    // Destroy any leaf data.
+    nlREQUIRE_ACTION(inFlagStateTuples != nullptr, done, lRetval = -EINVAL);
 
-    if (inOptionsPointer->m_state_dir != nullptr)
+    lEntries = static_cast<chkconfigFlagSortEntry *>(malloc(inFlagStateTupleCount * sizeof (chkconfigFlagSortEntry)));
+    nlREQUIRE_ACTION(lEntries != nullptr, done, lRetval = -ENOMEM);
+
+    lSorted = static_cast<chkconfig_flag_state_tuple_t *>(malloc(inFlagStateTupleCount * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lSorted != nullptr, done, lRetval = -ENOMEM);
+
+    // When sorting by state, first partition the entries such that
+    // on / true sorts before off / false, matching
+    // chkconfigFlagStateTupleStateSortFunction, and then sort each
+    // partition by flag.
+
+    if (inOrder == CHKCONFIG_SORT_ORDER_STATE)
     {
-        free(const_cast<char *>(inOptionsPointer->m_state_dir));
-        inOptionsPointer->m_state_dir = nullptr;
+        for (size_t lIndex = 0; lIndex < inFlagStateTupleCount; lIndex++)
+        {
+            lOnCount += (inFlagStateTuples[lIndex].m_state ? 1 : 0);
+        }
     }
 
-    if (inOptionsPointer->m_default_dir != nullptr)
+    lOffIndex = lOnCount;
+
+    for (size_t lIndex = 0; lIndex < inFlagStateTupleCount; lIndex++)
     {
-        free(const_cast<char *>(inOptionsPointer->m_default_dir));
-        inOptionsPointer->m_default_dir = nullptr;
+        const bool lOn = ((inOrder == CHKCONFIG_SORT_ORDER_STATE) && inFlagStateTuples[lIndex].m_state);
+        size_t &   lEntryIndex = (lOn ? lOnIndex : lOffIndex);
+
+        nlREQUIRE_ACTION(inFlagStateTuples[lIndex].m_flag != nullptr, done, lRetval = -EINVAL);
+
+        lEntries[lEntryIndex].m_flag  = inFlagStateTuples[lIndex].m_flag;
+        lEntries[lEntryIndex].m_index = lIndex;
+
+        lEntryIndex++;
     }
 
-    // Destroy the options data itself.
+    lRetval = chkconfigFlagSort(&lEntries[0], lOnCount, 0);
+    nlREQUIRE_SUCCESS(lRetval, done);
 
-    delete inOptionsPointer;
+    lRetval = chkconfigFlagSort(&lEntries[lOnCount], inFlagStateTupleCount - lOnCount, 0);
+    nlREQUIRE_SUCCESS(lRetval, done);
 
-    inOptionsPointer = nullptr;
+    // Permute the tuples into the sorted order.
+
+    for (size_t lIndex = 0; lIndex < inFlagStateTupleCount; lIndex++)
+    {
+        lSorted[lIndex] = inFlagStateTuples[lEntries[lIndex].m_index];
+    }
+
+    memcpy(inFlagStateTuples, lSorted, inFlagStateTupleCount * sizeof (chkconfig_flag_state_tuple_t));
 
  done:
+    free(lEntries);
+    free(lSorted);
+
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigDestroy(chkconfig_context_pointer_t &inContextPointer)
+static inline const char *chkconfigFlagStateTableGetFlag(const chkconfig_flag_state_table_t &inTable,
+                                                         const size_t &inIndex)
 {
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    return (&inTable.m_pool[inTable.m_offsets[inIndex]]);
+}
 
-    nlREQUIRE_ACTION(inContextPointer != nullptr, done, lRetval = -EINVAL);
+static inline chkconfig_state_t chkconfigFlagStateTableGetState(const chkconfig_flag_state_table_t &inTable,
+                                                                const size_t &inIndex)
+{
+    const uint64_t lWord = inTable.m_states[inIndex / kChkconfigStatesPerWord];
 
-    delete inContextPointer;
+    return (((lWord >> (inIndex % kChkconfigStatesPerWord)) & 1) != 0);
+}
 
-    inContextPointer = nullptr;
+static inline chkconfig_origin_t chkconfigFlagStateTableGetOrigin(const chkconfig_flag_state_table_t &inTable,
+                                                                  const size_t &inIndex)
+{
+    const uint8_t lByte = inTable.m_origins[inIndex / kChkconfigOriginsPerByte];
 
- done:
-    return (lRetval);
+    return (static_cast<chkconfig_origin_t>((lByte >> ((inIndex % kChkconfigOriginsPerByte) * 2)) & 0x3));
 }
 
-// MARK: Option Management
-
-static chkconfig_status_t chkconfigOptionsSet(chkconfig_context_t &inContext,
-                                              chkconfig_options_t &inOptions,
-                                              const chkconfig_option_t &inOption,
-                                              va_list inArguments)
+static inline void chkconfigFlagStateTableSetState(chkconfig_flag_state_table_t &inTable,
+                                                   const size_t &inIndex,
+                                                   const chkconfig_state_t &inState)
 {
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    uint64_t &     lWord = inTable.m_states[inIndex / kChkconfigStatesPerWord];
+    const uint64_t lMask = (static_cast<uint64_t>(1) << (inIndex % kChkconfigStatesPerWord));
 
-    (void)inContext;
+    lWord = (inState ? (lWord | lMask) : (lWord & ~lMask));
+}
 
-    switch (inOption)
-    {
+static inline void chkconfigFlagStateTableSetOrigin(chkconfig_flag_state_table_t &inTable,
+                                                    const size_t &inIndex,
+                                                    const chkconfig_origin_t &inOrigin)
+{
+    uint8_t &      lByte  = inTable.m_origins[inIndex / kChkconfigOriginsPerByte];
+    const unsigned lShift = static_cast<unsigned>((inIndex % kChkconfigOriginsPerByte) * 2);
 
-    case CHKCONFIG_OPTION_STATE_DIRECTORY:
-        if (inOptions.m_state_dir != nullptr)
-        {
-            free(const_cast<char *>(inOptions.m_state_dir));
-        }
+    lByte = static_cast<uint8_t>((lByte & ~(0x3U << lShift)) |
+                                 ((static_cast<unsigned>(inOrigin) & 0x3U) << lShift));
+}
 
-        inOptions.m_state_dir = strdup(va_arg(inArguments, const char *));
-        nlREQUIRE_ACTION(inOptions.m_state_dir != nullptr, done, lRetval = -ENOMEM);
-        break;
+static inline int chkconfigFlagStateTableCompare(const chkconfig_flag_state_table_t &inFirstTable,
+                                                 const size_t &inFirstIndex,
+                                                 const chkconfig_flag_state_table_t &inSecondTable,
+                                                 const size_t &inSecondIndex)
+{
+    return (chkconfigFlagCompare(inFirstTable.m_keys[inFirstIndex],
+                                 chkconfigFlagStateTableGetFlag(inFirstTable, inFirstIndex),
+                                 inSecondTable.m_keys[inSecondIndex],
+                                 chkconfigFlagStateTableGetFlag(inSecondTable, inSecondIndex)));
+}
 
-    case CHKCONFIG_OPTION_FORCE_STATE:
-        inOptions.m_force_state = va_arg(inArguments, int);
-        break;
+static void chkconfigFlagStateTableInit(chkconfig_flag_state_table_t &outTable)
+{
+    memset(&outTable, 0, sizeof (chkconfig_flag_state_table_t));
+}
 
-    case CHKCONFIG_OPTION_DEFAULT_DIRECTORY:
-        if (inOptions.m_default_dir != nullptr)
-        {
-            free(const_cast<char *>(inOptions.m_default_dir));
-        }
+static void chkconfigFlagStateTableDestroy(chkconfig_flag_state_table_t &inTable)
+{
+    free(inTable.m_pool);
+    free(inTable.m_offsets);
+    free(inTable.m_keys);
+    free(inTable.m_states);
+    free(inTable.m_origins);
 
-        inOptions.m_default_dir = strdup(va_arg(inArguments, const char *));
-        nlREQUIRE_ACTION(inOptions.m_default_dir != nullptr, done, lRetval = -ENOMEM);
-        break;
+    chkconfigFlagStateTableInit(inTable);
+}
 
-    case CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY:
-        inOptions.m_use_default_dir = va_arg(inArguments, int);
-        break;
+static chkconfig_status_t chkconfigReallocate(void *&inPointer, const size_t &inSize)
+{
+    void *             lResized;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
 
-    default:
-        lRetval = -EINVAL;
-        break;
+    lResized = realloc(inPointer, inSize);
+    nlREQUIRE_ACTION(lResized != nullptr, done, lRetval = -ENOMEM);
 
-    }
+    inPointer = lResized;
 
  done:
     return (lRetval);
 }
 
-// MARK: Observers
+template <typename T>
+static chkconfig_status_t chkconfigReallocate(T *&inPointer, const size_t &inCount)
+{
+    void *             lPointer = inPointer;
+    chkconfig_status_t lRetval;
 
-static chkconfig_status_t chkconfigStateGet(const chkconfig_origin_t &inOrigin,
-                                            const bool &inNonexistentIsAnError,
-                                            const char *inFlagPath,
-                                            chkconfig_state_t &outState,
-                                            chkconfig_origin_t &outOrigin)
+    lRetval = chkconfigReallocate(lPointer, inCount * sizeof (T));
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    inPointer = static_cast<T *>(lPointer);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigFlagStateTableReserve(chkconfig_flag_state_table_t &inTable,
+                                                         const size_t &inCapacity,
+                                                         const size_t &inPoolSize)
 {
-    int                lStatus;
-    int                lDescriptor = -1;
-    struct stat        lMetadata;
-    void *             lData   = MAP_FAILED;
-    chkconfig_state_t  lState  = false;
     chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(inFlagPath != nullptr, done, lRetval = -EINVAL);
+    if (inCapacity > inTable.m_capacity)
+    {
+        const size_t lStateWords  = ((inCapacity + kChkconfigStatesPerWord - 1) / kChkconfigStatesPerWord);
+        const size_t lOriginBytes = ((inCapacity + kChkconfigOriginsPerByte - 1) / kChkconfigOriginsPerByte);
 
-    // The path may very well not exist, so use the EXPECT rather than
-    // REQUIRE assertion form.
+        lRetval = chkconfigReallocate(inTable.m_offsets, inCapacity);
+        nlREQUIRE_SUCCESS(lRetval, done);
 
-    lDescriptor = open(inFlagPath, O_RDONLY);
-    nlEXPECT_ACTION(lDescriptor != -1,
-                    done,
-                    switch (errno)
-                    {
-
-                    case ENOENT:
-                        outState = false;
-                        outOrigin = CHKCONFIG_ORIGIN_NONE;
+        lRetval = chkconfigReallocate(inTable.m_keys, inCapacity);
+        nlREQUIRE_SUCCESS(lRetval, done);
 
-                        // If called with inNonexistentIsAnError
-                        // asserted, then the caller does NOT want the
-                        // return value "hidden" by success such that
-                        // they can fallback to the default directory
-                        // on failure.
+        lRetval = chkconfigReallocate(inTable.m_states, lStateWords);
+        nlREQUIRE_SUCCESS(lRetval, done);
 
-                        if (inNonexistentIsAnError)
-                        {
-                            lRetval = -errno;
-                        }
-                        break;
+        lRetval = chkconfigReallocate(inTable.m_origins, lOriginBytes);
+        nlREQUIRE_SUCCESS(lRetval, done);
 
-                    default:
-                        lRetval = -errno;
-                        break;
+        inTable.m_capacity = inCapacity;
+    }
 
-                    });
+    if (inPoolSize > inTable.m_pool_size)
+    {
+        lRetval = chkconfigReallocate(inTable.m_pool, inPoolSize);
+        nlREQUIRE_SUCCESS(lRetval, done);
 
-    // At this point, the file exists and is open. Determine its size
-    // for memory-mapping.
+        inTable.m_pool_size = inPoolSize;
+    }
 
-    lStatus = fstat(lDescriptor, &lMetadata);
-    nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+ done:
+    return (lRetval);
+}
 
-    // If the size of the file is non-zero, memory-map the file and
-    // attempt to determine its state value.
-    //
-    // Otherwise, there is no data to map and we must assume the
-    // default state of off or false.
+static chkconfig_status_t chkconfigFlagStateTableAppend(chkconfig_flag_state_table_t &inTable,
+                                                        const char *inFlag,
+                                                        const size_t &inLength,
+                                                        const uint64_t &inKey,
+                                                        const chkconfig_state_t &inState,
+                                                        const chkconfig_origin_t &inOrigin)
+{
+    static constexpr size_t kInitialCapacity = 64;
+    static constexpr size_t kInitialPoolSize = 4096;
+    const size_t            lSize            = (inLength + 1);
+    size_t                  lCapacity        = inTable.m_capacity;
+    size_t                  lPoolSize        = inTable.m_pool_size;
+    chkconfig_status_t      lRetval          = CHKCONFIG_STATUS_SUCCESS;
 
-    if (lMetadata.st_size > 0)
-    {
-        lData = mmap(nullptr, static_cast<size_t>(lMetadata.st_size), PROT_READ, MAP_PRIVATE, lDescriptor, 0);
-        nlREQUIRE_ACTION(lData != MAP_FAILED, done, lRetval = -errno);
+    // Offsets are 32-bit, which bounds the string pool at 4 GiB.
 
-        lRetval = chkconfigStateStringGetState(reinterpret_cast<const char *>(lData), lState);
-        nlREQUIRE_SUCCESS_ACTION(lRetval, done, outState = false);
-    }
-    else
-    {
-        lState = false;
-    }
+    nlREQUIRE_ACTION(inTable.m_pool_used <= UINT32_MAX, done, lRetval = -EOVERFLOW);
 
-    outState  = lState;
-    outOrigin = inOrigin;
+    // Grow the per-flag arrays and string pool geometrically, as
+    // needed.
 
- done:
-    if (lData != MAP_FAILED)
+    if (inTable.m_count == lCapacity)
     {
-        lStatus = munmap(lData, static_cast<size_t>(lMetadata.st_size));
-        nlREQUIRE_ACTION(lStatus == 0, close, lRetval = -errno);
+        lCapacity = ((lCapacity == 0) ? kInitialCapacity : (lCapacity * 2));
     }
 
- close:
-    if (lDescriptor != -1)
+    if ((inTable.m_pool_used + lSize) > lPoolSize)
     {
-        lStatus = close(lDescriptor);
-        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+        lPoolSize = ((lPoolSize == 0) ? kInitialPoolSize : lPoolSize);
+
+        while ((inTable.m_pool_used + lSize) > lPoolSize)
+        {
+            lPoolSize *= 2;
+        }
     }
 
-    return (lRetval);
-}
+    lRetval = chkconfigFlagStateTableReserve(inTable, lCapacity, lPoolSize);
+    nlREQUIRE_SUCCESS(lRetval, done);
 
-static chkconfig_status_t chkconfigFlagPathCopy(const char *inDirectory,
-                                                const chkconfig_flag_t &inFlag,
-                                                const size_t &inPathSize,
-                                                char *outPath)
-{
-    int                lStatus;
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    memcpy(&inTable.m_pool[inTable.m_pool_used], inFlag, inLength);
+    inTable.m_pool[inTable.m_pool_used + inLength] = '\0';
 
-    nlREQUIRE_ACTION(inDirectory != nullptr, done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(inFlag      != nullptr, done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(inFlag[0]   != '\0',    done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(inPathSize > 0,         done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(outPath     != nullptr, done, lRetval = -EINVAL);
+    inTable.m_offsets[inTable.m_count] = static_cast<uint32_t>(inTable.m_pool_used);
+    inTable.m_keys[inTable.m_count]    = inKey;
 
-    lStatus = snprintf(&outPath[0],
-                       inPathSize,
-                       "%s/%s",
-                       inDirectory,
-                       inFlag);
-    nlREQUIRE_ACTION(lStatus > 0,
-                     done,
-                     lRetval = -EOVERFLOW);
-    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < inPathSize,
-                     done,
-                     lRetval = -EOVERFLOW);
+    chkconfigFlagStateTableSetState(inTable, inTable.m_count, inState);
+    chkconfigFlagStateTableSetOrigin(inTable, inTable.m_count, inOrigin);
+
+    inTable.m_pool_used += lSize;
+    inTable.m_count++;
 
  done:
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigDefaultPathCopy(const chkconfig_context_t &inContext,
-                                                  const chkconfig_flag_t &inFlag,
-                                                  const size_t &inPathSize,
-                                                  char *outPath)
+static chkconfig_status_t chkconfigFlagStateTableAppend(chkconfig_flag_state_table_t &inTable,
+                                                        const char *inFlag,
+                                                        const chkconfig_state_t &inState,
+                                                        const chkconfig_origin_t &inOrigin)
 {
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    const size_t       lLength = strlen(inFlag);
+    chkconfig_status_t lRetval;
 
-    lRetval = chkconfigFlagPathCopy(inContext.m_options->m_default_dir,
-                                    inFlag,
-                                    inPathSize,
-                                    outPath);
+    lRetval = chkconfigFlagStateTableAppend(inTable,
+                                            inFlag,
+                                            lLength,
+                                            chkconfigFlagKey(inFlag),
+                                            inState,
+                                            inOrigin);
 
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStatePathCopy(const chkconfig_context_t &inContext,
-                                                 const chkconfig_flag_t &inFlag,
-                                                 const size_t &inPathSize,
-                                                 char *outPath)
+static chkconfig_status_t chkconfigFlagStateTableAppend(chkconfig_flag_state_table_t &inTable,
+                                                        const chkconfig_flag_state_table_t &inSourceTable,
+                                                        const size_t &inSourceIndex)
 {
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    const char *       lFlag = chkconfigFlagStateTableGetFlag(inSourceTable, inSourceIndex);
+    chkconfig_status_t lRetval;
 
-    lRetval = chkconfigFlagPathCopy(inContext.m_options->m_state_dir,
-                                    inFlag,
-                                    inPathSize,
-                                    outPath);
+    lRetval = chkconfigFlagStateTableAppend(inTable,
+                                            lFlag,
+                                            strlen(lFlag),
+                                            inSourceTable.m_keys[inSourceIndex],
+                                            chkconfigFlagStateTableGetState(inSourceTable, inSourceIndex),
+                                            chkconfigFlagStateTableGetOrigin(inSourceTable, inSourceIndex));
 
     return (lRetval);
 }
 
-static bool chkconfigUseDefaultDirectory(const chkconfig_context_t &inContext)
+/**
+ *  @brief
+ *    Sort a flag/state table by flag, in ascending strcmp(3) order.
+ *
+ *  The sort is a radix sort on cached flag keys, starting past any
+ *  prefix common to all flags. The per-flag arrays are then
+ *  permuted into the sorted order; the string pool itself is left
+ *  in place.
+ *
+ *  @param[in,out]  inTable  A reference to the table to sort.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the sort.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagStateTableSort(chkconfig_flag_state_table_t &inTable)
 {
-    const bool lRetval = (inContext.m_options->m_use_default_dir &&
-                          (inContext.m_options->m_default_dir != nullptr));
+    chkconfigFlagSortEntry *     lEntries = nullptr;
+    const char *                 lFirst;
+    size_t                       lPrefix;
+    chkconfig_flag_state_table_t lSorted;
+    chkconfig_status_t           lRetval  = CHKCONFIG_STATUS_SUCCESS;
 
-    return (lRetval);
-}
+    chkconfigFlagStateTableInit(lSorted);
 
-static chkconfig_status_t chkconfigStateGet(chkconfig_context_t &inContext,
-                                            const chkconfig_flag_t &inFlag,
-                                            chkconfig_state_t &outState,
-                                            chkconfig_origin_t &outOrigin)
-{
-    const bool         lUseDefaultDirectory = chkconfigUseDefaultDirectory(inContext);
-    char               lFlagPath[PATH_MAX];
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    if (inTable.m_count <= 1)
+    {
+        goto done;
+    }
 
-    // First, form the state directory path for the flag and attempt
-    // to get the state there.
+    // Flags commonly share a long leading prefix (for example,
+    // "net.wifi."), which every radix pass would otherwise have to
+    // step over one byte at a time. So, find the prefix common to
+    // all flags and start the sort following it instead.
 
-    lRetval = chkconfigStatePathCopy(inContext,
-                                     inFlag,
-                                     PATH_MAX,
-                                     &lFlagPath[0]);
-    nlREQUIRE_SUCCESS(lRetval, done);
+    lFirst  = chkconfigFlagStateTableGetFlag(inTable, 0);
+    lPrefix = strlen(lFirst);
 
-    lRetval = chkconfigStateGet(CHKCONFIG_ORIGIN_STATE,
-                                lUseDefaultDirectory,
-                                lFlagPath,
-                                outState,
-                                outOrigin);
+    for (size_t lIndex = 1; (lIndex < inTable.m_count) && (lPrefix > 0); lIndex++)
+    {
+        const char * lFlag   = chkconfigFlagStateTableGetFlag(inTable, lIndex);
+        size_t       lLength = 0;
 
-    // If that failed and the caller wants to use the default
-    // directory, make a second attempt with the default directory
-    // path.
+        while ((lLength < lPrefix) && (lFlag[lLength] == lFirst[lLength]))
+        {
+            lLength++;
+        }
 
-    if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && lUseDefaultDirectory)
-    {
-        lRetval = chkconfigDefaultPathCopy(inContext,
-                                           inFlag,
-                                           PATH_MAX,
-                                           &lFlagPath[0]);
+        lPrefix = lLength;
+    }
 
-        nlREQUIRE_SUCCESS(lRetval, done);
+    lEntries = static_cast<chkconfigFlagSortEntry *>(malloc(inTable.m_count * sizeof (chkconfigFlagSortEntry)));
+    nlREQUIRE_ACTION(lEntries != nullptr, done, lRetval = -ENOMEM);
 
-        lRetval = chkconfigStateGet(CHKCONFIG_ORIGIN_DEFAULT,
-                                    !lUseDefaultDirectory,
-                                    lFlagPath,
-                                    outState,
-                                    outOrigin);
+    for (size_t lIndex = 0; lIndex < inTable.m_count; lIndex++)
+    {
+        lEntries[lIndex].m_flag  = chkconfigFlagStateTableGetFlag(inTable, lIndex);
+        lEntries[lIndex].m_index = lIndex;
     }
 
- done:
-    return (lRetval);
-}
+    lRetval = chkconfigFlagSort(lEntries, inTable.m_count, lPrefix);
+    nlREQUIRE_SUCCESS(lRetval, done);
 
-static chkconfig_status_t chkconfigStateGetMultiple(chkconfig_context_t &inContext,
-                                                    chkconfig_flag_state_tuple_t *inFlagStateTuples,
-                                                    const size_t &inCount)
-{
-    chkconfig_flag_state_tuple_t * const lFirst   = &inFlagStateTuples[0];
-    chkconfig_flag_state_tuple_t * const lLast    = lFirst + inCount;
-    chkconfig_flag_state_tuple_t *       lCurrent = lFirst;
-    chkconfig_status_t                   lRetval  = CHKCONFIG_STATUS_SUCCESS;
+    // Permute the per-flag arrays into sorted order, sharing, rather
+    // than copying, the string pool.
 
-    nlREQUIRE_ACTION(inFlagStateTuples != nullptr, done, lRetval = -EINVAL);
+    lRetval = chkconfigFlagStateTableReserve(lSorted, inTable.m_count, 0);
+    nlREQUIRE_SUCCESS(lRetval, done);
 
-    while (lCurrent != lLast)
+    for (size_t lIndex = 0; lIndex < inTable.m_count; lIndex++)
     {
-        lRetval = chkconfigStateGet(inContext,
-                                    lCurrent->m_flag,
-                                    lCurrent->m_state,
-                                    lCurrent->m_origin);
-        nlREQUIRE_SUCCESS(lRetval, done);
+        const size_t lSource = lEntries[lIndex].m_index;
 
-        lCurrent++;
+        lSorted.m_offsets[lIndex] = inTable.m_offsets[lSource];
+        lSorted.m_keys[lIndex]    = inTable.m_keys[lSource];
+
+        chkconfigFlagStateTableSetState(lSorted, lIndex, chkconfigFlagStateTableGetState(inTable, lSource));
+        chkconfigFlagStateTableSetOrigin(lSorted, lIndex, chkconfigFlagStateTableGetOrigin(inTable, lSource));
     }
 
+    lSorted.m_pool      = inTable.m_pool;
+    lSorted.m_pool_size = inTable.m_pool_size;
+    lSorted.m_pool_used = inTable.m_pool_used;
+    lSorted.m_count     = inTable.m_count;
+
+    inTable.m_pool      = nullptr;
+
+    chkconfigFlagStateTableDestroy(inTable);
+
+    inTable = lSorted;
+
+    chkconfigFlagStateTableInit(lSorted);
+
  done:
+    chkconfigFlagStateTableDestroy(lSorted);
+
+    free(lEntries);
+
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStateGetCount(const char *inDirectoryPath,
-                                                 DIR *inDirectory,
-                                                 size_t &outCount)
+/**
+ *  @brief
+ *    A position in one of a number of flag-sorted flag/state tables
+ *    being merged.
+ *
+ *  @private
+ *
+ */
+struct chkconfigFlagStateTableMergeEntry
 {
-    struct dirent *    lDirent;
-    int                lStatus;
-    struct stat        lMetadata;
-    size_t             lCount  = 0;
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+    size_t m_table; //!< The index of the table.
+    size_t m_index; //!< The index of the entry in the table.
+};
 
-    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(inDirectory     != nullptr, done, lRetval = -EINVAL);
+static inline bool chkconfigFlagStateTableMergeLess(const chkconfig_flag_state_table_t *inTables,
+                                                    const chkconfigFlagStateTableMergeEntry &inFirst,
+                                                    const chkconfigFlagStateTableMergeEntry &inSecond)
+{
+    const int lComparison = chkconfigFlagStateTableCompare(inTables[inFirst.m_table], inFirst.m_index,
+                                                           inTables[inSecond.m_table], inSecond.m_index);
 
-    while ((lDirent = readdir(inDirectory)) != nullptr)
-    {
-        char lFlagPath[PATH_MAX];
+    // Among equal flags, the one from the earlier table, which takes
+    // precedence, comes first.
 
-        lRetval = chkconfigFlagPathCopy(inDirectoryPath,
-                                        lDirent->d_name,
-                                        PATH_MAX,
-                                        &lFlagPath[0]);
-        nlREQUIRE_SUCCESS(lRetval, done);
+    return ((lComparison < 0) || ((lComparison == 0) && (inFirst.m_table < inSecond.m_table)));
+}
 
-        lStatus = stat(lFlagPath, &lMetadata);
-        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+static void chkconfigFlagStateTableMergeSift(const chkconfig_flag_state_table_t *inTables,
+                                             chkconfigFlagStateTableMergeEntry *inHeap,
+                                             const size_t &inCount,
+                                             size_t inPosition)
+{
+    const chkconfigFlagStateTableMergeEntry lEntry = inHeap[inPosition];
+    size_t                                  lChild;
 
-        // Ignore anything but regular files, which importantly
-        // includes "." and "..".
-        //
-        // Ideally, there should not be anything but "." and ".." and
-        // regular files in the directory; however, there doesn't seem
-        // to be mandate to error out on such entries at the moment.
+    while ((lChild = ((inPosition * 2) + 1)) < inCount)
+    {
+        if (((lChild + 1) < inCount) &&
+            chkconfigFlagStateTableMergeLess(inTables, inHeap[lChild + 1], inHeap[lChild]))
+        {
+            lChild++;
+        }
 
-        if (S_ISREG(lMetadata.st_mode))
+        if (!chkconfigFlagStateTableMergeLess(inTables, inHeap[lChild], lEntry))
         {
-            lCount++;
+            break;
         }
-    }
 
-    outCount = lCount;
+        inHeap[inPosition] = inHeap[lChild];
+        inPosition         = lChild;
+    }
 
- done:
-    return (lRetval);
+    inHeap[inPosition] = lEntry;
 }
 
-static chkconfig_status_t chkconfigStateGetCount(const char *inDirectoryPath,
-                                                 size_t &outCount)
+static size_t chkconfigFlagStateTableMergeInit(const chkconfig_flag_state_table_t *inTables,
+                                               const size_t &inCount,
+                                               chkconfigFlagStateTableMergeEntry *outHeap)
 {
-    DIR *              lDirectory = nullptr;
-    chkconfig_status_t lStatus;
-    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
-
-    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
+    size_t lRetval = 0;
 
-    lDirectory = opendir(inDirectoryPath);
-    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+    for (size_t lTable = 0; lTable < inCount; lTable++)
+    {
+        if (inTables[lTable].m_count > 0)
+        {
+            outHeap[lRetval].m_table = lTable;
+            outHeap[lRetval].m_index = 0;
 
-    lRetval = chkconfigStateGetCount(inDirectoryPath,
-                                     lDirectory,
-                                     outCount);
-    nlREQUIRE_SUCCESS(lRetval, done);
+            lRetval++;
+        }
+    }
 
- done:
-    if (lDirectory != nullptr)
+    for (size_t lPosition = lRetval / 2; lPosition > 0; lPosition--)
     {
-        lStatus = closedir(lDirectory);
-        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+        chkconfigFlagStateTableMergeSift(inTables, outHeap, lRetval, lPosition - 1);
     }
 
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStateGetAll(const chkconfig_origin_t &inOrigin,
-                                               const char *inDirectoryPath,
-                                               DIR *inDirectory,
-                                               chkconfig_flag_state_tuple_t *&outFlagStateTuples,
-                                               const size_t &inCount)
+/**
+ *  @brief
+ *    Advance a k-way merge of flag-sorted flag/state tables past the
+ *    least flag, returning the entry for it that takes precedence.
+ *
+ *  Every entry for the least flag, from whichever table, is popped,
+ *  such that the next advance produces the next flag.
+ *
+ *  @private
+ *
+ */
+static chkconfigFlagStateTableMergeEntry chkconfigFlagStateTableMergeNext(const chkconfig_flag_state_table_t *inTables,
+                                                                          chkconfigFlagStateTableMergeEntry *inHeap,
+                                                                          size_t &inCount)
 {
-    struct dirent *                lDirent;
-    size_t                         lIndex = 0;
-    struct stat                    lMetadata;
-    int                            lStatus;
-    chkconfig_status_t             lRetval = CHKCONFIG_STATUS_SUCCESS;
-
-    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(inDirectory     != nullptr, done, lRetval = -EINVAL);
+    const chkconfigFlagStateTableMergeEntry lRetval = inHeap[0];
 
-    while (((lDirent = readdir(inDirectory)) != nullptr) && (lIndex < inCount))
+    do
     {
-        char lFlagPath[PATH_MAX];
-
-        lRetval = chkconfigFlagPathCopy(inDirectoryPath,
-                                        lDirent->d_name,
-                                        PATH_MAX,
-                                        &lFlagPath[0]);
-        nlREQUIRE_SUCCESS(lRetval, done);
+        chkconfigFlagStateTableMergeEntry & lTop = inHeap[0];
 
-        lStatus = stat(lFlagPath, &lMetadata);
-        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
-
-        if (S_ISREG(lMetadata.st_mode))
+        if (++lTop.m_index == inTables[lTop.m_table].m_count)
         {
-            constexpr bool lUseDefaultDirectory = true;
-
-            lRetval = chkconfigStateGet(inOrigin,
-                                        !lUseDefaultDirectory,
-                                        lFlagPath,
-                                        outFlagStateTuples[lIndex].m_state,
-                                        outFlagStateTuples[lIndex].m_origin);
-            nlREQUIRE_SUCCESS(lRetval, done);
-
-            outFlagStateTuples[lIndex].m_flag = strdup(lDirent->d_name);
-            nlREQUIRE_ACTION(outFlagStateTuples[lIndex].m_flag != nullptr, done, lRetval = -ENOMEM);
+            lTop = inHeap[--inCount];
+        }
 
-            lIndex++;
+        if (inCount > 0)
+        {
+            chkconfigFlagStateTableMergeSift(inTables, inHeap, inCount, 0);
         }
     }
+    while ((inCount > 0) &&
+           (chkconfigFlagStateTableCompare(inTables[inHeap[0].m_table], inHeap[0].m_index,
+                                           inTables[lRetval.m_table], lRetval.m_index) == 0));
 
- done:
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStateCopyAll(const chkconfig_origin_t &inOrigin,
-                                                const char *inDirectoryPath,
-                                                chkconfig_flag_state_tuple_t *&outFlagStateTuples,
-                                                size_t &outCount)
+/**
+ *  @brief
+ *    Form the union of a number of flag-sorted flag/state tables.
+ *
+ *  This merges the tables, each sorted by flag, into a new table,
+ *  also sorted by flag, in a single pass, drawing each next flag
+ *  from a binary heap of the head of each table. Where a flag
+ *  appears in more than one table, the entry from the earliest
+ *  takes precedence.
+ *
+ *  @param[in]   inTables  A pointer to the flag-sorted tables, in
+ *                         order of precedence.
+ *  @param[in]   inCount   The number of tables, at most
+ *                         kChkconfigStoresMaximum.
+ *  @param[out]  outTable  A reference to an initialized, empty
+ *                         table by which to return the union.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the union.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagStateTableMerge(const chkconfig_flag_state_table_t *inTables,
+                                                       const size_t &inCount,
+                                                       chkconfig_flag_state_table_t &outTable)
 {
-    size_t                         lCount           = 0;
-    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
-    DIR *                          lDirectory       = nullptr;
-    chkconfig_status_t             lRetval = CHKCONFIG_STATUS_SUCCESS;
+    chkconfigFlagStateTableMergeEntry lHeap[kChkconfigStoresMaximum];
+    chkconfigFlagStateTableMergeEntry lEntry;
+    size_t                            lHeapCount;
+    size_t                            lCount    = 0;
+    size_t                            lPoolUsed = 0;
+    chkconfig_status_t                lRetval   = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
+    // Reserve, exactly once, for the worst case, a disjoint union.
 
-    // Get a count of the number of flag/state backing files in the
-    // specified directory, which might very well be zero.
+    for (size_t lTable = 0; lTable < inCount; lTable++)
+    {
+        lCount    += inTables[lTable].m_count;
+        lPoolUsed += inTables[lTable].m_pool_used;
+    }
 
-    lRetval = chkconfigStateGetCount(inDirectoryPath, lCount);
+    lRetval = chkconfigFlagStateTableReserve(outTable, lCount, lPoolUsed);
     nlREQUIRE_SUCCESS(lRetval, done);
 
-    // If the count was non-zero, allocate a new flag/state
-    // tuple array for the results and populate them.
+    lHeapCount = chkconfigFlagStateTableMergeInit(inTables, inCount, &lHeap[0]);
 
-    if (lCount > 0)
+    while (lHeapCount > 0)
     {
-        // Allocate a new flag/state tuple array for the results.
+        lEntry = chkconfigFlagStateTableMergeNext(inTables, &lHeap[0], lHeapCount);
 
-        lRetval = chkconfigFlagStateTuplesInit(lFlagStateTuples, lCount);
+        lRetval = chkconfigFlagStateTableAppend(outTable, inTables[lEntry.m_table], lEntry.m_index);
         nlREQUIRE_SUCCESS(lRetval, done);
+    }
 
-        // Open the specified directory and populate the results.
+ done:
+    return (lRetval);
+}
 
-        lDirectory = opendir(inDirectoryPath);
-        nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+static size_t chkconfigFlagStateTableMergeCount(const chkconfig_flag_state_table_t *inTables,
+                                                const size_t &inCount)
+{
+    chkconfigFlagStateTableMergeEntry lHeap[kChkconfigStoresMaximum];
+    size_t                            lHeapCount;
+    size_t                            lRetval    = 0;
 
-        lRetval = chkconfigStateGetAll(inOrigin,
-                                       inDirectoryPath,
-                                       lDirectory,
-                                       lFlagStateTuples,
-                                       lCount);
-        nlREQUIRE_SUCCESS(lRetval, done);
+    lHeapCount = chkconfigFlagStateTableMergeInit(inTables, inCount, &lHeap[0]);
+
+    while (lHeapCount > 0)
+    {
+        chkconfigFlagStateTableMergeNext(inTables, &lHeap[0], lHeapCount);
+
+        lRetval++;
     }
 
-    outFlagStateTuples = lFlagStateTuples;
-    outCount           = lCount;
+    return (lRetval);
+}
 
- done:
-    // If we failed and flag state tuples were allocated, destory them
-    // before returning since the caller is only responsible to do so
-    // on success.
+/**
+ *  @brief
+ *    Find the next entry in a flag/state table, at or after an
+ *    index, with a state.
+ *
+ *  The state bitset is scanned a word at a time, such that entries
+ *  with the other state cost nothing beyond the words they share.
+ *
+ *  @param[in]  inTable  A reference to the table to scan.
+ *  @param[in]  inState  A pointer to the state to find or null to
+ *                       find any state.
+ *  @param[in]  inIndex  The index at which to start.
+ *
+ *  @returns
+ *    The index of the entry found or, if there is no such entry, an
+ *    index no less than the table count.
+ *
+ *  @private
+ *
+ */
+static size_t chkconfigFlagStateTableNext(const chkconfig_flag_state_table_t &inTable,
+                                          const chkconfig_state_t *inState,
+                                          const size_t &inIndex)
+{
+    const uint64_t lInvert    = ((inState != nullptr) && !*inState) ? ~UINT64_C(0) : 0;
+    size_t         lWordIndex = (inIndex / kChkconfigStatesPerWord);
+    uint64_t       lWord;
+    size_t         lRetval;
 
-    if (lRetval < CHKCONFIG_STATUS_SUCCESS)
+    if ((inState == nullptr) || (inIndex >= inTable.m_count))
+    {
+        return (inIndex);
+    }
+
+    lWord = ((inTable.m_states[lWordIndex] ^ lInvert) & (~UINT64_C(0) << (inIndex % kChkconfigStatesPerWord)));
+
+    while (lWord == 0)
     {
-        if (lFlagStateTuples != nullptr)
+        lWordIndex++;
+
+        if ((lWordIndex * kChkconfigStatesPerWord) >= inTable.m_count)
         {
-            const chkconfig_status_t lStatus = chkconfigFlagStateTuplesDestroy(lFlagStateTuples, lCount);
-            nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+            return (inTable.m_count);
         }
+
+        lWord = (inTable.m_states[lWordIndex] ^ lInvert);
     }
 
-    if (lDirectory != nullptr)
+    // Bits past the last entry are not maintained, so a set one
+    // there is no entry at all.
+
+    lRetval = ((lWordIndex * kChkconfigStatesPerWord) + static_cast<size_t>(__builtin_ctzll(lWord)));
+
+    return ((lRetval < inTable.m_count) ? lRetval : inTable.m_count);
+}
+
+/**
+ *  @brief
+ *    Count the entries in a flag/state table with a state.
+ *
+ *  @param[in]  inTable  A reference to the table to count.
+ *  @param[in]  inState  A pointer to the state to count or null to
+ *                       count every entry.
+ *
+ *  @returns
+ *    The number of entries with the state.
+ *
+ *  @private
+ *
+ */
+static size_t chkconfigFlagStateTableCountState(const chkconfig_flag_state_table_t &inTable,
+                                                const chkconfig_state_t *inState)
+{
+    const uint64_t lInvert = ((inState != nullptr) && !*inState) ? ~UINT64_C(0) : 0;
+    const size_t   lWords  = ((inTable.m_count + kChkconfigStatesPerWord - 1) / kChkconfigStatesPerWord);
+    const size_t   lTail   = (inTable.m_count % kChkconfigStatesPerWord);
+    uint64_t       lWord;
+    size_t         lRetval = 0;
+
+    if (inState == nullptr)
     {
-        const int lStatus = closedir(lDirectory);
-        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+        return (inTable.m_count);
+    }
+
+    for (size_t lWordIndex = 0; lWordIndex < lWords; lWordIndex++)
+    {
+        lWord = (inTable.m_states[lWordIndex] ^ lInvert);
+
+        if ((lWordIndex == (lWords - 1)) && (lTail != 0))
+        {
+            lWord &= ((UINT64_C(1) << lTail) - 1);
+        }
+
+        lRetval += static_cast<size_t>(__builtin_popcountll(lWord));
     }
 
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStateCopyAllWithDefaultDirectory(chkconfig_context_t &inContext,
-                                                                    chkconfig_flag_state_tuple_t *&outFlagStateTuples,
-                                                                    size_t &outCount)
+/**
+ *  @brief
+ *    Copy a flag/state table into a public flag/state tuple array.
+ *
+ *  @param[in]   inTable              A reference to the table to
+ *                                    copy.
+ *  @param[in]   inOrder              The order in which to copy the
+ *                                    table. For flag order, the
+ *                                    table order is preserved. For
+ *                                    state order, entries whose
+ *                                    state is on are copied, in
+ *                                    table order, before those
+ *                                    whose state is off, such that a
+ *                                    flag-sorted table yields
+ *                                    state-sorted tuples.
+ *  @param[in]   inState              A pointer to the state of the
+ *                                    entries to copy, in table
+ *                                    order, or null to copy every
+ *                                    entry. Entries with the other
+ *                                    state are skipped by way of the
+ *                                    state bitset, without touching
+ *                                    their flags.
+ *  @param[in]   inPacked             Whether the tuples and their
+ *                                    flags share a single
+ *                                    allocation.
+ *  @param[out]  outFlagStateTuples   A reference to storage by which
+ *                                    to return the tuple array, or
+ *                                    null if no entry is copied, if
+ *                                    successful.
+ *  @param[out]  outCount             A reference to storage by which
+ *                                    to return the number of tuples
+ *                                    if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the tuples.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagStateTableCopyTuples(const chkconfig_flag_state_table_t &inTable,
+                                                            const chkconfig_sort_order_t &inOrder,
+                                                            const chkconfig_state_t *inState,
+                                                            const bool &inPacked,
+                                                            chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                            size_t &outCount)
 {
-    size_t                         lDefaultCount           = 0;
-    size_t                         lStateCount             = 0;
-    size_t                         lUnionCount             = 0;
-    chkconfig_flag_state_tuple_t * lDefaultFlagStateTuples = nullptr;
-    chkconfig_flag_state_tuple_t * lStateFlagStateTuples   = nullptr;
-    chkconfig_flag_state_tuple_t * lUnionFlagStateTuples   = nullptr;
-    chkconfig_status_t             lRetval                 = CHKCONFIG_STATUS_SUCCESS;
+    static const chkconfig_state_t kPassStates[]    = { true, false };
+    const bool                     lByState         = ((inOrder == CHKCONFIG_SORT_ORDER_STATE) && (inState == nullptr));
+    const size_t                   lCount           = chkconfigFlagStateTableCountState(inTable, inState);
+    const size_t                   lTuplesSize      = (lCount * sizeof (chkconfig_flag_state_tuple_t));
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    const chkconfig_state_t *      lPassState;
+    char *                         lFlags           = nullptr;
+    size_t                         lFlagsSize       = 0;
+    size_t                         lTupleIndex      = 0;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    if (lCount > 0)
+    {
+        // Packed tuples and their flags share a single allocation,
+        // with the flags following the tuples.
 
-    // Here, we need to consider a copy across both of the default and
-    // state directories. In the best case, either one or the other is
-    // empty. In the worst case, each contains a non-overlapping
-    // collection of backing files. To navigate between those case
-    // extremes the union must be copied.
+        if (inPacked)
+        {
+            for (size_t lIndex = chkconfigFlagStateTableNext(inTable, inState, 0);
+                 lIndex < inTable.m_count;
+                 lIndex = chkconfigFlagStateTableNext(inTable, inState, lIndex + 1))
+            {
+                lFlagsSize += (strlen(chkconfigFlagStateTableGetFlag(inTable, lIndex)) + 1);
+            }
 
-    lRetval = chkconfigStateCopyAll(CHKCONFIG_ORIGIN_DEFAULT,
-                                    inContext.m_options->m_default_dir,
-                                    lDefaultFlagStateTuples,
-                                    lDefaultCount);
-    nlREQUIRE_SUCCESS(lRetval, done);
+            lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(lTuplesSize + lFlagsSize));
+            nlREQUIRE_ACTION(lFlagStateTuples != nullptr, done, lRetval = -ENOMEM);
 
-    lRetval = chkconfigStateCopyAll(CHKCONFIG_ORIGIN_STATE,
-                                    inContext.m_options->m_state_dir,
-                                    lStateFlagStateTuples,
-                                    lStateCount);
-    nlREQUIRE_SUCCESS(lRetval, done);
+            lFlags = reinterpret_cast<char *>(lFlagStateTuples) + lTuplesSize;
+        }
+        else
+        {
+            lRetval = chkconfigFlagStateTuplesInit(lFlagStateTuples, lCount);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
 
-    // Explicitly pass the state tuples as the left-hand argument and
-    // the default tuples as the right-hand argument to ensure that
-    // the state values from the latter take precedence over the
-    // former.
-
-    lRetval = chkconfigFlagStateTupleCopyUnion(lStateFlagStateTuples,
-                                               lStateCount,
-                                               lDefaultFlagStateTuples,
-                                               lDefaultCount,
-                                               lUnionFlagStateTuples,
-                                               lUnionCount);
-    nlREQUIRE_SUCCESS(lRetval, done);
+        // Make one pass for flag order or for a single state, or two
+        // passes, on and then off, for state order.
 
-    outFlagStateTuples = lUnionFlagStateTuples;
-    outCount           = lUnionCount;
+        for (size_t lPass = 0; lPass < (lByState ? 2 : 1); lPass++)
+        {
+            lPassState = (lByState ? &kPassStates[lPass] : inState);
 
- done:
-    if (lDefaultFlagStateTuples != nullptr)
-    {
-        const chkconfig_status_t lStatus = chkconfigFlagStateTuplesDestroy(lDefaultFlagStateTuples, lDefaultCount);
-        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+            for (size_t lIndex = chkconfigFlagStateTableNext(inTable, lPassState, 0);
+                 lIndex < inTable.m_count;
+                 lIndex = chkconfigFlagStateTableNext(inTable, lPassState, lIndex + 1))
+            {
+                const char * lFlag = chkconfigFlagStateTableGetFlag(inTable, lIndex);
+
+                if (inPacked)
+                {
+                    const size_t lSize = (strlen(lFlag) + 1);
+
+                    memcpy(lFlags, lFlag, lSize);
+
+                    lFlagStateTuples[lTupleIndex].m_flag = lFlags;
+
+                    lFlags += lSize;
+                }
+                else
+                {
+                    lFlagStateTuples[lTupleIndex].m_flag = strdup(lFlag);
+                    nlREQUIRE_ACTION(lFlagStateTuples[lTupleIndex].m_flag != nullptr, done, lRetval = -ENOMEM);
+                }
+
+                lFlagStateTuples[lTupleIndex].m_state  = chkconfigFlagStateTableGetState(inTable, lIndex);
+                lFlagStateTuples[lTupleIndex].m_origin = chkconfigFlagStateTableGetOrigin(inTable, lIndex);
+
+                lTupleIndex++;
+            }
+        }
     }
 
-    if (lStateFlagStateTuples != nullptr)
+    outFlagStateTuples = lFlagStateTuples;
+    outCount           = lCount;
+
+ done:
+    if (lRetval < CHKCONFIG_STATUS_SUCCESS)
     {
-        const chkconfig_status_t lStatus = chkconfigFlagStateTuplesDestroy(lStateFlagStateTuples, lStateCount);
-        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+        if ((lFlagStateTuples != nullptr) && !inPacked)
+        {
+            const chkconfig_status_t lStatus = chkconfigFlagStateTuplesDestroy(lFlagStateTuples, lCount);
+            nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+        }
     }
 
     return (lRetval);
 }
 
+// MARK: Flag Indexes
 
-static chkconfig_status_t chkconfigStateCopyAll(chkconfig_context_t &inContext,
-                                                chkconfig_flag_state_tuple_t *&outFlagStateTuples,
-                                                size_t &outCount)
+static constexpr size_t kChkconfigFlagIndexSlotsMinimum = 64;
+
+static void chkconfigFlagIndexInit(chkconfig_flag_index_t &outIndex)
 {
-    const bool         lUseDefaultDirectory = chkconfigUseDefaultDirectory(inContext);
-    chkconfig_status_t lRetval              = CHKCONFIG_STATUS_SUCCESS;
+    chkconfigFlagStateTableInit(outIndex.m_table);
 
-    // The algorithmic approach here depends on library runtime options.
-    //
-    // If 'chkconfigUseDefaultDirectory' returns false, then it's a
-    // simple and straightforward enumeration and copy of the state
-    // directory.
-    //
-    // However, if 'chkconfigUseDefaultDirectory' returns true, then
-    // we have to consider BOTH the default and state directories and
-    // enumerate and copy the union thereof.
+    outIndex.m_slots      = nullptr;
+    outIndex.m_slot_count = 0;
+}
 
-    if (!lUseDefaultDirectory)
-    {
-        lRetval = chkconfigStateCopyAll(CHKCONFIG_ORIGIN_STATE,
-                                        inContext.m_options->m_state_dir,
-                                        outFlagStateTuples,
-                                        outCount);
-        nlREQUIRE_SUCCESS(lRetval, done);
-    }
-    else
+static void chkconfigFlagIndexDestroy(chkconfig_flag_index_t &inIndex)
+{
+    chkconfigFlagStateTableDestroy(inIndex.m_table);
+
+    free(inIndex.m_slots);
+
+    inIndex.m_slots      = nullptr;
+    inIndex.m_slot_count = 0;
+}
+
+static uint64_t chkconfigFlagIndexHash(const char *inFlag, const size_t &inLength)
+{
+    uint64_t lRetval = 0xCBF29CE484222325ULL;
+
+    // FNV-1a
+
+    for (size_t lIndex = 0; lIndex < inLength; lIndex++)
     {
-        lRetval = chkconfigStateCopyAllWithDefaultDirectory(inContext,
-                                                            outFlagStateTuples,
-                                                            outCount);
-        nlREQUIRE_SUCCESS(lRetval, done);
+        lRetval ^= static_cast<uint8_t>(inFlag[lIndex]);
+        lRetval *= 0x100000001B3ULL;
     }
 
- done:
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStateGetCountWithDefaultDirectory(chkconfig_context_t &inContext,
-                                                                     size_t &outCount)
+static chkconfig_status_t chkconfigFlagIndexCheck(const chkconfig_flag_t &inFlag,
+                                                  size_t &outLength)
 {
-    chkconfig_flag_state_tuple_t * lUnionFlagStateTuples = nullptr;
-    size_t                         lUnionCount           = 0;
-    chkconfig_status_t             lRetval               = CHKCONFIG_STATUS_SUCCESS;
-
-    // Simply inovoke 'chkconfigStateCopyAllWithDefaultDirectory' and
-    // discard the tuples, while preserving the count since the
-    // algorithm is otherwise identical.
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
 
-    lRetval = chkconfigStateCopyAllWithDefaultDirectory(inContext,
-                                                        lUnionFlagStateTuples,
-                                                        lUnionCount);
-    nlREQUIRE_SUCCESS(lRetval, done);
+    nlREQUIRE_ACTION(inFlag    != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inFlag[0] != '\0',    done, lRetval = -EINVAL);
 
-    outCount = lUnionCount;
+    outLength = strlen(inFlag);
+    nlREQUIRE_ACTION(outLength <= NAME_MAX, done, lRetval = -ENAMETOOLONG);
 
  done:
-    if (lUnionFlagStateTuples != nullptr)
-    {
-        const chkconfig_status_t lStatus = chkconfigFlagStateTuplesDestroy(lUnionFlagStateTuples, lUnionCount);
-        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
-    }
-
     return (lRetval);
 }
 
 /**
  *  @brief
- *    Get the count of all flags covered by a backing store file.
- *
- *  This attempts to get a count of all flags covered by a backing
- *  store file.
- *
- *  @note
- *    Depending on runtime library options, the returned count may
- *    include only the state directory or both the default and state
- *    directories.
+ *    Look up a flag in a flag index.
  *
- *  @param[in]   inContext        A reference to the chkconfig
- *                                library context for which to
- *                                get the count of all flags
- *                                covered by a backing store
- *                                file.
- *  @param[out]  outCount         A reference to storage by which
- *                                to return the count if successful.
+ *  @param[in]   inIndex   A reference to the index to look in.
+ *  @param[in]   inFlag    A pointer to the null-terminated flag.
+ *  @param[in]   inLength  The length, in bytes, of @a inFlag.
+ *  @param[out]  outSlot   A reference to storage by which to return
+ *                         the hash slot of the flag or, if not
+ *                         found, the empty slot at which to insert
+ *                         it.
  *
- *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @returns
+ *    True if the flag was found; otherwise, false.
  *
  *  @private
  *
  */
-static chkconfig_status_t chkconfigStateGetCount(chkconfig_context_t &inContext,
-                                                 size_t &outCount)
+static bool chkconfigFlagIndexLookup(const chkconfig_flag_index_t &inIndex,
+                                     const char *inFlag,
+                                     const size_t &inLength,
+                                     size_t &outSlot)
 {
-    const bool         lUseDefaultDirectory = chkconfigUseDefaultDirectory(inContext);
-    chkconfig_status_t lRetval              = CHKCONFIG_STATUS_SUCCESS;
-
-    // The algorithmic approach here depends on library runtime options.
-    //
-    // If 'chkconfigUseDefaultDirectory' returns false, then it's a
-    // simple and straightforward enumeration of the state directory.
-    //
-    // However, if 'chkconfigUseDefaultDirectory' returns true, then
-    // we have to consider BOTH the default and state directories. In
-    // the best case, either one or the other is empty. In the worst
-    // case, each contains a non-overlapping collection of backing
-    // files. To navigate between those case extremes, not only must
-    // both diretories be counted, but the flags must be deduplicated
-    // between them such that the count of the unique union is returned.
+    const size_t lMask = (inIndex.m_slot_count - 1);
+    size_t       lSlot;
+    uint32_t     lEntry;
+    const char * lFlag;
+    bool         lRetval = false;
 
-    if (!lUseDefaultDirectory)
+    if (inIndex.m_slot_count == 0)
     {
-        lRetval = chkconfigStateGetCount(inContext.m_options->m_state_dir,
-                                         outCount);
-        nlREQUIRE_SUCCESS(lRetval, done);
+        goto done;
     }
-    else
+
+    // Linear probing, which the load factor bound of one half keeps
+    // short.
+
+    for (lSlot = (chkconfigFlagIndexHash(inFlag, inLength) & lMask);
+         (lEntry = inIndex.m_slots[lSlot]) != 0;
+         lSlot = ((lSlot + 1) & lMask))
     {
-        lRetval = chkconfigStateGetCountWithDefaultDirectory(inContext,
-                                                             outCount);
-        nlREQUIRE_SUCCESS(lRetval, done);
+        lFlag = chkconfigFlagStateTableGetFlag(inIndex.m_table, lEntry - 1);
+
+        if ((memcmp(lFlag, inFlag, inLength) == 0) && (lFlag[inLength] == '\0'))
+        {
+            lRetval = true;
+            break;
+        }
     }
 
+    outSlot = lSlot;
+
  done:
     return (lRetval);
 }
 
-// MARK: Mutators
-
-static chkconfig_status_t chkconfigStateSet(chkconfig_context_t &inContext,
-                                            const chkconfig_flag_t &inFlag,
-                                            const chkconfig_state_t &inState)
+static chkconfig_status_t chkconfigFlagIndexGrow(chkconfig_flag_index_t &inIndex,
+                                                 const size_t &inSlotCount)
 {
-    char               lFlagPath[PATH_MAX];
-    int                lStatus;
-    int                lFlags;
-    int                lDescriptor = -1;
-    const char *       lStateString;
+    uint32_t *         lSlots  = nullptr;
+    const char *       lFlag;
+    size_t             lLength;
+    size_t             lSlot;
     chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(inFlag    != nullptr, done, lRetval = -EINVAL);
-    nlREQUIRE_ACTION(inFlag[0] != '\0',    done, lRetval = -EINVAL);
-
-    lRetval = chkconfigStatePathCopy(inContext,
-                                     inFlag,
-                                     PATH_MAX,
-                                     &lFlagPath[0]);
-    nlREQUIRE_SUCCESS(lRetval, done);
-
-    lFlags = (O_WRONLY | O_TRUNC);
+    lSlots = static_cast<uint32_t *>(calloc(inSlotCount, sizeof (uint32_t)));
+    nlREQUIRE_ACTION(lSlots != nullptr, done, lRetval = -ENOMEM);
 
-    if (inContext.m_options->m_force_state)
-    {
-        lFlags |= (O_CREAT);
-    }
+    free(inIndex.m_slots);
 
-    // If 'm_force_state' was not asserted and, consequently, the
-    // O_CREAT flag not used, then the following open call will
-    // expectdly fail. Therefore, use the EXPECT rather than REQUIRE
-    // assertion form.
+    inIndex.m_slots      = lSlots;
+    inIndex.m_slot_count = inSlotCount;
 
-    lDescriptor = open(lFlagPath, lFlags, DEFFILEMODE);
-    nlEXPECT_ACTION(lDescriptor != -1, done, lRetval = -errno);
+    // The flags in the table are unique, so each is simply placed in
+    // the first empty slot of its probe sequence.
 
-    lRetval = chkconfigStateGetStateString(inState, lStateString);
-    nlREQUIRE_SUCCESS(lRetval, done);
+    for (size_t lIndex = 0; lIndex < inIndex.m_table.m_count; lIndex++)
+    {
+        lFlag   = chkconfigFlagStateTableGetFlag(inIndex.m_table, lIndex);
+        lLength = strlen(lFlag);
 
-    lStatus = dprintf(lDescriptor, "%s\n", lStateString);
-    nlREQUIRE_ACTION(lStatus > 0,
-                     done,
-                     lRetval = -EOVERFLOW);
+        chkconfigFlagIndexLookup(inIndex, lFlag, lLength, lSlot);
 
- done:
-    if (lDescriptor != -1)
-    {
-        lStatus = close(lDescriptor);
-        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+        inIndex.m_slots[lSlot] = static_cast<uint32_t>(lIndex + 1);
     }
 
+ done:
     return (lRetval);
 }
 
-static chkconfig_status_t chkconfigStateSetMultiple(chkconfig_context_t &inContext,
-                                                    const chkconfig_flag_state_tuple_t *inFlagStateTuples,
-                                                    const size_t &inCount)
+/**
+ *  @brief
+ *    Set the state of a flag in a flag index, adding the flag if it
+ *    is not already indexed.
+ *
+ *  @param[in,out]  inIndex   A reference to the index to set the
+ *                            flag in.
+ *  @param[in]      inFlag    A pointer to the null-terminated flag.
+ *  @param[in]      inLength  The length, in bytes, of @a inFlag.
+ *  @param[in]      inState   The state of the flag.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the flag.
+ *  @retval  -EOVERFLOW                If the index is full.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagIndexSet(chkconfig_flag_index_t &inIndex,
+                                                const char *inFlag,
+                                                const size_t &inLength,
+                                                const chkconfig_state_t &inState)
 {
+    size_t             lSlot;
+    size_t             lSlotCount;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
 
-    const chkconfig_flag_state_tuple_t * const lFirst   = &inFlagStateTuples[0];
-    const chkconfig_flag_state_tuple_t * const lLast    = lFirst + inCount;
-    const chkconfig_flag_state_tuple_t *       lCurrent = lFirst;
-    chkconfig_status_t                         lRetval  = CHKCONFIG_STATUS_SUCCESS;
+    if (chkconfigFlagIndexLookup(inIndex, inFlag, inLength, lSlot))
+    {
+        chkconfigFlagStateTableSetState(inIndex.m_table, inIndex.m_slots[lSlot] - 1, inState);
+        goto done;
+    }
 
-    nlREQUIRE_ACTION(inFlagStateTuples != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inIndex.m_table.m_count < UINT32_MAX, done, lRetval = -EOVERFLOW);
 
-    while (lCurrent != lLast)
+    if (((inIndex.m_table.m_count + 1) * 2) > inIndex.m_slot_count)
     {
-        lRetval = chkconfigStateSet(inContext,
-                                    lCurrent->m_flag,
-                                    lCurrent->m_state);
+        lSlotCount = ((inIndex.m_slot_count == 0) ? kChkconfigFlagIndexSlotsMinimum : (inIndex.m_slot_count * 2));
+
+        lRetval = chkconfigFlagIndexGrow(inIndex, lSlotCount);
         nlREQUIRE_SUCCESS(lRetval, done);
 
-        lCurrent++;
+        chkconfigFlagIndexLookup(inIndex, inFlag, inLength, lSlot);
     }
 
+    lRetval = chkconfigFlagStateTableAppend(inIndex.m_table,
+                                            inFlag,
+                                            inLength,
+                                            chkconfigFlagKey(inFlag),
+                                            inState,
+                                            CHKCONFIG_ORIGIN_STATE);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    inIndex.m_slots[lSlot] = static_cast<uint32_t>(inIndex.m_table.m_count);
+
  done:
     return (lRetval);
 }
 
-}; // namespace Detail
+// MARK: Flag State Log Lifetime Management
 
-}; // namespace nuovations
+static void chkconfigStateLogFree(chkconfig_state_log_t *&inLog)
+{
+    int lStatus;
 
-// MARK: C
+    if (inLog->m_descriptor != -1)
+    {
+        lStatus = close(inLog->m_descriptor);
+        nlVERIFY(lStatus == 0);
+    }
 
-// MARK: Lifetime Management
+    chkconfigFlagIndexDestroy(inLog->m_index);
 
-using namespace nuovations;
+    free(inLog->m_path);
+
+    delete inLog;
+
+    inLog = nullptr;
+}
+
+static void chkconfigStateLogsFree(chkconfig_state_log_t *&inLogs)
+{
+    chkconfig_state_log_t * lNext;
+
+    while (inLogs != nullptr)
+    {
+        lNext = inLogs->m_next;
+
+        chkconfigStateLogFree(inLogs);
+
+        inLogs = lNext;
+    }
+}
 
 /**
  *  @brief
- *    Initialize a chkconfig library context.
+ *    Find or create the flag state log for a path.
  *
- *  This attempts to initialize and return a chkconfig library context
- *  that will be used with nearly all library interfaces.
+ *  A context has at most one flag state log per path, shared by
+ *  every runtime options snapshot naming it and retained until the
+ *  context is destroyed, such that changing unrelated runtime
+ *  options neither reopens nor reindexes it. The log file itself is
+ *  not opened until first used.
  *
- *  The context will be intialized with the default options the
- *  library was instantiated with when it was built. Callers that do
- *  not want to use the default options may call
- *  #chkconfig_options_init and then #chkconfig_options_set to
- *  customize runtime library behavior.
+ *  @note
+ *    The caller must hold the context writer lock.
  *
- *  @param[out]  context_pointer  TBD
+ *  @param[in,out]  inContext  A reference to the library context
+ *                             owning the log.
+ *  @param[in]      inPath     A pointer to the null-terminated path
+ *                             of the log file.
+ *  @param[out]     outLog     A reference to storage by which to
+ *                             return a pointer to the log if
+ *                             successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
- *  @retval  -EINVAL                   If @a context_pointer is null.
- *  @retval  -ENOMEM                   If resources could not be allocated.
- *
- *  @sa chkconfig_options_init
- *  @sa chkconfig_options_set
- *  @sa chkconfig_destroy
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the log.
  *
- *  @ingroup lifetime
+ *  @private
  *
  */
-chkconfig_status_t chkconfig_init(chkconfig_context_pointer_t *context_pointer)
+static chkconfig_status_t chkconfigStateLogResolve(chkconfig_context_t &inContext,
+                                                   const char *inPath,
+                                                   chkconfig_state_log_t *&outLog)
 {
-    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+    chkconfig_state_log_t * lLog    = inContext.m_logs;
+    chkconfig_status_t      lRetval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    while ((lLog != nullptr) && (strcmp(lLog->m_path, inPath) != 0))
+    {
+        lLog = lLog->m_next;
+    }
 
-    retval = Detail::chkconfigInit(*context_pointer);
+    if (lLog == nullptr)
+    {
+        lLog = new chkconfig_state_log_t;
+        nlREQUIRE_ACTION(lLog != nullptr, done, lRetval = -ENOMEM);
+
+        lLog->m_descriptor = -1;
+        lLog->m_writable   = false;
+        lLog->m_device     = 0;
+        lLog->m_inode      = 0;
+        lLog->m_size       = 0;
+        lLog->m_records    = 0;
+        lLog->m_next       = nullptr;
+
+        chkconfigFlagIndexInit(lLog->m_index);
+
+        lLog->m_path       = strdup(inPath);
+        nlREQUIRE_ACTION(lLog->m_path != nullptr, done, chkconfigStateLogFree(lLog); lRetval = -ENOMEM);
+
+        lLog->m_next       = inContext.m_logs;
+        inContext.m_logs   = lLog;
+    }
+
+    outLog = lLog;
+
+ done:
+    return (lRetval);
+}
+
+// MARK: Memory Store Lifetime Management
+
+static void chkconfigMemoryStoreFree(chkconfig_memory_store_t *&inStore)
+{
+    chkconfigFlagIndexDestroy(inStore->m_index);
+
+    delete inStore;
+
+    inStore = nullptr;
+}
+
+/**
+ *  @brief
+ *    Find or create the in-memory flag store for a context.
+ *
+ *  A context has at most one in-memory flag store, created when first
+ *  named by a runtime options snapshot and retained, with its flags,
+ *  until the context is destroyed.
+ *
+ *  @note
+ *    The caller must hold the context writer lock.
+ *
+ *  @param[in,out]  inContext  A reference to the library context
+ *                             owning the store.
+ *  @param[out]     outStore   A reference to storage by which to
+ *                             return a pointer to the store if
+ *                             successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the store.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigMemoryStoreResolve(chkconfig_context_t &inContext,
+                                                      chkconfig_memory_store_t *&outStore)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    if (inContext.m_memory == nullptr)
+    {
+        inContext.m_memory = new chkconfig_memory_store_t;
+        nlREQUIRE_ACTION(inContext.m_memory != nullptr, done, lRetval = -ENOMEM);
+
+        chkconfigFlagIndexInit(inContext.m_memory->m_index);
+    }
+
+    outStore = inContext.m_memory;
+
+ done:
+    return (lRetval);
+}
+
+// MARK: Existence Filter Lifetime Management
+
+static void chkconfigExistenceFilterFree(chkconfig_existence_filter_t *&inFilter)
+{
+    chkconfigFlagIndexDestroy(inFilter->m_index);
+
+    free(inFilter->m_directory);
+
+    delete inFilter;
+
+    inFilter = nullptr;
+}
+
+static void chkconfigExistenceFiltersFree(chkconfig_existence_filters_t *&inFilters)
+{
+    chkconfig_existence_filter_t * lNext;
+    int                            lStatus;
+
+    // Closing the change notification descriptor removes every watch
+    // along with it.
+
+    if (inFilters->m_descriptor != -1)
+    {
+        lStatus = close(inFilters->m_descriptor);
+        nlVERIFY(lStatus == 0);
+    }
+
+    while (inFilters->m_first != nullptr)
+    {
+        lNext = inFilters->m_first->m_next;
+
+        chkconfigExistenceFilterFree(inFilters->m_first);
+
+        inFilters->m_first = lNext;
+    }
+
+    delete inFilters;
+
+    inFilters = nullptr;
+}
+
+#if CHKCONFIG_HAVE_INOTIFY
+/**
+ *  @brief
+ *    Find or create the existence filter for a directory.
+ *
+ *  A context has at most one existence filter per directory, shared
+ *  by every runtime options snapshot naming it and retained until
+ *  the context is destroyed. The filter is not built until first
+ *  used.
+ *
+ *  @note
+ *    The caller must hold the context writer lock.
+ *
+ *  @param[in,out]  inContext    A reference to the library context
+ *                               owning the filter.
+ *  @param[in]      inDirectory  A pointer to the null-terminated
+ *                               directory to filter.
+ *  @param[out]     outFilter    A reference to storage by which to
+ *                               return a pointer to the filter if
+ *                               successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the filter.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigExistenceFilterResolve(chkconfig_context_t &inContext,
+                                                          const char *inDirectory,
+                                                          chkconfig_existence_filter_t *&outFilter)
+{
+    chkconfig_existence_filters_t * lFilters;
+    chkconfig_existence_filter_t *  lFilter;
+    chkconfig_status_t              lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    if (inContext.m_filters == nullptr)
+    {
+        inContext.m_filters = new chkconfig_existence_filters_t;
+        nlREQUIRE_ACTION(inContext.m_filters != nullptr, done, lRetval = -ENOMEM);
+
+        inContext.m_filters->m_descriptor = -1;
+        inContext.m_filters->m_first      = nullptr;
+    }
+
+    lFilters = inContext.m_filters;
+    lFilter  = lFilters->m_first;
+
+    while ((lFilter != nullptr) && (strcmp(lFilter->m_directory, inDirectory) != 0))
+    {
+        lFilter = lFilter->m_next;
+    }
+
+    if (lFilter == nullptr)
+    {
+        lFilter = new chkconfig_existence_filter_t;
+        nlREQUIRE_ACTION(lFilter != nullptr, done, lRetval = -ENOMEM);
+
+        lFilter->m_watch     = -1;
+        lFilter->m_valid     = false;
+        lFilter->m_filters   = lFilters;
+        lFilter->m_next      = nullptr;
+
+        chkconfigFlagIndexInit(lFilter->m_index);
+
+        lFilter->m_directory = strdup(inDirectory);
+        nlREQUIRE_ACTION(lFilter->m_directory != nullptr, done, chkconfigExistenceFilterFree(lFilter); lRetval = -ENOMEM);
+
+        lFilter->m_length    = strlen(inDirectory);
+
+        // Readers walk the filters, under their lock, to route change
+        // notifications, so the new filter is linked in under it.
+
+        lFilters->m_lock.lock();
+
+        lFilter->m_next      = lFilters->m_first;
+        lFilters->m_first    = lFilter;
+
+        lFilters->m_lock.unlock();
+    }
+
+    outFilter = lFilter;
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Find or create the existence filters for each backing file
+ *    directory of a runtime options snapshot being published.
+ *
+ *  @note
+ *    The caller must hold the context writer lock.
+ *
+ *  @param[in,out]  inContext  A reference to the library context
+ *                             owning the filters.
+ *  @param[in,out]  inOptions  A reference to the runtime options
+ *                             snapshot in which to record the
+ *                             filters.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for a filter.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigExistenceFiltersResolve(chkconfig_context_t &inContext,
+                                                           chkconfig_options_t &inOptions)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    // Only a state store backed by a directory is filtered; neither a
+    // flag state log nor an in-memory store requires a system call to
+    // find a flag absent.
+
+    if ((inOptions.m_memory == nullptr) && (inOptions.m_log == nullptr))
+    {
+        lRetval = chkconfigExistenceFilterResolve(inContext,
+                                                  inOptions.m_state_dir,
+                                                  inOptions.m_state_filter);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    for (size_t lLayer = 0; lLayer < inOptions.m_layer_count; lLayer++)
+    {
+        lRetval = chkconfigExistenceFilterResolve(inContext,
+                                                  inOptions.m_layers[lLayer].m_directory,
+                                                  inOptions.m_layers[lLayer].m_filter);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    if (inOptions.m_use_default_dir)
+    {
+        lRetval = chkconfigExistenceFilterResolve(inContext,
+                                                  inOptions.m_default_dir,
+                                                  inOptions.m_default_filter);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    inOptions.m_filters = inContext.m_filters;
+
+ done:
+    return (lRetval);
+}
+#endif // CHKCONFIG_HAVE_INOTIFY
+
+// MARK: Runtime Options Snapshots
+
+/**
+ *  @brief
+ *    Remove every layer between the state store and the default
+ *    directory of library runtime options.
+ *
+ *  @param[in,out]  inOptions  A reference to the runtime options
+ *                             whose layers are to be removed.
+ *
+ *  @private
+ *
+ */
+static void chkconfigOptionsLayersFree(chkconfig_options_t &inOptions)
+{
+    for (size_t lLayer = 0; lLayer < inOptions.m_layer_count; lLayer++)
+    {
+        free(const_cast<char *>(inOptions.m_layers[lLayer].m_directory));
+    }
+
+    free(inOptions.m_layers);
+
+    inOptions.m_layers      = nullptr;
+    inOptions.m_layer_count = 0;
+}
+
+/**
+ *  @brief
+ *    Push a layer between the state store and the default
+ *    directory of library runtime options.
+ *
+ *  @param[in,out]  inOptions    A reference to the runtime options
+ *                               onto which to push the layer.
+ *  @param[in]      inDirectory  A pointer to the null-terminated C
+ *                               string of the layer directory.
+ *  @param[in]      inWritable   Whether flags that exist in the
+ *                               layer are set there.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOSPC                   If the maximum number of
+ *                                     layers have already been
+ *                                     pushed.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the layer.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigOptionsLayerPush(chkconfig_options_t &inOptions,
+                                                    const char *inDirectory,
+                                                    const bool &inWritable)
+{
+    chkconfig_layer_t * lLayers;
+    char *              lDirectory;
+    chkconfig_status_t  lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inOptions.m_layer_count < kChkconfigLayersMaximum, done, lRetval = -ENOSPC);
+
+    lLayers = static_cast<chkconfig_layer_t *>(realloc(inOptions.m_layers, (inOptions.m_layer_count + 1) * sizeof (chkconfig_layer_t)));
+    nlREQUIRE_ACTION(lLayers != nullptr, done, lRetval = -ENOMEM);
+
+    inOptions.m_layers = lLayers;
+
+    lDirectory = strdup(inDirectory);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -ENOMEM);
+
+    lLayers[inOptions.m_layer_count].m_directory = lDirectory;
+    lLayers[inOptions.m_layer_count].m_writable  = inWritable;
+    lLayers[inOptions.m_layer_count].m_filter    = nullptr;
+
+    inOptions.m_layer_count++;
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Destroy library runtime options.
+ *
+ *  This releases the leaf data of, and then deallocates, the
+ *  specified library runtime options. The library default options
+ *  are never destroyed.
+ *
+ *  @param[in,out]  inOptionsPointer  A reference to a pointer to the
+ *                                    runtime options to destroy,
+ *                                    which is reset to null.
+ *
+ *  @private
+ *
+ */
+static void chkconfigOptionsFree(chkconfig_options_t *&inOptionsPointer)
+{
+    if ((inOptionsPointer == nullptr) || (inOptionsPointer == &sChkconfigOptionsDefault))
+    {
+        return;
+    }
+
+    // Destroy any leaf data.
+
+    if (inOptionsPointer->m_state_dir != nullptr)
+    {
+        free(const_cast<char *>(inOptionsPointer->m_state_dir));
+        inOptionsPointer->m_state_dir = nullptr;
+    }
+
+    if (inOptionsPointer->m_default_dir != nullptr)
+    {
+        free(const_cast<char *>(inOptionsPointer->m_default_dir));
+        inOptionsPointer->m_default_dir = nullptr;
+    }
+
+    if (inOptionsPointer->m_state_log != nullptr)
+    {
+        free(const_cast<char *>(inOptionsPointer->m_state_log));
+        inOptionsPointer->m_state_log = nullptr;
+    }
+
+    chkconfigOptionsLayersFree(*inOptionsPointer);
+
+    // Destroy the options data itself.
+
+    delete inOptionsPointer;
+
+    inOptionsPointer = nullptr;
+}
+
+/**
+ *  @brief
+ *    Copy library runtime options.
+ *
+ *  This allocates new library runtime options and initializes them
+ *  with a deep copy of the specified options.
+ *
+ *  @param[in]   inOptions          A reference to the runtime options
+ *                                  to copy.
+ *  @param[out]  outOptionsPointer  A reference to storage by which to
+ *                                  return a pointer to the copy if
+ *                                  successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the copy.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigOptionsCopy(const chkconfig_options_t &inOptions,
+                                               chkconfig_options_pointer_t &outOptionsPointer)
+{
+    chkconfig_options_pointer_t lOptionsPointer;
+    chkconfig_status_t          lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lOptionsPointer = new chkconfig_options_t;
+    nlREQUIRE_ACTION(lOptionsPointer != nullptr, done, lRetval = -ENOMEM);
+
+    lOptionsPointer->m_state_dir         = nullptr;
+    lOptionsPointer->m_default_dir       = nullptr;
+    lOptionsPointer->m_state_log         = nullptr;
+    lOptionsPointer->m_log               = nullptr;
+    lOptionsPointer->m_memory            = nullptr;
+    lOptionsPointer->m_layers            = nullptr;
+    lOptionsPointer->m_layer_count       = 0;
+    lOptionsPointer->m_filters           = nullptr;
+    lOptionsPointer->m_state_filter      = nullptr;
+    lOptionsPointer->m_default_filter    = nullptr;
+    lOptionsPointer->m_next              = nullptr;
+
+    lOptionsPointer->m_state_dir         = strdup(inOptions.m_state_dir);
+    nlREQUIRE_ACTION(lOptionsPointer->m_state_dir != nullptr, done, lRetval = -ENOMEM);
+
+    lOptionsPointer->m_force_state       = inOptions.m_force_state;
+    lOptionsPointer->m_use_default_dir   = inOptions.m_use_default_dir;
+    lOptionsPointer->m_default_dir       = strdup(inOptions.m_default_dir);
+    nlREQUIRE_ACTION(lOptionsPointer->m_default_dir != nullptr, done, lRetval = -ENOMEM);
+    lOptionsPointer->m_sync_state        = inOptions.m_sync_state;
+    lOptionsPointer->m_io_queue_depth    = inOptions.m_io_queue_depth;
+    lOptionsPointer->m_threads           = inOptions.m_threads;
+    lOptionsPointer->m_memory_state      = inOptions.m_memory_state;
+    lOptionsPointer->m_sharded_layout    = inOptions.m_sharded_layout;
+    lOptionsPointer->m_existence_filters = inOptions.m_existence_filters;
+
+    if (inOptions.m_state_log != nullptr)
+    {
+        lOptionsPointer->m_state_log     = strdup(inOptions.m_state_log);
+        nlREQUIRE_ACTION(lOptionsPointer->m_state_log != nullptr, done, lRetval = -ENOMEM);
+    }
+
+    for (size_t lLayer = 0; lLayer < inOptions.m_layer_count; lLayer++)
+    {
+        lRetval = chkconfigOptionsLayerPush(*lOptionsPointer,
+                                            inOptions.m_layers[lLayer].m_directory,
+                                            inOptions.m_layers[lLayer].m_writable);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    outOptionsPointer = lOptionsPointer;
+
+ done:
+    if (lRetval < CHKCONFIG_STATUS_SUCCESS)
+    {
+        chkconfigOptionsFree(lOptionsPointer);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Reclaim all retired library runtime options snapshots.
+ *
+ *  @note
+ *    The caller must either hold the context writer lock, having
+ *    observed the context to have no readers, or be destroying the
+ *    context.
+ *
+ *  @param[in,out]  inContext  A reference to the library context
+ *                             whose retired snapshots are to be
+ *                             reclaimed.
+ *
+ *  @private
+ *
+ */
+static void chkconfigOptionsReclaim(chkconfig_context_t &inContext)
+{
+    chkconfig_options_pointer_t lOptionsPointer;
+
+    while (inContext.m_retired != nullptr)
+    {
+        lOptionsPointer     = inContext.m_retired;
+        inContext.m_retired = lOptionsPointer->m_next;
+
+        chkconfigOptionsFree(lOptionsPointer);
+    }
+}
+
+/**
+ *  @brief
+ *    Publish a library runtime options snapshot.
+ *
+ *  This publishes a new, immutable snapshot of the specified client
+ *  runtime options, or the library default options, as those in
+ *  effect for the specified context, retiring the snapshot it
+ *  replaces.
+ *
+ *  @note
+ *    The caller must hold the context writer lock.
+ *
+ *  @param[in,out]  inContext         A reference to the library
+ *                                    context for which to publish
+ *                                    the snapshot.
+ *  @param[in]      inOptionsPointer  An optional pointer to the
+ *                                    client runtime options of which
+ *                                    to publish a snapshot. If null,
+ *                                    the library default options are
+ *                                    published.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the snapshot.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigOptionsPublish(chkconfig_context_t &inContext,
+                                                  const chkconfig_options_t *inOptionsPointer)
+{
+    chkconfig_options_pointer_t lSnapshotPointer = nullptr;
+    const chkconfig_options_t * lRetiredPointer;
+    chkconfig_status_t          lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    if (inOptionsPointer != nullptr)
+    {
+        lRetval = chkconfigOptionsCopy(*inOptionsPointer, lSnapshotPointer);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (lSnapshotPointer->m_state_log != nullptr)
+        {
+            lRetval = chkconfigStateLogResolve(inContext,
+                                               lSnapshotPointer->m_state_log,
+                                               lSnapshotPointer->m_log);
+            nlREQUIRE_SUCCESS_ACTION(lRetval, done, chkconfigOptionsFree(lSnapshotPointer));
+        }
+
+        if (lSnapshotPointer->m_memory_state)
+        {
+            lRetval = chkconfigMemoryStoreResolve(inContext,
+                                                  lSnapshotPointer->m_memory);
+            nlREQUIRE_SUCCESS_ACTION(lRetval, done, chkconfigOptionsFree(lSnapshotPointer));
+        }
+
+#if CHKCONFIG_HAVE_INOTIFY
+        if (lSnapshotPointer->m_existence_filters && !lSnapshotPointer->m_sharded_layout)
+        {
+            lRetval = chkconfigExistenceFiltersResolve(inContext,
+                                                       *lSnapshotPointer);
+            nlREQUIRE_SUCCESS_ACTION(lRetval, done, chkconfigOptionsFree(lSnapshotPointer));
+        }
+#endif // CHKCONFIG_HAVE_INOTIFY
+    }
+
+    lRetiredPointer = inContext.m_options.exchange((lSnapshotPointer != nullptr) ?
+                                                   lSnapshotPointer :
+                                                   &sChkconfigOptionsDefault);
+
+    inContext.m_source = inOptionsPointer;
+
+    if (lRetiredPointer != &sChkconfigOptionsDefault)
+    {
+        lSnapshotPointer         = const_cast<chkconfig_options_t *>(lRetiredPointer);
+        lSnapshotPointer->m_next = inContext.m_retired;
+        inContext.m_retired      = lSnapshotPointer;
+    }
+
+    // Any reader that may still be using a retired snapshot counted
+    // itself in before loading it and has yet to count itself
+    // out. If there are no readers now, any that arrive later will
+    // load the snapshot just published and all retired snapshots may
+    // be reclaimed.
+
+    if (inContext.m_readers.load() == 0)
+    {
+        chkconfigOptionsReclaim(inContext);
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Acquire the current library runtime options snapshot.
+ *
+ *  This counts the caller in as a reader of the specified context
+ *  and returns the runtime options snapshot currently in effect for
+ *  it. The snapshot remains valid until the caller counts itself out
+ *  with #chkconfigOptionsRelease.
+ *
+ *  @param[in,out]  inContext  A reference to the library context
+ *                             for which to acquire the snapshot.
+ *
+ *  @returns
+ *    A reference to the current runtime options snapshot.
+ *
+ *  @private
+ *
+ */
+static const chkconfig_options_t &chkconfigOptionsAcquire(chkconfig_context_t &inContext)
+{
+    inContext.m_readers.fetch_add(1);
+
+    return (*inContext.m_options.load());
+}
+
+/**
+ *  @brief
+ *    Release a library runtime options snapshot.
+ *
+ *  This counts the caller out as a reader of the specified context,
+ *  after which any snapshot it acquired may no longer be used.
+ *
+ *  The last reader to count itself out reclaims any snapshots
+ *  retired while there were readers, such that, under steady
+ *  readers, they do not accumulate until a change to the runtime
+ *  options happens to find none. Should a change be underway, the
+ *  reader leaves reclamation to it, or to the next last reader.
+ *
+ *  @note
+ *    The caller must not hold the context writer lock.
+ *
+ *  @param[in,out]  inContext  A reference to the library context
+ *                             for which to release the snapshot.
+ *
+ *  @private
+ *
+ */
+static void chkconfigOptionsRelease(chkconfig_context_t &inContext)
+{
+    if (inContext.m_readers.fetch_sub(1) == 1)
+    {
+        if (inContext.m_writer.try_lock())
+        {
+            // A reader may have counted itself in since. If so, it
+            // loaded the current snapshot, which is never retired
+            // while the writer lock is held, and it reclaims in turn
+            // as it counts itself out.
+
+            if (inContext.m_readers.load() == 0)
+            {
+                chkconfigOptionsReclaim(inContext);
+            }
+
+            inContext.m_writer.unlock();
+        }
+    }
+}
+
+// MARK: Asynchronous Request Lifetime Management
+
+static void chkconfigAsyncRequestFree(chkconfig_async_request_t *&inRequest)
+{
+    free(inRequest->m_flag);
+
+    delete inRequest;
+
+    inRequest = nullptr;
+}
+
+static void chkconfigAsyncRequestsFree(chkconfig_async_request_t *&inRequests)
+{
+    chkconfig_async_request_t * lNext;
+
+    while (inRequests != nullptr)
+    {
+        lNext = inRequests->m_next;
+
+        chkconfigAsyncRequestFree(inRequests);
+
+        inRequests = lNext;
+    }
+}
+
+/**
+ *  @brief
+ *    Stop any asynchronous request worker thread for a library
+ *    context and release its asynchronous request resources.
+ *
+ *  Requests not yet performed or not yet dispatched are discarded
+ *  without their completion functions being called.
+ *
+ *  @param[in,out]  inContext  A reference to the context to release
+ *                             the resources of.
+ *
+ *  @private
+ *
+ */
+static void chkconfigAsyncDestroy(chkconfig_context_t &inContext)
+{
+    int  lStatus;
+    bool lStarted;
+
+    inContext.m_async_lock.lock();
+
+    inContext.m_async_stopping = true;
+    lStarted                   = inContext.m_async_started;
+
+    inContext.m_async_lock.unlock();
+
+    if (lStarted)
+    {
+        inContext.m_async_ready.notify_all();
+
+        lStatus = pthread_join(inContext.m_async_thread, nullptr);
+        nlVERIFY(lStatus == 0);
+    }
+
+    chkconfigAsyncRequestsFree(inContext.m_async_pending);
+    chkconfigAsyncRequestsFree(inContext.m_async_completed);
+
+    for (size_t lEnd = 0; lEnd < 2; lEnd++)
+    {
+        if (inContext.m_async_signal[lEnd] != -1)
+        {
+            lStatus = close(inContext.m_async_signal[lEnd]);
+            nlVERIFY(lStatus == 0);
+        }
+    }
+}
+
+// MARK: Lifetime Management
+
+static chkconfig_status_t chkconfigInit(chkconfig_context_pointer_t &outContextPointer)
+{
+    chkconfig_context_pointer_t lContextPointer;
+    chkconfig_status_t          lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lContextPointer = new chkconfig_context_t;
+    nlREQUIRE_ACTION(lContextPointer != nullptr, done, lRetval = -ENOMEM);
+
+    lContextPointer->m_options.store(&sChkconfigOptionsDefault);
+    lContextPointer->m_readers.store(0);
+    lContextPointer->m_source               = nullptr;
+    lContextPointer->m_retired              = nullptr;
+    lContextPointer->m_async_pending        = nullptr;
+    lContextPointer->m_async_pending_tail   = &lContextPointer->m_async_pending;
+    lContextPointer->m_async_completed      = nullptr;
+    lContextPointer->m_async_completed_tail = &lContextPointer->m_async_completed;
+    lContextPointer->m_async_signal[0]      = -1;
+    lContextPointer->m_async_signal[1]      = -1;
+    lContextPointer->m_async_started        = false;
+    lContextPointer->m_async_stopping       = false;
+    lContextPointer->m_logs                 = nullptr;
+    lContextPointer->m_memory               = nullptr;
+    lContextPointer->m_filters              = nullptr;
+
+    outContextPointer = lContextPointer;
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigOptionsInit(chkconfig_context_t &inContext,
+                                               chkconfig_options_pointer_t &outOptionsPointer)
+{
+    chkconfig_options_pointer_t lOptionsPointer = nullptr;
+    chkconfig_status_t          lRetval         = CHKCONFIG_STATUS_SUCCESS;
+
+    // Start by initializing the newly-allocated options to the defaults.
+
+    lRetval = chkconfigOptionsCopy(sChkconfigOptionsDefault, lOptionsPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // Then, publish them as the current options for the context.
+
+    inContext.m_writer.lock();
+
+    lRetval = chkconfigOptionsPublish(inContext, lOptionsPointer);
+
+    inContext.m_writer.unlock();
+
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    outOptionsPointer = lOptionsPointer;
+
+ done:
+    if (lRetval < CHKCONFIG_STATUS_SUCCESS)
+    {
+        chkconfigOptionsFree(lOptionsPointer);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigOptionsDestroy(chkconfig_context_t &inContext,
+                                                  chkconfig_options_pointer_t &inOptionsPointer)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inOptionsPointer != nullptr, done, lRetval = -EINVAL);
+
+    // If the current context options were published from those being
+    // destroyed, then reset the current context to the default
+    // options.
+
+    inContext.m_writer.lock();
+
+    if (inContext.m_source == inOptionsPointer)
+    {
+        lRetval = chkconfigOptionsPublish(inContext, nullptr);
+    }
+
+    inContext.m_writer.unlock();
+
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    chkconfigOptionsFree(inOptionsPointer);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigDestroy(chkconfig_context_pointer_t &inContextPointer)
+{
+    chkconfig_options_pointer_t lOptionsPointer;
+    chkconfig_status_t          lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inContextPointer != nullptr, done, lRetval = -EINVAL);
+
+    // Stop the asynchronous request worker, if any, first, since it
+    // may be using a runtime options snapshot.
+
+    chkconfigAsyncDestroy(*inContextPointer);
+
+    // Reclaim the current and any retired runtime options snapshots.
+
+    lOptionsPointer = const_cast<chkconfig_options_t *>(inContextPointer->m_options.load());
+
+    chkconfigOptionsFree(lOptionsPointer);
+    chkconfigOptionsReclaim(*inContextPointer);
+
+    // Then, with no snapshot left to refer to them, close and release
+    // any flag state logs, the in-memory flag store, and any existence
+    // filters.
+
+    chkconfigStateLogsFree(inContextPointer->m_logs);
+
+    if (inContextPointer->m_memory != nullptr)
+    {
+        chkconfigMemoryStoreFree(inContextPointer->m_memory);
+    }
+
+    if (inContextPointer->m_filters != nullptr)
+    {
+        chkconfigExistenceFiltersFree(inContextPointer->m_filters);
+    }
+
+    delete inContextPointer;
+
+    inContextPointer = nullptr;
+
+ done:
+    return (lRetval);
+}
+
+// MARK: Option Management
+
+static chkconfig_status_t chkconfigOptionsSet(chkconfig_context_t &inContext,
+                                              chkconfig_options_t &inOptions,
+                                              const chkconfig_option_t &inOption,
+                                              va_list inArguments)
+{
+    uint32_t           lQueueDepth;
+    uint32_t           lThreads;
+    const char *       lPath;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inContext.m_writer.lock();
+
+    switch (inOption)
+    {
+
+    case CHKCONFIG_OPTION_STATE_DIRECTORY:
+        if (inOptions.m_state_dir != nullptr)
+        {
+            free(const_cast<char *>(inOptions.m_state_dir));
+        }
+
+        inOptions.m_state_dir = strdup(va_arg(inArguments, const char *));
+        nlREQUIRE_ACTION(inOptions.m_state_dir != nullptr, done, lRetval = -ENOMEM);
+        break;
+
+    case CHKCONFIG_OPTION_FORCE_STATE:
+        inOptions.m_force_state = va_arg(inArguments, int);
+        break;
+
+    case CHKCONFIG_OPTION_DEFAULT_DIRECTORY:
+        if (inOptions.m_default_dir != nullptr)
+        {
+            free(const_cast<char *>(inOptions.m_default_dir));
+        }
+
+        inOptions.m_default_dir = strdup(va_arg(inArguments, const char *));
+        nlREQUIRE_ACTION(inOptions.m_default_dir != nullptr, done, lRetval = -ENOMEM);
+        break;
+
+    case CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY:
+        inOptions.m_use_default_dir = va_arg(inArguments, int);
+        break;
+
+    case CHKCONFIG_OPTION_SYNC_STATE:
+        inOptions.m_sync_state = va_arg(inArguments, int);
+        break;
+
+    case CHKCONFIG_OPTION_IO_QUEUE_DEPTH:
+        lQueueDepth = va_arg(inArguments, uint32_t);
+        nlREQUIRE_ACTION(lQueueDepth <= kChkconfigIoQueueDepthMaximum, done, lRetval = -EINVAL);
+
+        inOptions.m_io_queue_depth = lQueueDepth;
+        break;
+
+    case CHKCONFIG_OPTION_THREADS:
+        lThreads = va_arg(inArguments, uint32_t);
+        nlREQUIRE_ACTION((lThreads > 0) && (lThreads <= kChkconfigThreadsMaximum), done, lRetval = -EINVAL);
+
+        inOptions.m_threads = lThreads;
+        break;
+
+    case CHKCONFIG_OPTION_MEMORY_STATE:
+        inOptions.m_memory_state = va_arg(inArguments, int);
+        break;
+
+    case CHKCONFIG_OPTION_EXISTENCE_FILTERS:
+        inOptions.m_existence_filters = va_arg(inArguments, int);
+        break;
+
+    case CHKCONFIG_OPTION_SHARDED_LAYOUT:
+        inOptions.m_sharded_layout = va_arg(inArguments, int);
+        break;
+
+    case CHKCONFIG_OPTION_LAYER_DIRECTORY:
+    case CHKCONFIG_OPTION_WRITABLE_LAYER_DIRECTORY:
+        lPath = va_arg(inArguments, const char *);
+
+        if (lPath == nullptr)
+        {
+            chkconfigOptionsLayersFree(inOptions);
+        }
+        else
+        {
+            lRetval = chkconfigOptionsLayerPush(inOptions,
+                                                lPath,
+                                                (inOption == CHKCONFIG_OPTION_WRITABLE_LAYER_DIRECTORY));
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+        break;
+
+    case CHKCONFIG_OPTION_STATE_LOG:
+        lPath = va_arg(inArguments, const char *);
+
+        if (inOptions.m_state_log != nullptr)
+        {
+            free(const_cast<char *>(inOptions.m_state_log));
+            inOptions.m_state_log = nullptr;
+        }
+
+        if (lPath != nullptr)
+        {
+            inOptions.m_state_log = strdup(lPath);
+            nlREQUIRE_ACTION(inOptions.m_state_log != nullptr, done, lRetval = -ENOMEM);
+        }
+        break;
+
+    default:
+        lRetval = -EINVAL;
+        break;
+
+    }
+
+    // If the current context options were published from those just
+    // changed, then publish a new snapshot reflecting the change.
+
+    if ((lRetval == CHKCONFIG_STATUS_SUCCESS) && (inContext.m_source == &inOptions))
+    {
+        lRetval = chkconfigOptionsPublish(inContext, &inOptions);
+    }
+
+ done:
+    inContext.m_writer.unlock();
+
+    return (lRetval);
+}
+
+// MARK: Observers
+
+static chkconfig_status_t chkconfigStateGet(const chkconfig_origin_t &inOrigin,
+                                            const bool &inNonexistentIsAnError,
+                                            const int &inDirectoryDescriptor,
+                                            const char *inFlagPath,
+                                            chkconfig_state_t &outState,
+                                            chkconfig_origin_t &outOrigin)
+{
+    int                lStatus;
+    int                lDescriptor = -1;
+    struct stat        lMetadata;
+    void *             lData   = MAP_FAILED;
+    chkconfig_state_t  lState  = false;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inFlagPath != nullptr, done, lRetval = -EINVAL);
+
+    // The path may very well not exist, so use the EXPECT rather than
+    // REQUIRE assertion form.
+
+    lDescriptor = openat(inDirectoryDescriptor, inFlagPath, O_RDONLY);
+    nlEXPECT_ACTION(lDescriptor != -1,
+                    done,
+                    switch (errno)
+                    {
+
+                    case ENOENT:
+                        outState = false;
+                        outOrigin = CHKCONFIG_ORIGIN_NONE;
+
+                        // If called with inNonexistentIsAnError
+                        // asserted, then the caller does NOT want the
+                        // return value "hidden" by success such that
+                        // they can fallback to the default directory
+                        // on failure.
+
+                        if (inNonexistentIsAnError)
+                        {
+                            lRetval = -errno;
+                        }
+                        break;
+
+                    default:
+                        lRetval = -errno;
+                        break;
+
+                    });
+
+    // At this point, the file exists and is open. Determine its size
+    // for memory-mapping.
+
+    lStatus = fstat(lDescriptor, &lMetadata);
+    nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+    // If the size of the file is non-zero, memory-map the file and
+    // attempt to determine its state value.
+    //
+    // Otherwise, there is no data to map and we must assume the
+    // default state of off or false.
+
+    if (lMetadata.st_size > 0)
+    {
+        lData = mmap(nullptr, static_cast<size_t>(lMetadata.st_size), PROT_READ, MAP_PRIVATE, lDescriptor, 0);
+        nlREQUIRE_ACTION(lData != MAP_FAILED, done, lRetval = -errno);
+
+        lRetval = chkconfigStateStringGetState(reinterpret_cast<const char *>(lData), lState);
+        nlREQUIRE_SUCCESS_ACTION(lRetval, done, outState = false);
+    }
+    else
+    {
+        lState = false;
+    }
+
+    outState  = lState;
+    outOrigin = inOrigin;
+
+ done:
+    if (lData != MAP_FAILED)
+    {
+        lStatus = munmap(lData, static_cast<size_t>(lMetadata.st_size));
+        nlREQUIRE_ACTION(lStatus == 0, close, lRetval = -errno);
+    }
+
+ close:
+    if (lDescriptor != -1)
+    {
+        lStatus = close(lDescriptor);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateGet(const chkconfig_origin_t &inOrigin,
+                                            const bool &inNonexistentIsAnError,
+                                            const char *inFlagPath,
+                                            chkconfig_state_t &outState,
+                                            chkconfig_origin_t &outOrigin)
+{
+    return (chkconfigStateGet(inOrigin,
+                              inNonexistentIsAnError,
+                              AT_FDCWD,
+                              inFlagPath,
+                              outState,
+                              outOrigin));
+}
+
+static chkconfig_status_t chkconfigFlagPathCopy(const char *inDirectory,
+                                                const chkconfig_flag_t &inFlag,
+                                                const size_t &inPathSize,
+                                                char *outPath)
+{
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectory != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inFlag      != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inFlag[0]   != '\0',    done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inPathSize > 0,         done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(outPath     != nullptr, done, lRetval = -EINVAL);
+
+    lStatus = snprintf(&outPath[0],
+                       inPathSize,
+                       "%s/%s",
+                       inDirectory,
+                       inFlag);
+    nlREQUIRE_ACTION(lStatus > 0,
+                     done,
+                     lRetval = -EOVERFLOW);
+    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < inPathSize,
+                     done,
+                     lRetval = -EOVERFLOW);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the shard of a flag in a sharded directory layout.
+ *
+ *  The shard is the low eight bits of the same stable hash by which
+ *  flags are indexed, such that it never changes with the process,
+ *  host, or library version.
+ *
+ *  @private
+ *
+ */
+static size_t chkconfigFlagShard(const chkconfig_flag_t &inFlag)
+{
+    return (chkconfigFlagIndexHash(inFlag, strlen(inFlag)) % kChkconfigShardsMaximum);
+}
+
+/**
+ *  @brief
+ *    Copy the path of the backing file for a flag in a directory
+ *    store.
+ *
+ *  This is the backing file in the store directory itself or, for
+ *  a store with a sharded layout, in the shard subdirectory of the
+ *  flag.
+ *
+ *  @param[in]   inStore     A reference to the directory store.
+ *  @param[in]   inFlag      The flag for which to copy the path.
+ *  @param[in]   inPathSize  The size, in bytes, of @a outPath.
+ *  @param[out]  outPath     A pointer to storage by which to return
+ *                           the path if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If any argument was invalid.
+ *  @retval  -EOVERFLOW                If the path was too long.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigFlagPathCopy(const chkconfig_store_t &inStore,
+                                                const chkconfig_flag_t &inFlag,
+                                                const size_t &inPathSize,
+                                                char *outPath)
+{
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    if (!inStore.m_sharded)
+    {
+        lRetval = chkconfigFlagPathCopy(inStore.m_directory,
+                                        inFlag,
+                                        inPathSize,
+                                        outPath);
+        goto done;
+    }
+
+    nlREQUIRE_ACTION(inStore.m_directory != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inFlag              != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inFlag[0]           != '\0',    done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inPathSize > 0,                 done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(outPath             != nullptr, done, lRetval = -EINVAL);
+
+    lStatus = snprintf(&outPath[0],
+                       inPathSize,
+                       "%s/%02zx/%s",
+                       inStore.m_directory,
+                       chkconfigFlagShard(inFlag),
+                       inFlag);
+    nlREQUIRE_ACTION(lStatus > 0,
+                     done,
+                     lRetval = -EOVERFLOW);
+    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < inPathSize,
+                     done,
+                     lRetval = -EOVERFLOW);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Create the shard subdirectory containing a flag backing file
+ *    path, if it does not already exist.
+ *
+ *  @param[in,out]  inFlagPath  A pointer to the mutable
+ *                              null-terminated C string of the flag
+ *                              backing file path, as copied for a
+ *                              store with a sharded layout, which
+ *                              is restored before returning.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inFlagPath has no
+ *                                     directory.
+ *  @retval  -errno                    If the subdirectory could not
+ *                                     be created.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigShardCreate(char *inFlagPath)
+{
+    char *             lSeparator = strrchr(inFlagPath, '/');
+    int                lStatus;
+    chkconfig_status_t lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(lSeparator != nullptr, done, lRetval = -EINVAL);
+
+    *lSeparator = '\0';
+
+    lStatus = mkdir(inFlagPath, ACCESSPERMS);
+
+    *lSeparator = '/';
+
+    nlREQUIRE_ACTION((lStatus == 0) || (errno == EEXIST), done, lRetval = -errno);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the next shard subdirectory in a directory with a sharded
+ *    layout.
+ *
+ *  Entries other than directories named by two lowercase
+ *  hexadecimal digits are skipped.
+ *
+ *  @param[in]   inDirectory  A pointer to the open directory.
+ *  @param[out]  outDirent    A reference to storage by which to
+ *                            return the next shard entry or null if
+ *                            there are no more.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If an entry could not be
+ *                                     stat'ed.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigShardNext(DIR *inDirectory,
+                                             const struct dirent *&outDirent)
+{
+    const struct dirent * lDirent;
+    struct stat           lMetadata;
+    bool                  lIsDirectory;
+    int                   lStatus;
+    chkconfig_status_t    lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    outDirent = nullptr;
+
+    while ((lDirent = readdir(inDirectory)) != nullptr)
+    {
+        if ((strspn(lDirent->d_name, "0123456789abcdef") != 2) || (lDirent->d_name[2] != '\0'))
+        {
+            continue;
+        }
+
+#if defined(DT_UNKNOWN)
+        if ((lDirent->d_type != DT_UNKNOWN) && (lDirent->d_type != DT_LNK))
+        {
+            lIsDirectory = (lDirent->d_type == DT_DIR);
+        }
+        else
+#endif // defined(DT_UNKNOWN)
+        {
+            lStatus = fstatat(dirfd(inDirectory), lDirent->d_name, &lMetadata, 0);
+            nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+            lIsDirectory = S_ISDIR(lMetadata.st_mode);
+        }
+
+        if (lIsDirectory)
+        {
+            outDirent = lDirent;
+            break;
+        }
+    }
+
+ done:
+    return (lRetval);
+}
+
+static bool chkconfigUseDefaultDirectory(const chkconfig_options_t &inOptions)
+{
+    const bool lRetval = (inOptions.m_use_default_dir &&
+                          (inOptions.m_default_dir != nullptr));
+
+    return (lRetval);
+}
+
+// MARK: Flag State Logs
+
+// A flag state log file is a header, the magic below, followed by
+// zero or more records, each:
+//
+//   Offset  Size    Field
+//   0       4       CRC-32C of bytes 4 through the end of the record,
+//                   little-endian.
+//   4       2       The length, in bytes, of the flag, from 1 to
+//                   NAME_MAX, little-endian.
+//   6       1       The state, zero for off or one for on.
+//   7       1       Reserved, zero.
+//   8       length  The flag, without a null terminator.
+//
+// A record that is incomplete or fails its checksum, such as one
+// torn by a crash mid-append, ends the log; it and anything after it
+// are discarded by the next writer.
+
+static constexpr char   kChkconfigStateLogMagic[]          = { 'C', 'H', 'K', 'C', 'L', 'O', 'G', '1' };
+static constexpr size_t kChkconfigStateLogHeaderSize       = sizeof (kChkconfigStateLogMagic);
+static constexpr size_t kChkconfigStateLogRecordHeaderSize = 8;
+static constexpr size_t kChkconfigStateLogCompactRecords   = 1024;
+static constexpr size_t kChkconfigStateLogCompactRatio     = 2;
+
+/**
+ *  @brief
+ *    The lookup table for a bytewise CRC-32C (Castagnoli).
+ *
+ *  @private
+ *
+ */
+struct chkconfigChecksumTable
+{
+    chkconfigChecksumTable(void)
+    {
+        for (uint32_t lByte = 0; lByte < 256; lByte++)
+        {
+            uint32_t lValue = lByte;
+
+            for (size_t lBit = 0; lBit < 8; lBit++)
+            {
+                lValue = ((lValue & 1) ? ((lValue >> 1) ^ 0x82F63B78) : (lValue >> 1));
+            }
+
+            m_entries[lByte] = lValue;
+        }
+    }
+
+    uint32_t m_entries[256]; //!< The remainder for each byte value.
+};
+
+static uint32_t chkconfigChecksum(const uint8_t *inData, const size_t &inSize)
+{
+    static const chkconfigChecksumTable sTable;
+    uint32_t                            lChecksum = 0xFFFFFFFF;
+
+    for (size_t lIndex = 0; lIndex < inSize; lIndex++)
+    {
+        lChecksum = (sTable.m_entries[(lChecksum ^ inData[lIndex]) & 0xFF] ^ (lChecksum >> 8));
+    }
+
+    return (~lChecksum);
+}
+
+static void chkconfigStateLogReset(chkconfig_state_log_t &inLog)
+{
+    chkconfigFlagStateTableDestroy(inLog.m_index.m_table);
+
+    if (inLog.m_index.m_slots != nullptr)
+    {
+        memset(inLog.m_index.m_slots, 0, inLog.m_index.m_slot_count * sizeof (uint32_t));
+    }
+
+    inLog.m_size    = 0;
+    inLog.m_records = 0;
+}
+
+static void chkconfigStateLogClose(chkconfig_state_log_t &inLog)
+{
+    int lStatus;
+
+    if (inLog.m_descriptor != -1)
+    {
+        lStatus = close(inLog.m_descriptor);
+        nlVERIFY(lStatus == 0);
+
+        inLog.m_descriptor = -1;
+    }
+
+    chkconfigStateLogReset(inLog);
+}
+
+/**
+ *  @brief
+ *    Append the encoding of a flag state log record to a buffer.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogRecordAppend(uint8_t *&inBuffer,
+                                                        size_t &inBufferSize,
+                                                        size_t &inBufferUsed,
+                                                        const char *inFlag,
+                                                        const size_t &inLength,
+                                                        const chkconfig_state_t &inState)
+{
+    const size_t       lSize   = (kChkconfigStateLogRecordHeaderSize + inLength);
+    size_t             lBufferSize;
+    uint8_t *          lRecord;
+    uint32_t           lChecksum;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    if ((inBufferUsed + lSize) > inBufferSize)
+    {
+        lBufferSize = ((inBufferSize == 0) ? PATH_MAX : inBufferSize);
+
+        while ((inBufferUsed + lSize) > lBufferSize)
+        {
+            lBufferSize *= 2;
+        }
+
+        lRetval = chkconfigReallocate(inBuffer, lBufferSize);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        inBufferSize = lBufferSize;
+    }
+
+    lRecord = &inBuffer[inBufferUsed];
+
+    lRecord[4] = static_cast<uint8_t>(inLength & 0xFF);
+    lRecord[5] = static_cast<uint8_t>((inLength >> 8) & 0xFF);
+    lRecord[6] = static_cast<uint8_t>(inState ? 1 : 0);
+    lRecord[7] = 0;
+
+    memcpy(&lRecord[kChkconfigStateLogRecordHeaderSize], inFlag, inLength);
+
+    lChecksum  = chkconfigChecksum(&lRecord[4], lSize - 4);
+
+    lRecord[0] = static_cast<uint8_t>(lChecksum & 0xFF);
+    lRecord[1] = static_cast<uint8_t>((lChecksum >> 8) & 0xFF);
+    lRecord[2] = static_cast<uint8_t>((lChecksum >> 16) & 0xFF);
+    lRecord[3] = static_cast<uint8_t>((lChecksum >> 24) & 0xFF);
+
+    inBufferUsed += lSize;
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Index the valid records at the start of a buffer read from a
+ *    flag state log.
+ *
+ *  Indexing stops at the end of the buffer or at the first record
+ *  that is incomplete or invalid, whichever comes first.
+ *
+ *  @param[in,out]  inLog        A reference to the log to index the
+ *                               records in.
+ *  @param[in]      inData       A pointer to the records.
+ *  @param[in]      inSize       The size, in bytes, of @a inData.
+ *  @param[out]     outConsumed  A reference to storage by which to
+ *                               return the size, in bytes, of the
+ *                               valid records indexed.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for a flag.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogScan(chkconfig_state_log_t &inLog,
+                                                const uint8_t *inData,
+                                                const size_t &inSize,
+                                                size_t &outConsumed)
+{
+    const uint8_t *    lRecord;
+    size_t             lLength;
+    uint32_t           lChecksum;
+    char               lFlag[NAME_MAX + 1];
+    size_t             lConsumed = 0;
+    chkconfig_status_t lRetval   = CHKCONFIG_STATUS_SUCCESS;
+
+    while ((inSize - lConsumed) >= kChkconfigStateLogRecordHeaderSize)
+    {
+        lRecord   = &inData[lConsumed];
+        lLength   = (static_cast<size_t>(lRecord[4]) | (static_cast<size_t>(lRecord[5]) << 8));
+        lChecksum = (static_cast<uint32_t>(lRecord[0])         |
+                     (static_cast<uint32_t>(lRecord[1]) << 8)  |
+                     (static_cast<uint32_t>(lRecord[2]) << 16) |
+                     (static_cast<uint32_t>(lRecord[3]) << 24));
+
+        if ((lLength == 0) || (lLength > NAME_MAX) || (lRecord[6] > 1) || (lRecord[7] != 0))
+        {
+            break;
+        }
+
+        if ((inSize - lConsumed - kChkconfigStateLogRecordHeaderSize) < lLength)
+        {
+            break;
+        }
+
+        if (chkconfigChecksum(&lRecord[4], kChkconfigStateLogRecordHeaderSize - 4 + lLength) != lChecksum)
+        {
+            break;
+        }
+
+        memcpy(lFlag, &lRecord[kChkconfigStateLogRecordHeaderSize], lLength);
+        lFlag[lLength] = '\0';
+
+        if (strlen(lFlag) != lLength)
+        {
+            break;
+        }
+
+        lRetval = chkconfigFlagIndexSet(inLog.m_index, lFlag, lLength, (lRecord[6] != 0));
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        inLog.m_records++;
+
+        lConsumed += (kChkconfigStateLogRecordHeaderSize + lLength);
+    }
+
+ done:
+    outConsumed = lConsumed;
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateLogReadAt(const int &inDescriptor,
+                                                  uint8_t *outData,
+                                                  const size_t &inSize,
+                                                  const off_t &inOffset)
+{
+    ssize_t            lResult;
+    size_t             lRead   = 0;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    while (lRead < inSize)
+    {
+        lResult = pread(inDescriptor, &outData[lRead], inSize - lRead, inOffset + static_cast<off_t>(lRead));
+        nlREQUIRE_ACTION((lResult != -1) || (errno == EINTR), done, lRetval = -errno);
+        nlREQUIRE_ACTION(lResult != 0, done, lRetval = -EIO);
+
+        if (lResult > 0)
+        {
+            lRead += static_cast<size_t>(lResult);
+        }
+    }
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateLogWriteAt(const int &inDescriptor,
+                                                   const uint8_t *inData,
+                                                   const size_t &inSize,
+                                                   const off_t &inOffset)
+{
+    ssize_t            lResult;
+    size_t             lWritten = 0;
+    chkconfig_status_t lRetval  = CHKCONFIG_STATUS_SUCCESS;
+
+    while (lWritten < inSize)
+    {
+        lResult = pwrite(inDescriptor, &inData[lWritten], inSize - lWritten, inOffset + static_cast<off_t>(lWritten));
+        nlREQUIRE_ACTION((lResult != -1) || (errno == EINTR), done, lRetval = -errno);
+
+        if (lResult > 0)
+        {
+            lWritten += static_cast<size_t>(lResult);
+        }
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Index any records appended to a flag state log file since it
+ *    was last indexed.
+ *
+ *  @note
+ *    The caller must hold the log lock.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EILSEQ                   If the file is not a flag
+ *                                     state log.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the index.
+ *  @retval  -errno                    If the file could not be read.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogRead(chkconfig_state_log_t &inLog)
+{
+    struct stat        lMetadata;
+    uint8_t            lHeader[kChkconfigStateLogHeaderSize];
+    uint8_t *          lData   = nullptr;
+    size_t             lSize;
+    size_t             lConsumed;
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lStatus = fstat(inLog.m_descriptor, &lMetadata);
+    nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+    // A file shorter than what has been indexed was truncated by
+    // something other than a writer of the log; start over.
+
+    if (lMetadata.st_size < inLog.m_size)
+    {
+        chkconfigStateLogReset(inLog);
+    }
+
+    // An empty file, or one with a header still being written, is an
+    // empty log.
+
+    if (inLog.m_size == 0)
+    {
+        nlEXPECT(lMetadata.st_size >= static_cast<off_t>(kChkconfigStateLogHeaderSize), done);
+
+        lRetval = chkconfigStateLogReadAt(inLog.m_descriptor, lHeader, sizeof (lHeader), 0);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        nlREQUIRE_ACTION(memcmp(lHeader, kChkconfigStateLogMagic, sizeof (lHeader)) == 0,
+                         done,
+                         lRetval = -EILSEQ);
+
+        inLog.m_size = static_cast<off_t>(kChkconfigStateLogHeaderSize);
+    }
+
+    nlEXPECT(lMetadata.st_size > inLog.m_size, done);
+
+    lSize = static_cast<size_t>(lMetadata.st_size - inLog.m_size);
+
+    lData = static_cast<uint8_t *>(malloc(lSize));
+    nlREQUIRE_ACTION(lData != nullptr, done, lRetval = -ENOMEM);
+
+    lRetval = chkconfigStateLogReadAt(inLog.m_descriptor, lData, lSize, inLog.m_size);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfigStateLogScan(inLog, lData, lSize, lConsumed);
+
+    inLog.m_size += static_cast<off_t>(lConsumed);
+
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    free(lData);
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Bring a flag state log index up to date with its file.
+ *
+ *  The file is opened, and fully indexed, on first use and again
+ *  whenever the path no longer names the file open, as after
+ *  another process compacts the log. Otherwise, only records
+ *  appended since the last refresh are read.
+ *
+ *  @note
+ *    The caller must hold the log lock.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EILSEQ                   If the file is not a flag
+ *                                     state log.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the index.
+ *  @retval  -errno                    If the file could not be
+ *                                     opened or read.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogRefresh(chkconfig_state_log_t &inLog)
+{
+    struct stat        lMetadata;
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    if (inLog.m_descriptor != -1)
+    {
+        lStatus = stat(inLog.m_path, &lMetadata);
+        nlREQUIRE_ACTION((lStatus == 0) || (errno == ENOENT), done, lRetval = -errno);
+
+        if ((lStatus != 0) ||
+            (lMetadata.st_dev != inLog.m_device) ||
+            (lMetadata.st_ino != inLog.m_inode))
+        {
+            chkconfigStateLogClose(inLog);
+        }
+    }
+
+    if (inLog.m_descriptor == -1)
+    {
+        // Prefer to open the log for writing, creating it if need be,
+        // but settle for observing it where that is not permitted.
+
+        inLog.m_descriptor = open(inLog.m_path, (O_RDWR | O_CREAT | O_CLOEXEC), DEFFILEMODE);
+        inLog.m_writable   = (inLog.m_descriptor != -1);
+
+        if ((inLog.m_descriptor == -1) && ((errno == EACCES) || (errno == EROFS)))
+        {
+            inLog.m_descriptor = open(inLog.m_path, (O_RDONLY | O_CLOEXEC));
+        }
+
+        // A log that does not exist and cannot be created is, for
+        // observation, simply empty.
+
+        nlEXPECT_ACTION(inLog.m_descriptor != -1,
+                        done,
+                        if (errno != ENOENT)
+                        {
+                            lRetval = -errno;
+                        });
+
+        lStatus = fstat(inLog.m_descriptor, &lMetadata);
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno; chkconfigStateLogClose(inLog));
+
+        inLog.m_device = lMetadata.st_dev;
+        inLog.m_inode  = lMetadata.st_ino;
+    }
+
+    lRetval = chkconfigStateLogRead(inLog);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Acquire exclusive write access to a flag state log file, among
+ *    all processes, and bring its index up to date.
+ *
+ *  Any incomplete or invalid record at the end of the file, such as
+ *  one torn by a crash, is truncated away and, if the file is empty,
+ *  the header is written.
+ *
+ *  @note
+ *    The caller must hold the log lock.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOENT                   If the log could not be
+ *                                     created.
+ *  @retval  -EACCES                   If the log could not be opened
+ *                                     for writing.
+ *  @retval  -errno                    If the log could not be
+ *                                     locked, read, or repaired.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogLock(chkconfig_state_log_t &inLog)
+{
+    struct stat        lMetadata;
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    while (true)
+    {
+        lRetval = chkconfigStateLogRefresh(inLog);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        nlREQUIRE_ACTION(inLog.m_writable,
+                         done,
+                         lRetval = ((inLog.m_descriptor == -1) ? -ENOENT : -EACCES));
+
+        do {
+            lStatus = flock(inLog.m_descriptor, LOCK_EX);
+        } while ((lStatus == -1) && (errno == EINTR));
+
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+        // If another process replaced the file while this one waited
+        // for the lock, start over with the replacement.
+
+        lStatus = stat(inLog.m_path, &lMetadata);
+
+        if ((lStatus == 0) &&
+            (lMetadata.st_dev == inLog.m_device) &&
+            (lMetadata.st_ino == inLog.m_inode))
+        {
+            break;
+        }
+
+        chkconfigStateLogClose(inLog);
+    }
+
+    lRetval = chkconfigStateLogRead(inLog);
+    nlREQUIRE_SUCCESS(lRetval, unlock);
+
+    lStatus = fstat(inLog.m_descriptor, &lMetadata);
+    nlREQUIRE_ACTION(lStatus == 0, unlock, lRetval = -errno);
+
+    if (lMetadata.st_size > inLog.m_size)
+    {
+        lStatus = ftruncate(inLog.m_descriptor, inLog.m_size);
+        nlREQUIRE_ACTION(lStatus == 0, unlock, lRetval = -errno);
+    }
+
+    if (inLog.m_size == 0)
+    {
+        lRetval = chkconfigStateLogWriteAt(inLog.m_descriptor,
+                                           reinterpret_cast<const uint8_t *>(kChkconfigStateLogMagic),
+                                           kChkconfigStateLogHeaderSize,
+                                           0);
+        nlREQUIRE_SUCCESS(lRetval, unlock);
+
+        inLog.m_size = static_cast<off_t>(kChkconfigStateLogHeaderSize);
+    }
+
+    goto done;
+
+ unlock:
+    flock(inLog.m_descriptor, LOCK_UN);
+
+ done:
+    return (lRetval);
+}
+
+static void chkconfigStateLogUnlock(chkconfig_state_log_t &inLog)
+{
+    if (inLog.m_descriptor != -1)
+    {
+        flock(inLog.m_descriptor, LOCK_UN);
+    }
+}
+
+/**
+ *  @brief
+ *    Compact a flag state log file to one record per flag.
+ *
+ *  The compacted log is written to a temporary file alongside the
+ *  log, flushed to stable storage, and renamed over it, such that a
+ *  crash at any point leaves either the old or the new log intact.
+ *  Other processes notice the replacement on their next refresh.
+ *
+ *  @note
+ *    The caller must hold the log lock and write access to the log
+ *    file, which the replacement leaves released.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the compacted
+ *                                     log.
+ *  @retval  -errno                    If the compacted log could not
+ *                                     be written or renamed.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogCompact(chkconfig_state_log_t &inLog)
+{
+    char               lPath[PATH_MAX];
+    int                lDescriptor  = -1;
+    uint8_t *          lBuffer      = nullptr;
+    size_t             lBufferSize  = 0;
+    size_t             lBufferUsed  = 0;
+    const char *       lFlag;
+    struct stat        lMetadata;
+    int                lStatus;
+    chkconfig_status_t lRetval      = CHKCONFIG_STATUS_SUCCESS;
+
+    lStatus = snprintf(lPath, sizeof (lPath), "%s.XXXXXX", inLog.m_path);
+    nlREQUIRE_ACTION((lStatus > 0) && (static_cast<size_t>(lStatus) < sizeof (lPath)),
+                     done,
+                     lRetval = -EOVERFLOW);
+
+    lRetval = chkconfigReallocate(lBuffer, kChkconfigStateLogHeaderSize);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lBufferSize = kChkconfigStateLogHeaderSize;
+    lBufferUsed = kChkconfigStateLogHeaderSize;
+
+    memcpy(lBuffer, kChkconfigStateLogMagic, kChkconfigStateLogHeaderSize);
+
+    for (size_t lIndex = 0; lIndex < inLog.m_index.m_table.m_count; lIndex++)
+    {
+        lFlag = chkconfigFlagStateTableGetFlag(inLog.m_index.m_table, lIndex);
+
+        lRetval = chkconfigStateLogRecordAppend(lBuffer,
+                                                lBufferSize,
+                                                lBufferUsed,
+                                                lFlag,
+                                                strlen(lFlag),
+                                                chkconfigFlagStateTableGetState(inLog.m_index.m_table, lIndex));
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    lDescriptor = mkstemp(lPath);
+    nlREQUIRE_ACTION(lDescriptor != -1, done, lRetval = -errno);
+
+    // Carry the permissions of the log over to its replacement,
+    // rather than those mkstemp(3) creates it with.
+
+    lStatus = fstat(inLog.m_descriptor, &lMetadata);
+    nlREQUIRE_ACTION(lStatus == 0, unlink, lRetval = -errno);
+
+    lStatus = fchmod(lDescriptor, (lMetadata.st_mode & ALLPERMS));
+    nlREQUIRE_ACTION(lStatus == 0, unlink, lRetval = -errno);
+
+    lRetval = chkconfigStateLogWriteAt(lDescriptor, lBuffer, lBufferUsed, 0);
+    nlREQUIRE_SUCCESS(lRetval, unlink);
+
+    lStatus = fsync(lDescriptor);
+    nlREQUIRE_ACTION(lStatus == 0, unlink, lRetval = -errno);
+
+    lStatus = rename(lPath, inLog.m_path);
+    nlREQUIRE_ACTION(lStatus == 0, unlink, lRetval = -errno);
+
+    lStatus = fstat(lDescriptor, &lMetadata);
+    nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+    // Closing the replaced file releases the lock on it, waking any
+    // other process waiting to append to it, which will then find
+    // it replaced.
+
+    lStatus = close(inLog.m_descriptor);
+    nlVERIFY(lStatus == 0);
+
+    inLog.m_descriptor = lDescriptor;
+    inLog.m_device     = lMetadata.st_dev;
+    inLog.m_inode      = lMetadata.st_ino;
+    inLog.m_size       = static_cast<off_t>(lBufferUsed);
+    inLog.m_records    = inLog.m_index.m_table.m_count;
+
+    lDescriptor        = -1;
+
+    goto done;
+
+ unlink:
+    lStatus = unlink(lPath);
+    nlVERIFY(lStatus == 0);
+
+ done:
+    if (lDescriptor != -1)
+    {
+        lStatus = close(lDescriptor);
+        nlVERIFY(lStatus == 0);
+    }
+
+    free(lBuffer);
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the states of flags from a flag state log.
+ *
+ *  This has the same semantics as getting the flags from a directory
+ *  store, but with a single refresh of, and then in-memory lookups
+ *  in, the log index.
+ *
+ *  @param[in]      inLog              A reference to the log.
+ *  @param[in,out]  inFlagStateTuples  A pointer to the flag/state
+ *                                     tuples to get.
+ *  @param[in]      inCount            The number of flag/state
+ *                                     tuples.
+ *  @param[out]     outStatuses        An optional pointer to storage
+ *                                     for @a inCount statuses by
+ *                                     which to return the status of
+ *                                     getting each flag. Without it,
+ *                                     no flag after the first failure
+ *                                     is gotten.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If a flag was null or empty.
+ *  @retval  -ENAMETOOLONG             If a flag was too long.
+ *  @retval  -errno                    If the log could not be read.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogGet(chkconfig_state_log_t &inLog,
+                                               chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                               const size_t &inCount,
+                                               chkconfig_status_t *outStatuses)
+{
+    size_t             lLength;
+    size_t             lSlot;
+    chkconfig_status_t lFlagStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inLog.m_lock.lock();
+
+    lRetval = chkconfigStateLogRefresh(inLog);
+
+    for (size_t lIndex = 0; (lRetval < CHKCONFIG_STATUS_SUCCESS) && (outStatuses != nullptr) && (lIndex < inCount); lIndex++)
+    {
+        outStatuses[lIndex] = lRetval;
+    }
+
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+        lFlagStatus = chkconfigFlagIndexCheck(lTuple.m_flag, lLength);
+
+        if (lFlagStatus != CHKCONFIG_STATUS_SUCCESS)
+        {
+            if (lRetval == CHKCONFIG_STATUS_SUCCESS)
+            {
+                lRetval = lFlagStatus;
+            }
+        }
+        else if (chkconfigFlagIndexLookup(inLog.m_index, lTuple.m_flag, lLength, lSlot))
+        {
+            lTuple.m_state  = chkconfigFlagStateTableGetState(inLog.m_index.m_table, inLog.m_index.m_slots[lSlot] - 1);
+            lTuple.m_origin = CHKCONFIG_ORIGIN_STATE;
+        }
+        else
+        {
+            lTuple.m_state  = false;
+            lTuple.m_origin = CHKCONFIG_ORIGIN_NONE;
+        }
+
+        if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lFlagStatus;
+        }
+
+        if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && (outStatuses == nullptr))
+        {
+            break;
+        }
+    }
+
+ done:
+    inLog.m_lock.unlock();
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Set the states of flags in a flag state log.
+ *
+ *  This has the same semantics as setting the flags in the state
+ *  directory: a flag not already in the log is added only if
+ *  CHKCONFIG_OPTION_FORCE_STATE is asserted. However, the records
+ *  for all of the flags are appended with a single write and, if
+ *  CHKCONFIG_OPTION_SYNC_STATE is asserted, a single flush, and
+ *  none is appended for a flag already in the requested state.
+ *
+ *  Once the log holds more than twice as many records as flags, it
+ *  is compacted.
+ *
+ *  @param[in]   inLog              A reference to the log.
+ *  @param[in]   inOptions          A reference to the library
+ *                                  runtime options snapshot.
+ *  @param[in]   inFlagStateTuples  A pointer to the flag/state
+ *                                  tuples to set.
+ *  @param[in]   inCount            The number of flag/state tuples.
+ *  @param[out]  outStatuses        An optional pointer to storage
+ *                                  for @a inCount statuses by which
+ *                                  to return the status of setting
+ *                                  each flag. Without it, no flag
+ *                                  after the first failure is set.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    The status of the first flag
+ *                                     that could not be set or the
+ *                                     error writing the log.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogSet(chkconfig_state_log_t &inLog,
+                                               const chkconfig_options_t &inOptions,
+                                               const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                               const size_t &inCount,
+                                               chkconfig_status_t *outStatuses)
+{
+    uint8_t *          lBuffer     = nullptr;
+    size_t             lBufferSize = 0;
+    size_t             lBufferUsed = 0;
+    size_t             lLength;
+    size_t             lSlot;
+    bool               lFound;
+    int                lStatus;
+    chkconfig_status_t lFlagStatus;
+    chkconfig_status_t lRetval     = CHKCONFIG_STATUS_SUCCESS;
+
+    inLog.m_lock.lock();
+
+    lRetval = chkconfigStateLogLock(inLog);
+
+    for (size_t lIndex = 0; (lRetval < CHKCONFIG_STATUS_SUCCESS) && (outStatuses != nullptr) && (lIndex < inCount); lIndex++)
+    {
+        outStatuses[lIndex] = lRetval;
+    }
+
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // Encode a record for each flag and index it immediately, such
+    // that a later tuple for the same flag sees it.
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        const chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+        lFlagStatus = chkconfigFlagIndexCheck(lTuple.m_flag, lLength);
+
+        if (lFlagStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            lFound = chkconfigFlagIndexLookup(inLog.m_index, lTuple.m_flag, lLength, lSlot);
+
+            if (!lFound && !inOptions.m_force_state)
+            {
+                lFlagStatus = -ENOENT;
+            }
+            else if (!lFound ||
+                     (chkconfigFlagStateTableGetState(inLog.m_index.m_table, inLog.m_index.m_slots[lSlot] - 1) != lTuple.m_state))
+            {
+                lFlagStatus = chkconfigStateLogRecordAppend(lBuffer,
+                                                            lBufferSize,
+                                                            lBufferUsed,
+                                                            lTuple.m_flag,
+                                                            lLength,
+                                                            lTuple.m_state);
+
+                if (lFlagStatus == CHKCONFIG_STATUS_SUCCESS)
+                {
+                    lFlagStatus = chkconfigFlagIndexSet(inLog.m_index, lTuple.m_flag, lLength, lTuple.m_state);
+                }
+
+                if (lFlagStatus == CHKCONFIG_STATUS_SUCCESS)
+                {
+                    inLog.m_records++;
+                }
+            }
+        }
+
+        if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lFlagStatus;
+        }
+
+        if ((lFlagStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+        {
+            lRetval = lFlagStatus;
+        }
+
+        if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && (outStatuses == nullptr))
+        {
+            break;
+        }
+    }
+
+    // Append the records for the flags that were set.
+
+    if (lBufferUsed > 0)
+    {
+        lFlagStatus = chkconfigStateLogWriteAt(inLog.m_descriptor, lBuffer, lBufferUsed, inLog.m_size);
+
+        if ((lFlagStatus == CHKCONFIG_STATUS_SUCCESS) && inOptions.m_sync_state)
+        {
+            lStatus     = fdatasync(inLog.m_descriptor);
+            lFlagStatus = ((lStatus == 0) ? CHKCONFIG_STATUS_SUCCESS : -errno);
+        }
+
+        if (lFlagStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            inLog.m_size += static_cast<off_t>(lBufferUsed);
+        }
+        else
+        {
+            // The index is now ahead of the file, so discard it to be
+            // rebuilt from the file, less any torn record, on the
+            // next refresh. No flag in the batch can be relied upon
+            // to have been set.
+
+            chkconfigStateLogClose(inLog);
+
+            for (size_t lIndex = 0; (outStatuses != nullptr) && (lIndex < inCount); lIndex++)
+            {
+                if (outStatuses[lIndex] == CHKCONFIG_STATUS_SUCCESS)
+                {
+                    outStatuses[lIndex] = lFlagStatus;
+                }
+            }
+
+            lRetval = lFlagStatus;
+
+            goto done;
+        }
+    }
+
+    if ((inLog.m_records >= kChkconfigStateLogCompactRecords) &&
+        (inLog.m_records > (inLog.m_index.m_table.m_count * kChkconfigStateLogCompactRatio)))
+    {
+        // The flags are already set, so a failure to compact is not
+        // theirs; the log is simply left as it is.
+
+        lStatus = chkconfigStateLogCompact(inLog);
+        nlVERIFY_SUCCESS(lStatus);
+    }
+
+    chkconfigStateLogUnlock(inLog);
+
+ done:
+    inLog.m_lock.unlock();
+
+    free(lBuffer);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateLogCopyAll(chkconfig_state_log_t &inLog,
+                                                   const chkconfig_flag_match_t *inMatch,
+                                                   chkconfig_flag_state_table_t &outTable)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inLog.m_lock.lock();
+
+    lRetval = chkconfigStateLogRefresh(inLog);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // Only an unfiltered copy is known, up front, to need room for
+    // every indexed flag.
+
+    if (inMatch == nullptr)
+    {
+        lRetval = chkconfigFlagStateTableReserve(outTable,
+                                                 outTable.m_count + inLog.m_index.m_table.m_count,
+                                                 outTable.m_pool_used + inLog.m_index.m_table.m_pool_used);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    for (size_t lIndex = 0; lIndex < inLog.m_index.m_table.m_count; lIndex++)
+    {
+        if (!chkconfigFlagMatches(inMatch, chkconfigFlagStateTableGetFlag(inLog.m_index.m_table, lIndex)))
+        {
+            continue;
+        }
+
+        lRetval = chkconfigFlagStateTableAppend(outTable, inLog.m_index.m_table, lIndex);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    inLog.m_lock.unlock();
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateLogGetCount(chkconfig_state_log_t &inLog,
+                                                    size_t &outCount)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inLog.m_lock.lock();
+
+    lRetval = chkconfigStateLogRefresh(inLog);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    outCount = inLog.m_index.m_table.m_count;
+
+ done:
+    inLog.m_lock.unlock();
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the flag and state of a flag state log index entry.
+ *
+ *  @param[in]   inLog    A reference to the log.
+ *  @param[in]   inIndex  The index of the entry to get.
+ *  @param[out]  outFlag  A pointer to storage for at least NAME_MAX
+ *                        + 1 bytes by which to return a copy of the
+ *                        flag.
+ *  @param[out]  outState A reference to storage by which to return
+ *                        the state of the flag.
+ *
+ *  @returns
+ *    True if the index has such an entry; otherwise, false.
+ *
+ *  @private
+ *
+ */
+static bool chkconfigStateLogEntry(chkconfig_state_log_t &inLog,
+                                   const size_t &inIndex,
+                                   char *outFlag,
+                                   chkconfig_state_t &outState)
+{
+    bool lRetval;
+
+    inLog.m_lock.lock();
+
+    lRetval = (inIndex < inLog.m_index.m_table.m_count);
+
+    if (lRetval)
+    {
+        strcpy(outFlag, chkconfigFlagStateTableGetFlag(inLog.m_index.m_table, inIndex));
+
+        outState = chkconfigFlagStateTableGetState(inLog.m_index.m_table, inIndex);
+    }
+
+    inLog.m_lock.unlock();
+
+    return (lRetval);
+}
+
+static bool chkconfigStateLogContains(chkconfig_state_log_t &inLog,
+                                      const char *inFlag)
+{
+    size_t lSlot;
+    bool   lRetval;
+
+    inLog.m_lock.lock();
+
+    lRetval = chkconfigFlagIndexLookup(inLog.m_index, inFlag, strlen(inFlag), lSlot);
+
+    inLog.m_lock.unlock();
+
+    return (lRetval);
+}
+
+// MARK: Memory Stores
+
+/**
+ *  @brief
+ *    Get the states of flags from an in-memory flag store.
+ *
+ *  This has the same semantics as getting the flags from a directory
+ *  store: a flag not in the store is returned off, with no origin.
+ *
+ *  @param[in]      inStore            A reference to the store.
+ *  @param[in,out]  inFlagStateTuples  A pointer to the flag/state
+ *                                     tuples to get.
+ *  @param[in]      inCount            The number of flag/state
+ *                                     tuples.
+ *  @param[out]     outStatuses        An optional pointer to storage
+ *                                     for @a inCount statuses by
+ *                                     which to return the status of
+ *                                     each flag. If null, the first
+ *                                     failure ends the get.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If a flag was null or empty.
+ *  @retval  -ENAMETOOLONG             If a flag was too long.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigMemoryStoreGet(chkconfig_memory_store_t &inStore,
+                                                  chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                  const size_t &inCount,
+                                                  chkconfig_status_t *outStatuses)
+{
+    size_t             lLength;
+    size_t             lSlot;
+    chkconfig_status_t lFlagStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inStore.m_lock.lock();
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+        lFlagStatus = chkconfigFlagIndexCheck(lTuple.m_flag, lLength);
+
+        if (lFlagStatus != CHKCONFIG_STATUS_SUCCESS)
+        {
+            if (lRetval == CHKCONFIG_STATUS_SUCCESS)
+            {
+                lRetval = lFlagStatus;
+            }
+        }
+        else if (chkconfigFlagIndexLookup(inStore.m_index, lTuple.m_flag, lLength, lSlot))
+        {
+            lTuple.m_state  = chkconfigFlagStateTableGetState(inStore.m_index.m_table, inStore.m_index.m_slots[lSlot] - 1);
+            lTuple.m_origin = CHKCONFIG_ORIGIN_STATE;
+        }
+        else
+        {
+            lTuple.m_state  = false;
+            lTuple.m_origin = CHKCONFIG_ORIGIN_NONE;
+        }
+
+        if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lFlagStatus;
+        }
+
+        if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && (outStatuses == nullptr))
+        {
+            break;
+        }
+    }
+
+    inStore.m_lock.unlock();
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Set the states of flags in an in-memory flag store.
+ *
+ *  This has the same semantics as setting the flags in a directory
+ *  store: a flag not already in the store is added only if
+ *  CHKCONFIG_OPTION_FORCE_STATE is asserted.
+ *
+ *  @param[in]   inStore            A reference to the store.
+ *  @param[in]   inOptions          A reference to the library
+ *                                  runtime options snapshot.
+ *  @param[in]   inFlagStateTuples  A pointer to the flag/state tuples
+ *                                  to set.
+ *  @param[in]   inCount            The number of flag/state tuples.
+ *  @param[out]  outStatuses        An optional pointer to storage for
+ *                                  @a inCount statuses by which to
+ *                                  return the status of each flag.
+ *                                  If null, the first failure ends
+ *                                  the set.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If a flag was null or empty.
+ *  @retval  -ENAMETOOLONG             If a flag was too long.
+ *  @retval  -ENOENT                   If a flag was not in the store
+ *                                     and CHKCONFIG_OPTION_FORCE_STATE
+ *                                     was not asserted.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for a flag.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigMemoryStoreSet(chkconfig_memory_store_t &inStore,
+                                                  const chkconfig_options_t &inOptions,
+                                                  const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                  const size_t &inCount,
+                                                  chkconfig_status_t *outStatuses)
+{
+    size_t             lLength;
+    size_t             lSlot;
+    chkconfig_status_t lFlagStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inStore.m_lock.lock();
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        const chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+        lFlagStatus = chkconfigFlagIndexCheck(lTuple.m_flag, lLength);
+
+        if (lFlagStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            if (!chkconfigFlagIndexLookup(inStore.m_index, lTuple.m_flag, lLength, lSlot) && !inOptions.m_force_state)
+            {
+                lFlagStatus = -ENOENT;
+            }
+            else
+            {
+                lFlagStatus = chkconfigFlagIndexSet(inStore.m_index, lTuple.m_flag, lLength, lTuple.m_state);
+            }
+        }
+
+        if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lFlagStatus;
+        }
+
+        if ((lFlagStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+        {
+            lRetval = lFlagStatus;
+        }
+
+        if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && (outStatuses == nullptr))
+        {
+            break;
+        }
+    }
+
+    inStore.m_lock.unlock();
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigMemoryStoreCopyAll(chkconfig_memory_store_t &inStore,
+                                                      const chkconfig_flag_match_t *inMatch,
+                                                      chkconfig_flag_state_table_t &outTable)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    inStore.m_lock.lock();
+
+    // Only an unfiltered copy is known, up front, to need room for
+    // every indexed flag.
+
+    if (inMatch == nullptr)
+    {
+        lRetval = chkconfigFlagStateTableReserve(outTable,
+                                                 outTable.m_count + inStore.m_index.m_table.m_count,
+                                                 outTable.m_pool_used + inStore.m_index.m_table.m_pool_used);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    for (size_t lIndex = 0; lIndex < inStore.m_index.m_table.m_count; lIndex++)
+    {
+        if (!chkconfigFlagMatches(inMatch, chkconfigFlagStateTableGetFlag(inStore.m_index.m_table, lIndex)))
+        {
+            continue;
+        }
+
+        lRetval = chkconfigFlagStateTableAppend(outTable, inStore.m_index.m_table, lIndex);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    inStore.m_lock.unlock();
+
+    return (lRetval);
+}
+
+static size_t chkconfigMemoryStoreGetCount(chkconfig_memory_store_t &inStore)
+{
+    size_t lRetval;
+
+    inStore.m_lock.lock();
+
+    lRetval = inStore.m_index.m_table.m_count;
+
+    inStore.m_lock.unlock();
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the flag and state of an in-memory flag store entry.
+ *
+ *  @param[in]   inStore  A reference to the store.
+ *  @param[in]   inIndex  The index of the entry to get.
+ *  @param[out]  outFlag  A pointer to storage for at least NAME_MAX
+ *                        + 1 bytes by which to return a copy of the
+ *                        flag.
+ *  @param[out]  outState A reference to storage by which to return
+ *                        the state of the flag.
+ *
+ *  @returns
+ *    True if the store has such an entry; otherwise, false.
+ *
+ *  @private
+ *
+ */
+static bool chkconfigMemoryStoreEntry(chkconfig_memory_store_t &inStore,
+                                      const size_t &inIndex,
+                                      char *outFlag,
+                                      chkconfig_state_t &outState)
+{
+    bool lRetval;
+
+    inStore.m_lock.lock();
+
+    lRetval = (inIndex < inStore.m_index.m_table.m_count);
+
+    if (lRetval)
+    {
+        strcpy(outFlag, chkconfigFlagStateTableGetFlag(inStore.m_index.m_table, inIndex));
+
+        outState = chkconfigFlagStateTableGetState(inStore.m_index.m_table, inIndex);
+    }
+
+    inStore.m_lock.unlock();
+
+    return (lRetval);
+}
+
+static bool chkconfigMemoryStoreContains(chkconfig_memory_store_t &inStore,
+                                         const char *inFlag)
+{
+    size_t lSlot;
+    bool   lRetval;
+
+    inStore.m_lock.lock();
+
+    lRetval = chkconfigFlagIndexLookup(inStore.m_index, inFlag, strlen(inFlag), lSlot);
+
+    inStore.m_lock.unlock();
+
+    return (lRetval);
+}
+
+#if CHKCONFIG_HAVE_IO_URING
+// MARK: Batched I/O
+
+/**
+ *  The io_uring operations that make up the linked read or write of
+ *  a flag backing file, encoded in the low bits of each submission's
+ *  user data, above which is the index of the file in its batch.
+ *
+ */
+enum
+{
+    kChkconfigIoOperationOpen     = 0,
+    kChkconfigIoOperationTransfer = 1,
+    kChkconfigIoOperationSync     = 2,
+    kChkconfigIoOperationClose    = 3,
+
+    kChkconfigIoOperationsPerFile = 4,
+    kChkconfigIoOperationShift    = 2,
+    kChkconfigIoOperationMask     = ((1 << kChkconfigIoOperationShift) - 1)
+};
+
+/**
+ *  @brief
+ *    Destroy an io_uring submission and completion queue pair.
+ *
+ *  This unmaps the ring memory and closes the ring, which also closes
+ *  any direct file descriptors the ring still holds.
+ *
+ *  @param[in,out]  inRing  A reference to the ring to destroy.
+ *
+ *  @private
+ *
+ */
+static void chkconfigIoRingDestroy(chkconfig_io_ring_t &inRing)
+{
+    if (inRing.m_sqes != MAP_FAILED)
+    {
+        munmap(inRing.m_sqes, inRing.m_sqes_size);
+        inRing.m_sqes = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+    }
+
+    if ((inRing.m_cq_ring != MAP_FAILED) && (inRing.m_cq_ring != inRing.m_sq_ring))
+    {
+        munmap(inRing.m_cq_ring, inRing.m_cq_ring_size);
+    }
+
+    inRing.m_cq_ring = static_cast<uint8_t *>(MAP_FAILED);
+
+    if (inRing.m_sq_ring != MAP_FAILED)
+    {
+        munmap(inRing.m_sq_ring, inRing.m_sq_ring_size);
+        inRing.m_sq_ring = static_cast<uint8_t *>(MAP_FAILED);
+    }
+
+    if (inRing.m_descriptor != -1)
+    {
+        close(inRing.m_descriptor);
+        inRing.m_descriptor = -1;
+    }
+}
+
+/**
+ *  @brief
+ *    Initialize an io_uring submission and completion queue pair.
+ *
+ *  This sets up a ring with at least the specified number of
+ *  submission queue entries and registers a sparse table of the
+ *  specified number of direct file descriptors, such that linked
+ *  open, read, and close operations may refer to a file opened
+ *  earlier in the same submission.
+ *
+ *  Failure here is not fatal to callers: the kernel may predate
+ *  io_uring or the features required of it, or io_uring may be
+ *  disabled by policy, in which case callers fall back to
+ *  synchronous I/O.
+ *
+ *  @param[out]  outRing     A reference to the ring to initialize.
+ *  @param[in]   inEntries   The minimum number of submission queue
+ *                           entries.
+ *  @param[in]   inFiles     The number of direct file descriptors
+ *                           to register.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If the ring could not be set
+ *                                     up, mapped, or registered.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigIoRingInit(chkconfig_io_ring_t &outRing,
+                                              const size_t &inEntries,
+                                              const size_t &inFiles)
+{
+    struct io_uring_params        lParameters;
+    struct io_uring_rsrc_register lRegister;
+    long                          lStatus;
+    chkconfig_status_t            lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    outRing.m_descriptor = -1;
+    outRing.m_sq_ring    = static_cast<uint8_t *>(MAP_FAILED);
+    outRing.m_cq_ring    = static_cast<uint8_t *>(MAP_FAILED);
+    outRing.m_sqes       = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+
+    memset(&lParameters, 0, sizeof (lParameters));
+
+    lStatus = syscall(__NR_io_uring_setup, static_cast<unsigned>(inEntries), &lParameters);
+    nlEXPECT_ACTION(lStatus >= 0, done, lRetval = -errno);
+
+    outRing.m_descriptor   = static_cast<int>(lStatus);
+
+    // Map the submission and completion queue rings, which the
+    // kernel may allow to share a single mapping.
+
+    outRing.m_sq_ring_size = (lParameters.sq_off.array + (lParameters.sq_entries * sizeof (unsigned)));
+    outRing.m_cq_ring_size = (lParameters.cq_off.cqes  + (lParameters.cq_entries * sizeof (struct io_uring_cqe)));
+
+    if (lParameters.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (outRing.m_cq_ring_size > outRing.m_sq_ring_size)
+        {
+            outRing.m_sq_ring_size = outRing.m_cq_ring_size;
+        }
+
+        outRing.m_cq_ring_size = outRing.m_sq_ring_size;
+    }
+
+    outRing.m_sq_ring = static_cast<uint8_t *>(mmap(nullptr,
+                                                    outRing.m_sq_ring_size,
+                                                    PROT_READ | PROT_WRITE,
+                                                    MAP_SHARED | MAP_POPULATE,
+                                                    outRing.m_descriptor,
+                                                    IORING_OFF_SQ_RING));
+    nlREQUIRE_ACTION(outRing.m_sq_ring != MAP_FAILED, done, lRetval = -errno);
+
+    if (lParameters.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        outRing.m_cq_ring = outRing.m_sq_ring;
+    }
+    else
+    {
+        outRing.m_cq_ring = static_cast<uint8_t *>(mmap(nullptr,
+                                                        outRing.m_cq_ring_size,
+                                                        PROT_READ | PROT_WRITE,
+                                                        MAP_SHARED | MAP_POPULATE,
+                                                        outRing.m_descriptor,
+                                                        IORING_OFF_CQ_RING));
+        nlREQUIRE_ACTION(outRing.m_cq_ring != MAP_FAILED, done, lRetval = -errno);
+    }
+
+    outRing.m_sqes_size = (lParameters.sq_entries * sizeof (struct io_uring_sqe));
+    outRing.m_sqes      = static_cast<struct io_uring_sqe *>(mmap(nullptr,
+                                                                  outRing.m_sqes_size,
+                                                                  PROT_READ | PROT_WRITE,
+                                                                  MAP_SHARED | MAP_POPULATE,
+                                                                  outRing.m_descriptor,
+                                                                  IORING_OFF_SQES));
+    nlREQUIRE_ACTION(outRing.m_sqes != MAP_FAILED, done, lRetval = -errno);
+
+    outRing.m_sq_tail = reinterpret_cast<unsigned *>(outRing.m_sq_ring + lParameters.sq_off.tail);
+    outRing.m_sq_mask = *reinterpret_cast<unsigned *>(outRing.m_sq_ring + lParameters.sq_off.ring_mask);
+    outRing.m_cq_head = reinterpret_cast<unsigned *>(outRing.m_cq_ring + lParameters.cq_off.head);
+    outRing.m_cq_tail = reinterpret_cast<unsigned *>(outRing.m_cq_ring + lParameters.cq_off.tail);
+    outRing.m_cq_mask = *reinterpret_cast<unsigned *>(outRing.m_cq_ring + lParameters.cq_off.ring_mask);
+    outRing.m_cqes    = reinterpret_cast<struct io_uring_cqe *>(outRing.m_cq_ring + lParameters.cq_off.cqes);
+
+    // Submission queue entries are always used in order, so the
+    // indirection array is an identity mapping, established once.
+
+    for (unsigned lIndex = 0; lIndex < lParameters.sq_entries; lIndex++)
+    {
+        reinterpret_cast<unsigned *>(outRing.m_sq_ring + lParameters.sq_off.array)[lIndex] = lIndex;
+    }
+
+    // Register the sparse direct file descriptor table. This is
+    // also the feature test for direct descriptors, with which
+    // linked operations may share a file.
+
+    memset(&lRegister, 0, sizeof (lRegister));
+
+    lRegister.nr    = static_cast<__u32>(inFiles);
+    lRegister.flags = IORING_RSRC_REGISTER_SPARSE;
+
+    lStatus = syscall(__NR_io_uring_register,
+                      outRing.m_descriptor,
+                      IORING_REGISTER_FILES2,
+                      &lRegister,
+                      sizeof (lRegister));
+    nlEXPECT_ACTION(lStatus == 0, done, lRetval = -errno);
+
+ done:
+    if (lRetval != CHKCONFIG_STATUS_SUCCESS)
+    {
+        chkconfigIoRingDestroy(outRing);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Mark all of the operations on a batch file as pending.
+ *
+ *  Until completed, operations are marked canceled, which is also
+ *  what the kernel reports for those skipped when an earlier linked
+ *  operation fails.
+ *
+ *  @private
+ *
+ */
+static void chkconfigIoFilePending(chkconfig_io_file_t &outFile)
+{
+    for (size_t lOperation = 0; lOperation < kChkconfigIoOperationsPerFile; lOperation++)
+    {
+        outFile.m_results[lOperation] = -ECANCELED;
+    }
+}
+
+static bool chkconfigIoFileIsPending(const chkconfig_io_file_t &inFile)
+{
+    return (inFile.m_results[kChkconfigIoOperationOpen] == -ECANCELED);
+}
+
+/**
+ *  @brief
+ *    Get the next submission queue entry, cleared, for an operation
+ *    on the file at the specified batch index.
+ *
+ *  @private
+ *
+ */
+static struct io_uring_sqe *chkconfigIoRingEntry(chkconfig_io_ring_t &inRing,
+                                                 unsigned &ioTail,
+                                                 const size_t &inIndex,
+                                                 const unsigned &inOperation)
+{
+    struct io_uring_sqe * lRetval = &inRing.m_sqes[ioTail++ & inRing.m_sq_mask];
+
+    memset(lRetval, 0, sizeof (*lRetval));
+
+    lRetval->user_data = ((static_cast<__u64>(inIndex) << kChkconfigIoOperationShift) | inOperation);
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Queue the linked open, read, and close of a flag backing file.
+ *
+ *  The open installs the file into the direct file descriptor slot
+ *  of the same index as the file in its batch. Should the open
+ *  fail, the kernel cancels the read and close. The read and close
+ *  are hard-linked, such that the file is closed even when the read
+ *  is short, as it is for all but malformed files.
+ *
+ *  @param[in,out]  inRing   A reference to the ring on which to
+ *                           queue the operations.
+ *  @param[in]      inPaths  A pointer to the batch path pool.
+ *  @param[in,out]  inFile   A reference to the file to read.
+ *  @param[in]      inIndex  The index of the file in its batch.
+ *
+ *  @returns
+ *    The number of operations queued.
+ *
+ *  @private
+ *
+ */
+static size_t chkconfigIoRingQueueRead(chkconfig_io_ring_t &inRing,
+                                       const char *inPaths,
+                                       chkconfig_io_file_t &inFile,
+                                       const size_t &inIndex)
+{
+    unsigned              lTail = *inRing.m_sq_tail;
+    struct io_uring_sqe * lEntry;
+
+    lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationOpen);
+
+    lEntry->opcode     = IORING_OP_OPENAT;
+    lEntry->flags      = IOSQE_IO_LINK;
+    lEntry->fd         = AT_FDCWD;
+    lEntry->addr       = reinterpret_cast<uintptr_t>(&inPaths[inFile.m_path]);
+    lEntry->open_flags = O_RDONLY;
+    lEntry->file_index = static_cast<__u32>(inIndex + 1);
+
+    lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationTransfer);
+
+    lEntry->opcode     = IORING_OP_READ;
+    lEntry->flags      = (IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK);
+    lEntry->fd         = static_cast<__s32>(inIndex);
+    lEntry->addr       = reinterpret_cast<uintptr_t>(&inFile.m_data[0]);
+    lEntry->len        = (sizeof (inFile.m_data) - 1);
+
+    lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationClose);
+
+    lEntry->opcode     = IORING_OP_CLOSE;
+    lEntry->file_index = static_cast<__u32>(inIndex + 1);
+
+    __atomic_store_n(inRing.m_sq_tail, lTail, __ATOMIC_RELEASE);
+
+    return (3);
+}
+
+/**
+ *  @brief
+ *    Queue the linked open, write, optional sync, and close of a
+ *    flag backing file.
+ *
+ *  As with reads, should the open fail, the kernel cancels the
+ *  remaining operations; otherwise, the write, sync, and close are
+ *  hard-linked, such that the file is closed regardless.
+ *
+ *  @param[in,out]  inRing       A reference to the ring on which to
+ *                               queue the operations.
+ *  @param[in]      inPaths      A pointer to the batch path pool.
+ *  @param[in,out]  inFile       A reference to the file to write,
+ *                               the data of which is the state
+ *                               string to write.
+ *  @param[in]      inIndex      The index of the file in its batch.
+ *  @param[in]      inOpenFlags  The flags with which to open the
+ *                               file.
+ *  @param[in]      inSync       Whether to flush the file to stable
+ *                               storage before closing it.
+ *
+ *  @returns
+ *    The number of operations queued.
+ *
+ *  @private
+ *
+ */
+static size_t chkconfigIoRingQueueWrite(chkconfig_io_ring_t &inRing,
+                                        const char *inPaths,
+                                        chkconfig_io_file_t &inFile,
+                                        const size_t &inIndex,
+                                        const int &inOpenFlags,
+                                        const bool &inSync)
+{
+    unsigned              lTail = *inRing.m_sq_tail;
+    struct io_uring_sqe * lEntry;
+
+    lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationOpen);
+
+    lEntry->opcode     = IORING_OP_OPENAT;
+    lEntry->flags      = IOSQE_IO_LINK;
+    lEntry->fd         = AT_FDCWD;
+    lEntry->addr       = reinterpret_cast<uintptr_t>(&inPaths[inFile.m_path]);
+    lEntry->len        = DEFFILEMODE;
+    lEntry->open_flags = static_cast<__u32>(inOpenFlags);
+    lEntry->file_index = static_cast<__u32>(inIndex + 1);
+
+    lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationTransfer);
+
+    lEntry->opcode     = IORING_OP_WRITE;
+    lEntry->flags      = (IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK);
+    lEntry->fd         = static_cast<__s32>(inIndex);
+    lEntry->addr       = reinterpret_cast<uintptr_t>(&inFile.m_data[0]);
+    lEntry->len        = static_cast<__u32>(strlen(&inFile.m_data[0]));
+
+    if (inSync)
+    {
+        lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationSync);
+
+        lEntry->opcode = IORING_OP_FSYNC;
+        lEntry->flags  = (IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK);
+        lEntry->fd     = static_cast<__s32>(inIndex);
+    }
+
+    lEntry = chkconfigIoRingEntry(inRing, lTail, inIndex, kChkconfigIoOperationClose);
+
+    lEntry->opcode     = IORING_OP_CLOSE;
+    lEntry->file_index = static_cast<__u32>(inIndex + 1);
+
+    __atomic_store_n(inRing.m_sq_tail, lTail, __ATOMIC_RELEASE);
+
+    return (inSync ? 4 : 3);
+}
+
+/**
+ *  @brief
+ *    Submit the queued operations and wait for all of them to
+ *    complete, recording their results in the batch files.
+ *
+ *  @param[in,out]  inRing        A reference to the ring on which
+ *                                the operations are queued.
+ *  @param[in,out]  inFiles       A pointer to the batch files.
+ *  @param[in]      inOperations  The number of queued operations.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If the operations could not be
+ *                                     submitted or waited for.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigIoRingSubmitAndWait(chkconfig_io_ring_t &inRing,
+                                                       chkconfig_io_file_t *inFiles,
+                                                       const size_t &inOperations)
+{
+    size_t             lSubmitted = 0;
+    size_t             lCompleted = 0;
+    unsigned           lHead;
+    unsigned           lTail;
+    long               lStatus;
+    chkconfig_status_t lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    while (lCompleted < inOperations)
+    {
+        lStatus = syscall(__NR_io_uring_enter,
+                          inRing.m_descriptor,
+                          static_cast<unsigned>(inOperations - lSubmitted),
+                          static_cast<unsigned>(inOperations - lCompleted),
+                          IORING_ENTER_GETEVENTS,
+                          nullptr,
+                          0);
+        nlREQUIRE_ACTION((lStatus >= 0) || (errno == EINTR), done, lRetval = -errno);
+
+        if (lStatus > 0)
+        {
+            lSubmitted += static_cast<size_t>(lStatus);
+        }
+
+        lHead = *inRing.m_cq_head;
+        lTail = __atomic_load_n(inRing.m_cq_tail, __ATOMIC_ACQUIRE);
+
+        while (lHead != lTail)
+        {
+            const struct io_uring_cqe & lEntry     = inRing.m_cqes[lHead++ & inRing.m_cq_mask];
+            const unsigned              lOperation = (lEntry.user_data & kChkconfigIoOperationMask);
+            chkconfig_io_file_t &       lFile      = inFiles[lEntry.user_data >> kChkconfigIoOperationShift];
+
+            lFile.m_results[lOperation] = lEntry.res;
+
+            // Terminate the data read, if any. For writes, this is
+            // already where the terminator is.
+
+            if ((lOperation == kChkconfigIoOperationTransfer) && (lEntry.res >= 0))
+            {
+                lFile.m_data[lEntry.res] = '\0';
+            }
+
+            lCompleted++;
+        }
+
+        __atomic_store_n(inRing.m_cq_head, lHead, __ATOMIC_RELEASE);
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the state of a flag from its completed batch read.
+ *
+ *  This is the batched counterpart of, and has the same semantics
+ *  as, the synchronous read of a single flag backing file by path.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateGet(const chkconfig_origin_t &inOrigin,
+                                            const bool &inNonexistentIsAnError,
+                                            const chkconfig_io_file_t &inFile,
+                                            chkconfig_state_t &outState,
+                                            chkconfig_origin_t &outOrigin)
+{
+    const int32_t      lOpenResult = inFile.m_results[kChkconfigIoOperationOpen];
+    const int32_t      lReadResult = inFile.m_results[kChkconfigIoOperationTransfer];
+    chkconfig_state_t  lState      = false;
+    chkconfig_status_t lRetval     = CHKCONFIG_STATUS_SUCCESS;
+
+    nlEXPECT_ACTION(lOpenResult >= 0,
+                    done,
+                    switch (lOpenResult)
+                    {
+
+                    case -ENOENT:
+                        outState = false;
+                        outOrigin = CHKCONFIG_ORIGIN_NONE;
+
+                        if (inNonexistentIsAnError)
+                        {
+                            lRetval = lOpenResult;
+                        }
+                        break;
+
+                    default:
+                        lRetval = lOpenResult;
+                        break;
+
+                    });
+
+    nlREQUIRE_ACTION(lReadResult >= 0, done, lRetval = lReadResult);
+
+    if (lReadResult > 0)
+    {
+        lRetval = chkconfigStateStringGetState(&inFile.m_data[0], lState);
+        nlREQUIRE_SUCCESS_ACTION(lRetval, done, outState = false);
+    }
+
+    outState  = lState;
+    outOrigin = inOrigin;
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Append a flag backing file path to the batch path pool.
+ *
+ *  @param[in]      inStore      A reference to the directory store
+ *                               containing the flag.
+ *  @param[in]      inFlag       The flag.
+ *  @param[in,out]  ioPaths      A reference to the batch path pool,
+ *                               which is grown as needed.
+ *  @param[in,out]  ioPathsSize  A reference to the allocated size,
+ *                               in bytes, of the path pool.
+ *  @param[in,out]  ioPathsUsed  A reference to the used size, in
+ *                               bytes, of the path pool.
+ *  @param[out]     outPath      A reference to storage by which to
+ *                               return the offset of the path in
+ *                               the pool if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If the flag was null or empty.
+ *  @retval  -EOVERFLOW                If the path was too long.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigIoPathAppend(const chkconfig_store_t &inStore,
+                                                const chkconfig_flag_t &inFlag,
+                                                char *&ioPaths,
+                                                size_t &ioPathsSize,
+                                                size_t &ioPathsUsed,
+                                                size_t &outPath)
+{
+    size_t             lSize   = ioPathsSize;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    while ((lSize - ioPathsUsed) < PATH_MAX)
+    {
+        lSize = ((lSize == 0) ? PATH_MAX : (lSize * 2));
+    }
+
+    if (lSize != ioPathsSize)
+    {
+        lRetval = chkconfigReallocate(ioPaths, lSize);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ioPathsSize = lSize;
+    }
+
+    lRetval = chkconfigFlagPathCopy(inStore,
+                                    inFlag,
+                                    PATH_MAX,
+                                    &ioPaths[ioPathsUsed]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    outPath      = ioPathsUsed;
+    ioPathsUsed += (strlen(&ioPaths[ioPathsUsed]) + 1);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the states of multiple flags in a directory store with
+ *    batched io_uring reads.
+ *
+ *  Flags are read in batches of at most the queue depth. For each
+ *  batch, the linked open, read, and close of the backing file of
+ *  every flag are submitted together in a single system call, which
+ *  also waits for their completion.
+ *
+ *  The results are then resolved, in order, with the same semantics
+ *  as the synchronous path. Every flag in a batch is attempted,
+ *  regardless of the failure of any other. If per-flag statuses are
+ *  requested, every batch is attempted, as well; otherwise, no
+ *  further batches are attempted after one with a failure.
+ *
+ *  @param[in]      inStore            A reference to the directory
+ *                                     store to read.
+ *  @param[in,out]  inRing             A reference to the ring on
+ *                                     which to perform the reads,
+ *                                     with room for at least a
+ *                                     batch.
+ *  @param[in]      inQueueDepth       The maximum number of flags
+ *                                     per batch.
+ *  @param[in,out]  inFlagStateTuples  A pointer to the flag/state
+ *                                     tuples to get.
+ *  @param[in]      inCount            The number of flag/state
+ *                                     tuples.
+ *  @param[out]     outStatuses        An optional pointer to storage
+ *                                     for @a inCount statuses by
+ *                                     which to return the status of
+ *                                     getting each flag.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    The status of the first flag
+ *                                     that could not be gotten or
+ *                                     the error submitting the reads.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateGetMultiple(const chkconfig_store_t &inStore,
+                                                    chkconfig_io_ring_t &inRing,
+                                                    const size_t &inQueueDepth,
+                                                    chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                    const size_t &inCount,
+                                                    chkconfig_status_t *outStatuses)
+{
+    constexpr bool        lUseDefaultDirectory = true;
+    chkconfig_io_file_t * lFiles               = nullptr;
+    char *                lPaths               = nullptr;
+    size_t                lPathsSize           = 0;
+    size_t                lPathsUsed;
+    size_t                lFirst               = 0;
+    size_t                lLast;
+    size_t                lOperations;
+    chkconfig_status_t    lStatus;
+    chkconfig_status_t    lRetval              = CHKCONFIG_STATUS_SUCCESS;
+
+    lStatus = chkconfigReallocate(lFiles, inQueueDepth);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = lStatus);
+
+    while (lFirst < inCount)
+    {
+        // Form the paths for the batch. A flag whose path cannot be
+        // formed is not submitted, and that error is its status.
+
+        lPathsUsed = 0;
+
+        for (lLast = lFirst; (lLast < inCount) && ((lLast - lFirst) < inQueueDepth); lLast++)
+        {
+            chkconfig_io_file_t & lFile = lFiles[lLast - lFirst];
+
+            chkconfigIoFilePending(lFile);
+
+            lStatus = chkconfigIoPathAppend(inStore,
+                                            inFlagStateTuples[lLast].m_flag,
+                                            lPaths,
+                                            lPathsSize,
+                                            lPathsUsed,
+                                            lFile.m_path);
+            nlREQUIRE_ACTION(lStatus != -ENOMEM, done, lRetval = lStatus);
+
+            if (lStatus != CHKCONFIG_STATUS_SUCCESS)
+            {
+                lFile.m_results[kChkconfigIoOperationOpen] = lStatus;
+            }
+        }
+
+        // Queue, submit, and wait for the batch reads.
+
+        lOperations = 0;
+
+        for (size_t lIndex = 0; lIndex < (lLast - lFirst); lIndex++)
+        {
+            if (chkconfigIoFileIsPending(lFiles[lIndex]))
+            {
+                lOperations += chkconfigIoRingQueueRead(inRing, lPaths, lFiles[lIndex], lIndex);
+            }
+        }
+
+        lStatus = chkconfigIoRingSubmitAndWait(inRing, lFiles, lOperations);
+        nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = lStatus);
+
+        // Resolve the batch reads, in order, retaining the first
+        // failure.
+
+        for (size_t lIndex = lFirst; lIndex < lLast; lIndex++)
+        {
+            chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+            lStatus = chkconfigStateGet(inStore.m_origin,
+                                        !lUseDefaultDirectory,
+                                        lFiles[lIndex - lFirst],
+                                        lTuple.m_state,
+                                        lTuple.m_origin);
+
+            if (outStatuses != nullptr)
+            {
+                outStatuses[lIndex] = lStatus;
+            }
+
+            if ((lStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+            {
+                lRetval = lStatus;
+            }
+        }
+
+        nlEXPECT((lRetval == CHKCONFIG_STATUS_SUCCESS) || (outStatuses != nullptr), done);
+
+        lFirst = lLast;
+    }
+
+ done:
+    free(lFiles);
+    free(lPaths);
+
+    return (lRetval);
+}
+#endif // CHKCONFIG_HAVE_IO_URING
+
+/**
+ *  @brief
+ *    Determine whether a directory entry is a regular file.
+ *
+ *  This determines whether the specified directory entry, following
+ *  symbolic links, is a regular file and, consequently, a candidate
+ *  flag backing file.
+ *
+ *  Where the file system reports the entry type with the entry
+ *  itself, the determination is made without any further system
+ *  calls. Otherwise, the entry is stat'ed relative to the
+ *  directory.
+ *
+ *  @param[in]   inDirectory    A pointer to the open directory
+ *                              containing @a inDirent.
+ *  @param[in]   inDirent       A reference to the directory entry
+ *                              to check.
+ *  @param[out]  outIsRegular   A reference to storage by which to
+ *                              return whether the entry is a
+ *                              regular file if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inDirectory was null.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryEntryIsRegular(DIR *inDirectory,
+                                                           const struct dirent &inDirent,
+                                                           bool &outIsRegular)
+{
+    struct stat        lMetadata;
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectory != nullptr, done, lRetval = -EINVAL);
+
+#if defined(DT_UNKNOWN)
+    // Symbolic links are followed, consistent with stat(2), so only
+    // link and unknown entries require the entry to be stat'ed.
+
+    if ((inDirent.d_type != DT_UNKNOWN) && (inDirent.d_type != DT_LNK))
+    {
+        outIsRegular = (inDirent.d_type == DT_REG);
+        goto done;
+    }
+#endif // defined(DT_UNKNOWN)
+
+    lStatus = fstatat(dirfd(inDirectory), inDirent.d_name, &lMetadata, 0);
+    nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+    outIsRegular = S_ISREG(lMetadata.st_mode);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateGetCount(DIR *inDirectory,
+                                                 size_t &outCount)
+{
+    struct dirent *    lDirent;
+    bool               lIsRegular;
+    size_t             lCount  = 0;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectory != nullptr, done, lRetval = -EINVAL);
+
+    while ((lDirent = readdir(inDirectory)) != nullptr)
+    {
+        lRetval = chkconfigDirectoryEntryIsRegular(inDirectory,
+                                                   *lDirent,
+                                                   lIsRegular);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        // Ignore anything but regular files, which importantly
+        // includes "." and "..".
+        //
+        // Ideally, there should not be anything but "." and ".." and
+        // regular files in the directory; however, there doesn't seem
+        // to be mandate to error out on such entries at the moment.
+
+        if (lIsRegular)
+        {
+            lCount++;
+        }
+    }
+
+    outCount = lCount;
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateGetCount(const char *inDirectoryPath,
+                                                 size_t &outCount)
+{
+    DIR *              lDirectory = nullptr;
+    chkconfig_status_t lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
+
+    lDirectory = opendir(inDirectoryPath);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    lRetval = chkconfigStateGetCount(lDirectory,
+                                     outCount);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+static void chkconfigReadChunkFree(chkconfig_read_chunk_t *&inChunk)
+{
+    chkconfigFlagStateTableDestroy(inChunk->m_table);
+
+    delete inChunk;
+
+    inChunk = nullptr;
+}
+
+/**
+ *  @brief
+ *    Read the states of the flags in a chunk from their backing
+ *    files.
+ *
+ *  @param[in]      inPool   A reference to the pool describing the
+ *                           directory containing the backing files.
+ *  @param[in,out]  inChunk  A reference to the chunk to read, into
+ *                           which the status of reading it is
+ *                           returned.
+ *
+ *  @private
+ *
+ */
+static void chkconfigReadChunkRead(const chkconfig_read_pool_t &inPool,
+                                   chkconfig_read_chunk_t &inChunk)
+{
+    constexpr bool     lUseDefaultDirectory = true;
+    chkconfig_state_t  lState;
+    chkconfig_origin_t lOrigin;
+    chkconfig_status_t lRetval              = CHKCONFIG_STATUS_SUCCESS;
+
+    for (size_t lIndex = 0; lIndex < inChunk.m_table.m_count; lIndex++)
+    {
+        lRetval = chkconfigStateGet(inPool.m_origin,
+                                    !lUseDefaultDirectory,
+                                    inPool.m_directory,
+                                    chkconfigFlagStateTableGetFlag(inChunk.m_table, lIndex),
+                                    lState,
+                                    lOrigin);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        chkconfigFlagStateTableSetState(inChunk.m_table, lIndex, lState);
+        chkconfigFlagStateTableSetOrigin(inChunk.m_table, lIndex, lOrigin);
+    }
+
+ done:
+    inChunk.m_status = lRetval;
+}
+
+static void chkconfigReadQueuePush(chkconfig_read_queue_t &inQueue,
+                                   chkconfig_read_chunk_t &inChunk)
+{
+    inQueue.m_lock.lock();
+
+    inChunk.m_newer = nullptr;
+    inChunk.m_older = inQueue.m_newest;
+
+    if (inQueue.m_newest != nullptr)
+    {
+        inQueue.m_newest->m_newer = &inChunk;
+    }
+    else
+    {
+        inQueue.m_oldest = &inChunk;
+    }
+
+    inQueue.m_newest = &inChunk;
+
+    inQueue.m_lock.unlock();
+}
+
+/**
+ *  @brief
+ *    Take a chunk from a reader queue.
+ *
+ *  @param[in,out]  inQueue  A reference to the queue to take from.
+ *  @param[in]      inSteal  When asserted, take the oldest chunk, as
+ *                           a reader other than the owner does.
+ *                           Otherwise, take the newest chunk, as the
+ *                           owner does.
+ *
+ *  @returns
+ *    A pointer to the chunk taken or null if the queue was empty.
+ *
+ *  @private
+ *
+ */
+static chkconfig_read_chunk_t *chkconfigReadQueueTake(chkconfig_read_queue_t &inQueue,
+                                                      const bool &inSteal)
+{
+    chkconfig_read_chunk_t * lChunk;
+
+    inQueue.m_lock.lock();
+
+    lChunk = (inSteal ? inQueue.m_oldest : inQueue.m_newest);
+
+    if (lChunk != nullptr)
+    {
+        chkconfig_read_chunk_t *& lFromNewer = ((lChunk->m_newer != nullptr) ? lChunk->m_newer->m_older : inQueue.m_newest);
+        chkconfig_read_chunk_t *& lFromOlder = ((lChunk->m_older != nullptr) ? lChunk->m_older->m_newer : inQueue.m_oldest);
+
+        lFromNewer = lChunk->m_older;
+        lFromOlder = lChunk->m_newer;
+    }
+
+    inQueue.m_lock.unlock();
+
+    return (lChunk);
+}
+
+static void chkconfigReadPoolPost(chkconfig_read_pool_t &inPool,
+                                  const size_t &inCount)
+{
+    inPool.m_lock.lock();
+
+    inPool.m_posted += inCount;
+
+    inPool.m_lock.unlock();
+
+    if (inCount == 1)
+    {
+        inPool.m_ready.notify_one();
+    }
+    else
+    {
+        inPool.m_ready.notify_all();
+    }
+}
+
+static void chkconfigReadPoolWait(chkconfig_read_pool_t &inPool)
+{
+    unique_lock<mutex> lLock(inPool.m_lock);
+
+    inPool.m_ready.wait(lLock, [&inPool] { return (inPool.m_posted > 0); });
+
+    inPool.m_posted--;
+}
+
+/**
+ *  @brief
+ *    Claim a chunk for a reader, first from its own queue and then,
+ *    failing that, by stealing from the queues of the other readers.
+ *
+ *  @param[in,out]  inQueue  A reference to the queue of the reader
+ *                           claiming a chunk.
+ *
+ *  @returns
+ *    A pointer to the chunk claimed or null if every queue was empty.
+ *
+ *  @private
+ *
+ */
+static chkconfig_read_chunk_t *chkconfigReadPoolClaim(chkconfig_read_queue_t &inQueue)
+{
+    constexpr bool           lSteal   = true;
+    chkconfig_read_pool_t &  lPool    = *inQueue.m_pool;
+    const size_t             lOwner   = static_cast<size_t>(&inQueue - lPool.m_queues);
+    chkconfig_read_chunk_t * lChunk;
+
+    lChunk = chkconfigReadQueueTake(inQueue, !lSteal);
+
+    for (size_t lOffset = 1; (lChunk == nullptr) && (lOffset < lPool.m_readers); lOffset++)
+    {
+        lChunk = chkconfigReadQueueTake(lPool.m_queues[(lOwner + lOffset) % lPool.m_readers], lSteal);
+    }
+
+    return (lChunk);
+}
+
+/**
+ *  @brief
+ *    Read chunks as a reader in a pool until the directory has been
+ *    enumerated and every chunk read.
+ *
+ *  Each unit of work posted to the pool is taken by exactly one
+ *  reader, which then claims a chunk. Because queues are visited in
+ *  turn, a reader may find none, even though one remains, when
+ *  another reader steals the chunk it was headed for while a new one
+ *  lands in a queue it has already visited; so, it tries again until
+ *  it either claims a chunk or finds every queue empty once
+ *  enumeration is known to be complete.
+ *
+ *  @param[in,out]  inQueue  A reference to the queue of the reader.
+ *
+ *  @private
+ *
+ */
+static void chkconfigReadPoolRun(chkconfig_read_queue_t &inQueue)
+{
+    chkconfig_read_pool_t &  lPool = *inQueue.m_pool;
+    chkconfig_read_chunk_t * lChunk;
+    bool                     lDone;
+
+    while (true)
+    {
+        chkconfigReadPoolWait(lPool);
+
+        while (true)
+        {
+            lDone  = lPool.m_done.load();
+            lChunk = chkconfigReadPoolClaim(inQueue);
+
+            if ((lChunk != nullptr) || lDone)
+            {
+                break;
+            }
+
+            sched_yield();
+        }
+
+        if (lChunk == nullptr)
+        {
+            break;
+        }
+
+        chkconfigReadChunkRead(lPool, *lChunk);
+    }
+}
+
+static void *chkconfigReadPoolThread(void *inQueue)
+{
+    chkconfigReadPoolRun(*static_cast<chkconfig_read_queue_t *>(inQueue));
+
+    return (nullptr);
+}
+
+/**
+ *  @brief
+ *    Copy all flags with a backing file in a directory into a
+ *    flag/state table, reading their states with a pool of threads.
+ *
+ *  The calling thread enumerates the directory, gathering flags into
+ *  chunks and distributing them, round-robin, among the queues of
+ *  the readers, each of which reads the backing files in the chunks
+ *  it claims relative to the directory descriptor. A reader out of
+ *  work steals from the others, such that a slow file system or a
+ *  directory of uneven chunks does not leave threads idle. Once
+ *  enumeration is complete, the calling thread joins the pool as the
+ *  first reader. Should a thread fail to start, its queue is drained
+ *  by the others.
+ *
+ *  The chunks are then appended to the table in enumeration order,
+ *  exactly as a single thread would have.
+ *
+ *  @param[in]      inOrigin         The origin to associate with
+ *                                   the flags in @a inDirectoryPath.
+ *  @param[in]      inDirectoryPath  A pointer to the null-terminated
+ *                                   C string of the directory to
+ *                                   enumerate.
+ *  @param[in]      inMatch          A pointer to the criterion flags
+ *                                   must match to be copied or null
+ *                                   to copy all flags.
+ *  @param[in]      inThreads        The number of threads, including
+ *                                   the caller, with which to read
+ *                                   backing files.
+ *  @param[in,out]  inTable          A reference to the table to
+ *                                   append to.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inDirectoryPath was null
+ *                                     or @a inThreads was out of
+ *                                     range.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the flags.
+ *  @retval  -errno                    The status of the first flag,
+ *                                     in enumeration order, whose
+ *                                     state could not be read.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateCopyAllWithThreads(const chkconfig_origin_t &inOrigin,
+                                                           const char *inDirectoryPath,
+                                                           const chkconfig_flag_match_t *inMatch,
+                                                           const uint32_t &inThreads,
+                                                           chkconfig_flag_state_table_t &inTable)
+{
+    DIR *                     lDirectory = nullptr;
+    struct dirent *           lDirent;
+    bool                      lIsRegular;
+    chkconfig_read_pool_t     lPool;
+    chkconfig_read_queue_t    lQueues[kChkconfigThreadsMaximum];
+    pthread_t                 lThreads[kChkconfigThreadsMaximum];
+    bool                      lStarted[kChkconfigThreadsMaximum];
+    size_t                    lReaders   = 1;
+    size_t                    lQueued    = 0;
+    chkconfig_read_chunk_t *  lFirst     = nullptr;
+    chkconfig_read_chunk_t ** lLast      = &lFirst;
+    chkconfig_read_chunk_t *  lChunk     = nullptr;
+    int                       lStatus;
+    chkconfig_status_t        lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION((inThreads > 0) && (inThreads <= kChkconfigThreadsMaximum), done, lRetval = -EINVAL);
+
+    lDirectory = opendir(inDirectoryPath);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    lPool.m_directory = dirfd(lDirectory);
+    lPool.m_origin    = inOrigin;
+    lPool.m_queues    = &lQueues[0];
+    lPool.m_readers   = inThreads;
+    lPool.m_posted    = 0;
+    lPool.m_done.store(false);
+
+    for (size_t lReader = 0; lReader < inThreads; lReader++)
+    {
+        lQueues[lReader].m_pool   = &lPool;
+        lQueues[lReader].m_oldest = nullptr;
+        lQueues[lReader].m_newest = nullptr;
+    }
+
+    for (size_t lReader = 1; lReader < inThreads; lReader++)
+    {
+        lStarted[lReader] = (pthread_create(&lThreads[lReader],
+                                            nullptr,
+                                            chkconfigReadPoolThread,
+                                            &lQueues[lReader]) == 0);
+
+        lReaders += (lStarted[lReader] ? 1 : 0);
+    }
+
+    while ((lDirent = readdir(lDirectory)) != nullptr)
+    {
+        // The prefix is matched before, and any filter after, the
+        // entry is known to be a flag, such that a mismatch is never
+        // stat'ed and a filter is only ever offered flags.
+
+        if (!chkconfigFlagMatchesPrefix(inMatch, lDirent->d_name))
+        {
+            continue;
+        }
+
+        lRetval = chkconfigDirectoryEntryIsRegular(lDirectory,
+                                                   *lDirent,
+                                                   lIsRegular);
+        nlREQUIRE_SUCCESS(lRetval, join);
+
+        if (!lIsRegular || !chkconfigFlagMatchesFilter(inMatch, lDirent->d_name))
+        {
+            continue;
+        }
+
+        if (lChunk == nullptr)
+        {
+            lChunk = new chkconfig_read_chunk_t;
+            nlREQUIRE_ACTION(lChunk != nullptr, join, lRetval = -ENOMEM);
+
+            lChunk->m_next   = nullptr;
+            lChunk->m_status = CHKCONFIG_STATUS_SUCCESS;
+
+            chkconfigFlagStateTableInit(lChunk->m_table);
+
+            *lLast = lChunk;
+            lLast  = &lChunk->m_next;
+        }
+
+        lRetval = chkconfigFlagStateTableAppend(lChunk->m_table,
+                                                lDirent->d_name,
+                                                false,
+                                                CHKCONFIG_ORIGIN_NONE);
+        nlREQUIRE_SUCCESS(lRetval, join);
+
+        if (lChunk->m_table.m_count == kChkconfigReadChunkFlags)
+        {
+            chkconfigReadQueuePush(lQueues[lQueued++ % inThreads], *lChunk);
+            chkconfigReadPoolPost(lPool, 1);
+
+            lChunk = nullptr;
+        }
+    }
+
+    if (lChunk != nullptr)
+    {
+        chkconfigReadQueuePush(lQueues[lQueued++ % inThreads], *lChunk);
+        chkconfigReadPoolPost(lPool, 1);
+    }
+
+ join:
+    // Whether or not enumeration succeeded, every queued chunk must
+    // be drained and every reader released before the pool goes out
+    // of scope.
+
+    lPool.m_done.store(true);
+
+    chkconfigReadPoolPost(lPool, lReaders);
+
+    chkconfigReadPoolRun(lQueues[0]);
+
+    for (size_t lReader = 1; lReader < inThreads; lReader++)
+    {
+        if (lStarted[lReader])
+        {
+            lStatus = pthread_join(lThreads[lReader], nullptr);
+            nlVERIFY(lStatus == 0);
+        }
+    }
+
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // Return the first failure in enumeration order, regardless of
+    // the order in which the chunks were read.
+
+    for (lChunk = lFirst; lChunk != nullptr; lChunk = lChunk->m_next)
+    {
+        lRetval = lChunk->m_status;
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        for (size_t lIndex = 0; lIndex < lChunk->m_table.m_count; lIndex++)
+        {
+            lRetval = chkconfigFlagStateTableAppend(inTable,
+                                                    lChunk->m_table,
+                                                    lIndex);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+    }
+
+ done:
+    while (lFirst != nullptr)
+    {
+        lChunk = lFirst->m_next;
+
+        chkconfigReadChunkFree(lFirst);
+
+        lFirst = lChunk;
+    }
+
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Copy all flags with a backing file in a directory into a
+ *    flag/state table.
+ *
+ *  This enumerates the specified directory once, appending every
+ *  regular file to the table, in directory order.
+ *
+ *  With more than one thread, backing files are read by a pool of
+ *  threads while the directory is enumerated.
+ *
+ *  @param[in]      inOrigin         The origin to associate with
+ *                                   the flags in @a inDirectoryPath.
+ *  @param[in]      inDirectoryPath  A pointer to the null-terminated
+ *                                   C string of the directory to
+ *                                   enumerate.
+ *  @param[in]      inMatch          A pointer to the criterion flags
+ *                                   must match to be copied or null
+ *                                   to copy all flags. Flags that do
+ *                                   not match are skipped by name,
+ *                                   without opening their backing
+ *                                   file.
+ *  @param[in]      inReadState      When asserted, read the state of
+ *                                   each flag from its backing file.
+ *                                   Otherwise, only the flag names
+ *                                   are copied and no backing file
+ *                                   is opened.
+ *  @param[in]      inThreads        The maximum number of threads,
+ *                                   including the caller, with which
+ *                                   to read backing files.
+ *  @param[in,out]  inTable          A reference to the table to
+ *                                   append to.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inDirectoryPath was null.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the flags.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateCopyAll(const chkconfig_origin_t &inOrigin,
+                                                const char *inDirectoryPath,
+                                                const chkconfig_flag_match_t *inMatch,
+                                                const bool &inReadState,
+                                                const uint32_t &inThreads,
+                                                chkconfig_flag_state_table_t &inTable)
+{
+    DIR *              lDirectory = nullptr;
+    struct dirent *    lDirent;
+    bool               lIsRegular;
+    chkconfig_state_t  lState     = false;
+    chkconfig_origin_t lOrigin    = inOrigin;
+    int                lStatus;
+    chkconfig_status_t lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
+
+    if (inReadState && (inThreads > 1))
+    {
+        lRetval = chkconfigStateCopyAllWithThreads(inOrigin,
+                                                   inDirectoryPath,
+                                                   inMatch,
+                                                   inThreads,
+                                                   inTable);
+        goto done;
+    }
+
+    lDirectory = opendir(inDirectoryPath);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    while ((lDirent = readdir(lDirectory)) != nullptr)
+    {
+        // The prefix is matched before, and any filter after, the
+        // entry is known to be a flag, such that a mismatch is never
+        // stat'ed and a filter is only ever offered flags.
+
+        if (!chkconfigFlagMatchesPrefix(inMatch, lDirent->d_name))
+        {
+            continue;
+        }
+
+        lRetval = chkconfigDirectoryEntryIsRegular(lDirectory,
+                                                   *lDirent,
+                                                   lIsRegular);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (!lIsRegular || !chkconfigFlagMatchesFilter(inMatch, lDirent->d_name))
+        {
+            continue;
+        }
+
+        if (inReadState)
+        {
+            constexpr bool lUseDefaultDirectory = true;
+            char           lFlagPath[PATH_MAX];
+
+            lRetval = chkconfigFlagPathCopy(inDirectoryPath,
+                                            lDirent->d_name,
+                                            PATH_MAX,
+                                            &lFlagPath[0]);
+            nlREQUIRE_SUCCESS(lRetval, done);
+
+            lRetval = chkconfigStateGet(inOrigin,
+                                        !lUseDefaultDirectory,
+                                        lFlagPath,
+                                        lState,
+                                        lOrigin);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+
+        lRetval = chkconfigFlagStateTableAppend(inTable,
+                                                lDirent->d_name,
+                                                lState,
+                                                lOrigin);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+// MARK: Mutators
+
+static chkconfig_status_t chkconfigStateSet(const chkconfig_store_t &inStore,
+                                            const chkconfig_options_t &inOptions,
+                                            const chkconfig_flag_t &inFlag,
+                                            const chkconfig_state_t &inState)
+{
+    char               lFlagPath[PATH_MAX];
+    int                lStatus;
+    int                lFlags;
+    int                lDescriptor = -1;
+    const char *       lStateString;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inFlag    != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inFlag[0] != '\0',    done, lRetval = -EINVAL);
+
+    lRetval = chkconfigFlagPathCopy(inStore,
+                                    inFlag,
+                                    PATH_MAX,
+                                    &lFlagPath[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lFlags = (O_WRONLY | O_TRUNC);
+
+    if (inOptions.m_force_state)
+    {
+        lFlags |= (O_CREAT);
+    }
+
+    // If 'm_force_state' was not asserted and, consequently, the
+    // O_CREAT flag not used, then the following open call will
+    // expectdly fail. Therefore, use the EXPECT rather than REQUIRE
+    // assertion form.
+
+    lDescriptor = open(lFlagPath, lFlags, DEFFILEMODE);
+
+    // In a sharded layout, the shard subdirectory of a flag being
+    // forcibly created may not yet exist; if so, create it and try
+    // again.
+
+    if ((lDescriptor == -1) && (errno == ENOENT) && inStore.m_sharded && inOptions.m_force_state)
+    {
+        lRetval = chkconfigShardCreate(&lFlagPath[0]);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lDescriptor = open(lFlagPath, lFlags, DEFFILEMODE);
+    }
+
+    nlEXPECT_ACTION(lDescriptor != -1, done, lRetval = -errno);
+
+    lRetval = chkconfigStateGetStateString(inState, lStateString);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lStatus = dprintf(lDescriptor, "%s\n", lStateString);
+    nlREQUIRE_ACTION(lStatus > 0,
+                     done,
+                     lRetval = -EOVERFLOW);
+
+    if (inOptions.m_sync_state)
+    {
+        lStatus = fsync(lDescriptor);
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+    }
+
+ done:
+    if (lDescriptor != -1)
+    {
+        lStatus = close(lDescriptor);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+#if CHKCONFIG_HAVE_IO_URING
+/**
+ *  @brief
+ *    Get the status of setting a flag from its completed batch
+ *    write.
+ *
+ *  This is the batched counterpart of, and has the same semantics
+ *  as, the synchronous write of a single flag backing file.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateSetStatus(const chkconfig_io_file_t &inFile,
+                                                  const bool &inSync)
+{
+    const int32_t      lOpenResult  = inFile.m_results[kChkconfigIoOperationOpen];
+    const int32_t      lWriteResult = inFile.m_results[kChkconfigIoOperationTransfer];
+    const int32_t      lSyncResult  = inFile.m_results[kChkconfigIoOperationSync];
+    const int32_t      lCloseResult = inFile.m_results[kChkconfigIoOperationClose];
+    chkconfig_status_t lRetval      = CHKCONFIG_STATUS_SUCCESS;
+
+    // If CHKCONFIG_OPTION_FORCE_STATE was not asserted, the open may
+    // expectedly fail. Therefore, use the EXPECT rather than REQUIRE
+    // assertion form.
+
+    nlEXPECT_ACTION(lOpenResult >= 0, done, lRetval = lOpenResult);
+
+    nlREQUIRE_ACTION(lWriteResult >= 0, done, lRetval = lWriteResult);
+    nlREQUIRE_ACTION(static_cast<size_t>(lWriteResult) == strlen(&inFile.m_data[0]),
+                     done,
+                     lRetval = -EIO);
+
+    nlREQUIRE_ACTION(!inSync || (lSyncResult >= 0), done, lRetval = lSyncResult);
+
+    nlREQUIRE_ACTION(lCloseResult >= 0, done, lRetval = lCloseResult);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Set the states of multiple flags in a directory store with
+ *    batched io_uring writes.
+ *
+ *  Flags are written in batches of at most the queue depth. For each
+ *  batch, the linked open, write, optional sync, and close of the
+ *  backing file of every flag are submitted together in a single
+ *  system call, which also waits for their completion.
+ *
+ *  Every flag in a batch is attempted, regardless of the failure of
+ *  any other. If per-flag statuses are requested, every batch is
+ *  attempted, as well; otherwise, no further batches are attempted
+ *  after one with a failure.
+ *
+ *  @param[in]   inStore            A reference to the directory
+ *                                  store to write.
+ *  @param[in]   inOptions          A reference to the library
+ *                                  runtime options snapshot.
+ *  @param[in]   inRing             A reference to the ring on which
+ *                                  to perform the writes, with room
+ *                                  for at least a batch.
+ *  @param[in]   inQueueDepth       The maximum number of flags per
+ *                                  batch.
+ *  @param[in]   inFlagStateTuples  A pointer to the flag/state
+ *                                  tuples to set.
+ *  @param[in]   inCount            The number of flag/state tuples.
+ *  @param[out]  outStatuses        An optional pointer to storage
+ *                                  for @a inCount statuses by which
+ *                                  to return the status of setting
+ *                                  each flag.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    The status of the first flag
+ *                                     that could not be set or the
+ *                                     error submitting the writes.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateSetMultiple(const chkconfig_store_t &inStore,
+                                                    const chkconfig_options_t &inOptions,
+                                                    chkconfig_io_ring_t &inRing,
+                                                    const size_t &inQueueDepth,
+                                                    const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                    const size_t &inCount,
+                                                    chkconfig_status_t *outStatuses)
+{
+    const bool            lSync      = inOptions.m_sync_state;
+    int                   lOpenFlags = (O_WRONLY | O_TRUNC);
+    chkconfig_io_file_t * lFiles     = nullptr;
+    char *                lPaths     = nullptr;
+    size_t                lPathsSize = 0;
+    size_t                lPathsUsed;
+    size_t                lFirst     = 0;
+    size_t                lLast;
+    size_t                lOperations;
+    const char *          lStateString;
+    chkconfig_status_t    lStatus;
+    chkconfig_status_t    lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    if (inOptions.m_force_state)
+    {
+        lOpenFlags |= (O_CREAT);
+    }
+
+    lStatus = chkconfigReallocate(lFiles, inQueueDepth);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = lStatus);
+
+    while (lFirst < inCount)
+    {
+        // Form the paths and data for the batch. A flag whose path
+        // cannot be formed is not submitted, and that error is its
+        // status.
+
+        lPathsUsed = 0;
+
+        for (lLast = lFirst; (lLast < inCount) && ((lLast - lFirst) < inQueueDepth); lLast++)
+        {
+            chkconfig_io_file_t & lFile = lFiles[lLast - lFirst];
+
+            chkconfigIoFilePending(lFile);
+
+            lStatus = chkconfigIoPathAppend(inStore,
+                                            inFlagStateTuples[lLast].m_flag,
+                                            lPaths,
+                                            lPathsSize,
+                                            lPathsUsed,
+                                            lFile.m_path);
+            nlREQUIRE_ACTION(lStatus != -ENOMEM, done, lRetval = lStatus);
+
+            if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+            {
+                lStatus = chkconfigStateGetStateString(inFlagStateTuples[lLast].m_state, lStateString);
+                nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = lStatus);
+
+                snprintf(&lFile.m_data[0], sizeof (lFile.m_data), "%s\n", lStateString);
+            }
+            else
+            {
+                lFile.m_results[kChkconfigIoOperationOpen] = lStatus;
+            }
+        }
+
+        // Queue, submit, and wait for the batch writes.
+
+        lOperations = 0;
+
+        for (size_t lIndex = 0; lIndex < (lLast - lFirst); lIndex++)
+        {
+            if (chkconfigIoFileIsPending(lFiles[lIndex]))
+            {
+                lOperations += chkconfigIoRingQueueWrite(inRing,
+                                                         lPaths,
+                                                         lFiles[lIndex],
+                                                         lIndex,
+                                                         lOpenFlags,
+                                                         lSync);
+            }
+        }
+
+        lStatus = chkconfigIoRingSubmitAndWait(inRing, lFiles, lOperations);
+        nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = lStatus);
+
+        // Resolve the batch writes, in order, retaining the first
+        // failure.
+
+        for (size_t lIndex = lFirst; lIndex < lLast; lIndex++)
+        {
+            lStatus = chkconfigStateSetStatus(lFiles[lIndex - lFirst], lSync);
+
+            // In a sharded layout, a flag being forcibly created in a
+            // shard subdirectory that does not yet exist fails to
+            // open; set it synchronously, which creates the
+            // subdirectory.
+
+            if ((lStatus == -ENOENT) && inStore.m_sharded && inOptions.m_force_state)
+            {
+                lStatus = chkconfigStateSet(inStore,
+                                            inOptions,
+                                            inFlagStateTuples[lIndex].m_flag,
+                                            inFlagStateTuples[lIndex].m_state);
+            }
+
+            if (outStatuses != nullptr)
+            {
+                outStatuses[lIndex] = lStatus;
+            }
+
+            if ((lStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+            {
+                lRetval = lStatus;
+            }
+        }
+
+        nlEXPECT((lRetval == CHKCONFIG_STATUS_SUCCESS) || (outStatuses != nullptr), done);
+
+        lFirst = lLast;
+    }
+
+ done:
+    free(lFiles);
+    free(lPaths);
+
+    return (lRetval);
+}
+#endif // CHKCONFIG_HAVE_IO_URING
+
+/**
+ *  @brief
+ *    Migrate the flag backing files in a directory to the sharded
+ *    layout.
+ *
+ *  Each backing file in the directory itself is renamed into its
+ *  shard subdirectory, which is created as needed.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryShard(DIR *inDirectory)
+{
+    struct dirent *    lDirent;
+    bool               lIsRegular;
+    char               lShardPath[NAME_MAX + 4];
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    while ((lDirent = readdir(inDirectory)) != nullptr)
+    {
+        lRetval = chkconfigDirectoryEntryIsRegular(inDirectory,
+                                                   *lDirent,
+                                                   lIsRegular);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (!lIsRegular)
+        {
+            continue;
+        }
+
+        snprintf(&lShardPath[0],
+                 sizeof (lShardPath),
+                 "%02zx/%s",
+                 chkconfigFlagShard(lDirent->d_name),
+                 lDirent->d_name);
+
+        lStatus = renameat(dirfd(inDirectory), lDirent->d_name, dirfd(inDirectory), lShardPath);
+
+        // The shard subdirectory may not yet exist; if so, create it
+        // and try again.
+
+        if ((lStatus == -1) && (errno == ENOENT))
+        {
+            lShardPath[2] = '\0';
+
+            lStatus = mkdirat(dirfd(inDirectory), lShardPath, ACCESSPERMS);
+            nlREQUIRE_ACTION((lStatus == 0) || (errno == EEXIST), done, lRetval = -errno);
+
+            lShardPath[2] = '/';
+
+            lStatus = renameat(dirfd(inDirectory), lDirent->d_name, dirfd(inDirectory), lShardPath);
+        }
+
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Migrate the flag backing files in a directory to the flat
+ *    layout.
+ *
+ *  Each backing file in a shard subdirectory is renamed into the
+ *  directory itself and the subdirectory removed once emptied. A
+ *  subdirectory left with anything but backing files in it is left
+ *  in place.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryUnshard(DIR *inDirectory)
+{
+    DIR *                 lShard  = nullptr;
+    const struct dirent * lShardDirent;
+    struct dirent *       lDirent;
+    bool                  lIsRegular;
+    int                   lDescriptor;
+    int                   lStatus;
+    chkconfig_status_t    lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = chkconfigShardNext(inDirectory, lShardDirent);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    while (lShardDirent != nullptr)
+    {
+        lDescriptor = openat(dirfd(inDirectory),
+                             lShardDirent->d_name,
+                             (O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        nlREQUIRE_ACTION(lDescriptor != -1, done, lRetval = -errno);
+
+        lShard = fdopendir(lDescriptor);
+        nlREQUIRE_ACTION(lShard != nullptr, done, lRetval = -errno; close(lDescriptor));
+
+        while ((lDirent = readdir(lShard)) != nullptr)
+        {
+            lRetval = chkconfigDirectoryEntryIsRegular(lShard,
+                                                       *lDirent,
+                                                       lIsRegular);
+            nlREQUIRE_SUCCESS(lRetval, done);
+
+            if (!lIsRegular)
+            {
+                continue;
+            }
+
+            lStatus = renameat(dirfd(lShard), lDirent->d_name, dirfd(inDirectory), lDirent->d_name);
+            nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+        }
+
+        lStatus = closedir(lShard);
+        lShard  = nullptr;
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+        lStatus = unlinkat(dirfd(inDirectory), lShardDirent->d_name, AT_REMOVEDIR);
+        nlREQUIRE_ACTION((lStatus == 0) || (errno == ENOTEMPTY) || (errno == EEXIST), done, lRetval = -errno);
+
+        lRetval = chkconfigShardNext(inDirectory, lShardDirent);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    if (lShard != nullptr)
+    {
+        lStatus = closedir(lShard);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Migrate the flag backing files in a directory to a flat or
+ *    sharded layout.
+ *
+ *  Each backing file is atomically renamed into place, such that a
+ *  migration that is interrupted may simply be run again. Backing
+ *  files already in the requested layout are left alone.
+ *
+ *  @param[in]  inDirectoryPath  A pointer to the null-terminated C
+ *                               string of the directory to migrate.
+ *  @param[in]  inSharded        Whether to migrate to the sharded
+ *                               rather than the flat layout.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inDirectoryPath was
+ *                                     null.
+ *  @retval  -errno                    If the directory could not be
+ *                                     read or a backing file or
+ *                                     subdirectory could not be
+ *                                     moved, created, or removed.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryMigrate(const char *inDirectoryPath,
+                                                    const bool &inSharded)
+{
+    DIR *              lDirectory = nullptr;
+    int                lStatus;
+    chkconfig_status_t lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inDirectoryPath != nullptr, done, lRetval = -EINVAL);
+
+    lDirectory = opendir(inDirectoryPath);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    if (inSharded)
+    {
+        lRetval = chkconfigDirectoryShard(lDirectory);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+    else
+    {
+        lRetval = chkconfigDirectoryUnshard(lDirectory);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+// MARK: Existence Filters
+
+#if CHKCONFIG_HAVE_INOTIFY
+// The changes to a directory that keep its existence filter current
+// or that, affecting the directory itself, invalidate it.
+
+static constexpr uint32_t kChkconfigExistenceFilterEvents = (IN_CREATE      |
+                                                             IN_DELETE      |
+                                                             IN_MOVED_FROM  |
+                                                             IN_MOVED_TO    |
+                                                             IN_DELETE_SELF |
+                                                             IN_MOVE_SELF   |
+                                                             IN_ONLYDIR);
+
+// Large enough for several change notifications, each of which may
+// carry a name of up to NAME_MAX bytes.
+
+static constexpr size_t   kChkconfigExistenceFilterBufferSize = (4 * (sizeof (struct inotify_event) + NAME_MAX + 1));
+
+static void chkconfigExistenceFiltersInvalidate(chkconfig_existence_filters_t &inFilters)
+{
+    for (chkconfig_existence_filter_t *lFilter = inFilters.m_first; lFilter != nullptr; lFilter = lFilter->m_next)
+    {
+        lFilter->m_valid = false;
+    }
+}
+
+/**
+ *  @brief
+ *    Build an existence filter from its directory.
+ *
+ *  The directory is watched before it is enumerated, such that no
+ *  change made during enumeration is missed. Every entry, whatever
+ *  its type, is indexed, since any entry would be found by opening
+ *  or stat'ing a flag of the same name.
+ *
+ *  If the filter cannot be built, for example, because the
+ *  directory does not exist, it is left invalid and excludes no
+ *  flag.
+ *
+ *  @note
+ *    The caller must hold the existence filters lock.
+ *
+ *  @param[in,out]  inFilter  A reference to the filter to build.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the index.
+ *  @retval  -errno                    If the directory could not be
+ *                                     watched or enumerated.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigExistenceFilterBuild(chkconfig_existence_filter_t &inFilter)
+{
+    chkconfig_existence_filters_t & lFilters   = *inFilter.m_filters;
+    DIR *                           lDirectory = nullptr;
+    struct dirent *                 lDirent;
+    int                             lStatus;
+    chkconfig_status_t              lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    if (lFilters.m_descriptor == -1)
+    {
+        lFilters.m_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        nlREQUIRE_ACTION(lFilters.m_descriptor != -1, done, lRetval = -errno);
+    }
+
+    // The directory may very well not exist, so use the EXPECT rather
+    // than REQUIRE assertion form.
+
+    if (inFilter.m_watch == -1)
+    {
+        inFilter.m_watch = inotify_add_watch(lFilters.m_descriptor,
+                                             inFilter.m_directory,
+                                             kChkconfigExistenceFilterEvents);
+        nlEXPECT_ACTION(inFilter.m_watch != -1, done, lRetval = -errno);
+    }
+
+    lDirectory = opendir(inFilter.m_directory);
+    nlEXPECT_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    chkconfigFlagIndexDestroy(inFilter.m_index);
+    chkconfigFlagIndexInit(inFilter.m_index);
+
+    while ((lDirent = readdir(lDirectory)) != nullptr)
+    {
+        lRetval = chkconfigFlagIndexSet(inFilter.m_index,
+                                        lDirent->d_name,
+                                        strlen(lDirent->d_name),
+                                        true);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    inFilter.m_valid = true;
+
+ done:
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY(lStatus == 0);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Apply a change notification to the existence filter for the
+ *    directory it concerns.
+ *
+ *  @note
+ *    The caller must hold the existence filters lock.
+ *
+ *  @param[in,out]  inFilter  A reference to the filter to update.
+ *  @param[in]      inEvent   A reference to the change notification.
+ *
+ *  @private
+ *
+ */
+static void chkconfigExistenceFilterApply(chkconfig_existence_filter_t &inFilter,
+                                          const struct inotify_event &inEvent)
+{
+    size_t             lLength;
+    size_t             lSlot;
+    chkconfig_status_t lResult;
+
+    if (inEvent.mask & IN_IGNORED)
+    {
+        // The watch is gone, most likely along with the directory;
+        // it is added anew when the filter is next built.
+
+        inFilter.m_watch = -1;
+        inFilter.m_valid = false;
+    }
+    else if (inEvent.mask & IN_MOVE_SELF)
+    {
+        // The watch follows the directory to its new name, so it is
+        // removed, unless already gone with the directory, and added
+        // anew, by name, when the filter is next built.
+
+        inotify_rm_watch(inFilter.m_filters->m_descriptor, inFilter.m_watch);
+
+        inFilter.m_watch = -1;
+        inFilter.m_valid = false;
+    }
+    else if (inEvent.mask & IN_DELETE_SELF)
+    {
+        inFilter.m_valid = false;
+    }
+    else if (inFilter.m_valid && (inEvent.len > 0))
+    {
+        lLength = strlen(inEvent.name);
+
+        if (inEvent.mask & (IN_CREATE | IN_MOVED_TO))
+        {
+            lResult = chkconfigFlagIndexSet(inFilter.m_index, inEvent.name, lLength, true);
+            nlVERIFY_ACTION(lResult == CHKCONFIG_STATUS_SUCCESS, inFilter.m_valid = false);
+        }
+        else if (chkconfigFlagIndexLookup(inFilter.m_index, inEvent.name, lLength, lSlot))
+        {
+            chkconfigFlagStateTableSetState(inFilter.m_index.m_table, inFilter.m_index.m_slots[lSlot] - 1, false);
+        }
+    }
+}
+
+/**
+ *  @brief
+ *    Bring every existence filter of a context up to date with the
+ *    changes made to its directory since last refreshed.
+ *
+ *  Pending change notifications are read without blocking and
+ *  applied in order, such that each filter reflects every change
+ *  made before the refresh. Should notifications have been lost or
+ *  be unreadable, every filter is invalidated, to be rebuilt when
+ *  next used.
+ *
+ *  This is done once at the start of each observation or mutation,
+ *  at the cost of a single system call, regardless of the number of
+ *  flags or filtered directories.
+ *
+ *  @param[in,out]  inFilters  A reference to the existence filters
+ *                             to refresh.
+ *
+ *  @private
+ *
+ */
+static void chkconfigExistenceFiltersRefresh(chkconfig_existence_filters_t &inFilters)
+{
+    alignas(struct inotify_event) char lBuffer[kChkconfigExistenceFilterBufferSize];
+    const struct inotify_event *       lEvent;
+    chkconfig_existence_filter_t *     lFilter;
+    ssize_t                            lSize;
+
+    inFilters.m_lock.lock();
+
+    if (inFilters.m_descriptor == -1)
+    {
+        goto done;
+    }
+
+    while (true)
+    {
+        lSize = read(inFilters.m_descriptor, &lBuffer[0], sizeof (lBuffer));
+
+        if (lSize == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno != EAGAIN)
+            {
+                chkconfigExistenceFiltersInvalidate(inFilters);
+            }
+
+            break;
+        }
+
+        for (ssize_t lOffset = 0; lOffset < lSize; lOffset += static_cast<ssize_t>(sizeof (struct inotify_event) + lEvent->len))
+        {
+            lEvent = reinterpret_cast<const struct inotify_event *>(&lBuffer[lOffset]);
+
+            if (lEvent->mask & IN_Q_OVERFLOW)
+            {
+                chkconfigExistenceFiltersInvalidate(inFilters);
+                continue;
+            }
+
+            for (lFilter = inFilters.m_first; lFilter != nullptr; lFilter = lFilter->m_next)
+            {
+                if (lFilter->m_watch == lEvent->wd)
+                {
+                    chkconfigExistenceFilterApply(*lFilter, *lEvent);
+                    break;
+                }
+            }
+        }
+    }
+
+ done:
+    inFilters.m_lock.unlock();
+}
+
+/**
+ *  @brief
+ *    Lock the existence filters to which a filter belongs, building
+ *    the filter if it is not valid.
+ *
+ *  @param[in,out]  inFilter  A reference to the filter to lock.
+ *
+ *  @private
+ *
+ */
+static void chkconfigExistenceFilterLock(chkconfig_existence_filter_t &inFilter)
+{
+    inFilter.m_filters->m_lock.lock();
+
+    if (!inFilter.m_valid)
+    {
+        chkconfigExistenceFilterBuild(inFilter);
+    }
+}
+
+static void chkconfigExistenceFilterUnlock(chkconfig_existence_filter_t &inFilter)
+{
+    inFilter.m_filters->m_lock.unlock();
+}
+
+/**
+ *  @brief
+ *    Determine whether an existence filter shows a flag to be
+ *    absent from its directory.
+ *
+ *  Only a valid flag naming an entry directly in the directory, the
+ *  path to which is not too long, may be excluded; any other is left
+ *  to the file system to resolve, such that it fails just as it
+ *  would without the filter.
+ *
+ *  @note
+ *    The caller must have locked the filter.
+ *
+ *  @param[in]  inFilter  A reference to the filter.
+ *  @param[in]  inFlag    A pointer to the null-terminated flag.
+ *
+ *  @returns
+ *    True if the flag is certainly absent from the directory;
+ *    otherwise, false.
+ *
+ *  @private
+ *
+ */
+static bool chkconfigExistenceFilterExcludes(const chkconfig_existence_filter_t &inFilter,
+                                             const char *inFlag)
+{
+    size_t lLength;
+    size_t lSlot;
+    bool   lRetval = false;
+
+    nlEXPECT(inFilter.m_valid, done);
+    nlEXPECT((inFlag != nullptr) && (inFlag[0] != '\0'), done);
+
+    lLength = strnlen(inFlag, NAME_MAX + 1);
+    nlEXPECT(lLength <= NAME_MAX, done);
+    nlEXPECT((inFilter.m_length + 1 + lLength) < PATH_MAX, done);
+    nlEXPECT(memchr(inFlag, '/', lLength) == nullptr, done);
+
+    lRetval = (!chkconfigFlagIndexLookup(inFilter.m_index, inFlag, lLength, lSlot) ||
+               !chkconfigFlagStateTableGetState(inFilter.m_index.m_table, inFilter.m_index.m_slots[lSlot] - 1));
+
+ done:
+    return (lRetval);
+}
+#endif // CHKCONFIG_HAVE_INOTIFY
+
+// MARK: Flag Stores
+
+/**
+ *  @brief
+ *    Determine whether a flag exists in any of a number of flag
+ *    stores.
+ *
+ *  @param[in]   inStores     A pointer to the stores to check.
+ *  @param[in]   inCount      The number of stores.
+ *  @param[in]   inFlag       A pointer to the null-terminated C
+ *                            string of the flag to check.
+ *  @param[out]  outContains  A reference to storage by which to
+ *                            return whether the flag exists in any
+ *                            of the stores if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If a store could not be
+ *                                     checked.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStoresContain(const chkconfig_store_t *inStores,
+                                                 const size_t &inCount,
+                                                 const char *inFlag,
+                                                 bool &outContains)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    outContains = false;
+
+    for (size_t lIndex = 0; (lIndex < inCount) && !outContains; lIndex++)
+    {
+        const chkconfig_store_t & lStore = inStores[lIndex];
+
+        lRetval = lStore.m_operations->m_contains(lStore, inFlag, outContains);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Read the states of flags in a directory store.
+ *
+ *  Each flag is read from its backing file in the store directory,
+ *  with batched I/O if requested and available for more than one
+ *  flag.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreRead(const chkconfig_store_t &inStore,
+                                                      const chkconfig_options_t &inOptions __attribute__((unused)),
+                                                      chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                      const size_t &inCount,
+                                                      chkconfig_status_t *outStatuses)
+{
+    constexpr bool     lUseDefaultDirectory = true;
+    char               lFlagPath[PATH_MAX];
+    chkconfig_status_t lStatus;
+    chkconfig_status_t lRetval              = CHKCONFIG_STATUS_SUCCESS;
+
+#if CHKCONFIG_HAVE_IO_URING
+    // If batched I/O is requested and available, use it; otherwise,
+    // fall back to reading one flag at a time.
+
+    if ((inOptions.m_io_queue_depth > 0) && (inCount > 0))
+    {
+        const size_t        lQueueDepth = ((inCount < inOptions.m_io_queue_depth) ?
+                                           inCount :
+                                           inOptions.m_io_queue_depth);
+        chkconfig_io_ring_t lRing;
+
+        lStatus = chkconfigIoRingInit(lRing, lQueueDepth * kChkconfigIoOperationsPerFile, lQueueDepth);
+
+        if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            lRetval = chkconfigStateGetMultiple(inStore,
+                                                lRing,
+                                                lQueueDepth,
+                                                inFlagStateTuples,
+                                                inCount,
+                                                outStatuses);
+
+            chkconfigIoRingDestroy(lRing);
+
+            goto done;
+        }
+    }
+#endif // CHKCONFIG_HAVE_IO_URING
+
+    // Without per-flag statuses, stop at the first failure;
+    // otherwise, attempt every flag and return the first failure.
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+        lStatus = chkconfigFlagPathCopy(inStore,
+                                        lTuple.m_flag,
+                                        PATH_MAX,
+                                        &lFlagPath[0]);
+
+        if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            lStatus = chkconfigStateGet(inStore.m_origin,
+                                        !lUseDefaultDirectory,
+                                        lFlagPath,
+                                        lTuple.m_state,
+                                        lTuple.m_origin);
+        }
+
+        if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lStatus;
+        }
+
+        if ((lStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+        {
+            lRetval = lStatus;
+        }
+
+        nlEXPECT((lRetval == CHKCONFIG_STATUS_SUCCESS) || (outStatuses != nullptr), done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the states of flags in a directory store.
+ *
+ *  If the store has an existence filter, each flag it shows to be
+ *  absent is resolved as such without a system call and only the
+ *  rest are read from their backing files.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreGet(const chkconfig_store_t &inStore,
+                                                     const chkconfig_options_t &inOptions,
+                                                     chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                     const size_t &inCount,
+                                                     chkconfig_status_t *outStatuses)
+{
+#if CHKCONFIG_HAVE_INOTIFY
+    chkconfig_flag_state_tuple_t   lCandidate;
+    size_t                         lPosition;
+    chkconfig_status_t             lStatus;
+    chkconfig_flag_state_tuple_t * lCandidates = &lCandidate;
+    size_t *                       lPositions  = &lPosition;
+    chkconfig_status_t *           lStatuses   = nullptr;
+    size_t                         lCount      = 0;
+#endif // CHKCONFIG_HAVE_INOTIFY
+    chkconfig_status_t             lRetval     = CHKCONFIG_STATUS_SUCCESS;
+
+#if CHKCONFIG_HAVE_INOTIFY
+    if ((inStore.m_filter != nullptr) && (inCount > 0))
+    {
+        if (inCount > 1)
+        {
+            lCandidates = static_cast<chkconfig_flag_state_tuple_t *>(malloc(inCount * sizeof (chkconfig_flag_state_tuple_t)));
+            nlREQUIRE_ACTION(lCandidates != nullptr, done, lRetval = -ENOMEM);
+
+            lPositions  = static_cast<size_t *>(malloc(inCount * sizeof (size_t)));
+            nlREQUIRE_ACTION(lPositions != nullptr, done, lRetval = -ENOMEM);
+        }
+
+        // Resolve the flags the filter excludes and collect the rest,
+        // in order, as candidates to be read.
+
+        chkconfigExistenceFilterLock(*inStore.m_filter);
+
+        for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+        {
+            chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lIndex];
+
+            if (chkconfigExistenceFilterExcludes(*inStore.m_filter, lTuple.m_flag))
+            {
+                lTuple.m_state  = false;
+                lTuple.m_origin = CHKCONFIG_ORIGIN_NONE;
+
+                if (outStatuses != nullptr)
+                {
+                    outStatuses[lIndex] = CHKCONFIG_STATUS_SUCCESS;
+                }
+            }
+            else
+            {
+                lCandidates[lCount].m_flag   = lTuple.m_flag;
+                lCandidates[lCount].m_state  = false;
+                lCandidates[lCount].m_origin = CHKCONFIG_ORIGIN_NONE;
+                lPositions[lCount++]         = lIndex;
+            }
+        }
+
+        chkconfigExistenceFilterUnlock(*inStore.m_filter);
+
+        // If every flag is a candidate, read them in place.
+
+        nlEXPECT(lCount < inCount, read);
+        nlEXPECT(lCount > 0, done);
+
+        if (outStatuses != nullptr)
+        {
+            lStatuses = &lStatus;
+
+            if (lCount > 1)
+            {
+                lStatuses = static_cast<chkconfig_status_t *>(malloc(lCount * sizeof (chkconfig_status_t)));
+                nlREQUIRE_ACTION(lStatuses != nullptr, done, lRetval = -ENOMEM);
+            }
+        }
+
+        lRetval = chkconfigDirectoryStoreRead(inStore,
+                                              inOptions,
+                                              lCandidates,
+                                              lCount,
+                                              lStatuses);
+
+        for (size_t lIndex = 0; lIndex < lCount; lIndex++)
+        {
+            chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lPositions[lIndex]];
+
+            lTuple.m_state  = lCandidates[lIndex].m_state;
+            lTuple.m_origin = lCandidates[lIndex].m_origin;
+
+            if (outStatuses != nullptr)
+            {
+                outStatuses[lPositions[lIndex]] = lStatuses[lIndex];
+            }
+        }
+
+        goto done;
+    }
+
+ read:
+#endif // CHKCONFIG_HAVE_INOTIFY
+    lRetval = chkconfigDirectoryStoreRead(inStore,
+                                          inOptions,
+                                          inFlagStateTuples,
+                                          inCount,
+                                          outStatuses);
+
+#if CHKCONFIG_HAVE_INOTIFY
+ done:
+    if (lCandidates != &lCandidate)
+    {
+        free(lCandidates);
+    }
+
+    if (lPositions != &lPosition)
+    {
+        free(lPositions);
+    }
+
+    if ((lStatuses != nullptr) && (lStatuses != &lStatus))
+    {
+        free(lStatuses);
+    }
+#endif // CHKCONFIG_HAVE_INOTIFY
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Set the states of flags in a directory store.
+ *
+ *  Each flag is written to its backing file in the store directory,
+ *  with batched I/O if requested and available for more than one
+ *  flag.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreSet(const chkconfig_store_t &inStore,
+                                                     const chkconfig_options_t &inOptions,
+                                                     const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                     const size_t &inCount,
+                                                     chkconfig_status_t *outStatuses)
+{
+    chkconfig_status_t lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+#if CHKCONFIG_HAVE_IO_URING
+    // If batched I/O is requested and available, use it; otherwise,
+    // fall back to writing one flag at a time.
+
+    if ((inOptions.m_io_queue_depth > 0) && (inCount > 0))
+    {
+        const size_t        lQueueDepth = ((inCount < inOptions.m_io_queue_depth) ?
+                                           inCount :
+                                           inOptions.m_io_queue_depth);
+        chkconfig_io_ring_t lRing;
+
+        lStatus = chkconfigIoRingInit(lRing, lQueueDepth * kChkconfigIoOperationsPerFile, lQueueDepth);
+
+        if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            lRetval = chkconfigStateSetMultiple(inStore,
+                                                inOptions,
+                                                lRing,
+                                                lQueueDepth,
+                                                inFlagStateTuples,
+                                                inCount,
+                                                outStatuses);
+
+            chkconfigIoRingDestroy(lRing);
+
+            goto done;
+        }
+    }
+#endif // CHKCONFIG_HAVE_IO_URING
+
+    // Without per-flag statuses, stop at the first failure;
+    // otherwise, attempt every flag and return the first failure.
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        lStatus = chkconfigStateSet(inStore,
+                                    inOptions,
+                                    inFlagStateTuples[lIndex].m_flag,
+                                    inFlagStateTuples[lIndex].m_state);
+
+        if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lStatus;
+        }
+
+        if ((lStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+        {
+            lRetval = lStatus;
+        }
+
+        nlEXPECT((lRetval == CHKCONFIG_STATUS_SUCCESS) || (outStatuses != nullptr), done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Append all flags in a directory store to a table.
+ *
+ *  For a store with a sharded layout, each shard subdirectory is
+ *  enumerated, in turn, as a directory in its own right.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreCopyAll(const chkconfig_store_t &inStore,
+                                                         const chkconfig_flag_match_t *inMatch,
+                                                         const bool &inReadState,
+                                                         const uint32_t &inThreads,
+                                                         chkconfig_flag_state_table_t &inTable)
+{
+    DIR *                 lDirectory = nullptr;
+    const struct dirent * lDirent;
+    char                  lShardPath[PATH_MAX];
+    int                   lStatus;
+    chkconfig_status_t    lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    if (!inStore.m_sharded)
+    {
+        lRetval = chkconfigStateCopyAll(inStore.m_origin,
+                                        inStore.m_directory,
+                                        inMatch,
+                                        inReadState,
+                                        inThreads,
+                                        inTable);
+        goto done;
+    }
+
+    lDirectory = opendir(inStore.m_directory);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    lRetval = chkconfigShardNext(lDirectory, lDirent);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    while (lDirent != nullptr)
+    {
+        lRetval = chkconfigFlagPathCopy(inStore.m_directory,
+                                        lDirent->d_name,
+                                        PATH_MAX,
+                                        &lShardPath[0]);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lRetval = chkconfigStateCopyAll(inStore.m_origin,
+                                        lShardPath,
+                                        inMatch,
+                                        inReadState,
+                                        inThreads,
+                                        inTable);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lRetval = chkconfigShardNext(lDirectory, lDirent);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Count all flags in a directory store.
+ *
+ *  For a store with a sharded layout, this is the sum of the counts
+ *  of its shard subdirectories.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreGetCount(const chkconfig_store_t &inStore,
+                                                          size_t &outCount)
+{
+    DIR *                 lDirectory = nullptr;
+    const struct dirent * lDirent;
+    char                  lShardPath[PATH_MAX];
+    size_t                lCount;
+    size_t                lTotal     = 0;
+    int                   lStatus;
+    chkconfig_status_t    lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    if (!inStore.m_sharded)
+    {
+        lRetval = chkconfigStateGetCount(inStore.m_directory, outCount);
+        goto done;
+    }
+
+    lDirectory = opendir(inStore.m_directory);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    lRetval = chkconfigShardNext(lDirectory, lDirent);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    while (lDirent != nullptr)
+    {
+        lRetval = chkconfigFlagPathCopy(inStore.m_directory,
+                                        lDirent->d_name,
+                                        PATH_MAX,
+                                        &lShardPath[0]);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lRetval = chkconfigStateGetCount(lShardPath, lCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lTotal += lCount;
+
+        lRetval = chkconfigShardNext(lDirectory, lDirent);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    outCount = lTotal;
+
+ done:
+    if (lDirectory != nullptr)
+    {
+        lStatus = closedir(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigDirectoryStoreContains(const chkconfig_store_t &inStore,
+                                                          const char *inFlag,
+                                                          bool &outContains)
+{
+    char               lFlagPath[PATH_MAX];
+    struct stat        lMetadata;
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+#if CHKCONFIG_HAVE_INOTIFY
+    if (inStore.m_filter != nullptr)
+    {
+        chkconfigExistenceFilterLock(*inStore.m_filter);
+
+        outContains = !chkconfigExistenceFilterExcludes(*inStore.m_filter, inFlag);
+
+        chkconfigExistenceFilterUnlock(*inStore.m_filter);
+
+        nlEXPECT(outContains, done);
+    }
+#endif // CHKCONFIG_HAVE_INOTIFY
+
+    lRetval = chkconfigFlagPathCopy(inStore,
+                                    inFlag,
+                                    PATH_MAX,
+                                    &lFlagPath[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lStatus = stat(lFlagPath, &lMetadata);
+    nlREQUIRE_ACTION((lStatus == 0) || (errno == ENOENT), done, lRetval = -errno);
+
+    outContains = ((lStatus == 0) && S_ISREG(lMetadata.st_mode));
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigDirectoryStoreCursorOpen(chkconfig_store_cursor_t &inCursor)
+{
+    DIR *              lDirectory;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lDirectory = opendir(inCursor.m_store.m_directory);
+    nlREQUIRE_ACTION(lDirectory != nullptr, done, lRetval = -errno);
+
+    // For a sharded layout, the first shard is opened as the cursor
+    // is first advanced.
+
+    if (inCursor.m_store.m_sharded)
+    {
+        inCursor.m_shards    = lDirectory;
+    }
+    else
+    {
+        inCursor.m_directory = lDirectory;
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Advance a directory store cursor to the next shard of a store
+ *    with a sharded layout.
+ *
+ *  This closes the current shard, if any, and opens the next, if
+ *  any.
+ *
+ *  @param[in,out]  inCursor  A reference to the cursor to advance.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If the next shard could not
+ *                                     be opened.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreCursorShardNext(chkconfig_store_cursor_t &inCursor)
+{
+    const struct dirent * lDirent;
+    int                   lDescriptor;
+    int                   lStatus;
+    chkconfig_status_t    lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    if (inCursor.m_directory != nullptr)
+    {
+        lStatus = closedir(inCursor.m_directory);
+        nlVERIFY(lStatus == 0);
+
+        inCursor.m_directory = nullptr;
+    }
+
+    lRetval = chkconfigShardNext(inCursor.m_shards, lDirent);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    nlEXPECT(lDirent != nullptr, done);
+
+    lDescriptor = openat(dirfd(inCursor.m_shards),
+                         lDirent->d_name,
+                         (O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    nlREQUIRE_ACTION(lDescriptor != -1, done, lRetval = -errno);
+
+    inCursor.m_directory = fdopendir(lDescriptor);
+    nlREQUIRE_ACTION(inCursor.m_directory != nullptr, done, lRetval = -errno; close(lDescriptor));
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Advance a cursor over a directory store.
+ *
+ *  Flags are produced in directory order, shard by shard for a
+ *  sharded layout, the state of each read from its backing file as
+ *  it is produced.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigDirectoryStoreCursorNext(chkconfig_store_cursor_t &inCursor,
+                                                            const chkconfig_store_t *inShadows,
+                                                            const size_t &inShadowCount,
+                                                            chkconfig_flag_state_tuple_t &outFlagStateTuple)
+{
+    constexpr bool     lUseDefaultDirectory = true;
+    struct dirent *    lDirent;
+    bool               lIsRegular;
+    bool               lShadowed            = false;
+    chkconfig_status_t lRetval              = CHKCONFIG_STATUS_SUCCESS;
+
+    outFlagStateTuple.m_flag = nullptr;
+
+    while (true)
+    {
+        lDirent = ((inCursor.m_directory != nullptr) ? readdir(inCursor.m_directory) : nullptr);
+
+        // For a sharded layout, move on to the next shard whenever
+        // the current one, if any, is exhausted, until there are no
+        // more.
+
+        if (lDirent == nullptr)
+        {
+            nlEXPECT(inCursor.m_store.m_sharded, done);
+
+            lRetval = chkconfigDirectoryStoreCursorShardNext(inCursor);
+            nlREQUIRE_SUCCESS(lRetval, done);
+
+            nlEXPECT(inCursor.m_directory != nullptr, done);
+
+            continue;
+        }
+
+        lRetval = chkconfigDirectoryEntryIsRegular(inCursor.m_directory,
+                                                   *lDirent,
+                                                   lIsRegular);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (!lIsRegular)
+        {
+            continue;
+        }
+
+        lRetval = chkconfigStoresContain(inShadows, inShadowCount, lDirent->d_name, lShadowed);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (lShadowed)
+        {
+            continue;
+        }
+
+        lRetval = chkconfigStateGet(inCursor.m_store.m_origin,
+                                    !lUseDefaultDirectory,
+                                    dirfd(inCursor.m_directory),
+                                    lDirent->d_name,
+                                    outFlagStateTuple.m_state,
+                                    outFlagStateTuple.m_origin);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        outFlagStateTuple.m_flag = lDirent->d_name;
+
+        break;
+    }
+
+ done:
+    return (lRetval);
+}
+
+static void chkconfigDirectoryStoreCursorClose(chkconfig_store_cursor_t &inCursor)
+{
+    int lStatus;
+
+    if (inCursor.m_directory != nullptr)
+    {
+        lStatus = closedir(inCursor.m_directory);
+        nlVERIFY(lStatus == 0);
+
+        inCursor.m_directory = nullptr;
+    }
+
+    if (inCursor.m_shards != nullptr)
+    {
+        lStatus = closedir(inCursor.m_shards);
+        nlVERIFY(lStatus == 0);
+
+        inCursor.m_shards = nullptr;
+    }
+}
+
+static chkconfig_status_t chkconfigStateLogStoreGet(const chkconfig_store_t &inStore,
+                                                    const chkconfig_options_t &inOptions __attribute__((unused)),
+                                                    chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                    const size_t &inCount,
+                                                    chkconfig_status_t *outStatuses)
+{
+    return (chkconfigStateLogGet(*inStore.m_log, inFlagStateTuples, inCount, outStatuses));
+}
+
+static chkconfig_status_t chkconfigStateLogStoreSet(const chkconfig_store_t &inStore,
+                                                    const chkconfig_options_t &inOptions,
+                                                    const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                    const size_t &inCount,
+                                                    chkconfig_status_t *outStatuses)
+{
+    return (chkconfigStateLogSet(*inStore.m_log, inOptions, inFlagStateTuples, inCount, outStatuses));
+}
+
+static chkconfig_status_t chkconfigStateLogStoreCopyAll(const chkconfig_store_t &inStore,
+                                                        const chkconfig_flag_match_t *inMatch,
+                                                        const bool &inReadState __attribute__((unused)),
+                                                        const uint32_t &inThreads __attribute__((unused)),
+                                                        chkconfig_flag_state_table_t &inTable)
+{
+    return (chkconfigStateLogCopyAll(*inStore.m_log, inMatch, inTable));
+}
+
+static chkconfig_status_t chkconfigStateLogStoreGetCount(const chkconfig_store_t &inStore,
+                                                         size_t &outCount)
+{
+    return (chkconfigStateLogGetCount(*inStore.m_log, outCount));
+}
+
+static chkconfig_status_t chkconfigStateLogStoreContains(const chkconfig_store_t &inStore,
+                                                         const char *inFlag,
+                                                         bool &outContains)
+{
+    outContains = chkconfigStateLogContains(*inStore.m_log, inFlag);
+
+    return (CHKCONFIG_STATUS_SUCCESS);
+}
+
+static chkconfig_status_t chkconfigStateLogStoreCursorOpen(chkconfig_store_cursor_t &inCursor)
+{
+    size_t             lCount;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    // Bring the log index up to date now; entries are then produced
+    // from it as it stands when each is reached.
+
+    lRetval = chkconfigStateLogGetCount(*inCursor.m_store.m_log, lCount);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    inCursor.m_next = 0;
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Advance a cursor over a flag state log store.
+ *
+ *  Flags are produced in the order first logged, from the log
+ *  index.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateLogStoreCursorNext(chkconfig_store_cursor_t &inCursor,
+                                                           const chkconfig_store_t *inShadows,
+                                                           const size_t &inShadowCount,
+                                                           chkconfig_flag_state_tuple_t &outFlagStateTuple)
+{
+    bool               lShadowed = false;
+    chkconfig_status_t lRetval   = CHKCONFIG_STATUS_SUCCESS;
+
+    outFlagStateTuple.m_flag = nullptr;
+
+    while (chkconfigStateLogEntry(*inCursor.m_store.m_log,
+                                  inCursor.m_next,
+                                  &inCursor.m_flag[0],
+                                  outFlagStateTuple.m_state))
+    {
+        inCursor.m_next++;
+
+        lRetval = chkconfigStoresContain(inShadows, inShadowCount, &inCursor.m_flag[0], lShadowed);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (lShadowed)
+        {
+            continue;
+        }
+
+        outFlagStateTuple.m_flag   = &inCursor.m_flag[0];
+        outFlagStateTuple.m_origin = inCursor.m_store.m_origin;
+
+        break;
+    }
+
+ done:
+    return (lRetval);
+}
+
+static void chkconfigStateLogStoreCursorClose(chkconfig_store_cursor_t &inCursor __attribute__((unused)))
+{
+    return;
+}
+
+static chkconfig_status_t chkconfigMemoryStoreGet(const chkconfig_store_t &inStore,
+                                                  const chkconfig_options_t &inOptions __attribute__((unused)),
+                                                  chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                  const size_t &inCount,
+                                                  chkconfig_status_t *outStatuses)
+{
+    return (chkconfigMemoryStoreGet(*inStore.m_memory, inFlagStateTuples, inCount, outStatuses));
+}
+
+static chkconfig_status_t chkconfigMemoryStoreSet(const chkconfig_store_t &inStore,
+                                                  const chkconfig_options_t &inOptions,
+                                                  const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                  const size_t &inCount,
+                                                  chkconfig_status_t *outStatuses)
+{
+    return (chkconfigMemoryStoreSet(*inStore.m_memory, inOptions, inFlagStateTuples, inCount, outStatuses));
+}
+
+static chkconfig_status_t chkconfigMemoryStoreCopyAll(const chkconfig_store_t &inStore,
+                                                      const chkconfig_flag_match_t *inMatch,
+                                                      const bool &inReadState __attribute__((unused)),
+                                                      const uint32_t &inThreads __attribute__((unused)),
+                                                      chkconfig_flag_state_table_t &inTable)
+{
+    return (chkconfigMemoryStoreCopyAll(*inStore.m_memory, inMatch, inTable));
+}
+
+static chkconfig_status_t chkconfigMemoryStoreGetCount(const chkconfig_store_t &inStore,
+                                                       size_t &outCount)
+{
+    outCount = chkconfigMemoryStoreGetCount(*inStore.m_memory);
+
+    return (CHKCONFIG_STATUS_SUCCESS);
+}
+
+static chkconfig_status_t chkconfigMemoryStoreContains(const chkconfig_store_t &inStore,
+                                                       const char *inFlag,
+                                                       bool &outContains)
+{
+    outContains = chkconfigMemoryStoreContains(*inStore.m_memory, inFlag);
+
+    return (CHKCONFIG_STATUS_SUCCESS);
+}
+
+static chkconfig_status_t chkconfigMemoryStoreCursorOpen(chkconfig_store_cursor_t &inCursor)
+{
+    inCursor.m_next = 0;
+
+    return (CHKCONFIG_STATUS_SUCCESS);
+}
+
+/**
+ *  @brief
+ *    Advance a cursor over an in-memory flag store.
+ *
+ *  Flags are produced in the order first set, from the store as it
+ *  stands when each is reached.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigMemoryStoreCursorNext(chkconfig_store_cursor_t &inCursor,
+                                                         const chkconfig_store_t *inShadows,
+                                                         const size_t &inShadowCount,
+                                                         chkconfig_flag_state_tuple_t &outFlagStateTuple)
+{
+    bool               lShadowed = false;
+    chkconfig_status_t lRetval   = CHKCONFIG_STATUS_SUCCESS;
+
+    outFlagStateTuple.m_flag = nullptr;
+
+    while (chkconfigMemoryStoreEntry(*inCursor.m_store.m_memory,
+                                     inCursor.m_next,
+                                     &inCursor.m_flag[0],
+                                     outFlagStateTuple.m_state))
+    {
+        inCursor.m_next++;
+
+        lRetval = chkconfigStoresContain(inShadows, inShadowCount, &inCursor.m_flag[0], lShadowed);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (lShadowed)
+        {
+            continue;
+        }
+
+        outFlagStateTuple.m_flag   = &inCursor.m_flag[0];
+        outFlagStateTuple.m_origin = inCursor.m_store.m_origin;
+
+        break;
+    }
+
+ done:
+    return (lRetval);
+}
+
+static void chkconfigMemoryStoreCursorClose(chkconfig_store_cursor_t &inCursor __attribute__((unused)))
+{
+    return;
+}
+
+/**
+ *  The flag store with a backing file per flag in a directory.
+ *
+ */
+static const chkconfig_store_operations_t sChkconfigDirectoryStoreOperations =
+{
+    .m_get          = chkconfigDirectoryStoreGet,
+    .m_set          = chkconfigDirectoryStoreSet,
+    .m_copy_all     = chkconfigDirectoryStoreCopyAll,
+    .m_get_count    = chkconfigDirectoryStoreGetCount,
+    .m_contains     = chkconfigDirectoryStoreContains,
+    .m_cursor_open  = chkconfigDirectoryStoreCursorOpen,
+    .m_cursor_next  = chkconfigDirectoryStoreCursorNext,
+    .m_cursor_close = chkconfigDirectoryStoreCursorClose
+};
+
+/**
+ *  The flag store with every flag in a single-file flag state log.
+ *
+ */
+static const chkconfig_store_operations_t sChkconfigStateLogStoreOperations =
+{
+    .m_get          = chkconfigStateLogStoreGet,
+    .m_set          = chkconfigStateLogStoreSet,
+    .m_copy_all     = chkconfigStateLogStoreCopyAll,
+    .m_get_count    = chkconfigStateLogStoreGetCount,
+    .m_contains     = chkconfigStateLogStoreContains,
+    .m_cursor_open  = chkconfigStateLogStoreCursorOpen,
+    .m_cursor_next  = chkconfigStateLogStoreCursorNext,
+    .m_cursor_close = chkconfigStateLogStoreCursorClose
+};
+
+/**
+ *  The flag store with every flag in memory, private to the context.
+ *
+ */
+static const chkconfig_store_operations_t sChkconfigMemoryStoreOperations =
+{
+    .m_get          = chkconfigMemoryStoreGet,
+    .m_set          = chkconfigMemoryStoreSet,
+    .m_copy_all     = chkconfigMemoryStoreCopyAll,
+    .m_get_count    = chkconfigMemoryStoreGetCount,
+    .m_contains     = chkconfigMemoryStoreContains,
+    .m_cursor_open  = chkconfigMemoryStoreCursorOpen,
+    .m_cursor_next  = chkconfigMemoryStoreCursorNext,
+    .m_cursor_close = chkconfigMemoryStoreCursorClose
+};
+
+/**
+ *  @brief
+ *    Get the read/write state flag store for a library runtime
+ *    options snapshot.
+ *
+ *  This is the one place in which the runtime options select the
+ *  store implementing the state layer of the flag overlay.
+ *
+ *  @param[in]   inOptions  A reference to the library runtime
+ *                          options snapshot.
+ *  @param[out]  outStore   A reference to storage by which to return
+ *                          the store.
+ *
+ *  @private
+ *
+ */
+static void chkconfigStateStore(const chkconfig_options_t &inOptions,
+                                chkconfig_store_t &outStore)
+{
+    if (inOptions.m_memory != nullptr)
+    {
+        outStore.m_operations = &sChkconfigMemoryStoreOperations;
+    }
+    else if (inOptions.m_log != nullptr)
+    {
+        outStore.m_operations = &sChkconfigStateLogStoreOperations;
+    }
+    else
+    {
+        outStore.m_operations = &sChkconfigDirectoryStoreOperations;
+    }
+
+    outStore.m_origin     = CHKCONFIG_ORIGIN_STATE;
+    outStore.m_directory  = inOptions.m_state_dir;
+    outStore.m_log        = inOptions.m_log;
+    outStore.m_memory     = inOptions.m_memory;
+    outStore.m_filter     = inOptions.m_state_filter;
+    outStore.m_sharded    = inOptions.m_sharded_layout;
+}
+
+/**
+ *  @brief
+ *    Get the read-only default flag store for a library runtime
+ *    options snapshot.
+ *
+ *  @param[in]   inOptions  A reference to the library runtime
+ *                          options snapshot.
+ *  @param[out]  outStore   A reference to storage by which to return
+ *                          the store.
+ *
+ *  @private
+ *
+ */
+static void chkconfigDefaultStore(const chkconfig_options_t &inOptions,
+                                  chkconfig_store_t &outStore)
+{
+    outStore.m_operations = &sChkconfigDirectoryStoreOperations;
+    outStore.m_origin     = CHKCONFIG_ORIGIN_DEFAULT;
+    outStore.m_directory  = inOptions.m_default_dir;
+    outStore.m_log        = nullptr;
+    outStore.m_memory     = nullptr;
+    outStore.m_filter     = inOptions.m_default_filter;
+    outStore.m_sharded    = inOptions.m_sharded_layout;
+}
+
+/**
+ *  @brief
+ *    Get the flag store for a layer between the state store and the
+ *    default directory.
+ *
+ *  Flags from a writable layer have a state origin and those from a
+ *  read-only layer a default origin.
+ *
+ *  @param[in]   inOptions  A reference to the library runtime
+ *                          options snapshot.
+ *  @param[in]   inLayer    A reference to the layer.
+ *  @param[out]  outStore   A reference to storage by which to return
+ *                          the store.
+ *
+ *  @private
+ *
+ */
+static void chkconfigLayerStore(const chkconfig_options_t &inOptions,
+                                const chkconfig_layer_t &inLayer,
+                                chkconfig_store_t &outStore)
+{
+    outStore.m_operations = &sChkconfigDirectoryStoreOperations;
+    outStore.m_origin     = (inLayer.m_writable ? CHKCONFIG_ORIGIN_STATE : CHKCONFIG_ORIGIN_DEFAULT);
+    outStore.m_directory  = inLayer.m_directory;
+    outStore.m_log        = nullptr;
+    outStore.m_memory     = nullptr;
+    outStore.m_filter     = inLayer.m_filter;
+    outStore.m_sharded    = inOptions.m_sharded_layout;
+}
+
+/**
+ *  @brief
+ *    Get the flag stores overlaid for a library runtime options
+ *    snapshot, in order of precedence.
+ *
+ *  @param[in]   inOptions   A reference to the library runtime
+ *                           options snapshot.
+ *  @param[out]  outOverlay  A reference to storage by which to
+ *                           return the stores.
+ *
+ *  @private
+ *
+ */
+static void chkconfigOverlay(const chkconfig_options_t &inOptions,
+                             chkconfig_overlay_t &outOverlay)
+{
+    outOverlay.m_count = 0;
+
+#if CHKCONFIG_HAVE_INOTIFY
+    if (inOptions.m_filters != nullptr)
+    {
+        chkconfigExistenceFiltersRefresh(*inOptions.m_filters);
+    }
+#endif // CHKCONFIG_HAVE_INOTIFY
+
+    chkconfigStateStore(inOptions, outOverlay.m_stores[outOverlay.m_count++]);
+
+    for (size_t lLayer = inOptions.m_layer_count; lLayer > 0; lLayer--)
+    {
+        chkconfigLayerStore(inOptions,
+                            inOptions.m_layers[lLayer - 1],
+                            outOverlay.m_stores[outOverlay.m_count++]);
+    }
+
+    if (chkconfigUseDefaultDirectory(inOptions))
+    {
+        chkconfigDefaultStore(inOptions, outOverlay.m_stores[outOverlay.m_count++]);
+    }
+}
+
+// MARK: Overlaid Observers
+
+/**
+ *  @brief
+ *    Get the states of flags from the first overlaid flag store in
+ *    which each exists.
+ *
+ *  Every flag is first gotten from the state store, in a single
+ *  batch. Then, every flag with no state in the state store, or
+ *  that could not be gotten from it, is gotten from the next store,
+ *  if any, in a second batch, and so on, such that each store is
+ *  visited once, with only those flags not yet resolved.
+ *
+ *  @param[in]      inOptions          A reference to the library
+ *                                     runtime options snapshot.
+ *  @param[in,out]  inFlagStateTuples  A pointer to the flag/state
+ *                                     tuples to get.
+ *  @param[in]      inCount            The number of flag/state
+ *                                     tuples.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inFlagStateTuples was
+ *                                     null.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated.
+ *  @retval  -errno                    The status of the first flag
+ *                                     that could not be gotten from
+ *                                     the sole store or from a store
+ *                                     following the state store.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateGetMultiple(const chkconfig_options_t &inOptions,
+                                                    chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                    const size_t &inCount)
+{
+    chkconfig_overlay_t            lOverlay;
+    chkconfig_status_t             lStatus       = CHKCONFIG_STATUS_SUCCESS;
+    chkconfig_flag_state_tuple_t   lFallback;
+    size_t                         lPendingIndex = 0;
+    chkconfig_status_t *           lStatuses     = &lStatus;
+    chkconfig_flag_state_tuple_t * lFallbacks    = &lFallback;
+    size_t *                       lPending      = &lPendingIndex;
+    size_t                         lCount        = 0;
+    size_t                         lLast         = inCount;
+    chkconfig_status_t             lFailure      = CHKCONFIG_STATUS_SUCCESS;
+    chkconfig_status_t             lRetval       = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inFlagStateTuples != nullptr, done, lRetval = -EINVAL);
+
+    chkconfigOverlay(inOptions, lOverlay);
+
+    if (lOverlay.m_count == 1)
+    {
+        lRetval = lOverlay.m_stores[0].m_operations->m_get(lOverlay.m_stores[0],
+                                                           inOptions,
+                                                           inFlagStateTuples,
+                                                           inCount,
+                                                           nullptr);
+        goto done;
+    }
+
+    if (inCount > 1)
+    {
+        lStatuses  = static_cast<chkconfig_status_t *>(malloc(inCount * sizeof (chkconfig_status_t)));
+        nlREQUIRE_ACTION(lStatuses != nullptr, done, lRetval = -ENOMEM);
+
+        lFallbacks = static_cast<chkconfig_flag_state_tuple_t *>(malloc(inCount * sizeof (chkconfig_flag_state_tuple_t)));
+        nlREQUIRE_ACTION(lFallbacks != nullptr, done, lRetval = -ENOMEM);
+
+        lPending   = static_cast<size_t *>(malloc(inCount * sizeof (size_t)));
+        nlREQUIRE_ACTION(lPending != nullptr, done, lRetval = -ENOMEM);
+    }
+
+    lOverlay.m_stores[0].m_operations->m_get(lOverlay.m_stores[0],
+                                             inOptions,
+                                             inFlagStateTuples,
+                                             inCount,
+                                             lStatuses);
+
+    // Collect the flags with no state in the state store. A flag that
+    // could not be gotten from it, for whatever reason, such as a
+    // malformed backing file, is likewise gotten from the following
+    // stores, as it always has been, rather than failing.
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+    {
+        if (lStatuses[lIndex] < CHKCONFIG_STATUS_SUCCESS)
+        {
+            inFlagStateTuples[lIndex].m_state  = false;
+            inFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_NONE;
+        }
+
+        if (inFlagStateTuples[lIndex].m_origin == CHKCONFIG_ORIGIN_NONE)
+        {
+            lPending[lCount++] = lIndex;
+        }
+    }
+
+    // Get the pending flags from each following store in turn,
+    // resolving those found there and keeping the rest pending for
+    // the next. Since the pending flags are in order, the first that
+    // could not be gotten precedes any failure found before it, and
+    // the flags after it are dropped.
+
+    for (size_t lStore = 1; (lStore < lOverlay.m_count) && (lCount > 0); lStore++)
+    {
+        const chkconfig_store_t & lLayerStore = lOverlay.m_stores[lStore];
+        size_t                    lRemaining  = 0;
+
+        for (size_t lIndex = 0; lIndex < lCount; lIndex++)
+        {
+            lFallbacks[lIndex].m_flag = inFlagStateTuples[lPending[lIndex]].m_flag;
+        }
+
+        lLayerStore.m_operations->m_get(lLayerStore,
+                                        inOptions,
+                                        lFallbacks,
+                                        lCount,
+                                        lStatuses);
+
+        for (size_t lIndex = 0; lIndex < lCount; lIndex++)
+        {
+            chkconfig_flag_state_tuple_t & lTuple = inFlagStateTuples[lPending[lIndex]];
+
+            if (lStatuses[lIndex] < CHKCONFIG_STATUS_SUCCESS)
+            {
+                lFailure = lStatuses[lIndex];
+                lLast    = lPending[lIndex];
+                break;
+            }
+
+            if (lFallbacks[lIndex].m_origin == CHKCONFIG_ORIGIN_NONE)
+            {
+                lPending[lRemaining++] = lPending[lIndex];
+            }
+            else
+            {
+                lTuple.m_state  = lFallbacks[lIndex].m_state;
+                lTuple.m_origin = lFallbacks[lIndex].m_origin;
+            }
+        }
+
+        lCount = lRemaining;
+    }
+
+    if (lLast < inCount)
+    {
+        lRetval = lFailure;
+    }
+
+ done:
+    if (lStatuses != &lStatus)
+    {
+        free(lStatuses);
+    }
+
+    if (lFallbacks != &lFallback)
+    {
+        free(lFallbacks);
+    }
+
+    if (lPending != &lPendingIndex)
+    {
+        free(lPending);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateGet(const chkconfig_options_t &inOptions,
+                                            const chkconfig_flag_t &inFlag,
+                                            chkconfig_state_t &outState,
+                                            chkconfig_origin_t &outOrigin)
+{
+    chkconfig_flag_state_tuple_t lFlagStateTuple;
+    chkconfig_status_t           lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lFlagStateTuple.m_flag = inFlag;
+
+    lRetval = chkconfigStateGetMultiple(inOptions, &lFlagStateTuple, 1);
+    nlEXPECT(lRetval == CHKCONFIG_STATUS_SUCCESS, done);
+
+    outState  = lFlagStateTuple.m_state;
+    outOrigin = lFlagStateTuple.m_origin;
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Copy all flags in a flag store into a flag/state table, sorted
+ *    by flag.
+ *
+ *  @param[in,out]  inLayer  A reference to the layer to copy, into
+ *                           which the status of copying it is
+ *                           returned.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If the layer could not be
+ *                                     copied.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateCopyLayer(chkconfig_layer_copy_t &inLayer)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = inLayer.m_store.m_operations->m_copy_all(inLayer.m_store,
+                                                       inLayer.m_match,
+                                                       inLayer.m_read_state,
+                                                       inLayer.m_threads,
+                                                       *inLayer.m_table);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfigFlagStateTableSort(*inLayer.m_table);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    inLayer.m_status = lRetval;
+
+    return (lRetval);
+}
+
+static void *chkconfigStateCopyLayerThread(void *inLayer)
+{
+    chkconfigStateCopyLayer(*static_cast<chkconfig_layer_copy_t *>(inLayer));
+
+    return (nullptr);
+}
+
+/**
+ *  @brief
+ *    Copy all flags in each overlaid flag store into a flag/state
+ *    table of its own, sorted by flag.
+ *
+ *  @param[in]   inOptions    A reference to the library runtime
+ *                            options snapshot.
+ *  @param[in]   inOverlay    A reference to the stores to copy.
+ *  @param[in]   inMatch      A pointer to the criterion flags must
+ *                            match to be copied or null to copy all
+ *                            flags.
+ *  @param[in]   inReadState  Whether to read the state of each flag
+ *                            from its backing file.
+ *  @param[out]  outTables    A pointer to initialized, empty tables,
+ *                            one for each store, by which to return
+ *                            the copies.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If a store could not be
+ *                                     copied.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateCopyLayers(const chkconfig_options_t &inOptions,
+                                                   const chkconfig_overlay_t &inOverlay,
+                                                   const chkconfig_flag_match_t *inMatch,
+                                                   const bool &inReadState,
+                                                   chkconfig_flag_state_table_t *outTables)
+{
+    const uint32_t         lShare        = ((inOptions.m_threads > inOverlay.m_count) ?
+                                            static_cast<uint32_t>(inOptions.m_threads / inOverlay.m_count) :
+                                            1);
+    const uint32_t         lSpare        = ((inOptions.m_threads > (lShare * inOverlay.m_count)) ?
+                                            static_cast<uint32_t>(inOptions.m_threads - (lShare * inOverlay.m_count)) :
+                                            0);
+    chkconfig_layer_copy_t lLayers[kChkconfigStoresMaximum];
+    pthread_t              lThreads[kChkconfigStoresMaximum];
+    bool                   lStarted[kChkconfigStoresMaximum];
+    size_t                 lStartedCount = 0;
+    int                    lStatus;
+    chkconfig_status_t     lRetval       = CHKCONFIG_STATUS_SUCCESS;
+
+    // Here, we need to consider a copy across every overlaid store.
+    // In the best case, all but one are empty. In the worst case,
+    // each contains a non-overlapping collection of flags. To
+    // navigate between those case extremes, each is copied and
+    // sorted by flag such that the caller may merge them in a single,
+    // linear pass.
+    //
+    // With more than one thread, the stores are copied concurrently,
+    // each but the state store on a thread of its own while threads
+    // remain, each with an equal share of the threads for reading
+    // backing files, the state store, on the calling thread, taking
+    // whatever threads the equal shares leave over. Since each is
+    // sorted, the result is the same either way.
+
+    for (size_t lLayer = 0; lLayer < inOverlay.m_count; lLayer++)
+    {
+        lLayers[lLayer].m_store      = inOverlay.m_stores[lLayer];
+        lLayers[lLayer].m_match      = inMatch;
+        lLayers[lLayer].m_read_state = inReadState;
+        lLayers[lLayer].m_threads    = ((lLayer == 0) ? (lShare + lSpare) : lShare);
+        lLayers[lLayer].m_table      = &outTables[lLayer];
+        lLayers[lLayer].m_status     = CHKCONFIG_STATUS_SUCCESS;
+
+        lStarted[lLayer]             = false;
+    }
+
+    for (size_t lLayer = 1; lLayer < inOverlay.m_count; lLayer++)
+    {
+        if ((lStartedCount + 1) < inOptions.m_threads)
+        {
+            lStarted[lLayer] = (pthread_create(&lThreads[lLayer],
+                                               nullptr,
+                                               chkconfigStateCopyLayerThread,
+                                               &lLayers[lLayer]) == 0);
+
+        }
+
+        if (lStarted[lLayer])
+        {
+            lStartedCount++;
+        }
+        else
+        {
+            chkconfigStateCopyLayer(lLayers[lLayer]);
+        }
+    }
+
+    chkconfigStateCopyLayer(lLayers[0]);
+
+    for (size_t lLayer = 1; lLayer < inOverlay.m_count; lLayer++)
+    {
+        if (lStarted[lLayer])
+        {
+            lStatus = pthread_join(lThreads[lLayer], nullptr);
+            nlVERIFY(lStatus == 0);
+        }
+    }
+
+    // As when copied one after the other, from the lowest precedence
+    // store up, a failure copying a lower precedence store takes
+    // precedence.
+
+    for (size_t lLayer = inOverlay.m_count; lLayer > 0; lLayer--)
+    {
+        lRetval = lLayers[lLayer - 1].m_status;
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateCopyAll(const chkconfig_options_t &inOptions,
+                                                const chkconfig_flag_match_t *inMatch,
+                                                const bool &inSorted,
+                                                chkconfig_flag_state_table_t &outTable)
+{
+    constexpr bool               lReadState = true;
+    chkconfig_overlay_t          lOverlay;
+    chkconfig_flag_state_table_t lTables[kChkconfigStoresMaximum];
+    chkconfig_status_t           lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    chkconfigOverlay(inOptions, lOverlay);
+
+    for (size_t lLayer = 0; lLayer < lOverlay.m_count; lLayer++)
+    {
+        chkconfigFlagStateTableInit(lTables[lLayer]);
+    }
+
+    // The algorithmic approach here depends on library runtime options.
+    //
+    // If the state store is the only store overlaid, then it's a
+    // simple and straightforward enumeration and copy of it, which
+    // is sorted only if requested.
+    //
+    // However, if there are other stores overlaid, such as the
+    // default directory, then we have to consider ALL of them and
+    // enumerate and copy the union thereof, which is always sorted
+    // by flag since the merge requires it.
+
+    if (lOverlay.m_count == 1)
+    {
+        lRetval = lOverlay.m_stores[0].m_operations->m_copy_all(lOverlay.m_stores[0],
+                                                                inMatch,
+                                                                lReadState,
+                                                                inOptions.m_threads,
+                                                                outTable);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (inSorted)
+        {
+            lRetval = chkconfigFlagStateTableSort(outTable);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+    }
+    else
+    {
+        lRetval = chkconfigStateCopyLayers(inOptions,
+                                           lOverlay,
+                                           inMatch,
+                                           lReadState,
+                                           &lTables[0]);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        // The tables are in order of precedence, such that the state
+        // values from each take precedence over those following it.
+
+        lRetval = chkconfigFlagStateTableMerge(&lTables[0],
+                                               lOverlay.m_count,
+                                               outTable);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    for (size_t lLayer = 0; lLayer < lOverlay.m_count; lLayer++)
+    {
+        chkconfigFlagStateTableDestroy(lTables[lLayer]);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateCopyAll(const chkconfig_options_t &inOptions,
+                                                chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                size_t &outCount)
+{
+    constexpr bool               lSorted = true;
+    constexpr bool               lPacked = true;
+    chkconfig_flag_state_table_t lTable;
+    chkconfig_status_t           lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    chkconfigFlagStateTableInit(lTable);
+
+    lRetval = chkconfigStateCopyAll(inOptions, nullptr, !lSorted, lTable);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfigFlagStateTableCopyTuples(lTable,
+                                                CHKCONFIG_SORT_ORDER_FLAG,
+                                                nullptr,
+                                                !lPacked,
+                                                outFlagStateTuples,
+                                                outCount);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    chkconfigFlagStateTableDestroy(lTable);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateCopyMatching(const chkconfig_options_t &inOptions,
+                                                     const chkconfig_flag_match_t *inMatch,
+                                                     const chkconfig_state_t *inState,
+                                                     const chkconfig_sort_order_t &inOrder,
+                                                     const bool &inPacked,
+                                                     chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                     size_t &outCount)
+{
+    constexpr bool               lSorted = true;
+    chkconfig_flag_state_table_t lTable;
+    chkconfig_status_t           lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    chkconfigFlagStateTableInit(lTable);
+
+    nlREQUIRE_ACTION((inOrder == CHKCONFIG_SORT_ORDER_FLAG) ||
+                     (inOrder == CHKCONFIG_SORT_ORDER_STATE),
+                     done,
+                     lRetval = -EINVAL);
+
+    // Copy the table sorted by flag, which, for state order, is then
+    // stably partitioned by state as it is copied out.
+    //
+    // A flag's state is only known once every overlaid store has
+    // been merged, since a store of higher precedence may override
+    // it, so any state selection is made here, from the state bitset
+    // of the merged table, rather than by each store.
+
+    lRetval = chkconfigStateCopyAll(inOptions, inMatch, lSorted, lTable);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfigFlagStateTableCopyTuples(lTable,
+                                                inOrder,
+                                                inState,
+                                                inPacked,
+                                                outFlagStateTuples,
+                                                outCount);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    chkconfigFlagStateTableDestroy(lTable);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateCopyAllSorted(const chkconfig_options_t &inOptions,
+                                                      const chkconfig_sort_order_t &inOrder,
+                                                      const bool &inPacked,
+                                                      chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                      size_t &outCount)
+{
+    return (chkconfigStateCopyMatching(inOptions,
+                                       nullptr,
+                                       nullptr,
+                                       inOrder,
+                                       inPacked,
+                                       outFlagStateTuples,
+                                       outCount));
+}
+
+static chkconfig_status_t chkconfigStateCopyPrefix(const chkconfig_options_t &inOptions,
+                                                   const char *inPrefix,
+                                                   const chkconfig_sort_order_t &inOrder,
+                                                   chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                   size_t &outCount)
+{
+    constexpr bool         lPacked = true;
+    chkconfig_flag_match_t lMatch;
+    chkconfig_status_t     lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inPrefix != nullptr, done, lRetval = -EINVAL);
+
+    lMatch.m_prefix         = inPrefix;
+    lMatch.m_prefix_length  = strlen(inPrefix);
+    lMatch.m_filter         = nullptr;
+    lMatch.m_filter_context = nullptr;
+
+    lRetval = chkconfigStateCopyMatching(inOptions,
+                                         &lMatch,
+                                         nullptr,
+                                         inOrder,
+                                         !lPacked,
+                                         outFlagStateTuples,
+                                         outCount);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateCopyFiltered(const chkconfig_options_t &inOptions,
+                                                     chkconfig_flag_filter_t inFilter,
+                                                     void *inFilterContext,
+                                                     const chkconfig_sort_order_t &inOrder,
+                                                     chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                     size_t &outCount)
+{
+    constexpr bool         lPacked = true;
+    chkconfig_flag_match_t lMatch;
+    chkconfig_status_t     lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inFilter != nullptr, done, lRetval = -EINVAL);
+
+    lMatch.m_prefix         = "";
+    lMatch.m_prefix_length  = 0;
+    lMatch.m_filter         = inFilter;
+    lMatch.m_filter_context = inFilterContext;
+
+    lRetval = chkconfigStateCopyMatching(inOptions,
+                                         &lMatch,
+                                         nullptr,
+                                         inOrder,
+                                         !lPacked,
+                                         outFlagStateTuples,
+                                         outCount);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateCopyWhere(const chkconfig_options_t &inOptions,
+                                                  const chkconfig_state_t &inState,
+                                                  const chkconfig_sort_order_t &inOrder,
+                                                  chkconfig_flag_state_tuple_t *&outFlagStateTuples,
+                                                  size_t &outCount)
+{
+    constexpr bool lPacked = true;
+
+    return (chkconfigStateCopyMatching(inOptions,
+                                       nullptr,
+                                       &inState,
+                                       inOrder,
+                                       !lPacked,
+                                       outFlagStateTuples,
+                                       outCount));
+}
+
+/**
+ *  @brief
+ *    Get the count of all flags covered by a backing store file.
+ *
+ *  This attempts to get a count of all flags covered by a backing
+ *  store file.
+ *
+ *  @note
+ *    Depending on runtime library options, the returned count may
+ *    include only the state store or every overlaid store.
+ *
+ *  @param[in]   inOptions        A reference to the chkconfig
+ *                                library runtime options
+ *                                snapshot for which to get the
+ *                                count of all flags covered by a
+ *                                backing store file.
+ *  @param[out]  outCount         A reference to storage by which
+ *                                to return the count if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateGetCount(const chkconfig_options_t &inOptions,
+                                                 size_t &outCount)
+{
+    constexpr bool               lReadState = true;
+    chkconfig_overlay_t          lOverlay;
+    chkconfig_flag_state_table_t lTables[kChkconfigStoresMaximum];
+    chkconfig_status_t           lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    chkconfigOverlay(inOptions, lOverlay);
+
+    for (size_t lLayer = 0; lLayer < lOverlay.m_count; lLayer++)
+    {
+        chkconfigFlagStateTableInit(lTables[lLayer]);
+    }
+
+    // The algorithmic approach here depends on library runtime options.
+    //
+    // If the state store is the only store overlaid, then it's a
+    // simple and straightforward enumeration of it.
+    //
+    // However, if there are other stores overlaid, then we have to
+    // consider ALL of them. In the best case, all but one are empty.
+    // In the worst case, each contains a non-overlapping collection
+    // of backing files. To navigate between those case extremes, not
+    // only must every store be counted, but the flags must be
+    // deduplicated among them such that the count of the unique
+    // union is returned. Only the names matter for that, so just the
+    // sorted names from each store are copied, without opening or
+    // reading any backing file, and counted in a single merge pass.
+
+    if (lOverlay.m_count == 1)
+    {
+        lRetval = lOverlay.m_stores[0].m_operations->m_get_count(lOverlay.m_stores[0], outCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+    else
+    {
+        lRetval = chkconfigStateCopyLayers(inOptions,
+                                           lOverlay,
+                                           nullptr,
+                                           !lReadState,
+                                           &lTables[0]);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        outCount = chkconfigFlagStateTableMergeCount(&lTables[0], lOverlay.m_count);
+    }
+
+ done:
+    for (size_t lLayer = 0; lLayer < lOverlay.m_count; lLayer++)
+    {
+        chkconfigFlagStateTableDestroy(lTables[lLayer]);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Compare the state and default stores, flag by flag.
+ *
+ *  Each of the two stores is copied once, concurrently where threads
+ *  allow, into a table of its own sorted by flag. The tables are
+ *  then walked together in a single merge pass, each flag in either
+ *  being passed to the callback, in flag order, as it is reached.
+ *  Any layers between the two are not considered.
+ *
+ *  @param[in]  inOptions          A reference to the chkconfig
+ *                                 library runtime options snapshot
+ *                                 for which to compare the stores.
+ *  @param[in]  inCallback         The function to call for each
+ *                                 flag.
+ *  @param[in]  inCallbackContext  The caller context pointer to pass
+ *                                 to @a inCallback.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the copies.
+ *  @retval  -errno                    If a store could not be
+ *                                     copied.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateDiff(const chkconfig_options_t &inOptions,
+                                             chkconfig_diff_callback_t inCallback,
+                                             void *inCallbackContext)
+{
+    constexpr bool               lReadState    = true;
+    chkconfig_overlay_t          lOverlay;
+    chkconfig_flag_state_table_t lTables[2];
+    size_t                       lStateIndex   = 0;
+    size_t                       lDefaultIndex = 0;
+    int                          lComparison;
+    chkconfig_state_t            lState;
+    chkconfig_state_t            lDefaultState;
+    chkconfig_diff_t             lDiff;
+    const char *                 lFlag;
+    chkconfig_status_t           lRetval       = CHKCONFIG_STATUS_SUCCESS;
+
+    // The default store is compared whether or not it is otherwise
+    // used as a fallback, so, of the usual overlay, only the state
+    // store is kept.
+
+    chkconfigOverlay(inOptions, lOverlay);
+
+    lOverlay.m_count = 1;
+
+    chkconfigDefaultStore(inOptions, lOverlay.m_stores[lOverlay.m_count++]);
+
+    for (size_t lLayer = 0; lLayer < lOverlay.m_count; lLayer++)
+    {
+        chkconfigFlagStateTableInit(lTables[lLayer]);
+    }
+
+    lRetval = chkconfigStateCopyLayers(inOptions,
+                                       lOverlay,
+                                       nullptr,
+                                       lReadState,
+                                       &lTables[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    while ((lStateIndex < lTables[0].m_count) || (lDefaultIndex < lTables[1].m_count))
+    {
+        if (lStateIndex == lTables[0].m_count)
+        {
+            lComparison = 1;
+        }
+        else if (lDefaultIndex == lTables[1].m_count)
+        {
+            lComparison = -1;
+        }
+        else
+        {
+            lComparison = chkconfigFlagStateTableCompare(lTables[0], lStateIndex,
+                                                         lTables[1], lDefaultIndex);
+        }
+
+        lState        = ((lComparison <= 0) && chkconfigFlagStateTableGetState(lTables[0], lStateIndex));
+        lDefaultState = ((lComparison >= 0) && chkconfigFlagStateTableGetState(lTables[1], lDefaultIndex));
+
+        if (lComparison < 0)
+        {
+            lDiff = CHKCONFIG_DIFF_STATE_ONLY;
+            lFlag = chkconfigFlagStateTableGetFlag(lTables[0], lStateIndex++);
+        }
+        else if (lComparison > 0)
+        {
+            lDiff = CHKCONFIG_DIFF_DEFAULT_ONLY;
+            lFlag = chkconfigFlagStateTableGetFlag(lTables[1], lDefaultIndex++);
+        }
+        else
+        {
+            lDiff = ((lState == lDefaultState) ? CHKCONFIG_DIFF_SHADOWS : CHKCONFIG_DIFF_DIFFERS);
+            lFlag = chkconfigFlagStateTableGetFlag(lTables[0], lStateIndex++);
+
+            lDefaultIndex++;
+        }
+
+        inCallback(lFlag, lDiff, lState, lDefaultState, inCallbackContext);
+    }
+
+ done:
+    for (size_t lLayer = 0; lLayer < lOverlay.m_count; lLayer++)
+    {
+        chkconfigFlagStateTableDestroy(lTables[lLayer]);
+    }
+
+    return (lRetval);
+}
+
+// MARK: Cursors
+
+static void chkconfigStateCursorFree(chkconfig_state_cursor_t *&inCursor)
+{
+    for (size_t lLayer = 0; lLayer < inCursor->m_count; lLayer++)
+    {
+        chkconfig_store_cursor_t & lLayerCursor = inCursor->m_layers[lLayer];
+
+        lLayerCursor.m_store.m_operations->m_cursor_close(lLayerCursor);
+    }
+
+    for (size_t lStore = 0; lStore < kChkconfigStoresMaximum; lStore++)
+    {
+        free(inCursor->m_directories[lStore]);
+    }
+
+    delete inCursor;
+
+    inCursor = nullptr;
+}
+
+/**
+ *  @brief
+ *    Open a cursor over all flags with a backing file.
+ *
+ *  Every overlaid store is opened immediately and its directory, if
+ *  any, copied, such that the cursor is unaffected by later changes
+ *  to the runtime options. A cursor over a flag state log must be
+ *  closed before the context is destroyed.
+ *
+ *  @param[in]   inOptions  A reference to the runtime options
+ *                          describing the stores to open.
+ *  @param[out]  outCursor  A reference to storage by which to return
+ *                          a pointer to the cursor if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the cursor.
+ *  @retval  -errno                    If a store could not be
+ *                                     opened.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateCursorOpen(const chkconfig_options_t &inOptions,
+                                                   chkconfig_state_cursor_t *&outCursor)
+{
+    chkconfig_state_cursor_t * lCursor = nullptr;
+    chkconfig_status_t         lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lCursor = new chkconfig_state_cursor_t;
+    nlREQUIRE_ACTION(lCursor != nullptr, done, lRetval = -ENOMEM);
+
+    lCursor->m_count = 0;
+    lCursor->m_layer = 0;
+
+    for (size_t lStore = 0; lStore < kChkconfigStoresMaximum; lStore++)
+    {
+        lCursor->m_directories[lStore] = nullptr;
+    }
+
+    // The stores are in order of precedence, such that each may be
+    // shadowed by those before it.
+
+    chkconfigOverlay(inOptions, lCursor->m_overlay);
+
+    // The store directories belong to the runtime options snapshot,
+    // which may be reclaimed as soon as the cursor is open, yet they
+    // are still needed, after that, to check whether each flag is
+    // shadowed. Consequently, the cursor keeps its own copies.
+
+    for (size_t lStore = 0; lStore < lCursor->m_overlay.m_count; lStore++)
+    {
+        chkconfig_store_t & lLayerStore = lCursor->m_overlay.m_stores[lStore];
+
+        if (lLayerStore.m_directory != nullptr)
+        {
+            lCursor->m_directories[lStore] = strdup(lLayerStore.m_directory);
+            nlREQUIRE_ACTION(lCursor->m_directories[lStore] != nullptr, done, lRetval = -ENOMEM);
+
+            lLayerStore.m_directory = lCursor->m_directories[lStore];
+        }
+    }
+
+    while (lCursor->m_count < lCursor->m_overlay.m_count)
+    {
+        chkconfig_store_cursor_t & lLayerCursor = lCursor->m_layers[lCursor->m_count];
+
+        lLayerCursor.m_store     = lCursor->m_overlay.m_stores[lCursor->m_count];
+        lLayerCursor.m_directory = nullptr;
+        lLayerCursor.m_shards    = nullptr;
+        lLayerCursor.m_next      = 0;
+
+        lRetval = lLayerCursor.m_store.m_operations->m_cursor_open(lLayerCursor);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lCursor->m_count++;
+    }
+
+    outCursor = lCursor;
+
+ done:
+    if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && (lCursor != nullptr))
+    {
+        chkconfigStateCursorFree(lCursor);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Advance a cursor to the next flag with a backing file.
+ *
+ *  Flags in the state store are produced first, followed by those in
+ *  each following store not also in a store before it. Each store
+ *  produces its flags in its own order.
+ *
+ *  @param[in,out]  inCursor          A reference to the cursor to
+ *                                    advance.
+ *  @param[out]     outFlagStateTuple A reference to storage by which
+ *                                    to return the flag, its state,
+ *                                    and its origin, or a null flag
+ *                                    once the cursor is exhausted.
+ *                                    The flag is valid until the
+ *                                    cursor is next advanced or
+ *                                    closed.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If a flag could not be checked
+ *                                     or its state could not be read.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateCursorNext(chkconfig_state_cursor_t &inCursor,
+                                                   chkconfig_flag_state_tuple_t &outFlagStateTuple)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    outFlagStateTuple.m_flag = nullptr;
+
+    while (inCursor.m_layer < inCursor.m_count)
+    {
+        chkconfig_store_cursor_t & lLayerCursor = inCursor.m_layers[inCursor.m_layer];
+
+        // A flag also present in a store before this one has already
+        // been produced from there.
+
+        lRetval = lLayerCursor.m_store.m_operations->m_cursor_next(lLayerCursor,
+                                                                   &inCursor.m_overlay.m_stores[0],
+                                                                   inCursor.m_layer,
+                                                                   outFlagStateTuple);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (outFlagStateTuple.m_flag != nullptr)
+        {
+            break;
+        }
+
+        inCursor.m_layer++;
+    }
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Get the count of all flags covered by a backing store file, by
+ *    state and by origin.
+ *
+ *  The flags are counted in a single pass of a cursor over every
+ *  overlaid store, such that no flag is copied and no table or
+ *  tuple array is formed.
+ *
+ *  @param[in]   inOptions      A reference to the chkconfig library
+ *                              runtime options snapshot for which
+ *                              to count the flags.
+ *  @param[out]  outOn          A reference to storage by which to
+ *                              return the count of flags that are
+ *                              on if successful.
+ *  @param[out]  outOff         A reference to storage by which to
+ *                              return the count of flags that are
+ *                              off if successful.
+ *  @param[out]  outByOrigin    A reference to storage by which to
+ *                              return the counts for each origin if
+ *                              successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the cursor.
+ *  @retval  -errno                    If a store could not be
+ *                                     opened or a flag state could
+ *                                     not be read.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateGetCounts(const chkconfig_options_t &inOptions,
+                                                  size_t &outOn,
+                                                  size_t &outOff,
+                                                  chkconfig_origin_counts_t &outByOrigin)
+{
+    chkconfig_state_cursor_t *   lCursor      = nullptr;
+    chkconfig_origin_counts_t    lByOrigin;
+    chkconfig_state_counts_t *   lCounts;
+    chkconfig_flag_state_tuple_t lFlagStateTuple;
+    chkconfig_status_t           lRetval      = CHKCONFIG_STATUS_SUCCESS;
+
+    memset(&lByOrigin, 0, sizeof (lByOrigin));
+
+    lRetval = chkconfigStateCursorOpen(inOptions, lCursor);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    while (true)
+    {
+        lRetval = chkconfigStateCursorNext(*lCursor, lFlagStateTuple);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (lFlagStateTuple.m_flag == nullptr)
+        {
+            break;
+        }
+
+        lCounts = ((lFlagStateTuple.m_origin == CHKCONFIG_ORIGIN_DEFAULT) ?
+                   &lByOrigin.m_default :
+                   &lByOrigin.m_state);
+
+        if (lFlagStateTuple.m_state)
+        {
+            lCounts->m_on++;
+        }
+        else
+        {
+            lCounts->m_off++;
+        }
+    }
+
+    outOn       = (lByOrigin.m_default.m_on  + lByOrigin.m_state.m_on);
+    outOff      = (lByOrigin.m_default.m_off + lByOrigin.m_state.m_off);
+    outByOrigin = lByOrigin;
+
+ done:
+    if (lCursor != nullptr)
+    {
+        chkconfigStateCursorFree(lCursor);
+    }
+
+    return (lRetval);
+}
+
+// MARK: Overlaid Mutators
+
+/**
+ *  @brief
+ *    Get the overlaid flag store in which to set a flag.
+ *
+ *  This is the first writable store, starting with the state store,
+ *  in which the flag already exists or, failing that, the state
+ *  store.
+ *
+ *  @param[in]   inOverlay  A reference to the overlaid stores.
+ *  @param[in]   inFlag     A pointer to the null-terminated C string
+ *                          of the flag to set.
+ *  @param[out]  outStore   A reference to storage by which to return
+ *                          the index of the store if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If a store could not be
+ *                                     checked.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateSetStore(const chkconfig_overlay_t &inOverlay,
+                                                 const char *inFlag,
+                                                 size_t &outStore)
+{
+    bool               lContains = false;
+    chkconfig_status_t lRetval   = CHKCONFIG_STATUS_SUCCESS;
+
+    outStore = 0;
+
+    for (size_t lStore = 0; lStore < inOverlay.m_count; lStore++)
+    {
+        const chkconfig_store_t & lLayerStore = inOverlay.m_stores[lStore];
+
+        if (lLayerStore.m_origin != CHKCONFIG_ORIGIN_STATE)
+        {
+            continue;
+        }
+
+        lRetval = lLayerStore.m_operations->m_contains(lLayerStore, inFlag, lContains);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        if (lContains)
+        {
+            outStore = lStore;
+            break;
+        }
+    }
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateSetMultiple(const chkconfig_options_t &inOptions,
+                                                    const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                                    const size_t &inCount,
+                                                    chkconfig_status_t *outStatuses)
+{
+    chkconfig_overlay_t lOverlay;
+    bool                lWritableLayers = false;
+    size_t              lStore;
+    size_t              lNextStore;
+    size_t              lEnd;
+    chkconfig_status_t  lStatus;
+    chkconfig_status_t  lRetval         = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inFlagStateTuples != nullptr, done, lRetval = -EINVAL);
+
+    chkconfigOverlay(inOptions, lOverlay);
+
+    for (size_t lLayer = 1; lLayer < lOverlay.m_count; lLayer++)
+    {
+        lWritableLayers = (lWritableLayers || (lOverlay.m_stores[lLayer].m_origin == CHKCONFIG_ORIGIN_STATE));
+    }
+
+    // Without writable layers, flags are only ever set in the state
+    // store; the default store and any other layers are read-only.
+
+    if (!lWritableLayers)
+    {
+        lRetval = lOverlay.m_stores[0].m_operations->m_set(lOverlay.m_stores[0],
+                                                           inOptions,
+                                                           inFlagStateTuples,
+                                                           inCount,
+                                                           outStatuses);
+        goto done;
+    }
+
+    // Otherwise, set each run of consecutive flags bound for the same
+    // store in a single batch. Without per-flag statuses, stop at the
+    // first failure; otherwise, attempt every flag and return the
+    // first failure.
+
+    for (size_t lIndex = 0; lIndex < inCount; lIndex = lEnd)
+    {
+        lEnd    = (lIndex + 1);
+
+        lStatus = chkconfigStateSetStore(lOverlay, inFlagStateTuples[lIndex].m_flag, lStore);
+
+        if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            while ((lEnd < inCount) &&
+                   (chkconfigStateSetStore(lOverlay, inFlagStateTuples[lEnd].m_flag, lNextStore) == CHKCONFIG_STATUS_SUCCESS) &&
+                   (lNextStore == lStore))
+            {
+                lEnd++;
+            }
+
+            lStatus = lOverlay.m_stores[lStore].m_operations->m_set(lOverlay.m_stores[lStore],
+                                                                    inOptions,
+                                                                    &inFlagStateTuples[lIndex],
+                                                                    (lEnd - lIndex),
+                                                                    ((outStatuses != nullptr) ? &outStatuses[lIndex] : nullptr));
+        }
+        else if (outStatuses != nullptr)
+        {
+            outStatuses[lIndex] = lStatus;
+        }
+
+        if ((lStatus < CHKCONFIG_STATUS_SUCCESS) && (lRetval == CHKCONFIG_STATUS_SUCCESS))
+        {
+            lRetval = lStatus;
+        }
+
+        nlEXPECT((lRetval == CHKCONFIG_STATUS_SUCCESS) || (outStatuses != nullptr), done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigStateSet(const chkconfig_options_t &inOptions,
+                                            const chkconfig_flag_t &inFlag,
+                                            const chkconfig_state_t &inState)
+{
+    chkconfig_flag_state_tuple_t lFlagStateTuple;
+
+    lFlagStateTuple.m_flag   = inFlag;
+    lFlagStateTuple.m_state  = inState;
+    lFlagStateTuple.m_origin = CHKCONFIG_ORIGIN_STATE;
+
+    return (chkconfigStateSetMultiple(inOptions, &lFlagStateTuple, 1, nullptr));
+}
+
+/**
+ *  @brief
+ *    Set the states of a full set of flags, writing only those that
+ *    change.
+ *
+ *  The current state of every flag is copied, sorted by flag, once,
+ *  and walked together with the flags to import, also sorted by
+ *  flag, in a single merge pass to form the minimal set of changes.
+ *  Those, alone, are then set in a single batch, once every change
+ *  is known to be settable.
+ *
+ *  @param[in]   inOptions          A reference to the library
+ *                                  runtime options snapshot.
+ *  @param[in]   inFlagStateTuples  A pointer to the flag/state
+ *                                  tuples to import.
+ *  @param[in]   inCount            The number of flag/state tuples.
+ *  @param[in]   inPrune            Whether flags from a writable
+ *                                  store that are on but are absent
+ *                                  from @a inFlagStateTuples are to
+ *                                  be set off.
+ *  @param[out]  outChanged         A reference to storage by which to
+ *                                  return the number of flags set if
+ *                                  successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If any flag in @a
+ *                                     inFlagStateTuples is null or
+ *                                     appears more than once.
+ *  @retval  -ENOENT                   If the state of a flag that no
+ *                                     writable store has would change
+ *                                     and creating it is not forced.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated.
+ *  @retval  -errno                    The status of the first flag
+ *                                     that could not be set.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateImport(const chkconfig_options_t &inOptions,
+                                               const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                               const size_t &inCount,
+                                               const bool &inPrune,
+                                               size_t &outChanged)
+{
+    constexpr bool                 lSorted       = true;
+    chkconfig_flag_state_table_t   lTable;
+    chkconfig_flag_state_tuple_t * lImports      = nullptr;
+    chkconfig_flag_state_tuple_t * lChanges      = nullptr;
+    size_t                         lChangeCount  = 0;
+    size_t                         lImportIndex  = 0;
+    size_t                         lTableIndex   = 0;
+    int                            lComparison;
+    chkconfig_status_t             lRetval       = CHKCONFIG_STATUS_SUCCESS;
+
+    chkconfigFlagStateTableInit(lTable);
+
+    // Sort a shallow copy of the flags to import, such that they may
+    // be merged with the current flags, and reject any duplicates
+    // before anything is written.
+
+    if (inCount > 0)
+    {
+        lImports = static_cast<chkconfig_flag_state_tuple_t *>(malloc(inCount * sizeof (chkconfig_flag_state_tuple_t)));
+        nlREQUIRE_ACTION(lImports != nullptr, done, lRetval = -ENOMEM);
+
+        memcpy(lImports, inFlagStateTuples, inCount * sizeof (chkconfig_flag_state_tuple_t));
+
+        for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+        {
+            nlREQUIRE_ACTION(lImports[lIndex].m_flag != nullptr, done, lRetval = -EINVAL);
+        }
+
+        lRetval = chkconfigFlagStateTuplesSort(lImports, inCount, CHKCONFIG_SORT_ORDER_FLAG);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        for (size_t lIndex = 1; lIndex < inCount; lIndex++)
+        {
+            nlREQUIRE_ACTION(strcmp(lImports[lIndex - 1].m_flag, lImports[lIndex].m_flag) != 0,
+                             done,
+                             lRetval = -EINVAL);
+        }
+    }
+
+    lRetval = chkconfigStateCopyAll(inOptions, nullptr, lSorted, lTable);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // At worst, every flag to import and, when pruning, every current
+    // flag changes.
+
+    if ((inCount + (inPrune ? lTable.m_count : 0)) > 0)
+    {
+        lChanges = static_cast<chkconfig_flag_state_tuple_t *>(malloc((inCount + (inPrune ? lTable.m_count : 0)) *
+                                                                     sizeof (chkconfig_flag_state_tuple_t)));
+        nlREQUIRE_ACTION(lChanges != nullptr, done, lRetval = -ENOMEM);
+    }
+
+    // Each change refers to its flag where it already is, in the
+    // flags to import or the table, both of which outlive the set.
+    //
+    // A change to a flag that no writable store has, a state origin,
+    // would create its backing file in the state store. Unless that
+    // is forced, it would fail, so it is rejected here, before
+    // anything is written, rather than partway through the set.
+    //
+    // Likewise, only those flags from a writable store are pruned,
+    // since pruning a flag from a read-only store would create a
+    // backing file in the state store to shadow it.
+
+    while ((lImportIndex < inCount) || (lTableIndex < lTable.m_count))
+    {
+        if (lImportIndex == inCount)
+        {
+            lComparison = 1;
+        }
+        else if (lTableIndex == lTable.m_count)
+        {
+            lComparison = -1;
+        }
+        else
+        {
+            lComparison = strcmp(lImports[lImportIndex].m_flag,
+                                 chkconfigFlagStateTableGetFlag(lTable, lTableIndex));
+        }
+
+        if (lComparison < 0)
+        {
+            nlEXPECT_ACTION(inOptions.m_force_state, done, lRetval = -ENOENT);
+
+            lChanges[lChangeCount++] = lImports[lImportIndex++];
+        }
+        else if (lComparison > 0)
+        {
+            if (inPrune &&
+                chkconfigFlagStateTableGetState(lTable, lTableIndex) &&
+                (chkconfigFlagStateTableGetOrigin(lTable, lTableIndex) == CHKCONFIG_ORIGIN_STATE))
+            {
+                lChanges[lChangeCount].m_flag   = chkconfigFlagStateTableGetFlag(lTable, lTableIndex);
+                lChanges[lChangeCount].m_state  = false;
+                lChanges[lChangeCount].m_origin = CHKCONFIG_ORIGIN_STATE;
+
+                lChangeCount++;
+            }
+
+            lTableIndex++;
+        }
+        else
+        {
+            if (lImports[lImportIndex].m_state != chkconfigFlagStateTableGetState(lTable, lTableIndex))
+            {
+                nlEXPECT_ACTION(inOptions.m_force_state ||
+                                (chkconfigFlagStateTableGetOrigin(lTable, lTableIndex) == CHKCONFIG_ORIGIN_STATE),
+                                done,
+                                lRetval = -ENOENT);
+
+                lChanges[lChangeCount++] = lImports[lImportIndex];
+            }
+
+            lImportIndex++;
+            lTableIndex++;
+        }
+    }
+
+    if (lChangeCount > 0)
+    {
+        lRetval = chkconfigStateSetMultiple(inOptions, lChanges, lChangeCount, nullptr);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    outChanged = lChangeCount;
+
+ done:
+    chkconfigFlagStateTableDestroy(lTable);
+
+    if (lChanges != nullptr)
+    {
+        free(lChanges);
+    }
+
+    if (lImports != nullptr)
+    {
+        free(lImports);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Migrate every writable, overlaid directory store to the layout
+ *    selected by the library runtime options.
+ *
+ *  Read-only stores are never modified; neither a flag state log
+ *  nor an in-memory state store has a layout to migrate.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigStateMigrateLayout(const chkconfig_options_t &inOptions)
+{
+    chkconfig_overlay_t lOverlay;
+    chkconfig_status_t  lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    chkconfigOverlay(inOptions, lOverlay);
+
+    for (size_t lStore = 0; lStore < lOverlay.m_count; lStore++)
+    {
+        const chkconfig_store_t & lLayerStore = lOverlay.m_stores[lStore];
+
+        if ((lLayerStore.m_origin != CHKCONFIG_ORIGIN_STATE) ||
+            (lLayerStore.m_operations != &sChkconfigDirectoryStoreOperations))
+        {
+            continue;
+        }
+
+        lRetval = chkconfigDirectoryMigrate(lLayerStore.m_directory, lLayerStore.m_sharded);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+// MARK: Asynchronous Observers and Mutators
+
+/**
+ *  @brief
+ *    Create, if it does not already exist, the pipe through which a
+ *    library context signals that performed asynchronous requests
+ *    await dispatch.
+ *
+ *  Both ends are non-blocking and closed on exec. The caller must
+ *  hold the context asynchronous request lock.
+ *
+ *  @param[in,out]  inContext  A reference to the context for which
+ *                             to create the pipe.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -errno                    If the pipe could not be
+ *                                     created or configured.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigAsyncSignalInit(chkconfig_context_t &inContext)
+{
+    int                lDescriptors[2] = { -1, -1 };
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlEXPECT(inContext.m_async_signal[0] == -1, done);
+
+    lStatus = pipe(lDescriptors);
+    nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+    for (size_t lEnd = 0; lEnd < 2; lEnd++)
+    {
+        lStatus = fcntl(lDescriptors[lEnd], F_SETFL, fcntl(lDescriptors[lEnd], F_GETFL) | O_NONBLOCK);
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+
+        lStatus = fcntl(lDescriptors[lEnd], F_SETFD, FD_CLOEXEC);
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+    }
+
+    inContext.m_async_signal[0] = lDescriptors[0];
+    inContext.m_async_signal[1] = lDescriptors[1];
+
+ done:
+    if ((lRetval < CHKCONFIG_STATUS_SUCCESS) && (lDescriptors[0] != -1))
+    {
+        close(lDescriptors[0]);
+        close(lDescriptors[1]);
+    }
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Perform an asynchronous flag observation or mutation request.
+ *
+ *  The request is performed with the runtime options in effect for
+ *  the context when it is performed.
+ *
+ *  @param[in,out]  inContext  A reference to the context for which
+ *                             to perform the request.
+ *  @param[in,out]  inRequest  A reference to the request to perform,
+ *                             into which its state, origin, and
+ *                             status are returned.
+ *
+ *  @private
+ *
+ */
+static void chkconfigAsyncRequestPerform(chkconfig_context_t &inContext,
+                                         chkconfig_async_request_t &inRequest)
+{
+    const chkconfig_options_t &lOptions = chkconfigOptionsAcquire(inContext);
+
+    if (inRequest.m_mutate)
+    {
+        inRequest.m_status = chkconfigStateSet(lOptions,
+                                               inRequest.m_flag,
+                                               inRequest.m_state);
+
+        inRequest.m_origin = ((inRequest.m_status == CHKCONFIG_STATUS_SUCCESS) ?
+                              CHKCONFIG_ORIGIN_STATE :
+                              CHKCONFIG_ORIGIN_UNKNOWN);
+    }
+    else
+    {
+        inRequest.m_status = chkconfigStateGet(lOptions,
+                                               inRequest.m_flag,
+                                               inRequest.m_state,
+                                               inRequest.m_origin);
+    }
+
+    chkconfigOptionsRelease(inContext);
+}
+
+/**
+ *  @brief
+ *    Perform asynchronous requests for a library context, in the
+ *    order queued, until asked to stop.
+ *
+ *  Each performed request is queued for dispatch. The pipe is
+ *  written to only when that queue goes from empty to non-empty,
+ *  such that it never fills however long the client goes without
+ *  dispatching.
+ *
+ *  @param[in,out]  inContext  A pointer to the context for which to
+ *                             perform requests.
+ *
+ *  @returns
+ *    Null.
+ *
+ *  @private
+ *
+ */
+static void *chkconfigAsyncThread(void *inContext)
+{
+    chkconfig_context_t &       lContext = *static_cast<chkconfig_context_t *>(inContext);
+    const uint8_t               lSignal  = 1;
+    chkconfig_async_request_t * lRequest;
+    bool                        lWasEmpty;
+    ssize_t                     lWritten;
+
+    while (true)
+    {
+        {
+            unique_lock<mutex> lLock(lContext.m_async_lock);
+
+            lContext.m_async_ready.wait(lLock, [&lContext] {
+                return ((lContext.m_async_pending != nullptr) || lContext.m_async_stopping);
+            });
+
+            if (lContext.m_async_stopping)
+            {
+                break;
+            }
+
+            lRequest                 = lContext.m_async_pending;
+            lContext.m_async_pending = lRequest->m_next;
+
+            if (lContext.m_async_pending == nullptr)
+            {
+                lContext.m_async_pending_tail = &lContext.m_async_pending;
+            }
+        }
+
+        chkconfigAsyncRequestPerform(lContext, *lRequest);
+
+        lRequest->m_next = nullptr;
+
+        lContext.m_async_lock.lock();
+
+        lWasEmpty                        = (lContext.m_async_completed == nullptr);
+        *lContext.m_async_completed_tail = lRequest;
+        lContext.m_async_completed_tail  = &lRequest->m_next;
+
+        lContext.m_async_lock.unlock();
+
+        // A full pipe or an interrupted write leaves it readable
+        // regardless, which is all that matters.
+
+        if (lWasEmpty)
+        {
+            lWritten = write(lContext.m_async_signal[1], &lSignal, sizeof (lSignal));
+            (void)lWritten;
+        }
+    }
+
+    return (nullptr);
+}
+
+/**
+ *  @brief
+ *    Queue an asynchronous flag observation or mutation request for
+ *    a library context, starting its worker thread if necessary.
+ *
+ *  @param[in,out]  inContext          A reference to the context for
+ *                                     which to queue the request.
+ *  @param[in]      inMutate           When asserted, set rather than
+ *                                     get the flag state.
+ *  @param[in]      inFlag             The flag to get or set.
+ *  @param[in]      inState            The state to set, if @a
+ *                                     inMutate is asserted.
+ *  @param[in]      inCallback         The client completion function.
+ *  @param[in]      inCallbackContext  The client completion function
+ *                                     context.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a inFlag or @a inCallback
+ *                                     was null.
+ *  @retval  -ENOMEM                   If memory could not be
+ *                                     allocated for the request.
+ *  @retval  -errno                    If the pipe or worker thread
+ *                                     could not be created.
+ *
+ *  @private
+ *
+ */
+static chkconfig_status_t chkconfigAsyncSubmit(chkconfig_context_t &inContext,
+                                               const bool &inMutate,
+                                               const chkconfig_flag_t &inFlag,
+                                               const chkconfig_state_t &inState,
+                                               const chkconfig_state_callback_t &inCallback,
+                                               void *inCallbackContext)
+{
+    chkconfig_async_request_t * lRequest = nullptr;
+    int                         lStatus;
+    chkconfig_status_t          lRetval  = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(inFlag != nullptr, done, lRetval = -EINVAL);
+    nlREQUIRE_ACTION(inCallback != nullptr, done, lRetval = -EINVAL);
+
+    lRequest = new chkconfig_async_request_t;
+    nlREQUIRE_ACTION(lRequest != nullptr, done, lRetval = -ENOMEM);
+
+    lRequest->m_next             = nullptr;
+    lRequest->m_mutate           = inMutate;
+    lRequest->m_flag             = strdup(inFlag);
+    lRequest->m_state            = inState;
+    lRequest->m_origin           = CHKCONFIG_ORIGIN_UNKNOWN;
+    lRequest->m_status           = CHKCONFIG_STATUS_SUCCESS;
+    lRequest->m_callback         = inCallback;
+    lRequest->m_callback_context = inCallbackContext;
+
+    nlREQUIRE_ACTION(lRequest->m_flag != nullptr, done, lRetval = -ENOMEM);
+
+    inContext.m_async_lock.lock();
+
+    lRetval = chkconfigAsyncSignalInit(inContext);
+    nlREQUIRE_SUCCESS(lRetval, unlock);
+
+    if (!inContext.m_async_started)
+    {
+        lStatus = pthread_create(&inContext.m_async_thread,
+                                 nullptr,
+                                 chkconfigAsyncThread,
+                                 &inContext);
+        nlREQUIRE_ACTION(lStatus == 0, unlock, lRetval = -lStatus);
+
+        inContext.m_async_started = true;
+    }
+
+    *inContext.m_async_pending_tail = lRequest;
+    inContext.m_async_pending_tail  = &lRequest->m_next;
+
+    lRequest = nullptr;
+
+ unlock:
+    inContext.m_async_lock.unlock();
+
+    if (lRetval == CHKCONFIG_STATUS_SUCCESS)
+    {
+        inContext.m_async_ready.notify_one();
+    }
+
+ done:
+    if (lRequest != nullptr)
+    {
+        chkconfigAsyncRequestFree(lRequest);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t chkconfigPollDescriptor(chkconfig_context_t &inContext,
+                                                  int &outDescriptor)
+{
+    chkconfig_status_t lRetval;
+
+    inContext.m_async_lock.lock();
+
+    lRetval = chkconfigAsyncSignalInit(inContext);
+
+    if (lRetval == CHKCONFIG_STATUS_SUCCESS)
+    {
+        outDescriptor = inContext.m_async_signal[0];
+    }
+
+    inContext.m_async_lock.unlock();
+
+    return (lRetval);
+}
+
+/**
+ *  @brief
+ *    Call the completion functions of all performed asynchronous
+ *    requests for a library context, in the order performed.
+ *
+ *  The pipe is drained before the performed requests are taken, such
+ *  that a request performed in between leaves it readable rather than
+ *  going unnoticed. No lock is held while completion functions are
+ *  called, such that they may themselves submit requests.
+ *
+ *  @param[in,out]  inContext  A reference to the context for which
+ *                             to dispatch completions.
+ *
+ *  @private
+ *
+ */
+static void chkconfigDispatch(chkconfig_context_t &inContext)
+{
+    uint8_t                     lSignals[64];
+    int                         lDescriptor;
+    chkconfig_async_request_t * lRequests;
+    chkconfig_async_request_t * lNext;
+
+    inContext.m_async_lock.lock();
+
+    lDescriptor = inContext.m_async_signal[0];
+
+    inContext.m_async_lock.unlock();
+
+    if (lDescriptor != -1)
+    {
+        while (read(lDescriptor, &lSignals[0], sizeof (lSignals)) > 0)
+        {
+            continue;
+        }
+    }
+
+    inContext.m_async_lock.lock();
+
+    lRequests                        = inContext.m_async_completed;
+    inContext.m_async_completed      = nullptr;
+    inContext.m_async_completed_tail = &inContext.m_async_completed;
+
+    inContext.m_async_lock.unlock();
+
+    while (lRequests != nullptr)
+    {
+        lNext = lRequests->m_next;
+
+        lRequests->m_callback(lRequests->m_status,
+                              lRequests->m_flag,
+                              lRequests->m_state,
+                              lRequests->m_origin,
+                              lRequests->m_callback_context);
+
+        chkconfigAsyncRequestFree(lRequests);
+
+        lRequests = lNext;
+    }
+}
+
+}; // namespace Detail
+
+}; // namespace nuovations
+
+// MARK: C
+
+// MARK: Lifetime Management
+
+using namespace nuovations;
+
+/**
+ *  @brief
+ *    Initialize a chkconfig library context.
+ *
+ *  This attempts to initialize and return a chkconfig library context
+ *  that will be used with nearly all library interfaces.
+ *
+ *  The context will be intialized with the default options the
+ *  library was instantiated with when it was built. Callers that do
+ *  not want to use the default options may call
+ *  #chkconfig_options_init and then #chkconfig_options_set to
+ *  customize runtime library behavior.
+ *
+ *  @param[out]  context_pointer  TBD
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer is null.
+ *  @retval  -ENOMEM                   If resources could not be allocated.
+ *
+ *  @sa chkconfig_options_init
+ *  @sa chkconfig_options_set
+ *  @sa chkconfig_destroy
+ *
+ *  @ingroup lifetime
+ *
+ */
+chkconfig_status_t chkconfig_init(chkconfig_context_pointer_t *context_pointer)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigInit(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Initialize a chkconfig runtime library options context.
+ *
+ *  This attempts to initialize and return a chkconfig runtime library
+ *  options context.
+ *
+ *  The context will be intialized with the default options the
+ *  library was instantiated with when it was built. Callers that do
+ *  not want to use the default options may call
+ *  #chkconfig_options_set to customize runtime library behavior.
+ *
+ *  @param[in,out]  context_pointer  TBD
+ *  @param[out]     options_pointer  TBD
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer or @a
+ *                                     options_pointer is null.
+ *
+ *  @sa chkconfig_options_set
+ *  @sa chkconfig_options_destroy
+ *
+ *  @ingroup options_lifetime
+ *
+ */
+chkconfig_status_t chkconfig_options_init(chkconfig_context_pointer_t context_pointer,
+                                          chkconfig_options_pointer_t *options_pointer)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(options_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigOptionsInit(*context_pointer,
+                                          *options_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Deinitialize a chkconfig runtime library options context.
+ *
+ *  This attempts to deinitialize and release all resources associated
+ *  with the specified chkconfig runtime library options context.
+ *
+ *  @param[in,out]  context_pointer  TBD
+ *  @param[out]     options_pointer  TBD
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer or @a
+ *                                     options_pointer is null.
+ *
+ *  @sa chkconfig_options_init
+ *
+ *  @ingroup options_lifetime
+ *
+ */
+chkconfig_status_t chkconfig_options_destroy(chkconfig_context_pointer_t context_pointer,
+                                             chkconfig_options_pointer_t *options_pointer)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(options_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigOptionsDestroy(*context_pointer,
+                                             *options_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Deinitialize a chkconfig library context.
+ *
+ *  This attempts to deinitialize and deallocate all resources
+ *  associated with the specified chkconfig library context.
+ *
+ *  @warning
+ *    The caller is responsible for calling #chkconfig_options_destroy
+ *    to deinitialize any non-default options associated with the
+ *    context before calling this interface. Failure to do so will
+ *    result in a loss of such resources as this interface does not
+ *    take on this responsibility.
+ *
+ *  @param[out]  context_pointer  TBD
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer is null.
+ *
+ *  @sa chkconfig_init
+ *
+ *  @ingroup lifetime
+ *
+ */
+chkconfig_status_t chkconfig_destroy(chkconfig_context_pointer_t *context_pointer)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigDestroy(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+// MARK: Option Management
+
+/**
+ *  @brief
+ *    Set a chkconfig library runtime option.
+ *
+ *  This attempts to set the specified chkconfig library runtime
+ *  key/value option pair, modifying the runtime behavior of the
+ *  library.
+ *
+ *  @param[in]      context_pointer  A pointer to the chkconfig
+ *                                   library context whose runtime
+ *                                   behavior is to change with the
+ *                                   specified option.
+ *  @param[in,out]  options_pointer  A pointer to the chkconfig
+ *                                   library runtime option context
+ *                                   which will be updated with the
+ *                                   specified runtime option value if
+ *                                   successful.
+ *  @param[in]      option           The key of the option key/value
+ *                                   pair indicating the option to set.
+ *  @param[in]      ...              A variadic argument list, where
+ *                                   each argument corresponds to the
+ *                                   value or the key/value pair
+ *                                   associated with its peer option
+ *                                   key in @a option.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer or @a
+ *                                     options_pointer is null or if
+ *                                     @a option is not a recognized
+ *                                     option key.
+ *
+ *  @ingroup options
+ *
+ */
+chkconfig_status_t chkconfig_options_set(chkconfig_context_pointer_t context_pointer,
+                                         chkconfig_options_pointer_t options_pointer,
+                                         chkconfig_option_t option,
+                                         ...)
+{
+    va_list            arguments;
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(options_pointer != nullptr, done, retval = -EINVAL);
+
+    va_start(arguments, option);
+
+    retval = Detail::chkconfigOptionsSet(*context_pointer,
+                                         *options_pointer,
+                                         option,
+                                         arguments);
+
+    va_end(arguments);
+
+ done:
+    return (retval);
+}
+
+// MARK: Observers
+
+/**
+ *  @brief
+ *    Get the state value associated with a flag.
+ *
+ *  This attempts to get the state value associated with the specified
+ *  flag.
+ *
+ *  @param[in]   context_pointer  A pointer to the chkconfig library
+ *                                context for which to get the state
+ *                                value for the specified flag.
+ *  @param[in]   flag             The flag for which to get the associated
+ *                                state value.
+ *  @param[out]  state            A pointer to storage by which to return
+ *                                the state value if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer or @a
+ *                                     state is null.
+ *  @retval  -ENOENT                   If the backing file associated
+ *                                     with @a flag does not exist.
+ *
+ *  @sa chkconfig_state_get_with_origin
+ *  @sa chkconfig_state_get_count
+ *  @sa chkconfig_state_get_multiple
+ *  @sa chkconfig_state_copy_all
+ *
+ *  @ingroup observers
+ *
+ */
+chkconfig_status_t chkconfig_state_get(chkconfig_context_pointer_t context_pointer,
+                                       chkconfig_flag_t flag,
+                                       chkconfig_state_t *state)
+{
+    chkconfig_origin_t origin;
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(state           != nullptr, done, retval = -EINVAL);
+
+    retval = chkconfig_state_get_with_origin(context_pointer,
+                                             flag,
+                                             state,
+                                             &origin);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Get the state and origin values  associated with a flag.
+ *
+ *  This attempts to get the state and origin values associated with
+ *  the specified flag.
+ *
+ *  @param[in]   context_pointer  A pointer to the chkconfig library
+ *                                context for which to get the state
+ *                                and origin values for the specified
+ *                                flag.
+ *  @param[in]   flag             The flag for which to get the associated
+ *                                state and origin values..
+ *  @param[out]  state            A pointer to storage by which to return
+ *                                the state value if successful.
+ *  @param[out]  origin           A pointer to storage by which to return
+ *                                the origin value if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     state, or @a origin is null.
+ *  @retval  -ENOENT                   If the backing file associated
+ *                                     with @a flag does not exist.
+ *
+ *  @sa chkconfig_state_get
+ *  @sa chkconfig_state_get_count
+ *  @sa chkconfig_state_get_multiple
+ *  @sa chkconfig_state_copy_all
+ *
+ *  @ingroup observers
+ *
+ */
+chkconfig_status_t chkconfig_state_get_with_origin(chkconfig_context_pointer_t context_pointer,
+                                                   chkconfig_flag_t flag,
+                                                   chkconfig_state_t *state,
+                                                   chkconfig_origin_t *origin)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(state           != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(origin          != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateGet(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                       flag,
+                                       *state,
+                                       *origin);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Get the state values associated with one or more flags.
+ *
+ *  This attempts to get the state values associated with the specified
+ *  flags.
+ *
+ *  Where #CHKCONFIG_OPTION_IO_QUEUE_DEPTH is non-zero and batched I/O
+ *  is available, the backing files for up to that many flags at a
+ *  time are read with a single submission to the operating system.
+ *  Otherwise, they are read one at a time. In either case, the
+ *  results are the same.
+ *
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     get the state values for the
+ *                                     specified flags.
+ *  @param[in,out]  flag_state_tuples  A pointer to the flag/state
+ *                                     tuples array for which to get
+ *                                     the state values corresponding
+ *                                     to each flag.
+ *  @param[in]      count              The number of array elements in
+ *                                     @a flag_state_tuples.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer or @a
+ *                                     flag_state_tuples is null.
+ *  @retval  -ENOENT                   If the backing file associated
+ *                                     with a flag in @a
+ *                                     flag_state_tuples does not
+ *                                     exist.
+ *
+ *  @sa chkconfig_state_get_count
+ *  @sa chkconfig_state_get
+ *  @sa chkconfig_state_copy_all
+ *  @sa chkconfig_flag_state_tuples_init
+ *
+ *  @ingroup observers
+ *
+ */
+chkconfig_status_t chkconfig_state_get_multiple(chkconfig_context_pointer_t context_pointer,
+                                                chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                                size_t count)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateGetMultiple(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                               flag_state_tuples,
+                                               count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
@@ -1534,39 +10635,48 @@ chkconfig_status_t chkconfig_init(chkconfig_context_pointer_t *context_pointer)
 
 /**
  *  @brief
- *    Initialize a chkconfig runtime library options context.
+ *    Get the count of all flags covered by a backing store file.
  *
- *  This attempts to initialize and return a chkconfig runtime library
- *  options context.
+ *  This attempts to get a count of all flags covered by a backing
+ *  store file.
  *
- *  The context will be intialized with the default options the
- *  library was instantiated with when it was built. Callers that do
- *  not want to use the default options may call
- *  #chkconfig_options_set to customize runtime library behavior.
+ *  @note
+ *    Depending on runtime library options, the returned count may
+ *    include only the state directory or both the default and state
+ *    directories.
  *
- *  @param[in,out]  context_pointer  TBD
- *  @param[out]     options_pointer  TBD
+ *  @param[in]   context_pointer  A pointer to the chkconfig
+ *                                library context for which to
+ *                                get the count of all flags
+ *                                covered by a backing store
+ *                                file.
+ *  @param[out]  count            A pointer to storage by which
+ *                                to return the count if successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
  *  @retval  -EINVAL                   If @a context_pointer or @a
- *                                     options_pointer is null.
+ *                                     count is null.
  *
- *  @sa chkconfig_options_set
- *  @sa chkconfig_options_destroy
+ *  @sa chkconfig_state_get_count
+ *  @sa chkconfig_state_get
+ *  @sa chkconfig_state_copy_all
+ *  @sa chkconfig_flag_state_tuples_init
  *
- *  @ingroup options_lifetime
+ *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_options_init(chkconfig_context_pointer_t context_pointer,
-                                          chkconfig_options_pointer_t *options_pointer)
+chkconfig_status_t chkconfig_state_get_count(chkconfig_context_pointer_t context_pointer,
+                                             size_t *count)
 {
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
     nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(options_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count           != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigOptionsInit(*context_pointer,
-                                          *options_pointer);
+    retval = Detail::chkconfigStateGetCount(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                            *count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
@@ -1574,33 +10684,129 @@ chkconfig_status_t chkconfig_options_init(chkconfig_context_pointer_t context_po
 
 /**
  *  @brief
- *    Deinitialize a chkconfig runtime library options context.
+ *    Get the count of all flags covered by a backing store file that
+ *    are on and that are off, in total and for each origin.
  *
- *  This attempts to deinitialize and release all resources associated
- *  with the specified chkconfig runtime library options context.
+ *  This attempts to get the counts of all flags covered by a backing
+ *  store file, by state and by origin, exactly as counting the
+ *  result of #chkconfig_state_copy_all would, but in a single pass
+ *  over the backing stores without copying any flag.
  *
- *  @param[in,out]  context_pointer  TBD
- *  @param[out]     options_pointer  TBD
+ *  @note
+ *    Depending on runtime library options, the returned counts may
+ *    include only the state directory or both the default and state
+ *    directories.
+ *
+ *  @param[in]   context_pointer  A pointer to the chkconfig
+ *                                library context for which to
+ *                                get the counts of all flags
+ *                                covered by a backing store
+ *                                file.
+ *  @param[out]  on               A pointer to storage by which
+ *                                to return the count of flags that
+ *                                are on if successful.
+ *  @param[out]  off              A pointer to storage by which
+ *                                to return the count of flags that
+ *                                are off if successful.
+ *  @param[out]  by_origin        An optional pointer to storage by
+ *                                which to return the counts of
+ *                                flags that are on and off for each
+ *                                origin if successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer, @a on,
+ *                                     or @a off is null.
+ *  @retval  -ENOMEM                   Resources could not be
+ *                                     allocated to enumerate the
+ *                                     flags.
+ *  @retval  -errno                    If a backing store could not
+ *                                     be enumerated or a flag state
+ *                                     could not be read.
+ *
+ *  @sa chkconfig_state_get_count
+ *  @sa chkconfig_state_copy_all
+ *
+ *  @ingroup observers
+ *
+ */
+chkconfig_status_t chkconfig_state_get_counts(chkconfig_context_pointer_t context_pointer,
+                                              size_t *on,
+                                              size_t *off,
+                                              chkconfig_origin_counts_t *by_origin)
+{
+    chkconfig_origin_counts_t lByOrigin;
+    chkconfig_status_t        retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(on              != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(off             != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateGetCounts(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                             *on,
+                                             *off,
+                                             ((by_origin != nullptr) ? *by_origin : lByOrigin));
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Compare the state and default backing stores, flag by flag.
+ *
+ *  This attempts to compare the state backing store with the default
+ *  backing store, calling @a callback, in flag order, for every flag
+ *  in either. Each flag is reported as existing only in the state
+ *  backing store, only in the default backing store, in both with
+ *  the same state (that is, shadowing the default), or in both with
+ *  different states.
+ *
+ *  Each backing store is read once and the two compared in a single
+ *  pass, without forming either their union or a flag/state tuple
+ *  array.
+ *
+ *  @note
+ *    The default backing store is compared regardless of whether
+ *    the #CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY option is asserted.
+ *
+ *  @param[in]  context_pointer   A pointer to the chkconfig library
+ *                                context for which to compare the
+ *                                backing stores.
+ *  @param[in]  callback          The function to call for each flag.
+ *  @param[in]  callback_context  An optional caller context pointer
+ *                                to pass to @a callback.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
  *  @retval  -EINVAL                   If @a context_pointer or @a
- *                                     options_pointer is null.
+ *                                     callback is null.
+ *  @retval  -ENOMEM                   Resources could not be
+ *                                     allocated to compare the
+ *                                     backing stores.
+ *  @retval  -errno                    If a backing store could not
+ *                                     be enumerated or a flag state
+ *                                     could not be read.
  *
- *  @sa chkconfig_options_init
+ *  @sa chkconfig_state_copy_all
  *
- *  @ingroup options_lifetime
+ *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_options_destroy(chkconfig_context_pointer_t context_pointer,
-                                             chkconfig_options_pointer_t *options_pointer)
+chkconfig_status_t chkconfig_state_diff(chkconfig_context_pointer_t context_pointer,
+                                        chkconfig_diff_callback_t callback,
+                                        void *callback_context)
 {
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
     nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(options_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(callback        != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigOptionsDestroy(*context_pointer,
-                                             *options_pointer);
+    retval = Detail::chkconfigStateDiff(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                        callback,
+                                        callback_context);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
@@ -1608,145 +10814,391 @@ chkconfig_status_t chkconfig_options_destroy(chkconfig_context_pointer_t context
 
 /**
  *  @brief
- *    Deinitialize a chkconfig library context.
+ *    Copy the state values associated with all flags covered by a
+ *    backing store file.
  *
- *  This attempts to deinitialize and deallocate all resources
- *  associated with the specified chkconfig library context.
+ *  This attempts to copy the state values associated with all flags
+ *  covered by a backing store file.
  *
- *  @warning
- *    The caller is responsible for calling #chkconfig_options_destroy
- *    to deinitialize any non-default options associated with the
- *    context before calling this interface. Failure to do so will
- *    result in a loss of such resources as this interface does not
- *    take on this responsibility.
+ *  @note
+ *    The caller is responsible for deallocating resources on success
+ *    associated with @a flag_state_tuples by calling
+ *    #chkconfig_flag_state_tuples_destroy.
  *
- *  @param[out]  context_pointer  TBD
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     copy the state values for all
+ *                                     flags covered by a backing
+ *                                     store file.
+ *  @param[in,out]  flag_state_tuples  A pointer to storage for a
+ *                                     pointer to a flag/state tuples
+ *                                     array which will be populated
+ *                                     with the flags and state for
+ *                                     all flags covered by a backing
+ *                                     store file.
+ *  @param[out]  count                 A pointer to storage by which
+ *                                     to return the count of the
+ *                                     number of elements in @a
+ *                                     flag_state_tuples if
+ *                                     successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
- *  @retval  -EINVAL                   If @a context_pointer is null.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     flag_state_tuples, or @a count
+ *                                     is null.
+ *  @retval  -ENOMEM                   Resources could not be allocated
+ *                                     for the @a flag_state_tuples
+ *                                     array.
  *
- *  @sa chkconfig_init
+ *  @sa chkconfig_state_get_count
+ *  @sa chkconfig_state_get
+ *  @sa chkconfig_state_get_multiple
+ *  @sa chkconfig_flag_state_tuples_init
  *
- *  @ingroup lifetime
+ *  @ingroup observers
+ *
+ */
+chkconfig_status_t chkconfig_state_copy_all(chkconfig_context_pointer_t context_pointer,
+                                            chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                            size_t *count)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateCopyAll(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                           *flag_state_tuples,
+                                           *count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Copy the state values associated with all flags covered by a
+ *    backing store file, sorted in the specified order.
+ *
+ *  This attempts to copy the state values associated with all flags
+ *  covered by a backing store file, exactly as
+ *  #chkconfig_state_copy_all does, except that the returned array is
+ *  sorted in the specified order, as though by
+ *  #chkconfig_flag_state_tuples_sort.
+ *
+ *  Because the library already sorts by flag to form the union of
+ *  the default and state directories, this is less expensive than
+ *  sorting the result of #chkconfig_state_copy_all.
+ *
+ *  @note
+ *    The caller is responsible for deallocating resources on success
+ *    associated with @a flag_state_tuples by calling
+ *    #chkconfig_flag_state_tuples_destroy.
+ *
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     copy the state values for all
+ *                                     flags covered by a backing
+ *                                     store file.
+ *  @param[in]      order              The order in which to sort the
+ *                                     returned flag/state tuples.
+ *  @param[in,out]  flag_state_tuples  A pointer to storage for a
+ *                                     pointer to a flag/state tuples
+ *                                     array which will be populated
+ *                                     with the flags and state for
+ *                                     all flags covered by a backing
+ *                                     store file.
+ *  @param[out]  count                 A pointer to storage by which
+ *                                     to return the count of the
+ *                                     number of elements in @a
+ *                                     flag_state_tuples if
+ *                                     successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     flag_state_tuples, or @a count
+ *                                     is null or if @a order is
+ *                                     invalid.
+ *  @retval  -ENOMEM                   Resources could not be allocated
+ *                                     for the @a flag_state_tuples
+ *                                     array.
+ *
+ *  @sa chkconfig_state_copy_all
+ *  @sa chkconfig_flag_state_tuples_sort
+ *
+ *  @ingroup observers
+ *
+ */
+chkconfig_status_t chkconfig_state_copy_all_sorted(chkconfig_context_pointer_t context_pointer,
+                                                   chkconfig_sort_order_t order,
+                                                   chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                   size_t *count)
+{
+    constexpr bool     lPacked = true;
+    chkconfig_status_t retval  = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateCopyAllSorted(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                                 order,
+                                                 !lPacked,
+                                                 *flag_state_tuples,
+                                                 *count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Copy the state values associated with all flags covered by a
+ *    backing store file, sorted in the specified order, into a single
+ *    allocation.
+ *
+ *  This attempts to copy the state values associated with all flags
+ *  covered by a backing store file, exactly as
+ *  #chkconfig_state_copy_all_sorted does, except that the flag/state
+ *  tuples array and the flags it points to share one allocation, the
+ *  flags following the tuples, rather than each flag being allocated
+ *  separately.
+ *
+ *  @note
+ *    The caller is responsible for deallocating resources on success
+ *    associated with @a flag_state_tuples by calling
+ *    #chkconfig_flag_state_tuples_packed_destroy and must not call
+ *    #chkconfig_flag_state_tuples_destroy or modify the flags.
+ *
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     copy the state values for all
+ *                                     flags covered by a backing
+ *                                     store file.
+ *  @param[in]      order              The order in which to sort the
+ *                                     returned flag/state tuples.
+ *  @param[in,out]  flag_state_tuples  A pointer to storage for a
+ *                                     pointer to a packed flag/state
+ *                                     tuples array which will be
+ *                                     populated with the flags and
+ *                                     state for all flags covered by
+ *                                     a backing store file.
+ *  @param[out]  count                 A pointer to storage by which
+ *                                     to return the count of the
+ *                                     number of elements in @a
+ *                                     flag_state_tuples if
+ *                                     successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     flag_state_tuples, or @a count
+ *                                     is null or if @a order is
+ *                                     invalid.
+ *  @retval  -ENOMEM                   Resources could not be allocated
+ *                                     for the @a flag_state_tuples
+ *                                     array.
+ *
+ *  @sa chkconfig_state_copy_all_sorted
+ *  @sa chkconfig_flag_state_tuples_packed_destroy
+ *
+ *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_destroy(chkconfig_context_pointer_t *context_pointer)
+chkconfig_status_t chkconfig_state_copy_all_packed(chkconfig_context_pointer_t context_pointer,
+                                                   chkconfig_sort_order_t order,
+                                                   chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                   size_t *count)
 {
-    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+    constexpr bool     lPacked = true;
+    chkconfig_status_t retval  = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigDestroy(*context_pointer);
+    retval = Detail::chkconfigStateCopyAllSorted(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                                 order,
+                                                 lPacked,
+                                                 *flag_state_tuples,
+                                                 *count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
 }
 
-// MARK: Option Management
-
 /**
  *  @brief
- *    Set a chkconfig library runtime option.
+ *    Copy the state values associated with all flags beginning with
+ *    a prefix and covered by a backing store file, sorted in the
+ *    specified order.
  *
- *  This attempts to set the specified chkconfig library runtime
- *  key/value option pair, modifying the runtime behavior of the
- *  library.
+ *  This attempts to copy the state values associated with all flags
+ *  covered by a backing store file, exactly as
+ *  #chkconfig_state_copy_all_sorted does, except that only those
+ *  flags beginning with @a prefix, such as "net." for the flags of a
+ *  hierarchical "net" namespace, are copied.
  *
- *  @param[in]      context_pointer  A pointer to the chkconfig
- *                                   library context whose runtime
- *                                   behavior is to change with the
- *                                   specified option.
- *  @param[in,out]  options_pointer  A pointer to the chkconfig
- *                                   library runtime option context
- *                                   which will be updated with the
- *                                   specified runtime option value if
- *                                   successful.
- *  @param[in]      option           The key of the option key/value
- *                                   pair indicating the option to set.
- *  @param[in]      ...              A variadic argument list, where
- *                                   each argument corresponds to the
- *                                   value or the key/value pair
- *                                   associated with its peer option
- *                                   key in @a option.
+ *  Flags are matched by name as each flag store is enumerated, such
+ *  that no backing file of a flag that does not match is opened or
+ *  read and no such flag is copied. This is less expensive than
+ *  filtering the result of #chkconfig_state_copy_all.
+ *
+ *  @note
+ *    The caller is responsible for deallocating resources on success
+ *    associated with @a flag_state_tuples by calling
+ *    #chkconfig_flag_state_tuples_destroy.
+ *
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     copy the state values for the
+ *                                     matching flags.
+ *  @param[in]      prefix             A pointer to the null-terminated
+ *                                     C string prefix that flags must
+ *                                     begin with to be copied. An
+ *                                     empty prefix matches every
+ *                                     flag.
+ *  @param[in]      order              The order in which to sort the
+ *                                     returned flag/state tuples.
+ *  @param[in,out]  flag_state_tuples  A pointer to storage for a
+ *                                     pointer to a flag/state tuples
+ *                                     array which will be populated
+ *                                     with the flags and state for
+ *                                     the matching flags.
+ *  @param[out]  count                 A pointer to storage by which
+ *                                     to return the count of the
+ *                                     number of elements in @a
+ *                                     flag_state_tuples if
+ *                                     successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
- *  @retval  -EINVAL                   If @a context_pointer or @a
- *                                     options_pointer is null or if
- *                                     @a option is not a recognized
- *                                     option key.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     prefix, @a flag_state_tuples,
+ *                                     or @a count is null or if @a
+ *                                     order is invalid.
+ *  @retval  -ENOMEM                   Resources could not be allocated
+ *                                     for the @a flag_state_tuples
+ *                                     array.
  *
- *  @ingroup options
+ *  @sa chkconfig_state_copy_all_sorted
+ *  @sa chkconfig_flag_state_tuples_destroy
+ *
+ *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_options_set(chkconfig_context_pointer_t context_pointer,
-                                         chkconfig_options_pointer_t options_pointer,
-                                         chkconfig_option_t option,
-                                         ...)
+chkconfig_status_t chkconfig_state_copy_prefix(chkconfig_context_pointer_t context_pointer,
+                                               const char *prefix,
+                                               chkconfig_sort_order_t order,
+                                               chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                               size_t *count)
 {
-    va_list            arguments;
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(options_pointer != nullptr, done, retval = -EINVAL);
-
-    va_start(arguments, option);
+    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(prefix            != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigOptionsSet(*context_pointer,
-                                         *options_pointer,
-                                         option,
-                                         arguments);
+    retval = Detail::chkconfigStateCopyPrefix(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                              prefix,
+                                              order,
+                                              *flag_state_tuples,
+                                              *count);
 
-    va_end(arguments);
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
 }
 
-// MARK: Observers
-
 /**
  *  @brief
- *    Get the state value associated with a flag.
+ *    Copy the state values associated with all flags accepted by a
+ *    filter and covered by a backing store file, sorted in the
+ *    specified order.
  *
- *  This attempts to get the state value associated with the specified
- *  flag.
+ *  This attempts to copy the state values associated with all flags
+ *  covered by a backing store file, exactly as
+ *  #chkconfig_state_copy_all_sorted does, except that only those
+ *  flags for which @a filter returns true are copied.
+ *
+ *  The filter is called with each flag as each flag store is
+ *  enumerated, before the backing file of the flag is opened or read
+ *  and before the flag is copied, such that the cost beyond
+ *  enumeration is proportional to the flags accepted. A flag in more
+ *  than one store may be offered more than once and, as stores may
+ *  be enumerated concurrently, the filter may be called from several
+ *  threads at once, though never after this returns.
  *
- *  @param[in]   context_pointer  A pointer to the chkconfig library
- *                                context for which to get the state
- *                                value for the specified flag.
- *  @param[in]   flag             The flag for which to get the associated
- *                                state value.
- *  @param[out]  state            A pointer to storage by which to return
- *                                the state value if successful.
+ *  @note
+ *    The caller is responsible for deallocating resources on success
+ *    associated with @a flag_state_tuples by calling
+ *    #chkconfig_flag_state_tuples_destroy.
+ *
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     copy the state values for the
+ *                                     accepted flags.
+ *  @param[in]      filter             The function deciding whether
+ *                                     each flag is copied.
+ *  @param[in]      filter_context     A caller context pointer to
+ *                                     pass to @a filter.
+ *  @param[in]      order              The order in which to sort the
+ *                                     returned flag/state tuples.
+ *  @param[in,out]  flag_state_tuples  A pointer to storage for a
+ *                                     pointer to a flag/state tuples
+ *                                     array which will be populated
+ *                                     with the flags and state for
+ *                                     the accepted flags.
+ *  @param[out]  count                 A pointer to storage by which
+ *                                     to return the count of the
+ *                                     number of elements in @a
+ *                                     flag_state_tuples if
+ *                                     successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
- *  @retval  -EINVAL                   If @a context_pointer or @a
- *                                     state is null.
- *  @retval  -ENOENT                   If the backing file associated
- *                                     with @a flag does not exist.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     filter, @a flag_state_tuples,
+ *                                     or @a count is null or if @a
+ *                                     order is invalid.
+ *  @retval  -ENOMEM                   Resources could not be allocated
+ *                                     for the @a flag_state_tuples
+ *                                     array.
  *
- *  @sa chkconfig_state_get_with_origin
- *  @sa chkconfig_state_get_count
- *  @sa chkconfig_state_get_multiple
- *  @sa chkconfig_state_copy_all
+ *  @sa chkconfig_state_copy_prefix
+ *  @sa chkconfig_flag_state_tuples_destroy
  *
  *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_state_get(chkconfig_context_pointer_t context_pointer,
-                                       chkconfig_flag_t flag,
-                                       chkconfig_state_t *state)
+chkconfig_status_t chkconfig_state_copy_filtered(chkconfig_context_pointer_t context_pointer,
+                                                 chkconfig_flag_filter_t filter,
+                                                 void *filter_context,
+                                                 chkconfig_sort_order_t order,
+                                                 chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                 size_t *count)
 {
-    chkconfig_origin_t origin;
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(state           != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(filter            != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
 
-    retval = chkconfig_state_get_with_origin(context_pointer,
-                                             flag,
-                                             state,
-                                             &origin);
+    retval = Detail::chkconfigStateCopyFiltered(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                                filter,
+                                                filter_context,
+                                                order,
+                                                *flag_state_tuples,
+                                                *count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
@@ -1754,51 +11206,79 @@ chkconfig_status_t chkconfig_state_get(chkconfig_context_pointer_t context_point
 
 /**
  *  @brief
- *    Get the state and origin values  associated with a flag.
+ *    Copy the state values associated with all flags with a state
+ *    and covered by a backing store file, sorted in the specified
+ *    order.
  *
- *  This attempts to get the state and origin values associated with
- *  the specified flag.
+ *  This attempts to copy the state values associated with all flags
+ *  covered by a backing store file, exactly as
+ *  #chkconfig_state_copy_all_sorted does, except that only those
+ *  flags whose state is @a state, such as every flag that is on,
+ *  are copied.
  *
- *  @param[in]   context_pointer  A pointer to the chkconfig library
- *                                context for which to get the state
- *                                and origin values for the specified
- *                                flag.
- *  @param[in]   flag             The flag for which to get the associated
- *                                state and origin values..
- *  @param[out]  state            A pointer to storage by which to return
- *                                the state value if successful.
- *  @param[out]  origin           A pointer to storage by which to return
- *                                the origin value if successful.
+ *  Each backing file is read once and flags with the other state
+ *  are passed over by way of a state bitmap, without copying them.
+ *  Where the state comes from a state log or in-memory state, no
+ *  backing file is read at all.
+ *
+ *  @note
+ *    The caller is responsible for deallocating resources on success
+ *    associated with @a flag_state_tuples by calling
+ *    #chkconfig_flag_state_tuples_destroy.
+ *
+ *  @param[in]      context_pointer    A pointer to the chkconfig
+ *                                     library context for which to
+ *                                     copy the state values for the
+ *                                     matching flags.
+ *  @param[in]      state              The state of the flags to
+ *                                     copy.
+ *  @param[in]      order              The order in which to sort the
+ *                                     returned flag/state tuples.
+ *  @param[in,out]  flag_state_tuples  A pointer to storage for a
+ *                                     pointer to a flag/state tuples
+ *                                     array which will be populated
+ *                                     with the flags and state for
+ *                                     the matching flags.
+ *  @param[out]  count                 A pointer to storage by which
+ *                                     to return the count of the
+ *                                     number of elements in @a
+ *                                     flag_state_tuples if
+ *                                     successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
  *  @retval  -EINVAL                   If @a context_pointer, @a
- *                                     state, or @a origin is null.
- *  @retval  -ENOENT                   If the backing file associated
- *                                     with @a flag does not exist.
+ *                                     flag_state_tuples, or @a count
+ *                                     is null or if @a order is
+ *                                     invalid.
+ *  @retval  -ENOMEM                   Resources could not be allocated
+ *                                     for the @a flag_state_tuples
+ *                                     array.
  *
- *  @sa chkconfig_state_get
- *  @sa chkconfig_state_get_count
- *  @sa chkconfig_state_get_multiple
- *  @sa chkconfig_state_copy_all
+ *  @sa chkconfig_state_copy_all_sorted
+ *  @sa chkconfig_flag_state_tuples_destroy
  *
  *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_state_get_with_origin(chkconfig_context_pointer_t context_pointer,
-                                                   chkconfig_flag_t flag,
-                                                   chkconfig_state_t *state,
-                                                   chkconfig_origin_t *origin)
+chkconfig_status_t chkconfig_state_copy_where(chkconfig_context_pointer_t context_pointer,
+                                              chkconfig_state_t state,
+                                              chkconfig_sort_order_t order,
+                                              chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                              size_t *count)
 {
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(state           != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(origin          != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigStateGet(*context_pointer,
-                                       flag,
-                                       *state,
-                                       *origin);
+    retval = Detail::chkconfigStateCopyWhere(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                             state,
+                                             order,
+                                             *flag_state_tuples,
+                                             *count);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
@@ -1806,49 +11286,51 @@ chkconfig_status_t chkconfig_state_get_with_origin(chkconfig_context_pointer_t c
 
 /**
  *  @brief
- *    Get the state values associated with one or more flags.
+ *    Open a cursor over all flags with a backing file.
  *
- *  This attempts to get the state values associated with the specified
- *  flags.
+ *  This opens a cursor that produces the same flags, states, and
+ *  origins as #chkconfig_state_copy_all, one at a time and straight
+ *  from the directory scan, without materializing them into an
+ *  array. Flags in the state directory are produced first, followed
+ *  by those only in the default directory, if in use.
  *
- *  @param[in]      context_pointer    A pointer to the chkconfig
- *                                     library context for which to
- *                                     get the state values for the
- *                                     specified flags.
- *  @param[in,out]  flag_state_tuples  A pointer to the flag/state
- *                                     tuples array for which to get
- *                                     the state values corresponding
- *                                     to each flag.
- *  @param[in]      count              The number of array elements in
- *                                     @a flag_state_tuples.
+ *  The cursor uses the directories named by the runtime options in
+ *  effect when it is opened and may be used from any one thread at
+ *  a time, independent of the context.
+ *
+ *  @param[in]   context_pointer  A pointer to the chkconfig library
+ *                                context for which to open the
+ *                                cursor.
+ *  @param[out]  cursor_pointer   A pointer to storage by which to
+ *                                return the cursor if successful.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
  *  @retval  -EINVAL                   If @a context_pointer or @a
- *                                     flag_state_tuples is null.
- *  @retval  -ENOENT                   If the backing file associated
- *                                     with a flag in @a
- *                                     flag_state_tuples does not
- *                                     exist.
- *
- *  @sa chkconfig_state_get_count
- *  @sa chkconfig_state_get
+ *                                     cursor_pointer is null.
+ *  @retval  -ENOMEM                   If resources could not be
+ *                                     allocated for the cursor.
+ *  @retval  -errno                    If a backing file directory
+ *                                     could not be opened.
+ *
+ *  @sa chkconfig_state_cursor_next
+ *  @sa chkconfig_state_cursor_close
  *  @sa chkconfig_state_copy_all
- *  @sa chkconfig_flag_state_tuples_init
  *
  *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_state_get_multiple(chkconfig_context_pointer_t context_pointer,
-                                                chkconfig_flag_state_tuple_t *flag_state_tuples,
-                                                size_t count)
+chkconfig_status_t chkconfig_state_cursor_open(chkconfig_context_pointer_t context_pointer,
+                                               chkconfig_state_cursor_pointer_t *cursor_pointer)
 {
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
     nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(cursor_pointer  != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigStateGetMultiple(*context_pointer,
-                                               flag_state_tuples,
-                                               count);
+    retval = Detail::chkconfigStateCursorOpen(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                              *cursor_pointer);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
 
  done:
     return (retval);
@@ -1856,110 +11338,73 @@ chkconfig_status_t chkconfig_state_get_multiple(chkconfig_context_pointer_t cont
 
 /**
  *  @brief
- *    Get the count of all flags covered by a backing store file.
- *
- *  This attempts to get a count of all flags covered by a backing
- *  store file.
+ *    Advance a cursor to the next flag with a backing file.
  *
- *  @note
- *    Depending on runtime library options, the returned count may
- *    include only the state directory or both the default and state
- *    directories.
+ *  This produces the next flag from the cursor along with its state
+ *  value, read from its backing file, and origin.
  *
- *  @param[in]   context_pointer  A pointer to the chkconfig
- *                                library context for which to
- *                                get the count of all flags
- *                                covered by a backing store
- *                                file.
- *  @param[out]  count            A pointer to storage by which
- *                                to return the count if successful.
+ *  @param[in]   cursor_pointer    A pointer to the cursor to advance.
+ *  @param[out]  flag_state_tuple  A pointer to storage by which to
+ *                                 return the next flag, state, and
+ *                                 origin if successful. Once the
+ *                                 cursor is exhausted, the flag is
+ *                                 null. The flag is owned by the
+ *                                 cursor and is valid only until the
+ *                                 cursor is next advanced or closed.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
- *  @retval  -EINVAL                   If @a context_pointer or @a
- *                                     count is null.
+ *  @retval  -EINVAL                   If @a cursor_pointer or @a
+ *                                     flag_state_tuple is null.
+ *  @retval  -errno                    If the state of the next flag
+ *                                     could not be read.
  *
- *  @sa chkconfig_state_get_count
- *  @sa chkconfig_state_get
- *  @sa chkconfig_state_copy_all
- *  @sa chkconfig_flag_state_tuples_init
+ *  @sa chkconfig_state_cursor_open
+ *  @sa chkconfig_state_cursor_close
  *
  *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_state_get_count(chkconfig_context_pointer_t context_pointer,
-                                             size_t *count)
+chkconfig_status_t chkconfig_state_cursor_next(chkconfig_state_cursor_pointer_t cursor_pointer,
+                                               chkconfig_flag_state_tuple_t *flag_state_tuple)
 {
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(count           != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(cursor_pointer   != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(flag_state_tuple != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigStateGetCount(*context_pointer,
-                                            *count);
+    retval = Detail::chkconfigStateCursorNext(*cursor_pointer,
+                                              *flag_state_tuple);
 
  done:
     return (retval);
-}
-
-/**
- *  @brief
- *    Copy the state values associated with all flags covered by a
- *    backing store file.
- *
- *  This attempts to copy the state values associated with all flags
- *  covered by a backing store file.
+}
+
+/**
+ *  @brief
+ *    Close a cursor over flags.
  *
- *  @note
- *    The caller is responsible for deallocating resources on success
- *    associated with @a flag_state_tuples by calling
- *    #chkconfig_flag_state_tuples_destroy.
+ *  This releases all resources associated with the specified cursor.
  *
- *  @param[in]      context_pointer    A pointer to the chkconfig
- *                                     library context for which to
- *                                     copy the state values for all
- *                                     flags covered by a backing
- *                                     store file.
- *  @param[in,out]  flag_state_tuples  A pointer to storage for a
- *                                     pointer to a flag/state tuples
- *                                     array which will be populated
- *                                     with the flags and state for
- *                                     all flags covered by a backing
- *                                     store file.
- *  @param[out]  count                 A pointer to storage by which
- *                                     to return the count of the
- *                                     number of elements in @a
- *                                     flag_state_tuples if
- *                                     successful.
+ *  @param[in,out]  cursor_pointer  A pointer to the cursor to close,
+ *                                  which is reset to null.
  *
  *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
- *  @retval  -EINVAL                   If @a context_pointer, @a
- *                                     flag_state_tuples, or @a count
- *                                     is null.
- *  @retval  -ENOMEM                   Resources could not be allocated
- *                                     for the @a flag_state_tuples
- *                                     array.
+ *  @retval  -EINVAL                   If @a cursor_pointer or the
+ *                                     cursor it points to is null.
  *
- *  @sa chkconfig_state_get_count
- *  @sa chkconfig_state_get
- *  @sa chkconfig_state_get_multiple
- *  @sa chkconfig_flag_state_tuples_init
+ *  @sa chkconfig_state_cursor_open
  *
  *  @ingroup observers
  *
  */
-chkconfig_status_t chkconfig_state_copy_all(chkconfig_context_pointer_t context_pointer,
-                                            chkconfig_flag_state_tuple_t **flag_state_tuples,
-                                            size_t *count)
+chkconfig_status_t chkconfig_state_cursor_close(chkconfig_state_cursor_pointer_t *cursor_pointer)
 {
     chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
 
-    nlREQUIRE_ACTION(context_pointer   != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
-    nlREQUIRE_ACTION(count             != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(cursor_pointer  != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(*cursor_pointer != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigStateCopyAll(*context_pointer,
-                                           *flag_state_tuples,
-                                           *count);
+    Detail::chkconfigStateCursorFree(*cursor_pointer);
 
  done:
     return (retval);
@@ -2005,10 +11450,12 @@ chkconfig_status_t chkconfig_state_set(chkconfig_context_pointer_t context_point
 
     nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigStateSet(*context_pointer,
+    retval = Detail::chkconfigStateSet(Detail::chkconfigOptionsAcquire(*context_pointer),
                                        flag,
                                        state);
 
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
  done:
     return (retval);
 }
@@ -2018,7 +11465,14 @@ chkconfig_status_t chkconfig_state_set(chkconfig_context_pointer_t context_point
  *    Set the state values associated with one or more flags.
  *
  *  This attempts to set the state values associated with the specified
- *  flags.
+ *  flags, stopping at the first flag that could not be set.
+ *
+ *  Where #CHKCONFIG_OPTION_IO_QUEUE_DEPTH is non-zero and batched I/O
+ *  is available, the backing files for up to that many flags at a
+ *  time are written with a single submission to the operating
+ *  system. In that case, flags in the same batch as, but after, one
+ *  that could not be set may nonetheless have been set. Use
+ *  chkconfig_state_set_multiple_with_status to determine which.
  *
  *  @param[in]  context_pointer    A pointer to the chkconfig
  *                                 library context for which to set
@@ -2055,9 +11509,432 @@ chkconfig_status_t chkconfig_state_set_multiple(chkconfig_context_pointer_t cont
 
     nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
 
-    retval = Detail::chkconfigStateSetMultiple(*context_pointer,
+    retval = Detail::chkconfigStateSetMultiple(Detail::chkconfigOptionsAcquire(*context_pointer),
                                                flag_state_tuples,
-                                               count);
+                                               count,
+                                               nullptr);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Set the state values associated with one or more flags,
+ *    returning the status of each.
+ *
+ *  This attempts to set the state values associated with all of the
+ *  specified flags, regardless of whether any one of them could not
+ *  be set, and returns the status of setting each.
+ *
+ *  As with chkconfig_state_set_multiple, backing files are written
+ *  with batched I/O where #CHKCONFIG_OPTION_IO_QUEUE_DEPTH is
+ *  non-zero and batched I/O is available.
+ *
+ *  @param[in]   context_pointer    A pointer to the chkconfig
+ *                                  library context for which to set
+ *                                  the state values for the
+ *                                  specified flags.
+ *  @param[in]   flag_state_tuples  A pointer to the flag/state
+ *                                  tuples array for which to set the
+ *                                  state values corresponding to
+ *                                  each flag.
+ *  @param[in]   count              The number of array elements in
+ *                                  @a flag_state_tuples.
+ *  @param[out]  statuses           A pointer to an array of @a count
+ *                                  statuses by which to return the
+ *                                  status of setting the state value
+ *                                  of the corresponding flag in @a
+ *                                  flag_state_tuples.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer, @a
+ *                                     flag_state_tuples, or @a
+ *                                     statuses is null.
+ *  @retval  -errno                    The status of the first flag
+ *                                     in @a flag_state_tuples whose
+ *                                     state value could not be set.
+ *
+ *  @sa chkconfig_options_set
+ *  @sa chkconfig_state_set
+ *  @sa chkconfig_state_set_multiple
+ *
+ *  @ingroup mutators
+ *
+ */
+chkconfig_status_t chkconfig_state_set_multiple_with_status(chkconfig_context_pointer_t context_pointer,
+                                                            const chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                                            size_t count,
+                                                            chkconfig_status_t *statuses)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(statuses        != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateSetMultiple(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                               flag_state_tuples,
+                                               count,
+                                               statuses);
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Set the state values of a full set of flags, writing only those
+ *    that change.
+ *
+ *  This attempts to bring the state values of all flags into line
+ *  with the specified flags, as when provisioning from a previously
+ *  exported set. The current state of every flag is read once and
+ *  compared with the specified flags, such that only those flags
+ *  whose state would change are set, in a single batch, as with
+ *  #chkconfig_state_set_multiple.
+ *
+ *  The specified flags are checked before any state value is set,
+ *  such that none is set if any flag is null or appears more than
+ *  once or if any change could not be made.
+ *
+ *  @note
+ *    As with #chkconfig_state_set_multiple, a flag without a backing
+ *    file in a writable store, including one only in the default
+ *    directory or a read-only layer, is only created if the
+ *    #CHKCONFIG_OPTION_FORCE_STATE option is asserted. Otherwise, if
+ *    the state of any such flag would change, nothing is set.
+ *
+ *  @param[in]   context_pointer    A pointer to the chkconfig
+ *                                  library context for which to set
+ *                                  the state values.
+ *  @param[in]   flag_state_tuples  A pointer to the flag/state
+ *                                  tuples array of the flags and
+ *                                  state values to import. It may be
+ *                                  null if @a count is zero.
+ *  @param[in]   count              The number of array elements in
+ *                                  @a flag_state_tuples.
+ *  @param[in]   prune              Whether flags in a writable store
+ *                                  that are on but are absent from @a
+ *                                  flag_state_tuples are to be set
+ *                                  off, such that every such flag
+ *                                  reads as though it did not exist.
+ *                                  Flags only in a read-only store are
+ *                                  left as they are.
+ *  @param[out]  changed            An optional pointer to storage by
+ *                                  which to return the number of
+ *                                  flags whose state value was set if
+ *                                  successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer is null,
+ *                                     if @a flag_state_tuples is null
+ *                                     and @a count is not zero, or
+ *                                     if any flag in @a
+ *                                     flag_state_tuples is null or
+ *                                     appears more than once.
+ *  @retval  -ENOENT                   If the state of a flag without
+ *                                     a backing file in a writable
+ *                                     store would change and the
+ *                                     #CHKCONFIG_OPTION_FORCE_STATE
+ *                                     option is not asserted.
+ *  @retval  -ENOMEM                   Resources could not be
+ *                                     allocated to compare the flags.
+ *  @retval  -errno                    The status of the first flag
+ *                                     whose state value could not be
+ *                                     read or set.
+ *
+ *  @sa chkconfig_options_set
+ *  @sa chkconfig_state_set_multiple
+ *  @sa chkconfig_state_copy_all_sorted
+ *
+ *  @ingroup mutators
+ *
+ */
+chkconfig_status_t chkconfig_state_import(chkconfig_context_pointer_t context_pointer,
+                                          const chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                          size_t count,
+                                          bool prune,
+                                          size_t *changed)
+{
+    size_t             lChanged;
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION((flag_state_tuples != nullptr) || (count == 0), done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateImport(Detail::chkconfigOptionsAcquire(*context_pointer),
+                                          flag_state_tuples,
+                                          count,
+                                          prune,
+                                          ((changed != nullptr) ? *changed : lChanged));
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Migrate the flag backing file directories in use to the layout
+ *    selected by the runtime library options.
+ *
+ *  This moves the backing file of every flag in the read/write
+ *  state directory and in any writable layer directories into the
+ *  sharded layout, if the #CHKCONFIG_OPTION_SHARDED_LAYOUT runtime
+ *  library option is asserted, or out of it, otherwise. Read-only
+ *  directories, such as the default directory, are not modified;
+ *  to migrate one, use it as the state directory.
+ *
+ *  Each backing file is atomically renamed into place, such that a
+ *  migration that is interrupted may simply be run again. Backing
+ *  files already in the selected layout are left alone.
+ *
+ *  @param[in]  context_pointer  A pointer to the chkconfig library
+ *                               context for which to migrate the
+ *                               flag backing file directories.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer is null.
+ *  @retval  -errno                    If a directory could not be
+ *                                     read or a backing file or
+ *                                     subdirectory could not be
+ *                                     moved, created, or removed.
+ *
+ *  @sa chkconfig_options_set
+ *
+ *  @ingroup mutators
+ *
+ */
+chkconfig_status_t chkconfig_state_migrate_layout(chkconfig_context_pointer_t context_pointer)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigStateMigrateLayout(Detail::chkconfigOptionsAcquire(*context_pointer));
+
+    Detail::chkconfigOptionsRelease(*context_pointer);
+
+ done:
+    return (retval);
+}
+
+// MARK: Asynchronous Observers and Mutators
+
+/**
+ *  @brief
+ *    Get the state value associated with a flag without blocking.
+ *
+ *  This queues a request to get the state value and origin
+ *  associated with the specified flag, exactly as
+ *  #chkconfig_state_get_with_origin would, and returns immediately.
+ *  The request is performed on a worker thread belonging to the
+ *  context, using the runtime options in effect when it is
+ *  performed; @a callback is called with its outcome from a later
+ *  call to #chkconfig_dispatch.
+ *
+ *  Asynchronous requests for a context are performed, and their
+ *  completions dispatched, in the order submitted.
+ *
+ *  @param[in]  context_pointer   A pointer to the chkconfig library
+ *                                context for which to get the state
+ *                                value for the specified flag.
+ *  @param[in]  flag              The flag for which to get the
+ *                                associated state value. It is
+ *                                copied and need not outlive the
+ *                                call.
+ *  @param[in]  callback          The function to call with the
+ *                                outcome of the request.
+ *  @param[in]  callback_context  An optional pointer to pass to @a
+ *                                callback.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If the request was queued.
+ *  @retval  -EINVAL                   If @a context_pointer, @a flag,
+ *                                     or @a callback is null.
+ *  @retval  -ENOMEM                   If resources could not be
+ *                                     allocated for the request.
+ *  @retval  -errno                    If the context worker thread
+ *                                     could not be started.
+ *
+ *  @sa chkconfig_state_get_with_origin
+ *  @sa chkconfig_state_set_async
+ *  @sa chkconfig_poll_fd
+ *  @sa chkconfig_dispatch
+ *
+ *  @ingroup async
+ *
+ */
+chkconfig_status_t chkconfig_state_get_async(chkconfig_context_pointer_t context_pointer,
+                                             chkconfig_flag_t flag,
+                                             chkconfig_state_callback_t callback,
+                                             void *callback_context)
+{
+    constexpr bool     lMutate = true;
+    chkconfig_status_t retval  = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigAsyncSubmit(*context_pointer,
+                                          !lMutate,
+                                          flag,
+                                          false,
+                                          callback,
+                                          callback_context);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Set the state value associated with a flag without blocking.
+ *
+ *  This queues a request to set the state value associated with the
+ *  specified flag, exactly as #chkconfig_state_set would, and returns
+ *  immediately. The request is performed on a worker thread
+ *  belonging to the context, using the runtime options in effect
+ *  when it is performed; @a callback is called with its outcome, and
+ *  an origin of #CHKCONFIG_ORIGIN_STATE on success, from a later call
+ *  to #chkconfig_dispatch.
+ *
+ *  Asynchronous requests for a context are performed, and their
+ *  completions dispatched, in the order submitted.
+ *
+ *  @param[in]  context_pointer   A pointer to the chkconfig library
+ *                                context for which to set the state
+ *                                value for the specified flag.
+ *  @param[in]  flag              The flag for which to set the
+ *                                associated state value. It is
+ *                                copied and need not outlive the
+ *                                call.
+ *  @param[in]  state             The state value to set.
+ *  @param[in]  callback          The function to call with the
+ *                                outcome of the request.
+ *  @param[in]  callback_context  An optional pointer to pass to @a
+ *                                callback.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If the request was queued.
+ *  @retval  -EINVAL                   If @a context_pointer, @a flag,
+ *                                     or @a callback is null.
+ *  @retval  -ENOMEM                   If resources could not be
+ *                                     allocated for the request.
+ *  @retval  -errno                    If the context worker thread
+ *                                     could not be started.
+ *
+ *  @sa chkconfig_state_set
+ *  @sa chkconfig_state_get_async
+ *  @sa chkconfig_poll_fd
+ *  @sa chkconfig_dispatch
+ *
+ *  @ingroup async
+ *
+ */
+chkconfig_status_t chkconfig_state_set_async(chkconfig_context_pointer_t context_pointer,
+                                             chkconfig_flag_t flag,
+                                             chkconfig_state_t state,
+                                             chkconfig_state_callback_t callback,
+                                             void *callback_context)
+{
+    constexpr bool     lMutate = true;
+    chkconfig_status_t retval  = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigAsyncSubmit(*context_pointer,
+                                          lMutate,
+                                          flag,
+                                          state,
+                                          callback,
+                                          callback_context);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Get a file descriptor that becomes readable when asynchronous
+ *    request completions await dispatch.
+ *
+ *  The descriptor is suitable for poll(2), select(2), epoll(7), or
+ *  kqueue(2) and remains valid, and the same, until the context is
+ *  destroyed. It is owned by the context and must not be read from
+ *  or closed by the caller; when it becomes readable, call
+ *  #chkconfig_dispatch.
+ *
+ *  @param[in]   context_pointer  A pointer to the chkconfig library
+ *                                context for which to get the
+ *                                descriptor.
+ *  @param[out]  fd               A pointer to storage by which to
+ *                                return the descriptor if
+ *                                successful.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer or @a fd
+ *                                     is null.
+ *  @retval  -errno                    If the descriptor could not be
+ *                                     created.
+ *
+ *  @sa chkconfig_dispatch
+ *
+ *  @ingroup async
+ *
+ */
+chkconfig_status_t chkconfig_poll_fd(chkconfig_context_pointer_t context_pointer,
+                                     int *fd)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+    nlREQUIRE_ACTION(fd              != nullptr, done, retval = -EINVAL);
+
+    retval = Detail::chkconfigPollDescriptor(*context_pointer,
+                                             *fd);
+
+ done:
+    return (retval);
+}
+
+/**
+ *  @brief
+ *    Dispatch the completions of performed asynchronous requests.
+ *
+ *  This calls, on the calling thread and in the order the requests
+ *  were submitted, the completion function of every asynchronous
+ *  request for the context performed since the last dispatch. It
+ *  never blocks on flag I/O; when there is nothing to dispatch, it
+ *  returns immediately.
+ *
+ *  Completion functions may themselves submit asynchronous requests.
+ *  Requests outstanding when the context is destroyed are discarded
+ *  without their completion functions being called.
+ *
+ *  @param[in]  context_pointer  A pointer to the chkconfig library
+ *                               context for which to dispatch
+ *                               completions.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a context_pointer is null.
+ *
+ *  @sa chkconfig_poll_fd
+ *  @sa chkconfig_state_get_async
+ *  @sa chkconfig_state_set_async
+ *
+ *  @ingroup async
+ *
+ */
+chkconfig_status_t chkconfig_dispatch(chkconfig_context_pointer_t context_pointer)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(context_pointer != nullptr, done, retval = -EINVAL);
+
+    Detail::chkconfigDispatch(*context_pointer);
 
  done:
     return (retval);
@@ -2244,6 +12121,38 @@ chkconfig_status_t chkconfig_flag_state_tuples_destroy(chkconfig_flag_state_tupl
     return (retval);
 }
 
+/**
+ *  @brief
+ *    Deallocate a packed flag/state tuples array.
+ *
+ *  This deallocates the specified flag/state tuples array, along
+ *  with the flags sharing its allocation, as returned by
+ *  #chkconfig_state_copy_all_packed.
+ *
+ *  @param[in]  flag_state_tuples  A pointer to the packed flag/state
+ *                                 tuples array to deallocate.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a flag_state_tuples is
+ *                                     null.
+ *
+ *  @sa chkconfig_state_copy_all_packed
+ *
+ *  @ingroup utility
+ *
+ */
+chkconfig_status_t chkconfig_flag_state_tuples_packed_destroy(chkconfig_flag_state_tuple_t *flag_state_tuples)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION(flag_state_tuples != nullptr, done, retval = -EINVAL);
+
+    free(flag_state_tuples);
+
+ done:
+    return (retval);
+}
+
 /**
  *  @brief
  *    Compare two flag/state tuples, using their flag values as the
@@ -2312,3 +12221,50 @@ int chkconfig_flag_state_tuple_state_compare_function(const void *first_tuple,
 
     return (lRetval);
 }
+
+/**
+ *  @brief
+ *    Sort an array of flag/state tuples.
+ *
+ *  This sorts the specified array of flag/state tuples, in place, in
+ *  the specified order. The result is identical to that of qsort(3)
+ *  with #chkconfig_flag_state_tuple_flag_compare_function or
+ *  #chkconfig_flag_state_tuple_state_compare_function, respectively;
+ *  however, flags are sorted with a radix sort on their names rather
+ *  than by indirect, pairwise comparison.
+ *
+ *  @param[in,out]  flag_state_tuples  A pointer to the array of flag/
+ *                                     state tuples to sort.
+ *  @param[in]      count              The number of flag/state tuples
+ *                                     in @a flag_state_tuples.
+ *  @param[in]      order              The order in which to sort @a
+ *                                     flag_state_tuples.
+ *
+ *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+ *  @retval  -EINVAL                   If @a flag_state_tuples or any
+ *                                     of its flags is null or if @a
+ *                                     order is invalid.
+ *  @retval  -ENOMEM                   If memory could not be allocated
+ *                                     for the sort.
+ *
+ *  @sa chkconfig_flag_state_tuple_flag_compare_function
+ *  @sa chkconfig_flag_state_tuple_state_compare_function
+ *
+ *  @ingroup utility
+ *
+ */
+chkconfig_status_t chkconfig_flag_state_tuples_sort(chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                                    size_t count,
+                                                    chkconfig_sort_order_t order)
+{
+    chkconfig_status_t retval = CHKCONFIG_STATUS_SUCCESS;
+
+    nlREQUIRE_ACTION((flag_state_tuples != nullptr) || (count == 0), done, retval = -EINVAL);
+
+    retval = Detail::chkconfigFlagStateTuplesSort(flag_state_tuples,
+                                                  count,
+                                                  order);
+
+ done:
+    return (retval);
+}
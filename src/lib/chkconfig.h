@@ -93,6 +93,40 @@ typedef enum
                                   //!< state backing store.
 } chkconfig_origin_t;
 
+/**
+ *  An enumeration indicating the order in which to sort flag/state
+ *  tuples.
+ *
+ */
+typedef enum
+{
+    CHKCONFIG_SORT_ORDER_FLAG  = 0, //!< Sort by flag, ascending.
+
+    CHKCONFIG_SORT_ORDER_STATE = 1  //!< Sort by state, on before off,
+                                    //!< and then by flag, ascending.
+} chkconfig_sort_order_t;
+
+/**
+ *  An enumeration indicating how the state backing store and the
+ *  default backing store differ for a flag.
+ *
+ */
+typedef enum
+{
+    CHKCONFIG_DIFF_STATE_ONLY   = 0, //!< The flag exists only in the state
+                                     //!< backing store.
+
+    CHKCONFIG_DIFF_DEFAULT_ONLY = 1, //!< The flag exists only in the
+                                     //!< default backing store.
+
+    CHKCONFIG_DIFF_SHADOWS      = 2, //!< The flag exists in both, with the
+                                     //!< same state, such that the state
+                                     //!< backing store shadows the default.
+
+    CHKCONFIG_DIFF_DIFFERS      = 3  //!< The flag exists in both, with
+                                     //!< different states.
+} chkconfig_diff_t;
+
 /**
  *  A structure for manipulating a state flag and value as a pair.
  *
@@ -110,6 +144,40 @@ struct chkconfig_flag_state_tuple
  */
 typedef struct chkconfig_flag_state_tuple  chkconfig_flag_state_tuple_t;
 
+/**
+ *  A structure for counting flags by state.
+ *
+ */
+struct chkconfig_state_counts
+{
+    size_t m_on;  //!< The number of flags that are on.
+    size_t m_off; //!< The number of flags that are off.
+};
+
+/**
+ *  A convenience type for counting flags by state.
+ *
+ */
+typedef struct chkconfig_state_counts      chkconfig_state_counts_t;
+
+/**
+ *  A structure for counting flags by state for each origin.
+ *
+ */
+struct chkconfig_origin_counts
+{
+    chkconfig_state_counts_t m_default; //!< The counts for flags from the
+                                        //!< default backing store.
+    chkconfig_state_counts_t m_state;   //!< The counts for flags from the
+                                        //!< state backing store.
+};
+
+/**
+ *  A convenience type for counting flags by state for each origin.
+ *
+ */
+typedef struct chkconfig_origin_counts     chkconfig_origin_counts_t;
+
 struct _chkconfig_context;
 
 /**
@@ -123,6 +191,15 @@ typedef struct _chkconfig_context          chkconfig_context_t;
  *
  *  Most chkconfig library interfaces take a pointer to this context.
  *
+ *  A context may be shared among threads. Observers and mutators
+ *  never block on one another or on changes to runtime options; each
+ *  call uses the runtime options in effect when it began. Changes to
+ *  runtime options, through #chkconfig_options_init,
+ *  #chkconfig_options_set, and #chkconfig_options_destroy, are
+ *  serialized and take effect for calls that begin after they
+ *  return. A context may not, however, be destroyed while any other
+ *  thread is using it.
+ *
  */
 typedef chkconfig_context_t *              chkconfig_context_pointer_t;
 
@@ -148,6 +225,99 @@ typedef struct _chkconfig_options          chkconfig_options_t;
  */
 typedef chkconfig_options_t *              chkconfig_options_pointer_t;
 
+/**
+ *  A forward declaration for an opaque type for a cursor over flags.
+ *
+ *  @private
+ *
+ */
+struct _chkconfig_state_cursor;
+
+/**
+ *  A convenience type for a cursor over flags.
+ *
+ */
+typedef struct _chkconfig_state_cursor     chkconfig_state_cursor_t;
+
+/**
+ *  A convenience type for a pointer to a cursor over flags.
+ *
+ */
+typedef chkconfig_state_cursor_t *         chkconfig_state_cursor_pointer_t;
+
+/**
+ *  A type for a function called on completion of an asynchronous
+ *  flag observation or mutation.
+ *
+ *  @param[in]  status            The status of the request, as the
+ *                                corresponding synchronous interface
+ *                                would have returned it.
+ *  @param[in]  flag              The flag the request was for. The
+ *                                string is valid only for the
+ *                                duration of the call.
+ *  @param[in]  state             The state value observed or set, if
+ *                                @a status is successful.
+ *  @param[in]  origin            The origin of the state value
+ *                                observed or set, if @a status is
+ *                                successful.
+ *  @param[in]  callback_context  The caller context pointer the
+ *                                request was submitted with.
+ *
+ *  @sa chkconfig_state_get_async
+ *  @sa chkconfig_state_set_async
+ *  @sa chkconfig_dispatch
+ *
+ */
+typedef void (*chkconfig_state_callback_t)(chkconfig_status_t status,
+                                           chkconfig_flag_t flag,
+                                           chkconfig_state_t state,
+                                           chkconfig_origin_t origin,
+                                           void *callback_context);
+
+/**
+ *  A type for a function that filters flags as they are enumerated.
+ *
+ *  @param[in]  flag            The flag to filter. The string is
+ *                              valid only for the duration of the
+ *                              call.
+ *  @param[in]  filter_context  The caller context pointer the
+ *                              enumeration was requested with.
+ *
+ *  @returns
+ *    True if the flag is to be included; otherwise, false.
+ *
+ *  @sa chkconfig_state_copy_filtered
+ *
+ */
+typedef bool (*chkconfig_flag_filter_t)(chkconfig_flag_t flag,
+                                        void *filter_context);
+
+/**
+ *  A type for a function called for each flag as the state and
+ *  default backing stores are compared.
+ *
+ *  @param[in]  flag              The flag. The string is valid only
+ *                                for the duration of the call.
+ *  @param[in]  diff              How the backing stores differ for
+ *                                @a flag.
+ *  @param[in]  state             The state of @a flag in the state
+ *                                backing store or off if it does not
+ *                                exist there.
+ *  @param[in]  default_state     The state of @a flag in the default
+ *                                backing store or off if it does not
+ *                                exist there.
+ *  @param[in]  callback_context  The caller context pointer the
+ *                                comparison was requested with.
+ *
+ *  @sa chkconfig_state_diff
+ *
+ */
+typedef void (*chkconfig_diff_callback_t)(chkconfig_flag_t flag,
+                                          chkconfig_diff_t diff,
+                                          chkconfig_state_t state,
+                                          chkconfig_state_t default_state,
+                                          void *callback_context);
+
 /**
  *  A set of enumerations used to encode chkconfig option key/value
  *  pair keys.
@@ -254,7 +424,147 @@ enum {
      *  directory.
      *
      */
-    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY  = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_BOOLEAN, 4)
+    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY  = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_BOOLEAN, 4),
+
+    /**
+     *  An option key whose unsigned 32-bit integer value is the
+     *  maximum number of flags for which backing file I/O is
+     *  submitted to the operating system at once, where the
+     *  operating system supports batched, asynchronous I/O (at
+     *  present, io_uring on Linux).
+     *
+     *  When zero, the default, or where batched I/O is unsupported
+     *  or unavailable at run time, flags are read one at a time.
+     *
+     */
+    CHKCONFIG_OPTION_IO_QUEUE_DEPTH         = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_UINT32, 5),
+
+    /**
+     *  An option key whose Boolean value, when asserted, indicates
+     *  that backing state files should be flushed to stable storage
+     *  after being written and before being closed.
+     *
+     */
+    CHKCONFIG_OPTION_SYNC_STATE             = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_BOOLEAN, 6),
+
+    /**
+     *  An option key whose unsigned 32-bit integer value is the
+     *  maximum number of threads, including the calling thread, with
+     *  which the default and state directories are enumerated and
+     *  their flag backing files read when copying or counting all
+     *  flags.
+     *
+     *  When one, the default, all such work is performed on the
+     *  calling thread. The results are the same regardless of the
+     *  number of threads.
+     *
+     */
+    CHKCONFIG_OPTION_THREADS                = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_UINT32, 7),
+
+    /**
+     *  An option key whose immutable null-terminated C string value
+     *  is the path of a single, append-only log file in which flag
+     *  states are stored in place of the read/write flag state
+     *  backing file directory, or null, the default, to use that
+     *  directory.
+     *
+     *  The log is created if it does not already exist and is
+     *  indexed in memory when first used. The read-only fallback
+     *  default directory, if in use, still applies to flags not in
+     *  the log. The log may be shared among processes.
+     *
+     */
+    CHKCONFIG_OPTION_STATE_LOG              = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_CSTRING, 8),
+
+    /**
+     *  An option key whose Boolean value, when asserted, indicates
+     *  that flag states should be stored in memory, private to the
+     *  library context, in place of the read/write flag state
+     *  backing file directory or flag state log.
+     *
+     *  Flags in memory have the same semantics as those in the state
+     *  directory, including the read-only fallback default
+     *  directory, if in use, but are never persisted; they are
+     *  retained across changes to runtime options and discarded
+     *  when the context is destroyed. This is primarily intended for
+     *  testing and benchmarking the library apart from the file
+     *  system.
+     *
+     */
+    CHKCONFIG_OPTION_MEMORY_STATE           = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_BOOLEAN, 9),
+
+    /**
+     *  An option key whose immutable null-terminated C string value
+     *  is a read-only flag state backing file directory to push onto
+     *  the stack of layers between the read/write flag state store
+     *  and the read-only fallback default directory, or null to
+     *  remove every such layer.
+     *
+     *  Each layer pushed takes precedence over those pushed before
+     *  it. A flag is gotten from the first of the state store, the
+     *  layers, most recently pushed first, and, if in use, the
+     *  default directory in which it exists. Flags from a read-only
+     *  layer have a default origin.
+     *
+     */
+    CHKCONFIG_OPTION_LAYER_DIRECTORY        = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_CSTRING, 10),
+
+    /**
+     *  An option key whose immutable null-terminated C string value
+     *  is a writable flag state backing file directory to push onto
+     *  the stack of layers, as for
+     *  #CHKCONFIG_OPTION_LAYER_DIRECTORY, or null to remove every
+     *  such layer.
+     *
+     *  A flag is set in the first writable layer, starting with the
+     *  state store, in which it already exists or, failing that, in
+     *  the state store. Flags from a writable layer have a state
+     *  origin.
+     *
+     */
+    CHKCONFIG_OPTION_WRITABLE_LAYER_DIRECTORY = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_CSTRING, 11),
+
+    /**
+     *  An option key whose Boolean value, when asserted, indicates
+     *  that the library should keep, for each flag state backing
+     *  file directory in use, an in-memory set of the names in it,
+     *  such that getting a flag absent from a directory, before
+     *  falling back to the next, requires no system call.
+     *
+     *  Each set is built by enumerating its directory when first
+     *  used and is thereafter kept current with changes made by any
+     *  process by file system change notifications, drained once per
+     *  call. Flags present in a directory are still read from their
+     *  backing files.
+     *
+     *  This is of most benefit to long-lived contexts getting many
+     *  flags; a context used for a single call pays for enumerating
+     *  each directory. Where file system change notifications are
+     *  unavailable or #CHKCONFIG_OPTION_SHARDED_LAYOUT is asserted,
+     *  this option has no effect.
+     *
+     */
+    CHKCONFIG_OPTION_EXISTENCE_FILTERS      = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_BOOLEAN, 12),
+
+    /**
+     *  An option key whose Boolean value, when asserted, indicates
+     *  that every flag state backing file directory in use has a
+     *  sharded layout.
+     *
+     *  In a sharded layout, the backing file for a flag is not in
+     *  the directory itself but in one of up to 256 subdirectories
+     *  of it, named by two lowercase hexadecimal digits from a
+     *  stable hash of the flag, such that no one directory grows
+     *  large enough to make enumerating or looking up flags in it
+     *  slow. Subdirectories are created as flags are forcibly set in
+     *  them.
+     *
+     *  Use chkconfig_state_migrate_layout to convert the writable
+     *  directories in use to or from this layout. Existence filters
+     *  are not kept for a sharded layout.
+     *
+     */
+    CHKCONFIG_OPTION_SHARDED_LAYOUT         = _CHKCONFIG_OPTION_ENCODE(_CHKCONFIG_OPTION_TYPE_BOOLEAN, 13)
 };
 
 /**
@@ -279,10 +589,14 @@ extern chkconfig_status_t chkconfig_flag_state_tuples_init(chkconfig_flag_state_
                                                            size_t count);
 extern chkconfig_status_t chkconfig_flag_state_tuples_destroy(chkconfig_flag_state_tuple_t *flag_state_tuples,
                                                               size_t count);
+extern chkconfig_status_t chkconfig_flag_state_tuples_packed_destroy(chkconfig_flag_state_tuple_t *flag_state_tuples);
 extern int chkconfig_flag_state_tuple_flag_compare_function(const void *first_tuple,
                                                             const void *second_tuple);
 extern int chkconfig_flag_state_tuple_state_compare_function(const void *first_tuple,
                                                              const void *second_tuple);
+extern chkconfig_status_t chkconfig_flag_state_tuples_sort(chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                                           size_t count,
+                                                           chkconfig_sort_order_t order);
 
 // MARK: Context Lifetime Management
 
@@ -318,9 +632,46 @@ extern chkconfig_status_t chkconfig_state_get_multiple(chkconfig_context_pointer
                                                        size_t count);
 extern chkconfig_status_t chkconfig_state_get_count(chkconfig_context_pointer_t context_pointer,
                                                     size_t *count);
+extern chkconfig_status_t chkconfig_state_get_counts(chkconfig_context_pointer_t context_pointer,
+                                                     size_t *on,
+                                                     size_t *off,
+                                                     chkconfig_origin_counts_t *by_origin);
+extern chkconfig_status_t chkconfig_state_diff(chkconfig_context_pointer_t context_pointer,
+                                               chkconfig_diff_callback_t callback,
+                                               void *callback_context);
 extern chkconfig_status_t chkconfig_state_copy_all(chkconfig_context_pointer_t context_pointer,
                                                    chkconfig_flag_state_tuple_t **flag_state_tuples,
                                                    size_t *count);
+extern chkconfig_status_t chkconfig_state_copy_all_sorted(chkconfig_context_pointer_t context_pointer,
+                                                          chkconfig_sort_order_t order,
+                                                          chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                          size_t *count);
+extern chkconfig_status_t chkconfig_state_copy_all_packed(chkconfig_context_pointer_t context_pointer,
+                                                          chkconfig_sort_order_t order,
+                                                          chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                          size_t *count);
+extern chkconfig_status_t chkconfig_state_copy_prefix(chkconfig_context_pointer_t context_pointer,
+                                                      const char *prefix,
+                                                      chkconfig_sort_order_t order,
+                                                      chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                      size_t *count);
+extern chkconfig_status_t chkconfig_state_copy_filtered(chkconfig_context_pointer_t context_pointer,
+                                                        chkconfig_flag_filter_t filter,
+                                                        void *filter_context,
+                                                        chkconfig_sort_order_t order,
+                                                        chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                        size_t *count);
+extern chkconfig_status_t chkconfig_state_copy_where(chkconfig_context_pointer_t context_pointer,
+                                                     chkconfig_state_t state,
+                                                     chkconfig_sort_order_t order,
+                                                     chkconfig_flag_state_tuple_t **flag_state_tuples,
+                                                     size_t *count);
+
+extern chkconfig_status_t chkconfig_state_cursor_open(chkconfig_context_pointer_t context_pointer,
+                                                      chkconfig_state_cursor_pointer_t *cursor_pointer);
+extern chkconfig_status_t chkconfig_state_cursor_next(chkconfig_state_cursor_pointer_t cursor_pointer,
+                                                      chkconfig_flag_state_tuple_t *flag_state_tuple);
+extern chkconfig_status_t chkconfig_state_cursor_close(chkconfig_state_cursor_pointer_t *cursor_pointer);
 
 // MARK: Flag Mutation
 
@@ -330,6 +681,32 @@ extern chkconfig_status_t chkconfig_state_set(chkconfig_context_pointer_t contex
 extern chkconfig_status_t chkconfig_state_set_multiple(chkconfig_context_pointer_t context_pointer,
                                                        const chkconfig_flag_state_tuple_t *flag_state_tuples,
                                                        size_t count);
+extern chkconfig_status_t chkconfig_state_set_multiple_with_status(chkconfig_context_pointer_t context_pointer,
+                                                                   const chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                                                   size_t count,
+                                                                   chkconfig_status_t *statuses);
+extern chkconfig_status_t chkconfig_state_import(chkconfig_context_pointer_t context_pointer,
+                                                 const chkconfig_flag_state_tuple_t *flag_state_tuples,
+                                                 size_t count,
+                                                 bool prune,
+                                                 size_t *changed);
+extern chkconfig_status_t chkconfig_state_migrate_layout(chkconfig_context_pointer_t context_pointer);
+
+// MARK: Asynchronous Flag Observation and Mutation
+
+extern chkconfig_status_t chkconfig_state_get_async(chkconfig_context_pointer_t context_pointer,
+                                                    chkconfig_flag_t flag,
+                                                    chkconfig_state_callback_t callback,
+                                                    void *callback_context);
+extern chkconfig_status_t chkconfig_state_set_async(chkconfig_context_pointer_t context_pointer,
+                                                    chkconfig_flag_t flag,
+                                                    chkconfig_state_t state,
+                                                    chkconfig_state_callback_t callback,
+                                                    void *callback_context);
+
+extern chkconfig_status_t chkconfig_poll_fd(chkconfig_context_pointer_t context_pointer,
+                                            int *fd);
+extern chkconfig_status_t chkconfig_dispatch(chkconfig_context_pointer_t context_pointer);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,761 @@
+/*
+ *    Copyright (c) 2023 Nuovation System Designs, LLC
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an optional, header-only C++ interface to
+ *      the chkconfig configuruation management library.
+ *
+ *      With C++17, the library context and flag snapshots are
+ *      move-only owning types, and flags are exposed as
+ *      std::string_view into library-owned storage rather than as
+ *      individually-allocated strings.
+ *
+ *      With C++20 coroutines, flag observations and mutations are
+ *      also awaitable and are
+ *      performed by the asynchronous engine of the C interface. An
+ *      awaiting coroutine is resumed from #chkconfig_dispatch, on
+ *      whichever thread drives the event loop for the context, and
+ *      never from a library thread. Flag listings are lazy ranges
+ *      produced straight from the directory scan.
+ *
+ *      With an earlier language standard, this header declares
+ *      nothing beyond the C interface.
+ *
+ */
+
+#ifndef CHKCONFIG_HPP
+#define CHKCONFIG_HPP
+
+
+#include <chkconfig/chkconfig.h>
+
+#if defined(__cplusplus) && (__cplusplus >= 201703L)
+#define CHKCONFIG_HAVE_CXX17 1
+#endif
+
+#if CHKCONFIG_HAVE_CXX17 && (__cplusplus >= 202002L) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define CHKCONFIG_HAVE_COROUTINES 1
+#endif
+#endif
+
+#if CHKCONFIG_HAVE_CXX17
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include <errno.h>
+
+#if CHKCONFIG_HAVE_COROUTINES
+#include <coroutine>
+#endif
+
+
+namespace nuovations
+{
+
+namespace chkconfig
+{
+
+// MARK: Type Declarations
+
+/**
+ *  @brief
+ *    A flag, its state, and its origin.
+ *
+ *  The flag is a view into storage owned by whatever produced it.
+ *
+ */
+struct FlagState
+{
+    std::string_view   m_flag;   //!< The flag.
+    chkconfig_state_t  m_state;  //!< The state of the flag.
+    chkconfig_origin_t m_origin; //!< The origin of the state.
+};
+
+/**
+ *  @brief
+ *    A move-only, immutable copy of all flags with a backing file.
+ *
+ *  The flags and their states are held in a single library
+ *  allocation, as returned by #chkconfig_state_copy_all_packed, and
+ *  each element exposes its flag as a view into it. Elements remain
+ *  valid for the lifetime of the snapshot.
+ *
+ */
+class Snapshot
+{
+public:
+    /**
+     *  An input iterator over the snapshot.
+     *
+     */
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = FlagState;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = FlagState;
+
+        Iterator(void) noexcept :
+            m_tuple(nullptr)
+        {
+            return;
+        }
+
+        explicit Iterator(const chkconfig_flag_state_tuple_t *inTuple) noexcept :
+            m_tuple(inTuple)
+        {
+            return;
+        }
+
+        FlagState operator *(void) const noexcept
+        {
+            return (FlagState{ m_tuple->m_flag, m_tuple->m_state, m_tuple->m_origin });
+        }
+
+        Iterator &operator ++(void) noexcept
+        {
+            m_tuple++;
+
+            return (*this);
+        }
+
+        Iterator operator ++(int) noexcept
+        {
+            Iterator lPrevious(*this);
+
+            m_tuple++;
+
+            return (lPrevious);
+        }
+
+        bool operator ==(const Iterator &inIterator) const noexcept
+        {
+            return (m_tuple == inIterator.m_tuple);
+        }
+
+        bool operator !=(const Iterator &inIterator) const noexcept
+        {
+            return (m_tuple != inIterator.m_tuple);
+        }
+
+    private:
+        const chkconfig_flag_state_tuple_t * m_tuple;
+    };
+
+    Snapshot(void) noexcept :
+        m_tuples(nullptr),
+        m_count(0)
+    {
+        return;
+    }
+
+    Snapshot(Snapshot &&inSnapshot) noexcept :
+        m_tuples(std::exchange(inSnapshot.m_tuples, nullptr)),
+        m_count(std::exchange(inSnapshot.m_count, 0))
+    {
+        return;
+    }
+
+    Snapshot &operator =(Snapshot &&inSnapshot) noexcept
+    {
+        if (this != &inSnapshot)
+        {
+            Release();
+
+            m_tuples = std::exchange(inSnapshot.m_tuples, nullptr);
+            m_count  = std::exchange(inSnapshot.m_count, 0);
+        }
+
+        return (*this);
+    }
+
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator =(const Snapshot &) = delete;
+
+    ~Snapshot(void)
+    {
+        Release();
+    }
+
+    size_t size(void) const noexcept
+    {
+        return (m_count);
+    }
+
+    bool empty(void) const noexcept
+    {
+        return (m_count == 0);
+    }
+
+    FlagState operator [](size_t inIndex) const noexcept
+    {
+        return (*Iterator(&m_tuples[inIndex]));
+    }
+
+    Iterator begin(void) const noexcept
+    {
+        return (Iterator(m_tuples));
+    }
+
+    Iterator end(void) const noexcept
+    {
+        return (Iterator(m_tuples + m_count));
+    }
+
+private:
+    friend class Context;
+
+    void Release(void) noexcept
+    {
+        if (m_tuples != nullptr)
+        {
+            chkconfig_flag_state_tuples_packed_destroy(m_tuples);
+
+            m_tuples = nullptr;
+            m_count  = 0;
+        }
+    }
+
+    chkconfig_flag_state_tuple_t * m_tuples;
+    size_t                         m_count;
+};
+
+/**
+ *  @brief
+ *    A move-only owner of a chkconfig library context and its
+ *    runtime options.
+ *
+ *  Both are destroyed with the object. As with the underlying
+ *  context, observers and mutators may be called from several
+ *  threads at once.
+ *
+ */
+class Context
+{
+public:
+    Context(void) noexcept :
+        m_context_pointer(nullptr),
+        m_options_pointer(nullptr)
+    {
+        return;
+    }
+
+    Context(Context &&inContext) noexcept :
+        m_context_pointer(std::exchange(inContext.m_context_pointer, nullptr)),
+        m_options_pointer(std::exchange(inContext.m_options_pointer, nullptr))
+    {
+        return;
+    }
+
+    Context &operator =(Context &&inContext) noexcept
+    {
+        if (this != &inContext)
+        {
+            Destroy();
+
+            m_context_pointer = std::exchange(inContext.m_context_pointer, nullptr);
+            m_options_pointer = std::exchange(inContext.m_options_pointer, nullptr);
+        }
+
+        return (*this);
+    }
+
+    Context(const Context &) = delete;
+    Context &operator =(const Context &) = delete;
+
+    ~Context(void)
+    {
+        Destroy();
+    }
+
+    /**
+     *  Initialize the library context and its runtime options, which
+     *  start out with the library defaults.
+     *
+     *  @retval  CHKCONFIG_STATUS_SUCCESS  If successful.
+     *  @retval  -EALREADY                 If already initialized.
+     *  @retval  -ENOMEM                   If resources could not be
+     *                                     allocated.
+     *
+     */
+    chkconfig_status_t Init(void) noexcept
+    {
+        chkconfig_status_t lStatus;
+
+        if (m_context_pointer != nullptr)
+        {
+            return (-EALREADY);
+        }
+
+        lStatus = chkconfig_init(&m_context_pointer);
+
+        if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            lStatus = chkconfig_options_init(m_context_pointer, &m_options_pointer);
+
+            if (lStatus != CHKCONFIG_STATUS_SUCCESS)
+            {
+                chkconfig_destroy(&m_context_pointer);
+            }
+        }
+
+        return (lStatus);
+    }
+
+    /**
+     *  Set a runtime option, as #chkconfig_options_set would, with a
+     *  value of the type the option key encodes.
+     *
+     */
+    template <typename T>
+    chkconfig_status_t SetOption(chkconfig_option_t inOption, T inValue) noexcept
+    {
+        return (chkconfig_options_set(m_context_pointer, m_options_pointer, inOption, inValue));
+    }
+
+    chkconfig_status_t GetState(const char *inFlag,
+                                chkconfig_state_t &outState,
+                                chkconfig_origin_t &outOrigin) const noexcept
+    {
+        return (chkconfig_state_get_with_origin(m_context_pointer, inFlag, &outState, &outOrigin));
+    }
+
+    chkconfig_status_t SetState(const char *inFlag,
+                                chkconfig_state_t inState) const noexcept
+    {
+        return (chkconfig_state_set(m_context_pointer, inFlag, inState));
+    }
+
+    /**
+     *  Replace the contents of a snapshot with a copy of all flags
+     *  with a backing file, sorted in the specified order, in a
+     *  single allocation.
+     *
+     */
+    chkconfig_status_t CopyAll(Snapshot &outSnapshot,
+                               chkconfig_sort_order_t inOrder = CHKCONFIG_SORT_ORDER_FLAG) const noexcept
+    {
+        chkconfig_flag_state_tuple_t * lTuples = nullptr;
+        size_t                         lCount  = 0;
+        chkconfig_status_t             lStatus;
+
+        lStatus = chkconfig_state_copy_all_packed(m_context_pointer, inOrder, &lTuples, &lCount);
+
+        if (lStatus == CHKCONFIG_STATUS_SUCCESS)
+        {
+            outSnapshot.Release();
+
+            outSnapshot.m_tuples = lTuples;
+            outSnapshot.m_count  = lCount;
+        }
+
+        return (lStatus);
+    }
+
+    /**
+     *  Return the underlying library context, for use with the C
+     *  interface, or null if not initialized.
+     *
+     */
+    chkconfig_context_pointer_t GetPointer(void) const noexcept
+    {
+        return (m_context_pointer);
+    }
+
+private:
+    void Destroy(void) noexcept
+    {
+        if (m_options_pointer != nullptr)
+        {
+            chkconfig_options_destroy(m_context_pointer, &m_options_pointer);
+        }
+
+        if (m_context_pointer != nullptr)
+        {
+            chkconfig_destroy(&m_context_pointer);
+        }
+    }
+
+    chkconfig_context_pointer_t m_context_pointer;
+    chkconfig_options_pointer_t m_options_pointer;
+};
+
+#if CHKCONFIG_HAVE_COROUTINES
+/**
+ *  @brief
+ *    The outcome of an awaited flag observation or mutation.
+ *
+ */
+struct StateResult
+{
+    chkconfig_status_t m_status; //!< The status of the request.
+    chkconfig_state_t  m_state;  //!< The state observed or set, if
+                                 //!< successful.
+    chkconfig_origin_t m_origin; //!< The origin of the state, if
+                                 //!< successful.
+};
+
+namespace Detail
+{
+
+/**
+ *  @brief
+ *    An awaitable asynchronous flag observation or mutation.
+ *
+ *  The request is submitted when the awaiting coroutine suspends
+ *  and the coroutine is resumed from the completion function. Should
+ *  submission fail, the coroutine is not suspended at all and the
+ *  result carries the submission status.
+ *
+ *  @private
+ *
+ */
+class StateAwaitable
+{
+public:
+    StateAwaitable(chkconfig_context_pointer_t inContextPointer,
+                   chkconfig_flag_t inFlag,
+                   bool inMutate,
+                   chkconfig_state_t inState) noexcept :
+        m_context_pointer(inContextPointer),
+        m_flag(inFlag),
+        m_mutate(inMutate),
+        m_result{ CHKCONFIG_STATUS_SUCCESS, inState, CHKCONFIG_ORIGIN_UNKNOWN }
+    {
+        return;
+    }
+
+    bool await_ready(void) const noexcept
+    {
+        return (false);
+    }
+
+    bool await_suspend(std::coroutine_handle<> inHandle) noexcept
+    {
+        chkconfig_status_t lStatus;
+
+        m_handle = inHandle;
+
+        if (m_mutate)
+        {
+            lStatus = chkconfig_state_set_async(m_context_pointer,
+                                                m_flag,
+                                                m_result.m_state,
+                                                Complete,
+                                                this);
+        }
+        else
+        {
+            lStatus = chkconfig_state_get_async(m_context_pointer,
+                                                m_flag,
+                                                Complete,
+                                                this);
+        }
+
+        m_result.m_status = lStatus;
+
+        return (lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    StateResult await_resume(void) const noexcept
+    {
+        return (m_result);
+    }
+
+private:
+    static void Complete(chkconfig_status_t inStatus,
+                         chkconfig_flag_t inFlag __attribute__((unused)),
+                         chkconfig_state_t inState,
+                         chkconfig_origin_t inOrigin,
+                         void *inCallbackContext)
+    {
+        StateAwaitable * lAwaitable = static_cast<StateAwaitable *>(inCallbackContext);
+
+        lAwaitable->m_result.m_status = inStatus;
+        lAwaitable->m_result.m_state  = inState;
+        lAwaitable->m_result.m_origin = inOrigin;
+
+        // The awaitable may not outlive the resumption, so it must
+        // not be touched after this.
+
+        lAwaitable->m_handle.resume();
+    }
+
+    chkconfig_context_pointer_t m_context_pointer;
+    chkconfig_flag_t            m_flag;
+    bool                        m_mutate;
+    StateResult                 m_result;
+    std::coroutine_handle<>     m_handle;
+};
+
+}; // namespace Detail
+
+/**
+ *  @brief
+ *    A lazy, single-pass range over all flags with a backing file.
+ *
+ *  Each step advances an underlying flag cursor, reading one
+ *  directory entry and, at most, one backing file. No flag/state
+ *  tuple array is ever materialized, and each flag is valid only
+ *  until the range is next advanced.
+ *
+ *  Iteration stops at the first failure, the status of which is
+ *  then available from Status().
+ *
+ */
+class FlagRange
+{
+public:
+    /**
+     *  The end-of-range sentinel.
+     *
+     */
+    struct Sentinel { };
+
+    /**
+     *  An input iterator over the range.
+     *
+     */
+    class Iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = FlagState;
+        using difference_type  = std::ptrdiff_t;
+
+        Iterator(void) noexcept :
+            m_range(nullptr)
+        {
+            return;
+        }
+
+        explicit Iterator(FlagRange &inRange) noexcept :
+            m_range(&inRange)
+        {
+            return;
+        }
+
+        const FlagState &operator *(void) const noexcept
+        {
+            return (m_range->m_current);
+        }
+
+        const FlagState *operator ->(void) const noexcept
+        {
+            return (&m_range->m_current);
+        }
+
+        Iterator &operator ++(void) noexcept
+        {
+            m_range->Advance();
+
+            return (*this);
+        }
+
+        void operator ++(int) noexcept
+        {
+            m_range->Advance();
+        }
+
+        bool operator ==(const Sentinel &) const noexcept
+        {
+            return (m_range->m_done);
+        }
+
+    private:
+        FlagRange * m_range;
+    };
+
+    explicit FlagRange(chkconfig_context_pointer_t inContextPointer) noexcept :
+        m_cursor_pointer(nullptr),
+        m_current{ },
+        m_status(chkconfig_state_cursor_open(inContextPointer, &m_cursor_pointer)),
+        m_done(m_status != CHKCONFIG_STATUS_SUCCESS),
+        m_started(false)
+    {
+        return;
+    }
+
+    FlagRange(FlagRange &&inRange) noexcept :
+        m_cursor_pointer(std::exchange(inRange.m_cursor_pointer, nullptr)),
+        m_current(inRange.m_current),
+        m_status(inRange.m_status),
+        m_done(std::exchange(inRange.m_done, true)),
+        m_started(inRange.m_started)
+    {
+        return;
+    }
+
+    FlagRange(const FlagRange &) = delete;
+    FlagRange &operator =(const FlagRange &) = delete;
+    FlagRange &operator =(FlagRange &&) = delete;
+
+    ~FlagRange(void)
+    {
+        if (m_cursor_pointer != nullptr)
+        {
+            chkconfig_state_cursor_close(&m_cursor_pointer);
+        }
+    }
+
+    /**
+     *  Begin iterating the range, producing its first flag. The
+     *  range is single-pass, so this may be called only once.
+     *
+     */
+    Iterator begin(void) noexcept
+    {
+        if (!m_started)
+        {
+            m_started = true;
+
+            Advance();
+        }
+
+        return (Iterator(*this));
+    }
+
+    Sentinel end(void) const noexcept
+    {
+        return (Sentinel());
+    }
+
+    /**
+     *  Return the status of opening or advancing the range; once
+     *  iteration stops, a failure here means it stopped early.
+     *
+     */
+    chkconfig_status_t Status(void) const noexcept
+    {
+        return (m_status);
+    }
+
+private:
+    void Advance(void) noexcept
+    {
+        chkconfig_flag_state_tuple_t lFlagStateTuple;
+
+        if (m_done)
+        {
+            return;
+        }
+
+        m_status = chkconfig_state_cursor_next(m_cursor_pointer, &lFlagStateTuple);
+
+        if ((m_status != CHKCONFIG_STATUS_SUCCESS) || (lFlagStateTuple.m_flag == nullptr))
+        {
+            m_done = true;
+            return;
+        }
+
+        m_current.m_flag   = lFlagStateTuple.m_flag;
+        m_current.m_state  = lFlagStateTuple.m_state;
+        m_current.m_origin = lFlagStateTuple.m_origin;
+    }
+
+    chkconfig_state_cursor_pointer_t m_cursor_pointer;
+    FlagState                        m_current;
+    chkconfig_status_t               m_status;
+    bool                             m_done;
+    bool                             m_started;
+};
+
+// MARK: Observers
+
+/**
+ *  @brief
+ *    Get the state value and origin associated with a flag, as an
+ *    awaitable.
+ *
+ *  @param[in]  inContextPointer  A pointer to the chkconfig library
+ *                                context for which to get the state.
+ *  @param[in]  inFlag            The flag for which to get the state.
+ *                                It need only remain valid until the
+ *                                awaiting coroutine suspends.
+ *
+ *  @returns
+ *    An awaitable yielding the StateResult of the observation.
+ *
+ *  @sa chkconfig_state_get_async
+ *
+ */
+inline Detail::StateAwaitable Get(chkconfig_context_pointer_t inContextPointer,
+                                  chkconfig_flag_t inFlag) noexcept
+{
+    return (Detail::StateAwaitable(inContextPointer, inFlag, false, false));
+}
+
+/**
+ *  @brief
+ *    List all flags with a backing file as a lazy range.
+ *
+ *  @param[in]  inContextPointer  A pointer to the chkconfig library
+ *                                context for which to list flags.
+ *
+ *  @returns
+ *    A FlagRange over all flags, in the order of
+ *    #chkconfig_state_cursor_next.
+ *
+ *  @sa chkconfig_state_cursor_open
+ *
+ */
+inline FlagRange List(chkconfig_context_pointer_t inContextPointer) noexcept
+{
+    return (FlagRange(inContextPointer));
+}
+
+// MARK: Mutators
+
+/**
+ *  @brief
+ *    Set the state value associated with a flag, as an awaitable.
+ *
+ *  @param[in]  inContextPointer  A pointer to the chkconfig library
+ *                                context for which to set the state.
+ *  @param[in]  inFlag            The flag for which to set the state.
+ *                                It need only remain valid until the
+ *                                awaiting coroutine suspends.
+ *  @param[in]  inState           The state value to set.
+ *
+ *  @returns
+ *    An awaitable yielding the StateResult of the mutation.
+ *
+ *  @sa chkconfig_state_set_async
+ *
+ */
+inline Detail::StateAwaitable Set(chkconfig_context_pointer_t inContextPointer,
+                                  chkconfig_flag_t inFlag,
+                                  chkconfig_state_t inState) noexcept
+{
+    return (Detail::StateAwaitable(inContextPointer, inFlag, true, inState));
+}
+#endif // CHKCONFIG_HAVE_COROUTINES
+
+}; // namespace chkconfig
+
+}; // namespace nuovations
+
+#endif // CHKCONFIG_HAVE_CXX17
+
+#endif // CHKCONFIG_HPP
@@ -0,0 +1,2031 @@
+/*
+ *    Copyright (c) 2023 Nuovation System Designs, LLC
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements micro-benchmarks for the chkconfig
+ *      library interfaces.
+ *
+ *      Unlike the unit tests, these are built with, but not run by,
+ *      the 'check' target. Run them by hand, optionally naming one or
+ *      more benchmarks to run, for example:
+ *
+ *        % ./bench-libchkconfig -i 10 copy-all-with-defaults
+ *
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#if defined(__APPLE__)
+#include <sys/syslimits.h>
+#endif
+
+#include <chkconfig/chkconfig.h>
+
+#include "chkconfig-assert.h"
+
+
+// MARK: Type Declarations
+
+struct BenchmarkContext
+{
+    char                        mDefaultDirectory[PATH_MAX];
+    char                        mStateDirectory[PATH_MAX];
+    chkconfig_context_pointer_t mContextPointer;
+    chkconfig_options_pointer_t mOptionsPointer;
+    size_t                      mIterations;
+};
+
+typedef chkconfig_status_t (* BenchmarkFunction)(BenchmarkContext &inContext);
+
+struct Benchmark
+{
+    const char *      mName;
+    const char *      mDescription;
+    BenchmarkFunction mFunction;
+};
+
+struct BenchmarkResult
+{
+    uint64_t mMinimum;
+    uint64_t mMaximum;
+    uint64_t mTotal;
+};
+
+// MARK: Global Variables
+
+static const char * const kProgram       = "bench-libchkconfig";
+static const char * const kFlagFormat    = "flag-%07zu";
+static const uint32_t     kQueueDepths[] = { 0, 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+
+// MARK: Utility
+
+/**
+ *  @brief
+ *    Return the number of elements in a C-style array.
+ *
+ *  @tparam  T  The type of the elements in the array.
+ *  @tparam  N  The number of elements in the array.
+ *
+ *  @param[in]  aArray  A reference to the array.
+ *
+ *  @returns
+ *    The number of elements in the C-style array.
+ *
+ */
+template <typename T, size_t N>
+inline constexpr size_t
+ElementsOf(__attribute__((unused)) const T (&aArray)[N])
+{
+    return (N);
+}
+
+static uint64_t Now(void)
+{
+    struct timespec lTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &lTime);
+
+    return ((static_cast<uint64_t>(lTime.tv_sec) * 1000000000ULL) +
+            static_cast<uint64_t>(lTime.tv_nsec));
+}
+
+static void ResultInit(BenchmarkResult &outResult)
+{
+    outResult.mMinimum = UINT64_MAX;
+    outResult.mMaximum = 0;
+    outResult.mTotal   = 0;
+}
+
+static void ResultAccumulate(BenchmarkResult &inResult, const uint64_t &inStart, const uint64_t &inStop)
+{
+    const uint64_t lElapsed = (inStop - inStart);
+
+    inResult.mMinimum  = MIN(inResult.mMinimum, lElapsed);
+    inResult.mMaximum  = MAX(inResult.mMaximum, lElapsed);
+    inResult.mTotal   += lElapsed;
+}
+
+static void ResultPrint(const char *inName,
+                        const char *inParameters,
+                        const size_t &inIterations,
+                        const BenchmarkResult &inResult)
+{
+    static constexpr double kNanosecondsPerMillisecond = 1000000.0;
+
+    fprintf(stdout,
+            "%-32s  %-32s  %4zu  %12.3f  %12.3f  %12.3f\n",
+            inName,
+            inParameters,
+            inIterations,
+            static_cast<double>(inResult.mMinimum) / kNanosecondsPerMillisecond,
+            (static_cast<double>(inResult.mTotal) / static_cast<double>(inIterations)) / kNanosecondsPerMillisecond,
+            static_cast<double>(inResult.mMaximum) / kNanosecondsPerMillisecond);
+}
+
+static void ResultHeaderPrint(void)
+{
+    fprintf(stdout,
+            "%-32s  %-32s  %4s  %12s  %12s  %12s\n",
+            "Benchmark",
+            "Parameters",
+            "N",
+            "Min (ms)",
+            "Mean (ms)",
+            "Max (ms)");
+}
+
+static chkconfig_status_t CreateDirectory(const char *inDescription, const size_t &inNameSize, char *outName)
+{
+    int                lStatus;
+    char *             lResult;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lStatus = snprintf(outName,
+                       inNameSize,
+                       "%s-%s-XXXXXX",
+                       kProgram,
+                       inDescription);
+    nlREQUIRE_ACTION(lStatus > 0,
+                     done,
+                     lRetval = -EOVERFLOW);
+    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < inNameSize,
+                     done,
+                     lRetval = -EOVERFLOW);
+
+    lResult = mkdtemp(outName);
+    nlREQUIRE_ACTION(lResult != nullptr, done, lRetval = -errno);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t CreateFlags(const char *inDirectory,
+                                      const size_t &inFirst,
+                                      const size_t &inCount,
+                                      const chkconfig_state_t &inState)
+{
+    constexpr int      lFlags     = (O_WRONLY | O_TRUNC | O_CREAT);
+    const char *       lStateString;
+    int                lDirectory = -1;
+    int                lDescriptor;
+    char               lFlag[NAME_MAX];
+    ssize_t            lWritten;
+    int                lStatus;
+    chkconfig_status_t lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = chkconfig_state_get_state_string(inState, &lStateString);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lDirectory = open(inDirectory, O_RDONLY | O_DIRECTORY);
+    nlREQUIRE_ACTION(lDirectory != -1, done, lRetval = -errno);
+
+    for (size_t lIndex = inFirst; lIndex < (inFirst + inCount); lIndex++)
+    {
+        snprintf(lFlag, sizeof (lFlag), kFlagFormat, lIndex);
+
+        lDescriptor = openat(lDirectory, lFlag, lFlags, DEFFILEMODE);
+        nlREQUIRE_ACTION(lDescriptor != -1, done, lRetval = -errno);
+
+        lWritten = write(lDescriptor, lStateString, strlen(lStateString));
+
+        close(lDescriptor);
+
+        nlREQUIRE_ACTION(lWritten > 0, done, lRetval = -errno);
+    }
+
+ done:
+    if (lDirectory != -1)
+    {
+        lStatus = close(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t DestroyFlags(const char *inDirectory,
+                                       const size_t &inFirst,
+                                       const size_t &inCount)
+{
+    int                lDirectory = -1;
+    char               lFlag[NAME_MAX];
+    int                lStatus;
+    chkconfig_status_t lRetval    = CHKCONFIG_STATUS_SUCCESS;
+
+    lDirectory = open(inDirectory, O_RDONLY | O_DIRECTORY);
+    nlREQUIRE_ACTION(lDirectory != -1, done, lRetval = -errno);
+
+    for (size_t lIndex = inFirst; lIndex < (inFirst + inCount); lIndex++)
+    {
+        snprintf(lFlag, sizeof (lFlag), kFlagFormat, lIndex);
+
+        lStatus = unlinkat(lDirectory, lFlag, 0);
+        nlREQUIRE_ACTION(lStatus == 0, done, lRetval = -errno);
+    }
+
+ done:
+    if (lDirectory != -1)
+    {
+        lStatus = close(lDirectory);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    return (lRetval);
+}
+
+static chkconfig_status_t SetQueueDepth(BenchmarkContext &inContext, const uint32_t &inQueueDepth)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_IO_QUEUE_DEPTH,
+                                    inQueueDepth);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t SetThreads(BenchmarkContext &inContext, const uint32_t &inThreads)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_THREADS,
+                                    inThreads);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t SetUseDefaultDirectory(BenchmarkContext &inContext, const bool &inUseDefaultDirectory)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    inUseDefaultDirectory);
+
+    return (lRetval);
+}
+
+// MARK: Benchmarks
+
+/*
+ * Copy All w/ Defaults
+ *
+ * Copy the overlay of a default and a state directory, each with
+ * 100,000 flags, half of which overlap between the two.
+ */
+static chkconfig_status_t BenchmarkCopyAllWithDefaults(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount   = 100000;
+    static constexpr size_t        kOverlap = (kCount / 2);
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    BenchmarkResult                lResult;
+    uint64_t                       lStart;
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mDefaultDirectory, 0, kCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = CreateFlags(inContext.mStateDirectory, kOverlap, kCount, false);
+    nlREQUIRE_SUCCESS(lRetval, destroy_default);
+
+    lRetval = SetUseDefaultDirectory(inContext, true);
+    nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+    ResultInit(lResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_all(inContext.mContextPointer,
+                                           &lFlagStateTuples,
+                                           &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+        ResultAccumulate(lResult, lStart, Now());
+
+        nlREQUIRE_ACTION(lFlagStateTuplesCount == (kCount + kOverlap),
+                         destroy_state,
+                         lRetval = -EIO);
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy_state);
+    }
+
+    ResultPrint("copy-all-with-defaults", "100000+100000, 50% overlap", inContext.mIterations, lResult);
+
+ destroy_state:
+    lStatus = DestroyFlags(inContext.mStateDirectory, kOverlap, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ destroy_default:
+    lStatus = DestroyFlags(inContext.mDefaultDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Copy All by Threads
+ *
+ * Copy the overlay of a default and a state directory, each with
+ * 20,000 flags, half of which overlap between the two, with one,
+ * two, four, and eight threads.
+ */
+static chkconfig_status_t BenchmarkCopyAllByThreads(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount     = 20000;
+    static constexpr size_t        kOverlap   = (kCount / 2);
+    static const uint32_t          kThreads[] = { 1, 2, 4, 8 };
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    BenchmarkResult                lResult;
+    uint64_t                       lStart;
+    char                           lParameters[48];
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mDefaultDirectory, 0, kCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = CreateFlags(inContext.mStateDirectory, kOverlap, kCount, false);
+    nlREQUIRE_SUCCESS(lRetval, destroy_default);
+
+    lRetval = SetUseDefaultDirectory(inContext, true);
+    nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+    for (size_t lThreadsIndex = 0; lThreadsIndex < ElementsOf(kThreads); lThreadsIndex++)
+    {
+        lRetval = SetThreads(inContext, kThreads[lThreadsIndex]);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        ResultInit(lResult);
+
+        for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+        {
+            lStart = Now();
+
+            lRetval = chkconfig_state_copy_all(inContext.mContextPointer,
+                                               &lFlagStateTuples,
+                                               &lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, restore);
+
+            ResultAccumulate(lResult, lStart, Now());
+
+            nlREQUIRE_ACTION(lFlagStateTuplesCount == (kCount + kOverlap),
+                             restore,
+                             lRetval = -EIO);
+
+            lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, restore);
+        }
+
+        snprintf(lParameters, sizeof (lParameters), "%zu+%zu, threads %u", kCount, kCount, kThreads[lThreadsIndex]);
+
+        ResultPrint("copy-all-threads", lParameters, inContext.mIterations, lResult);
+    }
+
+ restore:
+    lStatus = SetThreads(inContext, 1);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ destroy_state:
+    lStatus = DestroyFlags(inContext.mStateDirectory, kOverlap, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ destroy_default:
+    lStatus = DestroyFlags(inContext.mDefaultDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Count w/ Defaults
+ *
+ * Count the overlay of a default and a state directory, each with
+ * 1,000, 10,000, and 100,000 flags, half of which overlap between
+ * the two.
+ */
+static chkconfig_status_t BenchmarkCountWithDefaults(BenchmarkContext &inContext)
+{
+    static constexpr size_t kCounts[] = { 1000, 10000, 100000 };
+    size_t                  lCount;
+    BenchmarkResult         lResult;
+    uint64_t                lStart;
+    char                    lParameters[32];
+    chkconfig_status_t      lStatus;
+    chkconfig_status_t      lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = SetUseDefaultDirectory(inContext, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    for (size_t lCountIndex = 0; lCountIndex < ElementsOf(kCounts); lCountIndex++)
+    {
+        const size_t lFlags   = kCounts[lCountIndex];
+        const size_t lOverlap = (lFlags / 2);
+
+        lRetval = CreateFlags(inContext.mDefaultDirectory, 0, lFlags, true);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        lRetval = CreateFlags(inContext.mStateDirectory, lOverlap, lFlags, false);
+        nlREQUIRE_SUCCESS(lRetval, destroy_default);
+
+        ResultInit(lResult);
+
+        for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+        {
+            lStart = Now();
+
+            lRetval = chkconfig_state_get_count(inContext.mContextPointer,
+                                                &lCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+            ResultAccumulate(lResult, lStart, Now());
+
+            nlREQUIRE_ACTION(lCount == (lFlags + lOverlap),
+                             destroy_state,
+                             lRetval = -EIO);
+        }
+
+        snprintf(lParameters, sizeof (lParameters), "%zu+%zu, 50%% overlap", lFlags, lFlags);
+
+        ResultPrint("count-with-defaults", lParameters, inContext.mIterations, lResult);
+
+    destroy_state:
+        lStatus = DestroyFlags(inContext.mStateDirectory, lOverlap, lFlags);
+        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    destroy_default:
+        lStatus = DestroyFlags(inContext.mDefaultDirectory, 0, lFlags);
+        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t SortOne(BenchmarkContext &inContext,
+                                  const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                  chkconfig_flag_state_tuple_t *inScratchTuples,
+                                  const size_t &inCount,
+                                  const chkconfig_sort_order_t &inOrder,
+                                  const bool &inUseQsort)
+{
+    int (* lCompareFunction)(const void *, const void *);
+    BenchmarkResult    lResult;
+    uint64_t           lStart;
+    char               lParameters[32];
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lCompareFunction = ((inOrder == CHKCONFIG_SORT_ORDER_STATE) ?
+                        chkconfig_flag_state_tuple_state_compare_function :
+                        chkconfig_flag_state_tuple_flag_compare_function);
+
+    ResultInit(lResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        memcpy(inScratchTuples, inFlagStateTuples, inCount * sizeof (chkconfig_flag_state_tuple_t));
+
+        lStart = Now();
+
+        if (inUseQsort)
+        {
+            qsort(inScratchTuples, inCount, sizeof (chkconfig_flag_state_tuple_t), lCompareFunction);
+        }
+        else
+        {
+            lRetval = chkconfig_flag_state_tuples_sort(inScratchTuples, inCount, inOrder);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+
+        ResultAccumulate(lResult, lStart, Now());
+    }
+
+    snprintf(lParameters,
+             sizeof (lParameters),
+             "%zu, %s, %s",
+             inCount,
+             ((inOrder == CHKCONFIG_SORT_ORDER_STATE) ? "state" : "flag"),
+             (inUseQsort ? "qsort" : "library"));
+
+    ResultPrint("sort", lParameters, inContext.mIterations, lResult);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Sort
+ *
+ * Sort 10,000, 100,000, and 1,000,000 in-memory flags, by flag and
+ * by state, with qsort(3) and the library comparison functions and
+ * with chkconfig_flag_state_tuples_sort.
+ */
+static chkconfig_status_t BenchmarkSort(BenchmarkContext &inContext)
+{
+    static constexpr size_t      kCounts[]   = { 10000, 100000, 1000000 };
+    static constexpr size_t      kFlagSize   = 40;
+    static const char * const    kPrefixes[] = {
+        "net.wifi.",
+        "net.ethernet.",
+        "system.logging.",
+        "ui."
+    };
+    static const chkconfig_sort_order_t kOrders[] = {
+        CHKCONFIG_SORT_ORDER_FLAG,
+        CHKCONFIG_SORT_ORDER_STATE
+    };
+    char *                         lFlags           = nullptr;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    chkconfig_flag_state_tuple_t * lScratchTuples   = nullptr;
+    const size_t                   lMaximum         = kCounts[ElementsOf(kCounts) - 1];
+    uint32_t                       lRandom          = 1;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lFlags = static_cast<char *>(malloc(lMaximum * kFlagSize));
+    nlREQUIRE_ACTION(lFlags != nullptr, done, lRetval = -ENOMEM);
+
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(lMaximum * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lFlagStateTuples != nullptr, done, lRetval = -ENOMEM);
+
+    lScratchTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(lMaximum * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lScratchTuples != nullptr, done, lRetval = -ENOMEM);
+
+    // Generate flags with a handful of shared, dotted prefixes
+    // followed by pseudo-random, lowercase-hexadecimal names, much
+    // as real-world flag namespaces look.
+
+    for (size_t lIndex = 0; lIndex < lMaximum; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * kFlagSize];
+
+        lRandom = (lRandom * 1103515245) + 12345;
+
+        snprintf(lFlag,
+                 kFlagSize,
+                 "%s%08x%zx",
+                 kPrefixes[(lRandom >> 16) % ElementsOf(kPrefixes)],
+                 lRandom,
+                 lIndex);
+
+        lFlagStateTuples[lIndex].m_flag   = lFlag;
+        lFlagStateTuples[lIndex].m_state  = ((lRandom >> 24) & 1);
+        lFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_STATE;
+    }
+
+    for (size_t lCountIndex = 0; lCountIndex < ElementsOf(kCounts); lCountIndex++)
+    {
+        for (size_t lOrderIndex = 0; lOrderIndex < ElementsOf(kOrders); lOrderIndex++)
+        {
+            lRetval = SortOne(inContext, lFlagStateTuples, lScratchTuples, kCounts[lCountIndex], kOrders[lOrderIndex], true);
+            nlREQUIRE_SUCCESS(lRetval, done);
+
+            lRetval = SortOne(inContext, lFlagStateTuples, lScratchTuples, kCounts[lCountIndex], kOrders[lOrderIndex], false);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+    }
+
+ done:
+    free(lFlags);
+    free(lFlagStateTuples);
+    free(lScratchTuples);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t GetMultipleOne(BenchmarkContext &inContext,
+                                         chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                         const size_t &inCount,
+                                         const char *inLayers,
+                                         const uint32_t &inQueueDepth)
+{
+    BenchmarkResult    lResult;
+    uint64_t           lStart;
+    char               lParameters[32];
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = SetQueueDepth(inContext, inQueueDepth);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    ResultInit(lResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_multiple(inContext.mContextPointer,
+                                               inFlagStateTuples,
+                                               inCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lResult, lStart, Now());
+    }
+
+    snprintf(lParameters, sizeof (lParameters), "%s, depth %u", inLayers, inQueueDepth);
+
+    ResultPrint("get-multiple", lParameters, inContext.mIterations, lResult);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Get Multiple
+ *
+ * Get 10,000 flags at once from a state directory alone and from the
+ * overlay of a default and a state directory, half of which overlap
+ * between the two, synchronously (depth 0) and with batched I/O at
+ * queue depths from 1 to 256.
+ */
+static chkconfig_status_t BenchmarkGetMultiple(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 10000;
+    static constexpr size_t        kOverlap         = (kCount / 2);
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    char *                         lFlags           = nullptr;
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lFlags = static_cast<char *>(malloc(kCount * NAME_MAX));
+    nlREQUIRE_ACTION(lFlags != nullptr, done, lRetval = -ENOMEM);
+
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kCount * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lFlagStateTuples != nullptr, done, lRetval = -ENOMEM);
+
+    // Request the flags in the state directory, the first half of
+    // which are only in the default directory when it is in use.
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * NAME_MAX];
+
+        snprintf(lFlag, NAME_MAX, kFlagFormat, kOverlap + lIndex);
+
+        lFlagStateTuples[lIndex].m_flag = lFlag;
+    }
+
+    lRetval = CreateFlags(inContext.mDefaultDirectory, 0, kCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = CreateFlags(inContext.mStateDirectory, kOverlap, kCount, false);
+    nlREQUIRE_SUCCESS(lRetval, destroy_default);
+
+    for (size_t lDepthIndex = 0; lDepthIndex < ElementsOf(kQueueDepths); lDepthIndex++)
+    {
+        lRetval = GetMultipleOne(inContext, lFlagStateTuples, kCount, "10000", kQueueDepths[lDepthIndex]);
+        nlREQUIRE_SUCCESS(lRetval, destroy_state);
+    }
+
+    lRetval = SetUseDefaultDirectory(inContext, true);
+    nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+    for (size_t lDepthIndex = 0; lDepthIndex < ElementsOf(kQueueDepths); lDepthIndex++)
+    {
+        lRetval = GetMultipleOne(inContext, lFlagStateTuples, kCount, "10000+10000", kQueueDepths[lDepthIndex]);
+        nlREQUIRE_SUCCESS(lRetval, destroy_state);
+    }
+
+ destroy_state:
+    lStatus = SetQueueDepth(inContext, 0);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = DestroyFlags(inContext.mStateDirectory, kOverlap, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ destroy_default:
+    lStatus = DestroyFlags(inContext.mDefaultDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    free(lFlags);
+    free(lFlagStateTuples);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t SetMultipleOne(BenchmarkContext &inContext,
+                                         const chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                         chkconfig_status_t *inStatuses,
+                                         const size_t &inCount,
+                                         const bool &inSync,
+                                         const uint32_t &inQueueDepth)
+{
+    BenchmarkResult    lResult;
+    uint64_t           lStart;
+    char               lParameters[32];
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = SetQueueDepth(inContext, inQueueDepth);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_SYNC_STATE,
+                                    inSync);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    ResultInit(lResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_set_multiple_with_status(inContext.mContextPointer,
+                                                           inFlagStateTuples,
+                                                           inCount,
+                                                           inStatuses);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lResult, lStart, Now());
+    }
+
+    snprintf(lParameters,
+             sizeof (lParameters),
+             "%zu, %sdepth %u",
+             inCount,
+             (inSync ? "sync, " : ""),
+             inQueueDepth);
+
+    ResultPrint("set-multiple", lParameters, inContext.mIterations, lResult);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Set Multiple
+ *
+ * Set 10,000 new flags at once, as in bulk provisioning, with and
+ * without flushing each to stable storage, synchronously (depth 0)
+ * and with batched I/O at queue depths from 1 to 256.
+ */
+static chkconfig_status_t BenchmarkSetMultiple(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 10000;
+    static constexpr bool          kSyncs[]         = { false, true };
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    chkconfig_status_t *           lStatuses        = nullptr;
+    char *                         lFlags           = nullptr;
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lFlags = static_cast<char *>(malloc(kCount * NAME_MAX));
+    nlREQUIRE_ACTION(lFlags != nullptr, done, lRetval = -ENOMEM);
+
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kCount * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lFlagStateTuples != nullptr, done, lRetval = -ENOMEM);
+
+    lStatuses = static_cast<chkconfig_status_t *>(malloc(kCount * sizeof (chkconfig_status_t)));
+    nlREQUIRE_ACTION(lStatuses != nullptr, done, lRetval = -ENOMEM);
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * NAME_MAX];
+
+        snprintf(lFlag, NAME_MAX, kFlagFormat, lIndex);
+
+        lFlagStateTuples[lIndex].m_flag   = lFlag;
+        lFlagStateTuples[lIndex].m_state  = (lIndex & 1);
+        lFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_STATE;
+    }
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    for (size_t lSyncIndex = 0; lSyncIndex < ElementsOf(kSyncs); lSyncIndex++)
+    {
+        for (size_t lDepthIndex = 0; lDepthIndex < ElementsOf(kQueueDepths); lDepthIndex++)
+        {
+            lRetval = SetMultipleOne(inContext,
+                                     lFlagStateTuples,
+                                     lStatuses,
+                                     kCount,
+                                     kSyncs[lSyncIndex],
+                                     kQueueDepths[lDepthIndex]);
+            nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+            lRetval = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+            nlREQUIRE_SUCCESS(lRetval, reset);
+        }
+    }
+
+    goto reset;
+
+ destroy_state:
+    lStatus = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ reset:
+    lStatus = SetQueueDepth(inContext, 0);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_SYNC_STATE,
+                                    false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    free(lFlags);
+    free(lFlagStateTuples);
+    free(lStatuses);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t StateLogOne(BenchmarkContext &inContext,
+                                      const char *inStore,
+                                      const char *inFlags,
+                                      const size_t &inCount,
+                                      const size_t &inOperations)
+{
+    static constexpr size_t kStride = 7919;
+    BenchmarkResult         lGetResult;
+    BenchmarkResult         lSetResult;
+    uint64_t                lStart;
+    chkconfig_state_t       lState;
+    char                    lParameters[32];
+    chkconfig_status_t      lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    ResultInit(lGetResult);
+    ResultInit(lSetResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        for (size_t lIndex = 0; lIndex < inOperations; lIndex++)
+        {
+            const char * lFlag = &inFlags[((lIndex * kStride) % inCount) * NAME_MAX];
+
+            lRetval = chkconfig_state_get(inContext.mContextPointer, lFlag, &lState);
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+
+        ResultAccumulate(lGetResult, lStart, Now());
+
+        lStart = Now();
+
+        for (size_t lIndex = 0; lIndex < inOperations; lIndex++)
+        {
+            const char * lFlag = &inFlags[((lIndex * kStride) % inCount) * NAME_MAX];
+
+            lRetval = chkconfig_state_set(inContext.mContextPointer, lFlag, ((lIteration & 1) == 0));
+            nlREQUIRE_SUCCESS(lRetval, done);
+        }
+
+        ResultAccumulate(lSetResult, lStart, Now());
+    }
+
+    snprintf(lParameters,
+             sizeof (lParameters),
+             "%s, %zu of %zu",
+             inStore,
+             inOperations,
+             inCount);
+
+    ResultPrint("state-log-get", lParameters, inContext.mIterations, lGetResult);
+    ResultPrint("state-log-set", lParameters, inContext.mIterations, lSetResult);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * State Log
+ *
+ * Look up and update 10,000 of 100,000 flags, one at a time, first
+ * with a backing file per flag in the state directory and then with
+ * all flags in a single-file state log.
+ */
+static chkconfig_status_t BenchmarkStateLog(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 100000;
+    static constexpr size_t        kOperations      = 10000;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    char *                         lFlags           = nullptr;
+    char                           lLogPath[PATH_MAX];
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lStatus = snprintf(lLogPath, sizeof (lLogPath), "%s/flags.log", inContext.mStateDirectory);
+    nlREQUIRE_ACTION(lStatus > 0, done, lRetval = -EOVERFLOW);
+    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < sizeof (lLogPath), done, lRetval = -EOVERFLOW);
+
+    lFlags = static_cast<char *>(malloc(kCount * NAME_MAX));
+    nlREQUIRE_ACTION(lFlags != nullptr, done, lRetval = -ENOMEM);
+
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kCount * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lFlagStateTuples != nullptr, done, lRetval = -ENOMEM);
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * NAME_MAX];
+
+        snprintf(lFlag, NAME_MAX, kFlagFormat, lIndex);
+
+        lFlagStateTuples[lIndex].m_flag   = lFlag;
+        lFlagStateTuples[lIndex].m_state  = false;
+        lFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_STATE;
+    }
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // A backing file per flag in the state directory
+
+    lRetval = CreateFlags(inContext.mStateDirectory, 0, kCount, false);
+    nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+    lRetval = StateLogOne(inContext, "directory", lFlags, kCount, kOperations);
+    nlREQUIRE_SUCCESS(lRetval, destroy_state);
+
+    lRetval = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlREQUIRE_SUCCESS(lRetval, reset);
+
+    // All flags in a single-file state log
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_LOG,
+                                    &lLogPath[0]);
+    nlREQUIRE_SUCCESS(lRetval, reset);
+
+    lRetval = chkconfig_state_set_multiple(inContext.mContextPointer,
+                                           lFlagStateTuples,
+                                           kCount);
+    nlREQUIRE_SUCCESS(lRetval, destroy_log);
+
+    lRetval = StateLogOne(inContext, "log", lFlags, kCount, kOperations);
+    nlREQUIRE_SUCCESS(lRetval, destroy_log);
+
+ destroy_log:
+    lStatus = unlink(lLogPath);
+    nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+
+    goto reset;
+
+ destroy_state:
+    lStatus = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ reset:
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_LOG,
+                                    static_cast<const char *>(nullptr));
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    free(lFlags);
+    free(lFlagStateTuples);
+
+    return (lRetval);
+}
+
+static chkconfig_status_t MemoryStateOne(BenchmarkContext &inContext,
+                                         chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                         const size_t &inCount)
+{
+    BenchmarkResult                lGetResult;
+    BenchmarkResult                lSetResult;
+    BenchmarkResult                lCopyResult;
+    uint64_t                       lStart;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lCount;
+    char                           lParameters[32];
+    chkconfig_status_t             lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    ResultInit(lGetResult);
+    ResultInit(lSetResult);
+    ResultInit(lCopyResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_multiple(inContext.mContextPointer,
+                                               inFlagStateTuples,
+                                               inCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lGetResult, lStart, Now());
+
+        for (size_t lIndex = 0; lIndex < inCount; lIndex++)
+        {
+            inFlagStateTuples[lIndex].m_state = ((lIteration & 1) == 0);
+        }
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_set_multiple(inContext.mContextPointer,
+                                               inFlagStateTuples,
+                                               inCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lSetResult, lStart, Now());
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_all_sorted(inContext.mContextPointer,
+                                                  CHKCONFIG_SORT_ORDER_FLAG,
+                                                  &lFlagStateTuples,
+                                                  &lCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lCopyResult, lStart, Now());
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+    }
+
+    snprintf(lParameters, sizeof (lParameters), "%zu", inCount);
+
+    ResultPrint("memory-state-get-multiple", lParameters, inContext.mIterations, lGetResult);
+    ResultPrint("memory-state-set-multiple", lParameters, inContext.mIterations, lSetResult);
+    ResultPrint("memory-state-copy-all", lParameters, inContext.mIterations, lCopyResult);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Memory State
+ *
+ * Get, set, and copy 10,000, 100,000, and 1,000,000 flags held in
+ * memory, measuring the library apart from the file system.
+ */
+static chkconfig_status_t BenchmarkMemoryState(BenchmarkContext &inContext)
+{
+    static const size_t            kCounts[]        = { 10000, 100000, 1000000 };
+    static constexpr size_t        kCountMaximum    = 1000000;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    char *                         lFlags           = nullptr;
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lFlags = static_cast<char *>(malloc(kCountMaximum * NAME_MAX));
+    nlREQUIRE_ACTION(lFlags != nullptr, done, lRetval = -ENOMEM);
+
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kCountMaximum * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lFlagStateTuples != nullptr, done, lRetval = -ENOMEM);
+
+    for (size_t lIndex = 0; lIndex < kCountMaximum; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * NAME_MAX];
+
+        snprintf(lFlag, NAME_MAX, kFlagFormat, lIndex);
+
+        lFlagStateTuples[lIndex].m_flag   = lFlag;
+        lFlagStateTuples[lIndex].m_state  = false;
+        lFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_STATE;
+    }
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    true);
+    nlREQUIRE_SUCCESS(lRetval, reset);
+
+    // The flags in memory are retained until the context is
+    // destroyed, so each count includes those of the last.
+
+    for (size_t lCountIndex = 0; lCountIndex < ElementsOf(kCounts); lCountIndex++)
+    {
+        lRetval = chkconfig_state_set_multiple(inContext.mContextPointer,
+                                               lFlagStateTuples,
+                                               kCounts[lCountIndex]);
+        nlREQUIRE_SUCCESS(lRetval, reset);
+
+        lRetval = MemoryStateOne(inContext, lFlagStateTuples, kCounts[lCountIndex]);
+        nlREQUIRE_SUCCESS(lRetval, reset);
+    }
+
+ reset:
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    free(lFlags);
+    free(lFlagStateTuples);
+
+    return (lRetval);
+}
+
+/*
+ * Layers
+ *
+ * Copy, count, and get the overlay of a default directory and four
+ * read-only layers, each with 10,000 flags, half of which overlap
+ * with the layer beneath it; then, get it again with existence
+ * filters.
+ */
+static chkconfig_status_t BenchmarkLayers(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount      = 10000;
+    static constexpr size_t        kOverlap    = (kCount / 2);
+    static constexpr size_t        kLayers     = 4;
+    static constexpr size_t        kUnique     = (kCount + (kLayers * kOverlap));
+    char                           lLayerDirectories[kLayers][PATH_MAX];
+    size_t                         lLayerCount = 0;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    chkconfig_flag_state_tuple_t * lGetFlagStateTuples = nullptr;
+    char *                         lFlags              = nullptr;
+    BenchmarkResult                lCopyResult;
+    BenchmarkResult                lCountResult;
+    BenchmarkResult                lGetResult;
+    BenchmarkResult                lFilteredResult;
+    uint64_t                       lStart;
+    char                           lParameters[32];
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval     = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mDefaultDirectory, 0, kCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // Each layer pushed takes precedence over the last, such that
+    // the flags of each are shadowed in part by the next.
+
+    while (lLayerCount < kLayers)
+    {
+        lRetval = CreateDirectory("layer", PATH_MAX, &lLayerDirectories[lLayerCount][0]);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        lLayerCount++;
+
+        lRetval = CreateFlags(lLayerDirectories[lLayerCount - 1], lLayerCount * kOverlap, kCount, false);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                        inContext.mOptionsPointer,
+                                        CHKCONFIG_OPTION_LAYER_DIRECTORY,
+                                        &lLayerDirectories[lLayerCount - 1][0]);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+    }
+
+    lRetval = SetUseDefaultDirectory(inContext, true);
+    nlREQUIRE_SUCCESS(lRetval, restore);
+
+    lFlags = static_cast<char *>(malloc(kUnique * NAME_MAX));
+    nlREQUIRE_ACTION(lFlags != nullptr, restore, lRetval = -ENOMEM);
+
+    lGetFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kUnique * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lGetFlagStateTuples != nullptr, restore, lRetval = -ENOMEM);
+
+    for (size_t lIndex = 0; lIndex < kUnique; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * NAME_MAX];
+
+        snprintf(lFlag, NAME_MAX, kFlagFormat, lIndex);
+
+        lGetFlagStateTuples[lIndex].m_flag = lFlag;
+    }
+
+    ResultInit(lCopyResult);
+    ResultInit(lCountResult);
+    ResultInit(lGetResult);
+    ResultInit(lFilteredResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_all_sorted(inContext.mContextPointer,
+                                                  CHKCONFIG_SORT_ORDER_FLAG,
+                                                  &lFlagStateTuples,
+                                                  &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        ResultAccumulate(lCopyResult, lStart, Now());
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        nlREQUIRE_ACTION(lFlagStateTuplesCount == kUnique,
+                         restore,
+                         lRetval = -EIO);
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_count(inContext.mContextPointer, &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        ResultAccumulate(lCountResult, lStart, Now());
+
+        nlREQUIRE_ACTION(lFlagStateTuplesCount == kUnique,
+                         restore,
+                         lRetval = -EIO);
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_multiple(inContext.mContextPointer,
+                                               lGetFlagStateTuples,
+                                               kUnique);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        ResultAccumulate(lGetResult, lStart, Now());
+    }
+
+    // Then, get the same flags with existence filters, once built by
+    // an untimed get, sparing the failed opens for the flags absent
+    // from each store.
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_EXISTENCE_FILTERS,
+                                    true);
+    nlREQUIRE_SUCCESS(lRetval, restore);
+
+    lRetval = chkconfig_state_get_multiple(inContext.mContextPointer,
+                                           lGetFlagStateTuples,
+                                           kUnique);
+    nlREQUIRE_SUCCESS(lRetval, restore);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_multiple(inContext.mContextPointer,
+                                               lGetFlagStateTuples,
+                                               kUnique);
+        nlREQUIRE_SUCCESS(lRetval, restore);
+
+        ResultAccumulate(lFilteredResult, lStart, Now());
+    }
+
+    snprintf(lParameters, sizeof (lParameters), "%zu stores, %zu flags", kLayers + 2, kUnique);
+
+    ResultPrint("layers-copy-all-sorted", lParameters, inContext.mIterations, lCopyResult);
+    ResultPrint("layers-get-count", lParameters, inContext.mIterations, lCountResult);
+    ResultPrint("layers-get-multiple", lParameters, inContext.mIterations, lGetResult);
+    ResultPrint("layers-get-multiple-filtered", lParameters, inContext.mIterations, lFilteredResult);
+
+ restore:
+    free(lFlags);
+    free(lGetFlagStateTuples);
+
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_EXISTENCE_FILTERS,
+                                    false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = SetUseDefaultDirectory(inContext, false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    lStatus = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_LAYER_DIRECTORY,
+                                    static_cast<const char *>(nullptr));
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+    for (size_t lLayer = 0; lLayer < lLayerCount; lLayer++)
+    {
+        lStatus = DestroyFlags(lLayerDirectories[lLayer], (lLayer + 1) * kOverlap, kCount);
+        nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+        lStatus = rmdir(lLayerDirectories[lLayer]);
+        nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+    }
+
+    lStatus = DestroyFlags(inContext.mDefaultDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Sharded Layout
+ *
+ * Count, copy, and get the flags of a state directory with 100,000
+ * flags, first in the flat layout and then, once migrated, in the
+ * sharded layout.
+ */
+static chkconfig_status_t ShardedLayoutOne(BenchmarkContext &inContext,
+                                           const char *inLayout,
+                                           chkconfig_flag_state_tuple_t *inFlagStateTuples,
+                                           const size_t &inCount)
+{
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    BenchmarkResult                lCopyResult;
+    BenchmarkResult                lCountResult;
+    BenchmarkResult                lGetResult;
+    uint64_t                       lStart;
+    char                           lParameters[32];
+    chkconfig_status_t             lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    ResultInit(lCopyResult);
+    ResultInit(lCountResult);
+    ResultInit(lGetResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_all(inContext.mContextPointer,
+                                           &lFlagStateTuples,
+                                           &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lCopyResult, lStart, Now());
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        nlREQUIRE_ACTION(lFlagStateTuplesCount == inCount,
+                         done,
+                         lRetval = -EIO);
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_count(inContext.mContextPointer, &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lCountResult, lStart, Now());
+
+        nlREQUIRE_ACTION(lFlagStateTuplesCount == inCount,
+                         done,
+                         lRetval = -EIO);
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_multiple(inContext.mContextPointer,
+                                               inFlagStateTuples,
+                                               inCount);
+        nlREQUIRE_SUCCESS(lRetval, done);
+
+        ResultAccumulate(lGetResult, lStart, Now());
+    }
+
+    snprintf(lParameters, sizeof (lParameters), "%s, %zu flags", inLayout, inCount);
+
+    ResultPrint("sharded-layout-copy-all", lParameters, inContext.mIterations, lCopyResult);
+    ResultPrint("sharded-layout-get-count", lParameters, inContext.mIterations, lCountResult);
+    ResultPrint("sharded-layout-get-multiple", lParameters, inContext.mIterations, lGetResult);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t SetShardedLayout(BenchmarkContext &inContext, const bool &inShardedLayout)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_SHARDED_LAYOUT,
+                                    inShardedLayout);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_state_migrate_layout(inContext.mContextPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t BenchmarkShardedLayout(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 100000;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples = nullptr;
+    char *                         lFlags           = nullptr;
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mStateDirectory, 0, kCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lFlags = static_cast<char *>(malloc(kCount * NAME_MAX));
+    nlREQUIRE_ACTION(lFlags != nullptr, destroy, lRetval = -ENOMEM);
+
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kCount * sizeof (chkconfig_flag_state_tuple_t)));
+    nlREQUIRE_ACTION(lFlagStateTuples != nullptr, destroy, lRetval = -ENOMEM);
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        char * lFlag = &lFlags[lIndex * NAME_MAX];
+
+        snprintf(lFlag, NAME_MAX, kFlagFormat, lIndex);
+
+        lFlagStateTuples[lIndex].m_flag = lFlag;
+    }
+
+    lRetval = ShardedLayoutOne(inContext, "flat", lFlagStateTuples, kCount);
+    nlREQUIRE_SUCCESS(lRetval, destroy);
+
+    lRetval = SetShardedLayout(inContext, true);
+    nlREQUIRE_SUCCESS(lRetval, restore);
+
+    lRetval = ShardedLayoutOne(inContext, "sharded", lFlagStateTuples, kCount);
+    nlREQUIRE_SUCCESS(lRetval, restore);
+
+ restore:
+    lStatus = SetShardedLayout(inContext, false);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ destroy:
+    free(lFlags);
+    free(lFlagStateTuples);
+
+    lStatus = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+static bool FilterByPrefix(chkconfig_flag_t inFlag, void *inPrefix)
+{
+    const char * lPrefix = static_cast<const char *>(inPrefix);
+
+    return (strncmp(inFlag, lPrefix, strlen(lPrefix)) == 0);
+}
+
+static chkconfig_status_t BenchmarkPrefixQueries(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 100000;
+    static const char * const      kPrefixes[]      = { "flag-009999", "flag-0099", "flag-" };
+    static const size_t            kMatches[]       = { 10, 1000, kCount };
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    BenchmarkResult                lFilterResult;
+    BenchmarkResult                lPrefixResult;
+    BenchmarkResult                lFilteredResult;
+    uint64_t                       lStart;
+    size_t                         lMatched;
+    char                           lParameters[32];
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mStateDirectory, 0, kCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    // Compare copying every flag and filtering the copy, as a client
+    // had to, against copying only the matching flags.
+
+    for (size_t lPrefix = 0; lPrefix < ElementsOf(kPrefixes); lPrefix++)
+    {
+        ResultInit(lFilterResult);
+        ResultInit(lPrefixResult);
+        ResultInit(lFilteredResult);
+
+        for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+        {
+            lStart = Now();
+
+            lRetval = chkconfig_state_copy_all_sorted(inContext.mContextPointer,
+                                                      CHKCONFIG_SORT_ORDER_FLAG,
+                                                      &lFlagStateTuples,
+                                                      &lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy);
+
+            lMatched = 0;
+
+            for (size_t lIndex = 0; lIndex < lFlagStateTuplesCount; lIndex++)
+            {
+                if (strncmp(lFlagStateTuples[lIndex].m_flag, kPrefixes[lPrefix], strlen(kPrefixes[lPrefix])) == 0)
+                {
+                    lMatched++;
+                }
+            }
+
+            ResultAccumulate(lFilterResult, lStart, Now());
+
+            lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy);
+
+            nlREQUIRE_ACTION(lMatched == kMatches[lPrefix],
+                             destroy,
+                             lRetval = -EIO);
+
+            lStart = Now();
+
+            lRetval = chkconfig_state_copy_prefix(inContext.mContextPointer,
+                                                  kPrefixes[lPrefix],
+                                                  CHKCONFIG_SORT_ORDER_FLAG,
+                                                  &lFlagStateTuples,
+                                                  &lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy);
+
+            ResultAccumulate(lPrefixResult, lStart, Now());
+
+            lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy);
+
+            nlREQUIRE_ACTION(lFlagStateTuplesCount == kMatches[lPrefix],
+                             destroy,
+                             lRetval = -EIO);
+
+            lStart = Now();
+
+            lRetval = chkconfig_state_copy_filtered(inContext.mContextPointer,
+                                                    FilterByPrefix,
+                                                    const_cast<char *>(kPrefixes[lPrefix]),
+                                                    CHKCONFIG_SORT_ORDER_FLAG,
+                                                    &lFlagStateTuples,
+                                                    &lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy);
+
+            ResultAccumulate(lFilteredResult, lStart, Now());
+
+            lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+            nlREQUIRE_SUCCESS(lRetval, destroy);
+
+            nlREQUIRE_ACTION(lFlagStateTuplesCount == kMatches[lPrefix],
+                             destroy,
+                             lRetval = -EIO);
+        }
+
+        snprintf(lParameters, sizeof (lParameters), "%zu of %zu flags", kMatches[lPrefix], kCount);
+
+        ResultPrint("copy-all-and-filter", lParameters, inContext.mIterations, lFilterResult);
+        ResultPrint("copy-prefix", lParameters, inContext.mIterations, lPrefixResult);
+        ResultPrint("copy-filtered", lParameters, inContext.mIterations, lFilteredResult);
+    }
+
+ destroy:
+    lStatus = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t BenchmarkStateQueries(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 100000;
+    static constexpr size_t        kOnCount         = 10000;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    BenchmarkResult                lFilterResult;
+    BenchmarkResult                lWhereResult;
+    uint64_t                       lStart;
+    size_t                         lMatched;
+    char                           lParameters[32];
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mStateDirectory, 0, kOnCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = CreateFlags(inContext.mStateDirectory, kOnCount, (kCount - kOnCount), false);
+    nlREQUIRE_SUCCESS(lRetval, destroy);
+
+    // Compare copying every flag and filtering the copy by state, as
+    // a client had to, against copying only the flags that are on.
+
+    ResultInit(lFilterResult);
+    ResultInit(lWhereResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_all_sorted(inContext.mContextPointer,
+                                                  CHKCONFIG_SORT_ORDER_FLAG,
+                                                  &lFlagStateTuples,
+                                                  &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        lMatched = 0;
+
+        for (size_t lIndex = 0; lIndex < lFlagStateTuplesCount; lIndex++)
+        {
+            if (lFlagStateTuples[lIndex].m_state)
+            {
+                lMatched++;
+            }
+        }
+
+        ResultAccumulate(lFilterResult, lStart, Now());
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        nlREQUIRE_ACTION(lMatched == kOnCount,
+                         destroy,
+                         lRetval = -EIO);
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_where(inContext.mContextPointer,
+                                             true,
+                                             CHKCONFIG_SORT_ORDER_FLAG,
+                                             &lFlagStateTuples,
+                                             &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        ResultAccumulate(lWhereResult, lStart, Now());
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        nlREQUIRE_ACTION(lFlagStateTuplesCount == kOnCount,
+                         destroy,
+                         lRetval = -EIO);
+    }
+
+    snprintf(lParameters, sizeof (lParameters), "%zu of %zu flags", kOnCount, kCount);
+
+    ResultPrint("copy-all-and-filter", lParameters, inContext.mIterations, lFilterResult);
+    ResultPrint("copy-where", lParameters, inContext.mIterations, lWhereResult);
+
+ destroy:
+    lStatus = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t BenchmarkStateCounts(BenchmarkContext &inContext)
+{
+    static constexpr size_t        kCount           = 100000;
+    static constexpr size_t        kOnCount         = 10000;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    BenchmarkResult                lCopyResult;
+    BenchmarkResult                lCountsResult;
+    uint64_t                       lStart;
+    size_t                         lOn;
+    size_t                         lOff;
+    char                           lParameters[32];
+    chkconfig_status_t             lStatus;
+    chkconfig_status_t             lRetval          = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateFlags(inContext.mStateDirectory, 0, kOnCount, true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = CreateFlags(inContext.mStateDirectory, kOnCount, (kCount - kOnCount), false);
+    nlREQUIRE_SUCCESS(lRetval, destroy);
+
+    // Compare copying every flag and counting the copy by state, as
+    // a client had to, against counting them in the library.
+
+    ResultInit(lCopyResult);
+    ResultInit(lCountsResult);
+
+    for (size_t lIteration = 0; lIteration < inContext.mIterations; lIteration++)
+    {
+        lStart = Now();
+
+        lRetval = chkconfig_state_copy_all(inContext.mContextPointer,
+                                           &lFlagStateTuples,
+                                           &lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        lOn = 0;
+
+        for (size_t lIndex = 0; lIndex < lFlagStateTuplesCount; lIndex++)
+        {
+            if (lFlagStateTuples[lIndex].m_state)
+            {
+                lOn++;
+            }
+        }
+
+        lOff = (lFlagStateTuplesCount - lOn);
+
+        ResultAccumulate(lCopyResult, lStart, Now());
+
+        lRetval = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        nlREQUIRE_ACTION((lOn == kOnCount) && (lOff == (kCount - kOnCount)),
+                         destroy,
+                         lRetval = -EIO);
+
+        lStart = Now();
+
+        lRetval = chkconfig_state_get_counts(inContext.mContextPointer,
+                                             &lOn,
+                                             &lOff,
+                                             nullptr);
+        nlREQUIRE_SUCCESS(lRetval, destroy);
+
+        ResultAccumulate(lCountsResult, lStart, Now());
+
+        nlREQUIRE_ACTION((lOn == kOnCount) && (lOff == (kCount - kOnCount)),
+                         destroy,
+                         lRetval = -EIO);
+    }
+
+    snprintf(lParameters, sizeof (lParameters), "%zu flags", kCount);
+
+    ResultPrint("copy-all-and-count", lParameters, inContext.mIterations, lCopyResult);
+    ResultPrint("get-counts", lParameters, inContext.mIterations, lCountsResult);
+
+ destroy:
+    lStatus = DestroyFlags(inContext.mStateDirectory, 0, kCount);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  The table of all benchmarks, in the order they run by default.
+ *
+ */
+static const Benchmark sBenchmarks[] = {
+    {
+        "copy-all-with-defaults",
+        "chkconfig_state_copy_all over a default and state directory overlay",
+        BenchmarkCopyAllWithDefaults
+    },
+    {
+        "copy-all-threads",
+        "chkconfig_state_copy_all over a default and state directory overlay by thread count",
+        BenchmarkCopyAllByThreads
+    },
+    {
+        "count-with-defaults",
+        "chkconfig_state_get_count over a default and state directory overlay",
+        BenchmarkCountWithDefaults
+    },
+    {
+        "sort",
+        "chkconfig_flag_state_tuples_sort versus qsort(3)",
+        BenchmarkSort
+    },
+    {
+        "get-multiple",
+        "chkconfig_state_get_multiple by I/O queue depth",
+        BenchmarkGetMultiple
+    },
+    {
+        "set-multiple",
+        "chkconfig_state_set_multiple_with_status by I/O queue depth",
+        BenchmarkSetMultiple
+    },
+    {
+        "state-log",
+        "chkconfig_state_get and chkconfig_state_set by flag store",
+        BenchmarkStateLog
+    },
+    {
+        "memory-state",
+        "chkconfig_state_get_multiple, _set_multiple, and _copy_all_sorted in memory",
+        BenchmarkMemoryState
+    },
+    {
+        "layers",
+        "chkconfig_state_* over a default directory and four layers",
+        BenchmarkLayers
+    },
+    {
+        "sharded-layout",
+        "chkconfig_state_* over a flat versus a sharded state directory",
+        BenchmarkShardedLayout
+    },
+    {
+        "prefix-queries",
+        "chkconfig_state_copy_prefix and _copy_filtered versus filtering _copy_all_sorted",
+        BenchmarkPrefixQueries
+    },
+    {
+        "state-queries",
+        "chkconfig_state_copy_where versus filtering _copy_all_sorted",
+        BenchmarkStateQueries
+    },
+    {
+        "state-counts",
+        "chkconfig_state_get_counts versus counting _copy_all",
+        BenchmarkStateCounts
+    }
+};
+
+// MARK: Setup and Teardown
+
+static chkconfig_status_t BenchmarkSuiteInitialize(BenchmarkContext &inContext)
+{
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = CreateDirectory("default",
+                              PATH_MAX,
+                              &inContext.mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = CreateDirectory("state",
+                              PATH_MAX,
+                              &inContext.mStateDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_init(&inContext.mContextPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_init(inContext.mContextPointer,
+                                     &inContext.mOptionsPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &inContext.mStateDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(inContext.mContextPointer,
+                                    inContext.mOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &inContext.mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t BenchmarkSuiteFinalize(BenchmarkContext &inContext)
+{
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lRetval = chkconfig_options_destroy(inContext.mContextPointer,
+                                        &inContext.mOptionsPointer);
+    nlVERIFY_SUCCESS(lRetval);
+
+    lRetval = chkconfig_destroy(&inContext.mContextPointer);
+    nlVERIFY_SUCCESS(lRetval);
+
+    lStatus = rmdir(inContext.mDefaultDirectory);
+    nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+
+    lStatus = rmdir(inContext.mStateDirectory);
+    nlVERIFY_ACTION(lStatus == 0, lRetval = -errno);
+
+    return (lRetval);
+}
+
+static void PrintUsage(const int &inStatus)
+{
+    fprintf(stdout,
+            "Usage: %s [ -h ] [ -i <iterations> ] [ <benchmark> ... ]\n"
+            "\n"
+            "  -h, --help                   Print this help, then exit.\n"
+            "  -i, --iterations ITERATIONS  Run each benchmark ITERATIONS times\n"
+            "                               (default: 5).\n"
+            "\n"
+            " Benchmarks:\n"
+            "\n",
+            kProgram);
+
+    for (size_t lIndex = 0; lIndex < ElementsOf(sBenchmarks); lIndex++)
+    {
+        fprintf(stdout, "  %-28s %s\n", sBenchmarks[lIndex].mName, sBenchmarks[lIndex].mDescription);
+    }
+
+    exit(inStatus);
+}
+
+static bool ShouldRun(const Benchmark &inBenchmark, int inArgumentCount, char * const inArgumentArray[])
+{
+    bool lRetval = (inArgumentCount == 0);
+
+    for (int lIndex = 0; !lRetval && (lIndex < inArgumentCount); lIndex++)
+    {
+        lRetval = (strcmp(inBenchmark.mName, inArgumentArray[lIndex]) == 0);
+    }
+
+    return (lRetval);
+}
+
+int main(int argc, char * const argv[])
+{
+    static const struct option sOptions[] = {
+        { "help",       no_argument,       nullptr, 'h' },
+        { "iterations", required_argument, nullptr, 'i' },
+        { nullptr,      0,                 nullptr, 0   }
+    };
+    BenchmarkContext   lContext;
+    int                c;
+    chkconfig_status_t lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lContext.mIterations = 5;
+
+    while ((c = getopt_long(argc, argv, "hi:", sOptions, nullptr)) != -1)
+    {
+        switch (c)
+        {
+
+        case 'h':
+            PrintUsage(EXIT_SUCCESS);
+            break;
+
+        case 'i':
+            lContext.mIterations = strtoul(optarg, nullptr, 0);
+            if (lContext.mIterations == 0)
+            {
+                PrintUsage(EXIT_FAILURE);
+            }
+            break;
+
+        default:
+            PrintUsage(EXIT_FAILURE);
+            break;
+
+        }
+    }
+
+    lRetval = BenchmarkSuiteInitialize(lContext);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    ResultHeaderPrint();
+
+    for (size_t lIndex = 0; lIndex < ElementsOf(sBenchmarks); lIndex++)
+    {
+        if (!ShouldRun(sBenchmarks[lIndex], argc - optind, argv + optind))
+        {
+            continue;
+        }
+
+        lRetval = sBenchmarks[lIndex].mFunction(lContext);
+        nlREQUIRE_SUCCESS_ACTION(lRetval,
+                                 finalize,
+                                 fprintf(stderr, "Benchmark \"%s\" failed: %s\n",
+                                         sBenchmarks[lIndex].mName,
+                                         strerror(-lRetval)));
+
+        lRetval = SetUseDefaultDirectory(lContext, false);
+        nlREQUIRE_SUCCESS(lRetval, finalize);
+    }
+
+ finalize:
+    lStatus = BenchmarkSuiteFinalize(lContext);
+    nlVERIFY_SUCCESS_ACTION(lStatus, lRetval = lStatus);
+
+ done:
+    return ((lRetval == CHKCONFIG_STATUS_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,761 @@
+/*
+ *    Copyright (c) 2023 Nuovation System Designs, LLC
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the optional, header-only
+ *      C++ interface to the chkconfig library.
+ *
+ *      It is built once per language standard that enables more of
+ *      the interface: with C++17, the owning context and snapshot
+ *      types are tested and, with C++20 coroutines, the lazy flag
+ *      range and the awaitable observers and mutators are as well.
+ *
+ */
+
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/param.h>
+#if defined(__APPLE__)
+#include <sys/syslimits.h>
+#endif
+
+#include <nlunit-test.h>
+
+#include <chkconfig/chkconfig.hpp>
+
+#include "chkconfig-assert.h"
+
+#if !CHKCONFIG_HAVE_CXX17
+#error "The chkconfig C++ interface tests require C++17 or later."
+#endif
+
+#if CHKCONFIG_HAVE_COROUTINES
+#include <ranges>
+#endif
+
+
+using namespace nuovations::chkconfig;
+
+
+// MARK: Type Declarations
+
+struct TestContext
+{
+    char mDefaultDirectory[PATH_MAX];
+    char mStateDirectory[PATH_MAX];
+};
+
+#if CHKCONFIG_HAVE_COROUTINES
+/**
+ *  @brief
+ *    A minimal, eagerly-started coroutine that is driven to
+ *    completion by polling the context descriptor and dispatching.
+ *
+ */
+struct TestTask
+{
+    struct promise_type
+    {
+        TestTask get_return_object(void) noexcept
+        {
+            return (TestTask(std::coroutine_handle<promise_type>::from_promise(*this)));
+        }
+
+        std::suspend_never initial_suspend(void) const noexcept
+        {
+            return (std::suspend_never());
+        }
+
+        std::suspend_always final_suspend(void) const noexcept
+        {
+            return (std::suspend_always());
+        }
+
+        void return_void(void) noexcept
+        {
+            return;
+        }
+
+        void unhandled_exception(void) noexcept
+        {
+            abort();
+        }
+    };
+
+    explicit TestTask(std::coroutine_handle<promise_type> inHandle) noexcept :
+        mHandle(inHandle)
+    {
+        return;
+    }
+
+    TestTask(const TestTask &) = delete;
+    TestTask &operator =(const TestTask &) = delete;
+
+    ~TestTask(void)
+    {
+        mHandle.destroy();
+    }
+
+    std::coroutine_handle<promise_type> mHandle;
+};
+
+struct TestAwaitResults
+{
+    size_t      mCount;
+    StateResult mResults[4];
+};
+#endif // CHKCONFIG_HAVE_COROUTINES
+
+// MARK: Test Utilities
+
+static int TestSuiteCreateDirectory(const char *inProgram, const char *inDescription, const size_t &inNameSize, char *outName)
+{
+    int    lStatus;
+    char * lResult;
+    int    lRetval = 0;
+
+    lStatus = snprintf(outName,
+                       inNameSize,
+                       "%s-%s-XXXXXX",
+                       inProgram,
+                       inDescription);
+    nlREQUIRE_ACTION(lStatus > 0,
+                     done,
+                     lRetval = -EOVERFLOW);
+    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < inNameSize,
+                     done,
+                     lRetval = -EOVERFLOW);
+
+    lResult = mkdtemp(outName);
+    nlREQUIRE_ACTION(lResult != nullptr, done, lRetval = -errno);
+
+ done:
+    return (lRetval);
+}
+
+static int TestSuiteDestroyDirectory(const char *inPath)
+{
+    int lStatus;
+    int lRetval = 0;
+
+    lStatus = access(inPath, F_OK);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = -errno);
+
+    lStatus = rmdir(inPath);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = -errno);
+
+ done:
+    return (-lRetval);
+}
+
+static chkconfig_status_t DestroyBackingStoreFlag(const char *inDirectory,
+                                                  const chkconfig_flag_t &inFlag)
+{
+    char               lFlagPath[PATH_MAX];
+    int                lStatus;
+    chkconfig_status_t lRetval = CHKCONFIG_STATUS_SUCCESS;
+
+    lStatus = snprintf(&lFlagPath[0],
+                       sizeof (lFlagPath),
+                       "%s/%s",
+                       inDirectory,
+                       inFlag);
+    nlREQUIRE_ACTION(lStatus > 0,
+                     done,
+                     lRetval = -EOVERFLOW);
+    nlREQUIRE_ACTION(static_cast<size_t>(lStatus) < sizeof (lFlagPath),
+                     done,
+                     lRetval = -EOVERFLOW);
+
+    lStatus = unlink(lFlagPath);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = -errno);
+
+ done:
+    return (lRetval);
+}
+
+/**
+ *  Initialize a context against the test suite state and default
+ *  directories, with forced mutation so that flags may be created.
+ *
+ */
+static chkconfig_status_t ContextInit(const TestContext &inTestContext,
+                                      Context &outContext)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = outContext.Init();
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = outContext.SetOption(CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                   &inTestContext.mStateDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = outContext.SetOption(CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                   &inTestContext.mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = outContext.SetOption(CHKCONFIG_OPTION_FORCE_STATE,
+                                   true);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+static int TestSuiteInitialize(void *inContext)
+{
+    static const char * const kProgram = "test-libchkconfig-cxx";
+    TestContext *             lContext = static_cast<TestContext *>(inContext);
+    int                       lStatus;
+    int                       lRetval  = 0;
+
+    lStatus = TestSuiteCreateDirectory(kProgram,
+                                       "default",
+                                       PATH_MAX,
+                                       &lContext->mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = FAILURE);
+
+    lStatus = TestSuiteCreateDirectory(kProgram,
+                                       "state",
+                                       PATH_MAX,
+                                       &lContext->mStateDirectory[0]);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = FAILURE);
+
+ done:
+    return (lRetval);
+}
+
+static int TestSuiteFinalize(void *inContext)
+{
+    TestContext * lContext = static_cast<TestContext *>(inContext);
+    int           lStatus;
+    int           lRetval  = 0;
+
+    lStatus = TestSuiteDestroyDirectory(&lContext->mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = FAILURE);
+
+    lStatus = TestSuiteDestroyDirectory(&lContext->mStateDirectory[0]);
+    nlREQUIRE_SUCCESS_ACTION(lStatus, done, lRetval = FAILURE);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Context Lifetime Management
+ */
+static void TestContextLifetime(nlTestSuite *inSuite, void *inContext)
+{
+    TestContext *               lTestContext = static_cast<TestContext *>(inContext);
+    Context                     lContext;
+    chkconfig_context_pointer_t lContextPointer;
+    chkconfig_state_t           lState;
+    chkconfig_origin_t          lOrigin;
+    chkconfig_status_t          lStatus;
+
+    // 1.0. Negative tests
+
+    // 1.0.0. An uninitialized context has no underlying context, and
+    //        observing through it fails.
+
+    NL_TEST_ASSERT(inSuite, lContext.GetPointer() == nullptr);
+
+    lStatus = lContext.GetState("a", lState, lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.1. A context may only be initialized once.
+
+    lStatus = ContextInit(*lTestContext, lContext);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lContextPointer = lContext.GetPointer();
+    NL_TEST_ASSERT(inSuite, lContextPointer != nullptr);
+
+    lStatus = lContext.Init();
+    NL_TEST_ASSERT(inSuite, lStatus == -EALREADY);
+    NL_TEST_ASSERT(inSuite, lContext.GetPointer() == lContextPointer);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. Move construction transfers the underlying context and
+    //        options and leaves the source uninitialized.
+
+    {
+        Context lOther(std::move(lContext));
+
+        NL_TEST_ASSERT(inSuite, lContext.GetPointer() == nullptr);
+        NL_TEST_ASSERT(inSuite, lOther.GetPointer() == lContextPointer);
+
+        lStatus = lOther.SetState("a", true);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lStatus = lOther.GetState("a", lState, lOrigin);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lState == true);
+        NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+        // 2.0.1. Move assignment transfers them back, destroying
+        //        whatever the destination held, and leaves the
+        //        source uninitialized.
+
+        lStatus = lContext.Init();
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lContext.GetPointer() != nullptr);
+
+        lContext = std::move(lOther);
+
+        NL_TEST_ASSERT(inSuite, lOther.GetPointer() == nullptr);
+        NL_TEST_ASSERT(inSuite, lContext.GetPointer() == lContextPointer);
+
+        // 2.0.2. Destroying a moved-from context is harmless and a
+        //        moved-from context may be initialized again.
+
+        lStatus = lOther.Init();
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lOther.GetPointer() != nullptr);
+        NL_TEST_ASSERT(inSuite, lOther.GetPointer() != lContextPointer);
+    }
+
+    // 2.0.3. The moved context retains its options.
+
+    lStatus = lContext.GetState("a", lState, lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // Test Finalization
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
+/*
+ * Snapshots
+ */
+static void TestSnapshot(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const kFlags[]     = { "a", "b", "c" };
+    static const bool         kStates[]    = { false, true, false };
+    TestContext *             lTestContext = static_cast<TestContext *>(inContext);
+    Context                   lContext;
+    Snapshot                  lSnapshot;
+    size_t                    lIndex;
+    chkconfig_status_t        lStatus;
+
+    // Test Initialization
+
+    lStatus = ContextInit(*lTestContext, lContext);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // Create the flags out of order so that sorting is observable.
+
+    lStatus = lContext.SetState(kFlags[2], kStates[2]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = lContext.SetState(kFlags[0], kStates[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = lContext.SetState(kFlags[1], kStates[1]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    // 1.0.0. A failed copy leaves the snapshot untouched.
+
+    {
+        Context lUninitialized;
+
+        lStatus = lUninitialized.CopyAll(lSnapshot);
+        NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+        NL_TEST_ASSERT(inSuite, lSnapshot.empty());
+        NL_TEST_ASSERT(inSuite, lSnapshot.size() == 0);
+        NL_TEST_ASSERT(inSuite, lSnapshot.begin() == lSnapshot.end());
+    }
+
+    // 2.0. Positive tests
+
+    // 2.0.0. A snapshot in flag order is indexed and iterated in
+    //        that order.
+
+    lStatus = lContext.CopyAll(lSnapshot);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, !lSnapshot.empty());
+    NL_TEST_ASSERT(inSuite, lSnapshot.size() == 3);
+
+    lIndex = 0;
+
+    for (const FlagState &lFlagState : lSnapshot)
+    {
+        NL_TEST_ASSERT(inSuite, lIndex < 3);
+
+        if (lIndex >= 3)
+        {
+            break;
+        }
+
+        NL_TEST_ASSERT(inSuite, lFlagState.m_flag == kFlags[lIndex]);
+        NL_TEST_ASSERT(inSuite, lFlagState.m_state == kStates[lIndex]);
+        NL_TEST_ASSERT(inSuite, lFlagState.m_origin == CHKCONFIG_ORIGIN_STATE);
+
+        NL_TEST_ASSERT(inSuite, lSnapshot[lIndex].m_flag == lFlagState.m_flag);
+
+        lIndex++;
+    }
+
+    NL_TEST_ASSERT(inSuite, lIndex == 3);
+
+    // 2.0.1. Copying again in state order replaces the contents.
+
+    lStatus = lContext.CopyAll(lSnapshot, CHKCONFIG_SORT_ORDER_STATE);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lSnapshot.size() == 3);
+    NL_TEST_ASSERT(inSuite, lSnapshot[0].m_flag == "b");
+    NL_TEST_ASSERT(inSuite, lSnapshot[0].m_state == true);
+    NL_TEST_ASSERT(inSuite, lSnapshot[1].m_state == false);
+    NL_TEST_ASSERT(inSuite, lSnapshot[2].m_state == false);
+
+    // 2.0.2. Move construction transfers the flags, which remain
+    //        valid, and leaves the source empty.
+
+    {
+        const std::string_view lFirst = lSnapshot[0].m_flag;
+        Snapshot               lOther(std::move(lSnapshot));
+
+        NL_TEST_ASSERT(inSuite, lSnapshot.empty());
+        NL_TEST_ASSERT(inSuite, lSnapshot.begin() == lSnapshot.end());
+        NL_TEST_ASSERT(inSuite, lOther.size() == 3);
+        NL_TEST_ASSERT(inSuite, lOther[0].m_flag.data() == lFirst.data());
+
+        // 2.0.3. Move assignment releases whatever the destination
+        //        held and transfers the flags back.
+
+        lStatus = lContext.CopyAll(lSnapshot);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lSnapshot.size() == 3);
+
+        lSnapshot = std::move(lOther);
+
+        NL_TEST_ASSERT(inSuite, lOther.empty());
+        NL_TEST_ASSERT(inSuite, lSnapshot.size() == 3);
+        NL_TEST_ASSERT(inSuite, lSnapshot[0].m_flag.data() == lFirst.data());
+    }
+
+    // 2.0.4. A snapshot outlives the context that produced it.
+
+    lContext = Context();
+
+    NL_TEST_ASSERT(inSuite, lSnapshot[0].m_flag == "b");
+
+    // Test Finalization
+
+    for (const char * lFlag : kFlags)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, lFlag);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+}
+
+#if CHKCONFIG_HAVE_COROUTINES
+static_assert(std::ranges::input_range<FlagRange>);
+static_assert(std::sentinel_for<FlagRange::Sentinel, FlagRange::Iterator>);
+static_assert(std::is_move_constructible_v<FlagRange>);
+static_assert(!std::is_copy_constructible_v<FlagRange>);
+
+/*
+ * Flag Ranges
+ */
+static void TestFlagRange(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const kFlags[]     = { "a", "b", "c" };
+    TestContext *             lTestContext = static_cast<TestContext *>(inContext);
+    Context                   lContext;
+    size_t                    lCount;
+    chkconfig_status_t        lStatus;
+
+    // Test Initialization
+
+    lStatus = ContextInit(*lTestContext, lContext);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (const char * lFlag : kFlags)
+    {
+        lStatus = lContext.SetState(lFlag, true);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // 1.0. Negative tests
+
+    // 1.0.0. A range over an uninitialized context is empty and
+    //        reports why.
+
+    {
+        FlagRange lRange = List(nullptr);
+
+        lCount = 0;
+
+        for (const FlagState &lFlagState __attribute__((unused)) : lRange)
+        {
+            lCount++;
+        }
+
+        NL_TEST_ASSERT(inSuite, lCount == 0);
+        NL_TEST_ASSERT(inSuite, lRange.Status() == -EINVAL);
+    }
+
+    // 2.0. Positive tests
+
+    // 2.0.0. A full pass produces every flag exactly once.
+
+    {
+        FlagRange lRange = List(lContext.GetPointer());
+        bool      lSeen[3] = { false, false, false };
+
+        lCount = 0;
+
+        for (const FlagState &lFlagState : lRange)
+        {
+            for (size_t lIndex = 0; lIndex < 3; lIndex++)
+            {
+                if (lFlagState.m_flag == kFlags[lIndex])
+                {
+                    NL_TEST_ASSERT(inSuite, !lSeen[lIndex]);
+
+                    lSeen[lIndex] = true;
+                }
+            }
+
+            NL_TEST_ASSERT(inSuite, lFlagState.m_state == true);
+            NL_TEST_ASSERT(inSuite, lFlagState.m_origin == CHKCONFIG_ORIGIN_STATE);
+
+            lCount++;
+        }
+
+        NL_TEST_ASSERT(inSuite, lCount == 3);
+        NL_TEST_ASSERT(inSuite, lSeen[0] && lSeen[1] && lSeen[2]);
+        NL_TEST_ASSERT(inSuite, lRange.Status() == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // 2.0.1. Breaking out early leaves the range successful and
+    //        releases its cursor when the range is destroyed.
+
+    {
+        FlagRange lRange = List(lContext.GetPointer());
+
+        lCount = 0;
+
+        for (const FlagState &lFlagState : lRange)
+        {
+            NL_TEST_ASSERT(inSuite, !lFlagState.m_flag.empty());
+
+            lCount++;
+
+            break;
+        }
+
+        NL_TEST_ASSERT(inSuite, lCount == 1);
+        NL_TEST_ASSERT(inSuite, lRange.Status() == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // 2.0.2. A range may be moved before iteration, leaving the
+    //        source empty, and works with the standard range
+    //        algorithms.
+
+    {
+        FlagRange lSource = List(lContext.GetPointer());
+        FlagRange lRange(std::move(lSource));
+
+        NL_TEST_ASSERT(inSuite, lSource.begin() == lSource.end());
+
+        lCount = static_cast<size_t>(std::ranges::count_if(lRange,
+                                                           [](const FlagState &inFlagState) {
+                                                               return (inFlagState.m_state);
+                                                           }));
+
+        NL_TEST_ASSERT(inSuite, lCount == 3);
+        NL_TEST_ASSERT(inSuite, lRange.Status() == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // Test Finalization
+
+    for (const char * lFlag : kFlags)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, lFlag);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+}
+
+static TestTask AwaitSetAndGet(chkconfig_context_pointer_t inContextPointer,
+                               TestAwaitResults *outResults)
+{
+    outResults->mResults[outResults->mCount++] = co_await Set(inContextPointer, "a", false);
+    outResults->mResults[outResults->mCount++] = co_await Get(inContextPointer, "a");
+    outResults->mResults[outResults->mCount++] = co_await Get(inContextPointer, "z");
+    outResults->mResults[outResults->mCount++] = co_await Get(nullptr, "a");
+}
+
+/*
+ * Awaitable Observation and Mutation
+ */
+static void TestAwaitables(nlTestSuite *inSuite, void *inContext)
+{
+    static constexpr int kTimeout     = 5000;
+    TestContext *        lTestContext = static_cast<TestContext *>(inContext);
+    Context              lContext;
+    int                  lDescriptor  = -1;
+    struct pollfd        lPollDescriptor;
+    TestAwaitResults     lResults;
+    chkconfig_status_t   lStatus;
+
+    // Test Initialization
+
+    lResults.mCount = 0;
+
+    lStatus = ContextInit(*lTestContext, lContext);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = lContext.SetState("a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_poll_fd(lContext.GetPointer(), &lDescriptor);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lDescriptor >= 0);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. Set, get, and get a nonexistent flag, each awaited in
+    //        turn, with the coroutine resumed only from dispatch,
+    //        polling the descriptor until it finishes.
+
+    {
+        TestTask lTask = AwaitSetAndGet(lContext.GetPointer(), &lResults);
+
+        // The first request has been submitted and the coroutine
+        // suspended, without anything having been dispatched.
+
+        NL_TEST_ASSERT(inSuite, !lTask.mHandle.done());
+        NL_TEST_ASSERT(inSuite, lResults.mCount == 0);
+
+        while (!lTask.mHandle.done())
+        {
+            lPollDescriptor.fd      = lDescriptor;
+            lPollDescriptor.events  = POLLIN;
+            lPollDescriptor.revents = 0;
+
+            lStatus = poll(&lPollDescriptor, 1, kTimeout);
+            NL_TEST_ASSERT(inSuite, lStatus == 1);
+
+            if (lStatus != 1)
+            {
+                break;
+            }
+
+            lStatus = chkconfig_dispatch(lContext.GetPointer());
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+
+        NL_TEST_ASSERT(inSuite, lTask.mHandle.done());
+    }
+
+    NL_TEST_ASSERT(inSuite, lResults.mCount == 4);
+
+    NL_TEST_ASSERT(inSuite, lResults.mResults[0].m_status == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lResults.mResults[0].m_state == false);
+    NL_TEST_ASSERT(inSuite, lResults.mResults[0].m_origin == CHKCONFIG_ORIGIN_STATE);
+
+    NL_TEST_ASSERT(inSuite, lResults.mResults[1].m_status == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lResults.mResults[1].m_state == false);
+    NL_TEST_ASSERT(inSuite, lResults.mResults[1].m_origin == CHKCONFIG_ORIGIN_STATE);
+
+    NL_TEST_ASSERT(inSuite, lResults.mResults[2].m_status == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lResults.mResults[2].m_state == false);
+    NL_TEST_ASSERT(inSuite, lResults.mResults[2].m_origin == CHKCONFIG_ORIGIN_NONE);
+
+    // 2.0.1. A request that cannot be submitted does not suspend the
+    //        coroutine and yields the submission status.
+
+    NL_TEST_ASSERT(inSuite, lResults.mResults[3].m_status == -EINVAL);
+
+    // 2.0.2. The mutation went through the library.
+
+    {
+        chkconfig_state_t  lState;
+        chkconfig_origin_t lOrigin;
+
+        lStatus = lContext.GetState("a", lState, lOrigin);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lState == false);
+        NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+    }
+
+    // Test Finalization
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+#endif // CHKCONFIG_HAVE_COROUTINES
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Context Lifetime Management",   TestContextLifetime),
+    NL_TEST_DEF("Snapshots",                     TestSnapshot),
+#if CHKCONFIG_HAVE_COROUTINES
+    NL_TEST_DEF("Flag Ranges",                   TestFlagRange),
+    NL_TEST_DEF("Awaitable Observation",         TestAwaitables),
+#endif
+
+    NL_TEST_SENTINEL()
+};
+
+int main(void)
+{
+    TestContext theContext;
+    nlTestSuite theSuite = {
+        "libchkconfig-cxx",
+        &sTests[0],
+        TestSuiteInitialize,
+        TestSuiteFinalize,
+        nullptr,
+        nullptr,
+        0,
+        0,
+        0,
+        0,
+        0
+    };
+
+    // Generate human-readable output.
+    nlTestSetOutputStyle(OUTPUT_DEF);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, &theContext);
+
+    return (nlTestRunnerStats(&theSuite));
+}
@@ -23,9 +23,12 @@
 
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -581,6 +584,12 @@ static void TestUtilityTuplesLifetime(nlTestSuite *inSuite, void *inContext __at
 
     delete lFlagStateTuples;
 
+    // 1.4.0. Ensure that passing a null tuples argument to
+    //        chkconfig_flag_state_tuples_packed_destroy returns -EINVAL.
+
+    lStatus = chkconfig_flag_state_tuples_packed_destroy(nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
     // 2.0. Positive Tests
 
     // 2.0.0. Ensure that passing a valid pointer and size to
@@ -672,6 +681,165 @@ static void TestUtilityTuplesCompare(nlTestSuite *inSuite, void *inContext __att
     NL_TEST_ASSERT(inSuite, lComparison > 0);
 }
 
+/*
+ * Utility (Tuples Sort)
+ */
+static void TestUtilityTuplesSort(nlTestSuite *inSuite, void *inContext __attribute__((unused)))
+{
+    static constexpr int         kBadOrder   = 42;
+    static constexpr size_t      kCount      = 512;
+    static const char * const    kPrefixes[] = {
+        "",
+        "a",
+        "ab",
+        "abcdefg",
+        "abcdefgh",
+        "abcdefghi",
+        "net.wifi.enabled.",
+        "net.wifi.enabled.interface."
+    };
+    static constexpr size_t      kLongCount  = 64;
+    static const size_t          kLongPrefixLengths[] = { 2000, 8000, 65536 };
+    char                         lFlags[kCount][64];
+    chkconfig_flag_state_tuple_t lFlagStateTuples[kCount];
+    chkconfig_flag_state_tuple_t lExpectedTuples[kCount];
+    uint32_t                     lRandom = 1;
+    chkconfig_status_t           lStatus;
+
+    // Generate flags with shared prefixes both shorter and longer
+    // than eight bytes, flags that are prefixes of one another, and
+    // duplicates, with a deterministic pseudo-random state.
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        lRandom = (lRandom * 1103515245) + 12345;
+
+        snprintf(lFlags[lIndex],
+                 sizeof (lFlags[lIndex]),
+                 "%s%.*u",
+                 kPrefixes[(lRandom >> 16) % ElementsOf(kPrefixes)],
+                 static_cast<int>((lRandom >> 8) % 4),
+                 (lRandom >> 20) % 64);
+
+        if (lFlags[lIndex][0] == '\0')
+        {
+            lFlags[lIndex][0] = 'z';
+            lFlags[lIndex][1] = '\0';
+        }
+
+        lFlagStateTuples[lIndex].m_flag   = lFlags[lIndex];
+        lFlagStateTuples[lIndex].m_state  = ((lRandom >> 24) & 1);
+        lFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_UNKNOWN;
+    }
+
+    // 1.0. Negative Tests
+
+    // 1.0.0. Ensure that passing a null tuple array with a non-zero
+    //        count returns -EINVAL.
+
+    lStatus = chkconfig_flag_state_tuples_sort(nullptr, kCount, CHKCONFIG_SORT_ORDER_FLAG);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.1. Ensure that passing an invalid order returns -EINVAL.
+
+    lStatus = chkconfig_flag_state_tuples_sort(lFlagStateTuples, kCount, static_cast<chkconfig_sort_order_t>(kBadOrder));
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.1.0. Ensure that sorting an empty array succeeds.
+
+    lStatus = chkconfig_flag_state_tuples_sort(nullptr, 0, CHKCONFIG_SORT_ORDER_FLAG);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0. Ensure that sorting by flag matches qsort with the flag
+    //      compare function.
+
+    memcpy(lExpectedTuples, lFlagStateTuples, sizeof (lFlagStateTuples));
+
+    qsort(lExpectedTuples,
+          kCount,
+          sizeof (chkconfig_flag_state_tuple_t),
+          chkconfig_flag_state_tuple_flag_compare_function);
+
+    lStatus = chkconfig_flag_state_tuples_sort(lFlagStateTuples, kCount, CHKCONFIG_SORT_ORDER_FLAG);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[lIndex].m_flag, lExpectedTuples[lIndex].m_flag) == 0);
+    }
+
+    // 3.0. Ensure that sorting by state matches qsort with the state
+    //      compare function.
+
+    qsort(lExpectedTuples,
+          kCount,
+          sizeof (chkconfig_flag_state_tuple_t),
+          chkconfig_flag_state_tuple_state_compare_function);
+
+    lStatus = chkconfig_flag_state_tuples_sort(lFlagStateTuples, kCount, CHKCONFIG_SORT_ORDER_STATE);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (size_t lIndex = 0; lIndex < kCount; lIndex++)
+    {
+        NL_TEST_ASSERT(inSuite, chkconfig_flag_state_tuple_state_compare_function(&lFlagStateTuples[lIndex],
+                                                                                  &lExpectedTuples[lIndex]) == 0);
+    }
+
+    // 4.0. Ensure that flags sharing prefixes far longer than any
+    //      flag name, which the interface nonetheless accepts, sort
+    //      as qsort with the flag compare function does, without
+    //      exhausting the stack.
+
+    for (const size_t lPrefixLength : kLongPrefixLengths)
+    {
+        const size_t lFlagSize = (lPrefixLength + 8);
+        char *       lLongFlags;
+
+        lLongFlags = static_cast<char *>(malloc(kLongCount * lFlagSize));
+        NL_TEST_ASSERT(inSuite, lLongFlags != nullptr);
+
+        if (lLongFlags == nullptr)
+        {
+            break;
+        }
+
+        for (size_t lIndex = 0; lIndex < kLongCount; lIndex++)
+        {
+            char * lFlag = &lLongFlags[lIndex * lFlagSize];
+
+            lRandom = (lRandom * 1103515245) + 12345;
+
+            memset(lFlag, 'p', lPrefixLength);
+
+            snprintf(&lFlag[lPrefixLength],
+                     lFlagSize - lPrefixLength,
+                     "%u",
+                     (lRandom >> 16) % 1000);
+
+            lFlagStateTuples[lIndex].m_flag   = lFlag;
+            lFlagStateTuples[lIndex].m_state  = ((lRandom >> 24) & 1);
+            lFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_UNKNOWN;
+        }
+
+        memcpy(lExpectedTuples, lFlagStateTuples, kLongCount * sizeof (chkconfig_flag_state_tuple_t));
+
+        qsort(lExpectedTuples,
+              kLongCount,
+              sizeof (chkconfig_flag_state_tuple_t),
+              chkconfig_flag_state_tuple_flag_compare_function);
+
+        lStatus = chkconfig_flag_state_tuples_sort(lFlagStateTuples, kLongCount, CHKCONFIG_SORT_ORDER_FLAG);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        for (size_t lIndex = 0; lIndex < kLongCount; lIndex++)
+        {
+            NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[lIndex].m_flag, lExpectedTuples[lIndex].m_flag) == 0);
+        }
+
+        free(lLongFlags);
+    }
+}
+
 /*
  * Context Lifetime Management
  */
@@ -850,6 +1018,40 @@ static void TestOptionsMutation(nlTestSuite *inSuite, void *inContext)
                                     true);
     NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
 
+    // 1.0.3. Ensure that passing an out-of-range queue depth to
+    //        chkconfig_options_set returns -EINVAL.
+
+    lOption = CHKCONFIG_OPTION_IO_QUEUE_DEPTH;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    UINT32_MAX);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.4. Ensure that passing an out-of-range thread count to
+    //        chkconfig_options_set returns -EINVAL.
+
+    lOption = CHKCONFIG_OPTION_THREADS;
+
+    // 1.0.4.0. Ensure that passing a zero (0) thread count to
+    //          chkconfig_options_set returns -EINVAL.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    0);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.4.1. Ensure that passing an excessive thread count to
+    //          chkconfig_options_set returns -EINVAL.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    UINT32_MAX);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
     // 2.0. Positive Tests
 
     // 2.0.0. Ensure that CHKCONFIG_OPTION_STATE_DIRECTORY can be
@@ -920,6 +1122,75 @@ static void TestOptionsMutation(nlTestSuite *inSuite, void *inContext)
                                     false);
     NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
 
+    // 2.0.4. Ensure that CHKCONFIG_OPTION_IO_QUEUE_DEPTH can be
+    //        successfully set.
+
+    lOption = CHKCONFIG_OPTION_IO_QUEUE_DEPTH;
+
+    // 2.0.4.0. Ensure that CHKCONFIG_OPTION_IO_QUEUE_DEPTH can be
+    //          successfully set to a non-zero depth.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    64);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.4.1. Ensure that CHKCONFIG_OPTION_IO_QUEUE_DEPTH can be
+    //          successfully set to zero.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    0);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.5. Ensure that CHKCONFIG_OPTION_SYNC_STATE can be
+    //        successfully set.
+
+    lOption = CHKCONFIG_OPTION_SYNC_STATE;
+
+    // 2.0.5.0. Ensure that CHKCONFIG_OPTION_SYNC_STATE can be
+    //          successfully set to true.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.5.1. Ensure that CHKCONFIG_OPTION_SYNC_STATE can be
+    //          successfully set to false.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.6. Ensure that CHKCONFIG_OPTION_THREADS can be
+    //        successfully set.
+
+    lOption = CHKCONFIG_OPTION_THREADS;
+
+    // 2.0.6.0. Ensure that CHKCONFIG_OPTION_THREADS can be
+    //          successfully set to eight (8).
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    8);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.6.1. Ensure that CHKCONFIG_OPTION_THREADS can be
+    //          successfully set to one (1).
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    1);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
     // Test Finalization
 
     lStatus = chkconfig_options_destroy(lContextPointer, &lOptionsPointer);
@@ -988,6 +1259,7 @@ static void TestFlagObservationWithBackingStoreFlags(nlTestSuite *inSuite,
     const size_t                         lExpectedFlagStateTuplesCount = std::distance(inExpectedFlagStateTupleFirst, inExpectedFlagStateTupleLast);
     chkconfig_flag_state_tuple_t *       lActualFlagStateTuples = nullptr;
     size_t                               lActualFlagStateTuplesCount;
+    chkconfig_flag_state_tuple_t *       lMultipleFlagStateTuples;
     const chkconfig_flag_state_tuple_t * lActualFlagStateTupleCurrent;
     const chkconfig_flag_state_tuple_t * lActualFlagStateTupleLast;
     chkconfig_state_t                    lState;
@@ -1016,7 +1288,36 @@ static void TestFlagObservationWithBackingStoreFlags(nlTestSuite *inSuite,
         lExpectedFlagStateTupleCurrent++;
     }
 
-    // 2.0.0.1. Ensure that chkconfig_state_get_count and
+    // 2.0.0.1. Ensure that chkconfig_state_get_multiple returns the
+    //          expected states and origins for all of the flags at
+    //          once.
+
+    lMultipleFlagStateTuples = new chkconfig_flag_state_tuple_t[lExpectedFlagStateTuplesCount];
+    NL_TEST_ASSERT(inSuite, lMultipleFlagStateTuples != nullptr);
+
+    for (size_t lIndex = 0; lIndex < lExpectedFlagStateTuplesCount; lIndex++)
+    {
+        lMultipleFlagStateTuples[lIndex].m_flag   = inExpectedFlagStateTupleFirst[lIndex].m_flag;
+        lMultipleFlagStateTuples[lIndex].m_state  = !inExpectedFlagStateTupleFirst[lIndex].m_state;
+        lMultipleFlagStateTuples[lIndex].m_origin = CHKCONFIG_ORIGIN_UNKNOWN;
+    }
+
+    lStatus = chkconfig_state_get_multiple(inContextPointer,
+                                           lMultipleFlagStateTuples,
+                                           lExpectedFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (size_t lIndex = 0; lIndex < lExpectedFlagStateTuplesCount; lIndex++)
+    {
+        NL_TEST_ASSERT(inSuite, (lMultipleFlagStateTuples[lIndex].m_state ==
+                                 inExpectedFlagStateTupleFirst[lIndex].m_state));
+        NL_TEST_ASSERT(inSuite, (lMultipleFlagStateTuples[lIndex].m_origin ==
+                                 inExpectedFlagStateTupleFirst[lIndex].m_origin));
+    }
+
+    delete [] lMultipleFlagStateTuples;
+
+    // 2.0.0.2. Ensure that chkconfig_state_get_count and
     //          chkconfig_state_copy_all return the expected count and
     //          set of backing store flags.
 
@@ -1064,6 +1365,111 @@ static void TestFlagObservationWithBackingStoreFlags(nlTestSuite *inSuite,
     {
         chkconfig_flag_state_tuples_destroy(lActualFlagStateTuples,
                                             lActualFlagStateTuplesCount);
+
+        lActualFlagStateTuples = nullptr;
+    }
+
+    // 2.0.0.3. Ensure that chkconfig_state_copy_all_sorted, by flag,
+    //          returns the expected set of backing store flags,
+    //          already sorted by flag.
+
+    lStatus = chkconfig_state_copy_all_sorted(inContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lActualFlagStateTuples,
+                                              &lActualFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lActualFlagStateTuplesCount == lExpectedFlagStateTuplesCount);
+
+    lExpectedFlagStateTupleCurrent = inExpectedFlagStateTupleFirst;
+    lActualFlagStateTupleCurrent   = lActualFlagStateTuples;
+    lActualFlagStateTupleLast      = lActualFlagStateTupleCurrent + lActualFlagStateTuplesCount;
+
+    while ((lExpectedFlagStateTupleCurrent != inExpectedFlagStateTupleLast) &&
+           (lActualFlagStateTupleCurrent   != lActualFlagStateTupleLast))
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lExpectedFlagStateTupleCurrent->m_flag,
+                                       lActualFlagStateTupleCurrent->m_flag) == 0);
+        NL_TEST_ASSERT(inSuite, (lExpectedFlagStateTupleCurrent->m_state ==
+                                 lActualFlagStateTupleCurrent->m_state));
+        NL_TEST_ASSERT(inSuite, (lExpectedFlagStateTupleCurrent->m_origin ==
+                                 lActualFlagStateTupleCurrent->m_origin));
+
+        lExpectedFlagStateTupleCurrent++;
+        lActualFlagStateTupleCurrent++;
+    }
+
+    if (lActualFlagStateTuples != nullptr)
+    {
+        chkconfig_flag_state_tuples_destroy(lActualFlagStateTuples,
+                                            lActualFlagStateTuplesCount);
+
+        lActualFlagStateTuples = nullptr;
+    }
+
+    // 2.0.0.4. Ensure that chkconfig_state_copy_all_sorted, by state,
+    //          returns the expected count of backing store flags,
+    //          already sorted by state and then by flag.
+
+    lStatus = chkconfig_state_copy_all_sorted(inContextPointer,
+                                              CHKCONFIG_SORT_ORDER_STATE,
+                                              &lActualFlagStateTuples,
+                                              &lActualFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lActualFlagStateTuplesCount == lExpectedFlagStateTuplesCount);
+
+    for (size_t lIndex = 1; lIndex < lActualFlagStateTuplesCount; lIndex++)
+    {
+        NL_TEST_ASSERT(inSuite, chkconfig_flag_state_tuple_state_compare_function(&lActualFlagStateTuples[lIndex - 1],
+                                                                                  &lActualFlagStateTuples[lIndex]) < 0);
+    }
+
+    if (lActualFlagStateTuples != nullptr)
+    {
+        chkconfig_flag_state_tuples_destroy(lActualFlagStateTuples,
+                                            lActualFlagStateTuplesCount);
+
+        lActualFlagStateTuples = nullptr;
+    }
+
+    // 2.0.0.5. Ensure that chkconfig_state_copy_all_packed, by flag,
+    //          returns the expected set of backing store flags,
+    //          already sorted by flag, in a single allocation.
+
+    lStatus = chkconfig_state_copy_all_packed(inContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lActualFlagStateTuples,
+                                              &lActualFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lActualFlagStateTuplesCount == lExpectedFlagStateTuplesCount);
+
+    lExpectedFlagStateTupleCurrent = inExpectedFlagStateTupleFirst;
+    lActualFlagStateTupleCurrent   = lActualFlagStateTuples;
+    lActualFlagStateTupleLast      = lActualFlagStateTupleCurrent + lActualFlagStateTuplesCount;
+
+    while ((lExpectedFlagStateTupleCurrent != inExpectedFlagStateTupleLast) &&
+           (lActualFlagStateTupleCurrent   != lActualFlagStateTupleLast))
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lExpectedFlagStateTupleCurrent->m_flag,
+                                       lActualFlagStateTupleCurrent->m_flag) == 0);
+        NL_TEST_ASSERT(inSuite, (lExpectedFlagStateTupleCurrent->m_state ==
+                                 lActualFlagStateTupleCurrent->m_state));
+        NL_TEST_ASSERT(inSuite, (lExpectedFlagStateTupleCurrent->m_origin ==
+                                 lActualFlagStateTupleCurrent->m_origin));
+
+        // Each flag must lie within the allocation, after the
+        // tuples themselves.
+
+        NL_TEST_ASSERT(inSuite, (lActualFlagStateTupleCurrent->m_flag >=
+                                 reinterpret_cast<const char *>(lActualFlagStateTupleLast)));
+
+        lExpectedFlagStateTupleCurrent++;
+        lActualFlagStateTupleCurrent++;
+    }
+
+    if (lActualFlagStateTuples != nullptr)
+    {
+        lStatus = chkconfig_flag_state_tuples_packed_destroy(lActualFlagStateTuples);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
     }
 }
 
@@ -1096,6 +1502,7 @@ static void TestFlagObservationWithBackingStoreFlags(nlTestSuite *inSuite,
 static void TestNegativeFlagObservation(nlTestSuite *inSuite,
                                         chkconfig_context_pointer_t &inContextPointer)
 {
+    static constexpr int           kBadOrder  = 42;
     static const char * const      kFlagFirst = "test-a";
     chkconfig_status_t             lStatus;
     chkconfig_state_t              lState;
@@ -1228,6 +1635,42 @@ static void TestNegativeFlagObservation(nlTestSuite *inSuite,
                                        &lFlagStateTuples,
                                        nullptr);
     NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.10. Ensure that passing a null context pointer argument to
+    //         chkconfig_state_copy_all_sorted returns -EINVAL.
+
+    lStatus = chkconfig_state_copy_all_sorted(nullptr,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuples,
+                                              &lFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.11. Ensure that passing a null tuples argument to
+    //         chkconfig_state_copy_all_sorted returns -EINVAL.
+
+    lStatus = chkconfig_state_copy_all_sorted(inContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              nullptr,
+                                              &lFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.12. Ensure that passing a null tuple count argument to
+    //         chkconfig_state_copy_all_sorted returns -EINVAL.
+
+    lStatus = chkconfig_state_copy_all_sorted(inContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuples,
+                                              nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.13. Ensure that passing an invalid order to
+    //         chkconfig_state_copy_all_sorted returns -EINVAL.
+
+    lStatus = chkconfig_state_copy_all_sorted(inContextPointer,
+                                              static_cast<chkconfig_sort_order_t>(kBadOrder),
+                                              &lFlagStateTuples,
+                                              &lFlagStateTuplesCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
 }
 
 /*
@@ -1291,6 +1734,25 @@ static void TestFlagObservationWithoutDefaults(nlTestSuite *inSuite, void *inCon
     lFlagStateTupleFirst = &kFlagStateTuples[0];
     lFlagStateTupleLast  = lFlagStateTupleFirst + ElementsOf(kFlagStateTuples);
 
+    TestFlagObservationWithBackingStoreFlags(inSuite,
+                                             *lTestContext,
+                                             lContextPointer,
+                                             lFlagStateTupleFirst,
+                                             lFlagStateTupleLast,
+                                             lFlagStateTupleFirst,
+                                             lFlagStateTupleLast);
+
+    // 2.0.2. With two (2) state backing store flags, read in batches
+    //        of one (1) flag.
+
+    lOption = CHKCONFIG_OPTION_IO_QUEUE_DEPTH;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    1);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
     TestFlagObservationWithBackingStoreFlags(inSuite,
                                              *lTestContext,
                                              lContextPointer,
@@ -1308,18 +1770,332 @@ static void TestFlagObservationWithoutDefaults(nlTestSuite *inSuite, void *inCon
     NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
 }
 
-/*
- * Flag Observation w/ Defaults
- */
-static void TestFlagObservationWithDefaults(nlTestSuite *inSuite, void *inContext)
+static void TestFlagObservationWithThreads(nlTestSuite *inSuite,
+                                           const TestContext &inTestContext,
+                                           chkconfig_context_pointer_t &inContextPointer,
+                                           chkconfig_options_pointer_t &inOptionsPointer)
 {
-    static const char * const                     kFlagFirst   = "test-a";
-    static const char * const                     kFlagSecond  = "test-b";
-    static const char * const                     kFlagThird   = "test-c";
-    static const char * const                     kFlagFourth  = "test-d";
-    static const char * const                     kFlagFifth   = "test-e";
-    static const chkconfig_flag_state_tuple_t     kInputFlagStateTuples_2_0_1[] =
-    {
+    static constexpr size_t        kDefaultFlags  = 150;
+    static constexpr size_t        kStateFirst    = (kDefaultFlags / 2);
+    static constexpr size_t        kStateLast     = (kStateFirst + kDefaultFlags);
+    static const uint32_t          kThreads[]     = { 1, 4 };
+    char                           lFlag[32];
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    size_t                         lFlagStateTuplesCount;
+    chkconfig_flag_state_tuple_t   lFlagStateTuple;
+    chkconfig_state_cursor_t *     lCursorPointer;
+    bool                           lSeen[kStateLast];
+    size_t                         lCount;
+    size_t                         lMismatches;
+    chkconfig_status_t             lStatus;
+
+    // Test Initialization
+    //
+    // There are enough flags in each directory that each is read in
+    // more than one range when read with more than one thread.
+
+    for (size_t lIndex = 0; lIndex < kStateLast; lIndex++)
+    {
+        snprintf(lFlag, sizeof (lFlag), "test-%03zu", lIndex);
+
+        if (lIndex < kDefaultFlags)
+        {
+            lStatus = CreateBackingStoreFlag(inTestContext.mDefaultDirectory, lFlag, ((lIndex % 3) == 0));
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+
+        if (lIndex >= kStateFirst)
+        {
+            lStatus = CreateBackingStoreFlag(inTestContext.mStateDirectory, lFlag, ((lIndex % 2) == 0));
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+
+    for (size_t lThreadsIndex = 0; lThreadsIndex < ElementsOf(kThreads); lThreadsIndex++)
+    {
+        lStatus = chkconfig_options_set(inContextPointer,
+                                        inOptionsPointer,
+                                        CHKCONFIG_OPTION_THREADS,
+                                        kThreads[lThreadsIndex]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        // Ensure that chkconfig_state_get_count returns the count of
+        // the unique union of both directories.
+
+        lStatus = chkconfig_state_get_count(inContextPointer, &lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lCount == kStateLast);
+
+        // Ensure that chkconfig_state_copy_all_sorted returns every
+        // flag, in order, with the state and origin of the state
+        // directory where it exists there and of the default
+        // directory otherwise.
+
+        lStatus = chkconfig_state_copy_all_sorted(inContextPointer,
+                                                  CHKCONFIG_SORT_ORDER_FLAG,
+                                                  &lFlagStateTuples,
+                                                  &lFlagStateTuplesCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuplesCount == kStateLast);
+
+        lMismatches = 0;
+
+        for (size_t lIndex = 0; lIndex < lFlagStateTuplesCount; lIndex++)
+        {
+            const bool lIsState = (lIndex >= kStateFirst);
+
+            snprintf(lFlag, sizeof (lFlag), "test-%03zu", lIndex);
+
+            lMismatches += ((strcmp(lFlagStateTuples[lIndex].m_flag, lFlag) != 0) ||
+                            (lFlagStateTuples[lIndex].m_state != (lIsState ? ((lIndex % 2) == 0) : ((lIndex % 3) == 0))) ||
+                            (lFlagStateTuples[lIndex].m_origin != (lIsState ? CHKCONFIG_ORIGIN_STATE : CHKCONFIG_ORIGIN_DEFAULT)));
+        }
+
+        NL_TEST_ASSERT(inSuite, lMismatches == 0);
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lFlagStateTuplesCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // Ensure that a cursor produces each flag exactly once, in no
+    // particular order, with the same state and origin as
+    // chkconfig_state_copy_all_sorted.
+
+    lStatus = chkconfig_state_cursor_open(nullptr, &lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_cursor_open(inContextPointer, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_cursor_open(inContextPointer, &lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_cursor_next(nullptr, &lFlagStateTuple);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_cursor_next(lCursorPointer, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // Swap the state and default directories between opening and
+    // advancing the cursor. This publishes new runtime options and
+    // reclaims those the cursor was opened with, which the cursor
+    // must neither use nor reflect.
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &inTestContext.mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &inTestContext.mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    std::fill(&lSeen[0], &lSeen[kStateLast], false);
+
+    lCount      = 0;
+    lMismatches = 0;
+
+    while (true)
+    {
+        size_t lIndex;
+
+        lStatus = chkconfig_state_cursor_next(lCursorPointer, &lFlagStateTuple);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        if ((lStatus != CHKCONFIG_STATUS_SUCCESS) || (lFlagStateTuple.m_flag == nullptr))
+        {
+            break;
+        }
+
+        lIndex = strtoul(lFlagStateTuple.m_flag + strlen("test-"), nullptr, 10);
+
+        if ((lIndex >= kStateLast) || lSeen[lIndex])
+        {
+            lMismatches++;
+        }
+        else
+        {
+            const bool lIsState = (lIndex >= kStateFirst);
+
+            lSeen[lIndex] = true;
+
+            lMismatches += ((lFlagStateTuple.m_state != (lIsState ? ((lIndex % 2) == 0) : ((lIndex % 3) == 0))) ||
+                            (lFlagStateTuple.m_origin != (lIsState ? CHKCONFIG_ORIGIN_STATE : CHKCONFIG_ORIGIN_DEFAULT)));
+        }
+
+        lCount++;
+    }
+
+    NL_TEST_ASSERT(inSuite, lCount == kStateLast);
+    NL_TEST_ASSERT(inSuite, lMismatches == 0);
+
+    // An exhausted cursor stays exhausted.
+
+    lStatus = chkconfig_state_cursor_next(lCursorPointer, &lFlagStateTuple);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_flag == nullptr);
+
+    lStatus = chkconfig_state_cursor_close(&lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCursorPointer == nullptr);
+
+    lStatus = chkconfig_state_cursor_close(&lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // Test Finalization
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &inTestContext.mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &inTestContext.mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_THREADS,
+                                    1);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (size_t lIndex = 0; lIndex < kStateLast; lIndex++)
+    {
+        snprintf(lFlag, sizeof (lFlag), "test-%03zu", lIndex);
+
+        if (lIndex < kDefaultFlags)
+        {
+            lStatus = DestroyBackingStoreFlag(inTestContext.mDefaultDirectory, lFlag);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+
+        if (lIndex >= kStateFirst)
+        {
+            lStatus = DestroyBackingStoreFlag(inTestContext.mStateDirectory, lFlag);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+}
+
+/*
+ * Flag Observation w/ Defaults
+ */
+static void TestFlagObservationWithMalformedState(nlTestSuite *inSuite,
+                                                  const TestContext &inTestContext,
+                                                  chkconfig_context_pointer_t &inContextPointer,
+                                                  chkconfig_options_pointer_t &inOptionsPointer)
+{
+    static const char * const      kFlagMalformed  = "test-m";
+    static const char * const      kFlagWellFormed = "test-w";
+    static const uint32_t          kQueueDepths[]  = { 0, 2 };
+    char                           lFlagPath[PATH_MAX];
+    FILE *                         lFile;
+    chkconfig_flag_state_tuple_t   lFlagStateTuples[2];
+    chkconfig_state_t              lState;
+    chkconfig_origin_t             lOrigin;
+    bool                           lUseDefault;
+    chkconfig_status_t             lStatus;
+
+    // Test Initialization
+    //
+    // The state backing file of the first flag is neither on nor
+    // off, whereas its default backing file is on.
+
+    lStatus = CreateBackingStoreFlag(inTestContext.mDefaultDirectory, kFlagMalformed, true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(inTestContext.mStateDirectory, kFlagWellFormed, true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = FlagPathCopy(inTestContext.mStateDirectory, kFlagMalformed, sizeof (lFlagPath), lFlagPath);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lFile = fopen(lFlagPath, "w");
+    NL_TEST_ASSERT(inSuite, lFile != nullptr);
+
+    if (lFile != nullptr)
+    {
+        fputs("maybe\n", lFile);
+        fclose(lFile);
+    }
+
+    // With the default directory, the flag falls back to it, both
+    // alone and with another flag, whether read one flag at a time
+    // or in batches.
+
+    for (size_t lIndex = 0; lIndex < ElementsOf(kQueueDepths); lIndex++)
+    {
+        lStatus = chkconfig_options_set(inContextPointer,
+                                        inOptionsPointer,
+                                        CHKCONFIG_OPTION_IO_QUEUE_DEPTH,
+                                        kQueueDepths[lIndex]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lStatus = chkconfig_state_get_with_origin(inContextPointer, kFlagMalformed, &lState, &lOrigin);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lState == true);
+        NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+        lFlagStateTuples[0].m_flag = kFlagMalformed;
+        lFlagStateTuples[1].m_flag = kFlagWellFormed;
+
+        lStatus = chkconfig_state_get_multiple(inContextPointer, lFlagStateTuples, ElementsOf(lFlagStateTuples));
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_state == true);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_origin == CHKCONFIG_ORIGIN_DEFAULT);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_state == true);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_origin == CHKCONFIG_ORIGIN_STATE);
+    }
+
+    // Without the default directory, there is nothing to fall back
+    // to, so the error is returned.
+
+    lUseDefault = false;
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get(inContextPointer, kFlagMalformed, &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // Test Finalization
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(inContextPointer,
+                                    inOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(inTestContext.mDefaultDirectory, kFlagMalformed);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(inTestContext.mStateDirectory, kFlagMalformed);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(inTestContext.mStateDirectory, kFlagWellFormed);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
+static void TestFlagObservationWithDefaults(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const                     kFlagFirst   = "test-a";
+    static const char * const                     kFlagSecond  = "test-b";
+    static const char * const                     kFlagThird   = "test-c";
+    static const char * const                     kFlagFourth  = "test-d";
+    static const char * const                     kFlagFifth   = "test-e";
+    static const chkconfig_flag_state_tuple_t     kInputFlagStateTuples_2_0_1[] =
+    {
         { kFlagFirst,  true,  CHKCONFIG_ORIGIN_DEFAULT },
         { kFlagSecond, false, CHKCONFIG_ORIGIN_DEFAULT }
     };
@@ -1516,6 +2292,66 @@ static void TestFlagObservationWithDefaults(nlTestSuite *inSuite, void *inContex
                                              lExpectedFlagStateTupleFirst,
                                              lExpectedFlagStateTupleLast);
 
+    // 2.0.6. With three (3) default and two (2) overlapping state
+    //        backing store flags, read in batches of two (2) flags.
+
+    lOption = CHKCONFIG_OPTION_IO_QUEUE_DEPTH;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    2);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lInputFlagStateTupleFirst    = &kInputFlagStateTuples_2_0_4[0];
+    lInputFlagStateTupleLast     = lInputFlagStateTupleFirst + ElementsOf(kInputFlagStateTuples_2_0_4);
+    lExpectedFlagStateTupleFirst = &kExpectedFlagStateTuples_2_0_4[0];
+    lExpectedFlagStateTupleLast  = lExpectedFlagStateTupleFirst + ElementsOf(kExpectedFlagStateTuples_2_0_4);
+
+    TestFlagObservationWithBackingStoreFlags(inSuite,
+                                             *lTestContext,
+                                             lContextPointer,
+                                             lInputFlagStateTupleFirst,
+                                             lInputFlagStateTupleLast,
+                                             lExpectedFlagStateTupleFirst,
+                                             lExpectedFlagStateTupleLast);
+
+    // 2.0.7. With three (3) default and two (2) overlapping state
+    //        backing store flags, read with four (4) threads.
+
+    lOption = CHKCONFIG_OPTION_THREADS;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    4);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    TestFlagObservationWithBackingStoreFlags(inSuite,
+                                             *lTestContext,
+                                             lContextPointer,
+                                             lInputFlagStateTupleFirst,
+                                             lInputFlagStateTupleLast,
+                                             lExpectedFlagStateTupleFirst,
+                                             lExpectedFlagStateTupleLast);
+
+    // 2.0.8. With one hundred fifty (150) default and one hundred
+    //        fifty (150) half-overlapping state backing store flags,
+    //        read with one (1) and with four (4) threads.
+
+    TestFlagObservationWithThreads(inSuite,
+                                   *lTestContext,
+                                   lContextPointer,
+                                   lOptionsPointer);
+
+    // 2.0.9. With a malformed state backing store flag, which falls
+    //        back to the default backing store flag.
+
+    TestFlagObservationWithMalformedState(inSuite,
+                                          *lTestContext,
+                                          lContextPointer,
+                                          lOptionsPointer);
+
     // Test Finalization
 
     lStatus = chkconfig_options_destroy(lContextPointer, &lOptionsPointer);
@@ -1534,6 +2370,7 @@ static void TestNegativeFlagMutation(nlTestSuite *inSuite,
     chkconfig_state_t               lState;
     chkconfig_flag_state_tuple_t *  lFlagStateTuples;
     size_t                          lFlagStateTuplesCount;
+    chkconfig_status_t              lStatuses[1];
 
     // 1.0.0.0. Ensure that passing a null context pointer argument to
     //          chkconfig_state_set returns -EINVAL.
@@ -1585,6 +2422,41 @@ static void TestNegativeFlagMutation(nlTestSuite *inSuite,
                                            nullptr,
                                            lFlagStateTuplesCount);
     NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.0.5. Ensure that passing a null context pointer argument to
+    //          chkconfig_state_set_multiple_with_status returns
+    //          -EINVAL.
+
+    lFlagStateTuples      = new chkconfig_flag_state_tuple_t;
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples != nullptr);
+
+    lStatus = chkconfig_state_set_multiple_with_status(nullptr,
+                                                       lFlagStateTuples,
+                                                       lFlagStateTuplesCount,
+                                                       &lStatuses[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.0.6. Ensure that passing a null tuples argument to
+    //          chkconfig_state_set_multiple_with_status returns
+    //          -EINVAL.
+
+    lStatus = chkconfig_state_set_multiple_with_status(inContextPointer,
+                                                       nullptr,
+                                                       lFlagStateTuplesCount,
+                                                       &lStatuses[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 1.0.0.7. Ensure that passing a null statuses argument to
+    //          chkconfig_state_set_multiple_with_status returns
+    //          -EINVAL.
+
+    lStatus = chkconfig_state_set_multiple_with_status(inContextPointer,
+                                                       lFlagStateTuples,
+                                                       lFlagStateTuplesCount,
+                                                       nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    delete lFlagStateTuples;
 }
 
 static void TestPositiveFlagMutation(nlTestSuite *inSuite,
@@ -1595,6 +2467,7 @@ static void TestPositiveFlagMutation(nlTestSuite *inSuite,
     static const char * const                  kFlagFirst   = "test-a";
     static const char * const                  kFlagSecond  = "test-b";
     static const char * const                  kFlagThird   = "test-c";
+    static const char                          kNullFlag[1] = { '\0' };
     static const chkconfig_flag_state_tuple_t  kExpectedFlagStateTuples_2_0_0[] =
     {
         { kFlagFirst,  true,  CHKCONFIG_ORIGIN_STATE }
@@ -1605,6 +2478,18 @@ static void TestPositiveFlagMutation(nlTestSuite *inSuite,
         { kFlagSecond, false, CHKCONFIG_ORIGIN_STATE },
         { kFlagThird,  true,  CHKCONFIG_ORIGIN_STATE }
     };
+    static const chkconfig_flag_state_tuple_t  kInputFlagStateTuples_2_0_2[] =
+    {
+        { kFlagFirst,  true,  CHKCONFIG_ORIGIN_STATE },
+        { kNullFlag,   false, CHKCONFIG_ORIGIN_STATE },
+        { kFlagThird,  true,  CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t  kExpectedFlagStateTuples_2_0_2[] =
+    {
+        { kFlagFirst,  true,  CHKCONFIG_ORIGIN_STATE },
+        { kFlagThird,  true,  CHKCONFIG_ORIGIN_STATE }
+    };
+    chkconfig_status_t                         lStatuses[ElementsOf(kInputFlagStateTuples_2_0_2)];
     chkconfig_status_t                         lStatus;
 
     if (!inForceState)
@@ -1622,6 +2507,18 @@ static void TestPositiveFlagMutation(nlTestSuite *inSuite,
                                                &kExpectedFlagStateTuples_2_0_1[0],
                                                ElementsOf(kExpectedFlagStateTuples_2_0_1));
         NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+
+        // 2.0.2. Set multiple flags, one of which is invalid, with
+        //        per-flag status.
+
+        lStatus = chkconfig_state_set_multiple_with_status(inContextPointer,
+                                                           &kInputFlagStateTuples_2_0_2[0],
+                                                           ElementsOf(kInputFlagStateTuples_2_0_2),
+                                                           &lStatuses[0]);
+        NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+        NL_TEST_ASSERT(inSuite, lStatuses[0] == -ENOENT);
+        NL_TEST_ASSERT(inSuite, lStatuses[1] == -EINVAL);
+        NL_TEST_ASSERT(inSuite, lStatuses[2] == -ENOENT);
     }
     else
     {
@@ -1657,6 +2554,29 @@ static void TestPositiveFlagMutation(nlTestSuite *inSuite,
                                            &kExpectedFlagStateTuples_2_0_1[0],
                                            &kExpectedFlagStateTuples_2_0_1[0] + ElementsOf(kExpectedFlagStateTuples_2_0_1));
         NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        // 2.0.2. Set multiple flags, one of which is invalid, with
+        //        per-flag status, and ensure that the flags after the
+        //        invalid one are still set.
+
+        lStatus = chkconfig_state_set_multiple_with_status(inContextPointer,
+                                                           &kInputFlagStateTuples_2_0_2[0],
+                                                           ElementsOf(kInputFlagStateTuples_2_0_2),
+                                                           &lStatuses[0]);
+        NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+        NL_TEST_ASSERT(inSuite, lStatuses[0] == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lStatuses[1] == -EINVAL);
+        NL_TEST_ASSERT(inSuite, lStatuses[2] == CHKCONFIG_STATUS_SUCCESS);
+
+        TestFlagObservationWithBackingStoreFlags(inSuite,
+                                                 inContextPointer,
+                                                 &kExpectedFlagStateTuples_2_0_2[0],
+                                                 &kExpectedFlagStateTuples_2_0_2[0] + ElementsOf(kExpectedFlagStateTuples_2_0_2));
+
+        lStatus = DestroyBackingStoreFlags(inTestContext,
+                                           &kExpectedFlagStateTuples_2_0_2[0],
+                                           &kExpectedFlagStateTuples_2_0_2[0] + ElementsOf(kExpectedFlagStateTuples_2_0_2));
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
     }
 }
 
@@ -1705,6 +2625,29 @@ static void TestFlagMutation(nlTestSuite *inSuite,
 
     // 2.0. Positive Tests
 
+    TestPositiveFlagMutation(inSuite,
+                             lContextPointer,
+                             inTestContext,
+                             inForceState);
+
+    // 3.0. Positive Tests, with Batched and Synchronized I/O
+
+    lOption = CHKCONFIG_OPTION_IO_QUEUE_DEPTH;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    2);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lOption = CHKCONFIG_OPTION_SYNC_STATE;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    lOption,
+                                    true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
     TestPositiveFlagMutation(inSuite,
                              lContextPointer,
                              inTestContext,
@@ -1741,6 +2684,2936 @@ static void TestFlagMutationWithForce(nlTestSuite *inSuite, void *inContext)
     TestFlagMutation(inSuite, *lTestContext, lForceState);
 }
 
+static void ConcurrentObserver(chkconfig_context_pointer_t inContextPointer,
+                               const std::atomic<bool> &inDone,
+                               size_t &outFailures)
+{
+    chkconfig_flag_state_tuple_t lFlagStateTuples[2];
+    chkconfig_state_t            lState;
+    chkconfig_origin_t           lOrigin;
+    size_t                       lCount;
+    chkconfig_status_t           lStatus;
+    size_t                       lFailures = 0;
+
+    // Whatever the runtime options snapshot in effect for a call,
+    // "a" always exists in the state directory while "b" exists only
+    // in the default directory, so it is either on from the default
+    // directory or off from nowhere, depending on whether the default
+    // directory is in use for the call. "c" also exists in the state
+    // directory but, since every observer sets it, it is only
+    // counted and never observed.
+
+    while (!inDone.load())
+    {
+        lStatus = chkconfig_state_get_with_origin(inContextPointer, "a", &lState, &lOrigin);
+        lFailures += ((lStatus != CHKCONFIG_STATUS_SUCCESS) ||
+                      (lState != true) ||
+                      (lOrigin != CHKCONFIG_ORIGIN_STATE));
+
+        lStatus = chkconfig_state_get_with_origin(inContextPointer, "b", &lState, &lOrigin);
+        lFailures += ((lStatus != CHKCONFIG_STATUS_SUCCESS) ||
+                      !(((lState == true) && (lOrigin == CHKCONFIG_ORIGIN_DEFAULT)) ||
+                        ((lState == false) && (lOrigin == CHKCONFIG_ORIGIN_NONE))));
+
+        lFlagStateTuples[0].m_flag = "a";
+        lFlagStateTuples[1].m_flag = "b";
+
+        lStatus = chkconfig_state_get_multiple(inContextPointer, &lFlagStateTuples[0], ElementsOf(lFlagStateTuples));
+        lFailures += ((lStatus != CHKCONFIG_STATUS_SUCCESS) ||
+                      (lFlagStateTuples[0].m_state != true) ||
+                      (lFlagStateTuples[0].m_origin != CHKCONFIG_ORIGIN_STATE) ||
+                      !(((lFlagStateTuples[1].m_state == true) && (lFlagStateTuples[1].m_origin == CHKCONFIG_ORIGIN_DEFAULT)) ||
+                        ((lFlagStateTuples[1].m_state == false) && (lFlagStateTuples[1].m_origin == CHKCONFIG_ORIGIN_NONE))));
+
+        lStatus = chkconfig_state_get_count(inContextPointer, &lCount);
+        lFailures += ((lStatus != CHKCONFIG_STATUS_SUCCESS) ||
+                      ((lCount != 2) && (lCount != 3)));
+
+        lStatus = chkconfig_state_set(inContextPointer, "c", true);
+        lFailures += (lStatus != CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    outFailures = lFailures;
+}
+
+/*
+ * Shared Context Concurrency
+ */
+static void TestSharedContextConcurrency(nlTestSuite *inSuite, void *inContext)
+{
+    static constexpr size_t      kObservers      = 4;
+    static constexpr size_t      kIterations     = 500;
+    TestContext *                lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t           lStatus;
+    chkconfig_context_pointer_t  lContextPointer = nullptr;
+    chkconfig_options_pointer_t  lOptionsPointer = nullptr;
+    std::atomic<bool>            lDone(false);
+    std::thread                  lObservers[kObservers];
+    size_t                       lFailures[kObservers];
+
+    // Test Initialization
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "b", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "c", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lContextPointer != nullptr);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOptionsPointer != nullptr);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Observe and mutate flags from several threads sharing the
+    //      context while the main thread repeatedly changes every
+    //      runtime option that affects them, including replacing the
+    //      directory strings that earlier calls may still be using.
+
+    for (size_t i = 0; i < kObservers; i++)
+    {
+        lFailures[i]  = 0;
+        lObservers[i] = std::thread(ConcurrentObserver,
+                                    lContextPointer,
+                                    std::cref(lDone),
+                                    std::ref(lFailures[i]));
+    }
+
+    for (size_t i = 0; i < kIterations; i++)
+    {
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                        &lTestContext->mStateDirectory[0]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                        &lTestContext->mDefaultDirectory[0]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                        ((i % 2) == 0));
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_IO_QUEUE_DEPTH,
+                                        static_cast<uint32_t>((i % 3) * 2));
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lDone.store(true);
+
+    for (size_t i = 0; i < kObservers; i++)
+    {
+        lObservers[i].join();
+
+        NL_TEST_ASSERT(inSuite, lFailures[i] == 0);
+    }
+
+    // Test Finalization
+
+    lStatus = chkconfig_options_destroy(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_destroy(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "b");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
+struct AsyncCompletion
+{
+    chkconfig_status_t mStatus;
+    char               mFlag[16];
+    chkconfig_state_t  mState;
+    chkconfig_origin_t mOrigin;
+};
+
+struct AsyncCompletions
+{
+    AsyncCompletion mCompletions[4];
+    size_t          mCount;
+};
+
+static void AsyncCompletionCallback(chkconfig_status_t inStatus,
+                                    chkconfig_flag_t inFlag,
+                                    chkconfig_state_t inState,
+                                    chkconfig_origin_t inOrigin,
+                                    void *inCallbackContext)
+{
+    AsyncCompletions * lCompletions = static_cast<AsyncCompletions *>(inCallbackContext);
+
+    if (lCompletions->mCount < ElementsOf(lCompletions->mCompletions))
+    {
+        AsyncCompletion & lCompletion = lCompletions->mCompletions[lCompletions->mCount];
+
+        lCompletion.mStatus = inStatus;
+        lCompletion.mState  = inState;
+        lCompletion.mOrigin = inOrigin;
+
+        snprintf(&lCompletion.mFlag[0], sizeof (lCompletion.mFlag), "%s", inFlag);
+    }
+
+    lCompletions->mCount++;
+}
+
+/*
+ * Asynchronous Flag Observation and Mutation
+ */
+static void TestAsyncFlagObservationAndMutation(nlTestSuite *inSuite, void *inContext)
+{
+    static constexpr int         kTimeout        = 5000;
+    TestContext *                lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t           lStatus;
+    chkconfig_context_pointer_t  lContextPointer = nullptr;
+    chkconfig_options_pointer_t  lOptionsPointer = nullptr;
+    int                          lDescriptor     = -1;
+    int                          lOtherDescriptor;
+    struct pollfd                lPollDescriptor;
+    AsyncCompletions             lCompletions;
+
+    // Test Initialization
+
+    lCompletions.mCount = 0;
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lContextPointer != nullptr);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOptionsPointer != nullptr);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    // 1.0.0. Null context, flag, callback, and descriptor pointers
+
+    lStatus = chkconfig_state_get_async(nullptr, "a", AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_get_async(lContextPointer, nullptr, AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_get_async(lContextPointer, "a", nullptr, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_set_async(nullptr, "a", true, AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_set_async(lContextPointer, nullptr, true, AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_set_async(lContextPointer, "a", true, nullptr, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_poll_fd(nullptr, &lDescriptor);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_poll_fd(lContextPointer, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_dispatch(nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. Dispatch with nothing submitted
+
+    lStatus = chkconfig_dispatch(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCount == 0);
+
+    // 2.0.1. The poll descriptor is stable
+
+    lStatus = chkconfig_poll_fd(lContextPointer, &lDescriptor);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lDescriptor >= 0);
+
+    lStatus = chkconfig_poll_fd(lContextPointer, &lOtherDescriptor);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOtherDescriptor == lDescriptor);
+
+    // 2.0.2. Set, get, and get a nonexistent flag, polling the
+    //        descriptor and dispatching until all three complete, in
+    //        order.
+
+    lStatus = chkconfig_state_set_async(lContextPointer, "a", false, AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_async(lContextPointer, "a", AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_async(lContextPointer, "z", AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    while (lCompletions.mCount < 3)
+    {
+        lPollDescriptor.fd      = lDescriptor;
+        lPollDescriptor.events  = POLLIN;
+        lPollDescriptor.revents = 0;
+
+        lStatus = poll(&lPollDescriptor, 1, kTimeout);
+        NL_TEST_ASSERT(inSuite, lStatus == 1);
+
+        if (lStatus != 1)
+        {
+            break;
+        }
+
+        lStatus = chkconfig_dispatch(lContextPointer);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    NL_TEST_ASSERT(inSuite, lCompletions.mCount == 3);
+
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[0].mStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, strcmp(lCompletions.mCompletions[0].mFlag, "a") == 0);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[0].mState == false);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[0].mOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[1].mStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, strcmp(lCompletions.mCompletions[1].mFlag, "a") == 0);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[1].mState == false);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[1].mOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[2].mStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, strcmp(lCompletions.mCompletions[2].mFlag, "z") == 0);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[2].mState == false);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCompletions[2].mOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    // 2.0.3. Nothing is left to dispatch and the descriptor is no
+    //        longer readable.
+
+    lStatus = chkconfig_dispatch(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCount == 3);
+
+    lPollDescriptor.fd      = lDescriptor;
+    lPollDescriptor.events  = POLLIN;
+    lPollDescriptor.revents = 0;
+
+    lStatus = poll(&lPollDescriptor, 1, 0);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    // 2.0.4. Requests outstanding at destruction are discarded
+    //        without being dispatched.
+
+    lStatus = chkconfig_state_set_async(lContextPointer, "a", true, AsyncCompletionCallback, &lCompletions);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // Test Finalization
+
+    lStatus = chkconfig_options_destroy(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_destroy(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCompletions.mCount == 3);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
+static chkconfig_status_t StateLogOpen(const TestContext &inTestContext,
+                                       const char *inLogPath,
+                                       chkconfig_context_pointer_t &outContextPointer,
+                                       chkconfig_options_pointer_t &outOptionsPointer)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_init(&outContextPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_init(outContextPointer, &outOptionsPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(outContextPointer,
+                                    outOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &inTestContext.mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(outContextPointer,
+                                    outOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_LOG,
+                                    inLogPath);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+static chkconfig_status_t ContextClose(chkconfig_context_pointer_t &inContextPointer,
+                                       chkconfig_options_pointer_t &inOptionsPointer)
+{
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_options_destroy(inContextPointer, &inOptionsPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_destroy(&inContextPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Flag State Log
+ */
+static void TestFlagStateLog(nlTestSuite *inSuite, void *inContext)
+{
+    static constexpr size_t        kToggles        = 2048;
+    static constexpr size_t        kRecordSize     = 8 + 1;
+    static const char              kGarbage[]      = { 0x5a, 0x00, 0x13 };
+    TestContext *                  lTestContext    = static_cast<TestContext *>(inContext);
+    char                           lLogPath[PATH_MAX];
+    chkconfig_status_t             lStatus;
+    chkconfig_context_pointer_t    lContextPointer = nullptr;
+    chkconfig_options_pointer_t    lOptionsPointer = nullptr;
+    chkconfig_state_cursor_t *     lCursorPointer  = nullptr;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    chkconfig_flag_state_tuple_t   lFlagStateTuple;
+    chkconfig_state_t              lState;
+    chkconfig_origin_t             lOrigin;
+    size_t                         lCount;
+    bool                           lForce;
+    bool                           lUseDefault;
+    struct stat                    lStat;
+    int                            lDescriptor;
+    ssize_t                        lWritten;
+    size_t                         i;
+
+    // Test Initialization
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory,
+                           "flags.log",
+                           PATH_MAX,
+                           &lLogPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "c", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = StateLogOpen(*lTestContext, lLogPath, lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    // 1.0.0. Setting a flag absent from the log without force
+
+    lStatus = chkconfig_state_set(lContextPointer, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. A flag absent from the log is not an error and has no
+    //        origin.
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    // 2.0.1. Set with force, then get
+
+    lForce = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "b", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 2.0.2. Count, copy, and iterate the logged flags
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    lStatus = chkconfig_state_copy_all_sorted(lContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuples,
+                                              &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 2))
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[0].m_flag, "a") == 0);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_state == true);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_origin == CHKCONFIG_ORIGIN_STATE);
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[1].m_flag, "b") == 0);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_state == false);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_origin == CHKCONFIG_ORIGIN_STATE);
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_state_cursor_open(lContextPointer, &lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lCount = 0;
+
+    do
+    {
+        lStatus = chkconfig_state_cursor_next(lCursorPointer, &lFlagStateTuple);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr))
+        {
+            NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_origin == CHKCONFIG_ORIGIN_STATE);
+            lCount++;
+        }
+    } while ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr));
+
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    lStatus = chkconfig_state_cursor_close(&lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.3. Flags absent from the log fall back to the default
+    //        directory.
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 3);
+
+    // 2.0.4. The log persists across contexts.
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = StateLogOpen(*lTestContext, lLogPath, lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 2.0.5. A torn record at the tail of the log, as left by a
+    //        crash mid-append, is ignored when read and discarded by
+    //        the next mutation.
+
+    lDescriptor = open(lLogPath, O_WRONLY | O_APPEND);
+    NL_TEST_ASSERT(inSuite, lDescriptor != -1);
+
+    lWritten = write(lDescriptor, kGarbage, sizeof (kGarbage));
+    NL_TEST_ASSERT(inSuite, lWritten == static_cast<ssize_t>(sizeof (kGarbage)));
+
+    close(lDescriptor);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "b", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    lStatus = chkconfig_state_set(lContextPointer, "a", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = StateLogOpen(*lTestContext, lLogPath, lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 2.0.6. Superseded records are compacted away.
+
+    for (i = 0; i < kToggles; i++)
+    {
+        lStatus = chkconfig_state_set(lContextPointer, "a", ((i % 2) == 0));
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = stat(lLogPath, &lStat);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+    NL_TEST_ASSERT(inSuite, static_cast<size_t>(lStat.st_size) < ((kToggles / 2) + 8) * kRecordSize);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "b", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 2.0.7. A file that is not a flag state log is rejected.
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lDescriptor = open(lLogPath, O_WRONLY);
+    NL_TEST_ASSERT(inSuite, lDescriptor != -1);
+
+    lWritten = pwrite(lDescriptor, kGarbage, sizeof (kGarbage), 0);
+    NL_TEST_ASSERT(inSuite, lWritten == static_cast<ssize_t>(sizeof (kGarbage)));
+
+    close(lDescriptor);
+
+    lStatus = StateLogOpen(*lTestContext, lLogPath, lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == -EILSEQ);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = unlink(lLogPath);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
+static chkconfig_status_t MemoryStateOpen(const TestContext &inTestContext,
+                                          chkconfig_context_pointer_t &outContextPointer,
+                                          chkconfig_options_pointer_t &outOptionsPointer)
+{
+    const bool         lMemoryState = true;
+    chkconfig_status_t lRetval;
+
+    lRetval = chkconfig_init(&outContextPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_init(outContextPointer, &outOptionsPointer);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(outContextPointer,
+                                    outOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &inTestContext.mStateDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(outContextPointer,
+                                    outOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &inTestContext.mDefaultDirectory[0]);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+    lRetval = chkconfig_options_set(outContextPointer,
+                                    outOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    lMemoryState);
+    nlREQUIRE_SUCCESS(lRetval, done);
+
+ done:
+    return (lRetval);
+}
+
+/*
+ * Memory State
+ */
+static void TestMemoryState(nlTestSuite *inSuite, void *inContext)
+{
+    static constexpr size_t        kCount          = 1024;
+    TestContext *                  lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t             lStatus;
+    chkconfig_context_pointer_t    lContextPointer = nullptr;
+    chkconfig_options_pointer_t    lOptionsPointer = nullptr;
+    chkconfig_state_cursor_t *     lCursorPointer  = nullptr;
+    chkconfig_flag_state_tuple_t * lFlagStateTuples;
+    chkconfig_flag_state_tuple_t   lFlagStateTuple;
+    chkconfig_status_t *           lStatuses;
+    char *                         lFlags;
+    char                           lFlagPath[PATH_MAX];
+    chkconfig_state_t              lState;
+    chkconfig_origin_t             lOrigin;
+    size_t                         lCount;
+    bool                           lForce;
+    bool                           lUseDefault;
+    bool                           lMemoryState;
+    size_t                         i;
+
+    // Test Initialization
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "c", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = MemoryStateOpen(*lTestContext, lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    // 1.0.0. Setting a flag absent from memory without force
+
+    lStatus = chkconfig_state_set(lContextPointer, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+
+    // 1.0.1. Getting and setting an empty flag
+
+    lStatus = chkconfig_state_get(lContextPointer, "", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_set(lContextPointer, "", true);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. A flag absent from memory is not an error and has no
+    //        origin.
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    // 2.0.1. Set with force, then get
+
+    lForce = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "b", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 2.0.2. Nothing is written to the state directory.
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory,
+                           "a",
+                           PATH_MAX,
+                           &lFlagPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = access(lFlagPath, F_OK);
+    NL_TEST_ASSERT(inSuite, (lStatus == -1) && (errno == ENOENT));
+
+    // 2.0.3. Count, copy, and iterate the flags
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    lStatus = chkconfig_state_copy_all_sorted(lContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuples,
+                                              &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 2))
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[0].m_flag, "a") == 0);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_state == true);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_origin == CHKCONFIG_ORIGIN_STATE);
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[1].m_flag, "b") == 0);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_state == false);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_origin == CHKCONFIG_ORIGIN_STATE);
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_state_cursor_open(lContextPointer, &lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lCount = 0;
+
+    do
+    {
+        lStatus = chkconfig_state_cursor_next(lCursorPointer, &lFlagStateTuple);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr))
+        {
+            NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_origin == CHKCONFIG_ORIGIN_STATE);
+            lCount++;
+        }
+    } while ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr));
+
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    lStatus = chkconfig_state_cursor_close(&lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.4. Flags absent from memory fall back to the default
+    //        directory.
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 3);
+
+    lUseDefault = false;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0.5. Many flags at once, each with its own status
+
+    lFlags           = static_cast<char *>(malloc(kCount * NAME_MAX));
+    lFlagStateTuples = static_cast<chkconfig_flag_state_tuple_t *>(malloc(kCount * sizeof (chkconfig_flag_state_tuple_t)));
+    lStatuses        = static_cast<chkconfig_status_t *>(malloc(kCount * sizeof (chkconfig_status_t)));
+    NL_TEST_ASSERT(inSuite, lFlags != nullptr);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples != nullptr);
+    NL_TEST_ASSERT(inSuite, lStatuses != nullptr);
+
+    if ((lFlags != nullptr) && (lFlagStateTuples != nullptr) && (lStatuses != nullptr))
+    {
+        for (i = 0; i < kCount; i++)
+        {
+            snprintf(&lFlags[i * NAME_MAX], NAME_MAX, "m%04zu", i);
+
+            lFlagStateTuples[i].m_flag   = &lFlags[i * NAME_MAX];
+            lFlagStateTuples[i].m_state  = ((i % 3) == 0);
+            lFlagStateTuples[i].m_origin = CHKCONFIG_ORIGIN_STATE;
+        }
+
+        lStatus = chkconfig_state_set_multiple_with_status(lContextPointer,
+                                                           lFlagStateTuples,
+                                                           kCount,
+                                                           lStatuses);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        for (i = 0; i < kCount; i++)
+        {
+            NL_TEST_ASSERT(inSuite, lStatuses[i] == CHKCONFIG_STATUS_SUCCESS);
+
+            lFlagStateTuples[i].m_state  = ((i % 3) != 0);
+            lFlagStateTuples[i].m_origin = CHKCONFIG_ORIGIN_NONE;
+        }
+
+        lStatus = chkconfig_state_get_multiple(lContextPointer,
+                                               lFlagStateTuples,
+                                               kCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        for (i = 0; i < kCount; i++)
+        {
+            NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == ((i % 3) == 0));
+            NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_origin == CHKCONFIG_ORIGIN_STATE);
+        }
+
+        lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lCount == kCount + 2);
+    }
+
+    free(lFlags);
+    free(lFlagStateTuples);
+    free(lStatuses);
+
+    // 2.0.6. The flags are retained across changes to runtime
+    //        options, but not shared with the state directory.
+
+    lMemoryState = false;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    lMemoryState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    lMemoryState = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    lMemoryState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 2.0.7. The flags are private to the context.
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = MemoryStateOpen(*lTestContext, lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
+/*
+ * Layers
+ */
+static void TestLayers(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kProgram        = "test-libchkconfig";
+    static const char * const        kNoLayers       = nullptr;
+    static const char * const        kFlags[]        = { "a", "b", "c", "d", "e", "z" };
+    static const bool                kStates[]       = { false, false, true, true, false, false };
+    static const chkconfig_origin_t  kOrigins[]      =
+    {
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_DEFAULT,
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_DEFAULT,
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_NONE
+    };
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_state_cursor_t *       lCursorPointer  = nullptr;
+    chkconfig_flag_state_tuple_t     lFlagStateTuples[ElementsOf(kFlags)];
+    chkconfig_flag_state_tuple_t *   lFlagStateTuplesPointer;
+    chkconfig_flag_state_tuple_t     lFlagStateTuple;
+    chkconfig_status_t               lStatuses[3];
+    char                             lProductDirectory[PATH_MAX];
+    char                             lSiteDirectory[PATH_MAX];
+    char                             lFlagPath[PATH_MAX];
+    chkconfig_state_t                lState;
+    chkconfig_origin_t               lOrigin;
+    size_t                           lCount;
+    bool                             lUseDefault;
+    size_t                           i;
+
+    // Test Initialization
+    //
+    // The overlay, from the highest precedence down, is:
+    //
+    //   state:             a=off
+    //   site (writable):   c=on, e=off
+    //   product:           b=off, c=off
+    //   default:           a=on, b=on, c=on, d=on
+
+    lStatus = TestSuiteCreateDirectory(kProgram, "product", PATH_MAX, &lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = TestSuiteCreateDirectory(kProgram, "site", PATH_MAX, &lSiteDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    for (i = 0; i < 4; i++)
+    {
+        lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, kFlags[i], true);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = CreateBackingStoreFlag(lProductDirectory, "b", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lProductDirectory, "c", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lSiteDirectory, "c", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lSiteDirectory, "e", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "a", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_LAYER_DIRECTORY,
+                                    &lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_WRITABLE_LAYER_DIRECTORY,
+                                    &lSiteDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Positive tests
+
+    // 1.0.0. Each flag resolves from the first layer in which it
+    //        exists, one at a time and all at once.
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = chkconfig_state_get_with_origin(lContextPointer, kFlags[i], &lState, &lOrigin);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lState == kStates[i]);
+        NL_TEST_ASSERT(inSuite, lOrigin == kOrigins[i]);
+
+        lFlagStateTuples[i].m_flag = kFlags[i];
+    }
+
+    lStatus = chkconfig_state_get_multiple(lContextPointer,
+                                           lFlagStateTuples,
+                                           ElementsOf(lFlagStateTuples));
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == kStates[i]);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_origin == kOrigins[i]);
+    }
+
+    // 1.0.1. Count, copy, and iterate the union of every layer
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 5);
+
+    lStatus = chkconfig_state_copy_all_sorted(lContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuplesPointer,
+                                              &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 5);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 5))
+    {
+        for (i = 0; i < lCount; i++)
+        {
+            NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuplesPointer[i].m_flag, kFlags[i]) == 0);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuplesPointer[i].m_state == kStates[i]);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuplesPointer[i].m_origin == kOrigins[i]);
+        }
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuplesPointer, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_state_cursor_open(lContextPointer, &lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lCount = 0;
+
+    do
+    {
+        lStatus = chkconfig_state_cursor_next(lCursorPointer, &lFlagStateTuple);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr))
+        {
+            i = static_cast<size_t>(lFlagStateTuple.m_flag[0] - 'a');
+
+            NL_TEST_ASSERT(inSuite, i < 5);
+
+            if (i < 5)
+            {
+                NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_state == kStates[i]);
+                NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_origin == kOrigins[i]);
+            }
+
+            lCount++;
+        }
+    } while ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr));
+
+    NL_TEST_ASSERT(inSuite, lCount == 5);
+
+    lStatus = chkconfig_state_cursor_close(&lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0.2. A flag in a writable layer is set there, not in the
+    //        state directory.
+
+    lStatus = chkconfig_state_set(lContextPointer, "e", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "e", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory,
+                           "e",
+                           PATH_MAX,
+                           &lFlagPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = access(lFlagPath, F_OK);
+    NL_TEST_ASSERT(inSuite, (lStatus == -1) && (errno == ENOENT));
+
+    // 2.0. Negative tests
+
+    // 2.0.0. A flag only in a read-only layer is set in the state
+    //        directory, which, without force, it is not.
+
+    lFlagStateTuples[0].m_flag  = "a";
+    lFlagStateTuples[0].m_state = true;
+    lFlagStateTuples[1].m_flag  = "e";
+    lFlagStateTuples[1].m_state = false;
+    lFlagStateTuples[2].m_flag  = "b";
+    lFlagStateTuples[2].m_state = true;
+
+    lStatus = chkconfig_state_set_multiple_with_status(lContextPointer,
+                                                       lFlagStateTuples,
+                                                       ElementsOf(lStatuses),
+                                                       lStatuses);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+    NL_TEST_ASSERT(inSuite, lStatuses[0] == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lStatuses[1] == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lStatuses[2] == -ENOENT);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "b", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    // 2.0.1. Pushing more than the maximum number of layers
+
+    for (i = 0; i < 16; i++)
+    {
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_LAYER_DIRECTORY,
+                                        &lProductDirectory[0]);
+
+        if (lStatus != CHKCONFIG_STATUS_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOSPC);
+
+    // 3.0. Removing every layer restores the state and default
+    //      directories alone.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_LAYER_DIRECTORY,
+                                    kNoLayers);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 4);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < 4; i++)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, kFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = DestroyBackingStoreFlag(lProductDirectory, "b");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lProductDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lSiteDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lSiteDirectory, "e");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = TestSuiteDestroyDirectory(&lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = TestSuiteDestroyDirectory(&lSiteDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+}
+
+/*
+ * Existence Filters
+ */
+static void TestExistenceFilters(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kProgram        = "test-libchkconfig";
+    static const char * const        kFlags[]        = { "a", "b", "c", "z" };
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_flag_state_tuple_t     lFlagStateTuples[ElementsOf(kFlags)];
+    char                             lProductDirectory[PATH_MAX];
+    char                             lSiteDirectory[PATH_MAX];
+    char                             lFromPath[PATH_MAX];
+    char                             lToPath[PATH_MAX];
+    char                             lLongFlag[NAME_MAX + 2];
+    chkconfig_state_t                lState;
+    chkconfig_origin_t               lOrigin;
+    bool                             lOption;
+    size_t                           i;
+
+    // Test Initialization
+    //
+    // The overlay, from the highest precedence down, is:
+    //
+    //   state:             (none)
+    //   product:           b=off
+    //   default:           b=on, c=on
+
+    lStatus = TestSuiteCreateDirectory(kProgram, "product", PATH_MAX, &lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = TestSuiteCreateDirectory(kProgram, "site", PATH_MAX, &lSiteDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = CreateBackingStoreFlag(lProductDirectory, "b", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "b", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "c", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lOption = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lOption);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lOption);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_EXISTENCE_FILTERS,
+                                    lOption);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_LAYER_DIRECTORY,
+                                    &lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Positive tests
+
+    // 1.0.0. Flags resolve as without filters.
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "b", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    // 1.0.1. Flags created and removed behind the library, once the
+    //        filters are built, are observed.
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lProductDirectory, "c", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    // 1.0.2. Flags renamed into, within, and out of a directory are
+    //        observed.
+
+    lStatus = CreateBackingStoreFlag(lSiteDirectory, "z", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = FlagPathCopy(lSiteDirectory, "z", PATH_MAX, &lFromPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory, "z", PATH_MAX, &lToPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = rename(lFromPath, lToPath);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "z", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory, "a", PATH_MAX, &lFromPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = rename(lToPath, lFromPath);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "z", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    lStatus = FlagPathCopy(lSiteDirectory, "a", PATH_MAX, &lToPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = rename(lFromPath, lToPath);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    // 1.0.3. A flag set by the library is observed, all at once with
+    //        those absent and present elsewhere.
+
+    lStatus = chkconfig_state_set(lContextPointer, "b", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lFlagStateTuples[i].m_flag = kFlags[i];
+    }
+
+    lStatus = chkconfig_state_get_multiple(lContextPointer,
+                                           lFlagStateTuples,
+                                           ElementsOf(lFlagStateTuples));
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_origin == CHKCONFIG_ORIGIN_NONE);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_state  == true);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples[1].m_origin == CHKCONFIG_ORIGIN_STATE);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples[2].m_state  == false);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples[2].m_origin == CHKCONFIG_ORIGIN_DEFAULT);
+    NL_TEST_ASSERT(inSuite, lFlagStateTuples[3].m_origin == CHKCONFIG_ORIGIN_NONE);
+
+    // 1.0.4. A layer directory removed and recreated behind the
+    //        library is observed.
+
+    lStatus = DestroyBackingStoreFlag(lProductDirectory, "b");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lProductDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = TestSuiteDestroyDirectory(&lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lStatus = mkdir(lProductDirectory, S_IRWXU);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = CreateBackingStoreFlag(lProductDirectory, "c", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "c", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    // 2.0. Negative tests
+
+    // 2.0.0. A flag too long to name a backing file fails just as it
+    //        would without filters.
+
+    memset(&lLongFlag[0], 'x', NAME_MAX + 1);
+    lLongFlag[NAME_MAX + 1] = '\0';
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, lLongFlag, &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENAMETOOLONG);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "b");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "b");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lProductDirectory, "c");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lSiteDirectory, "a");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = TestSuiteDestroyDirectory(&lProductDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+
+    lStatus = TestSuiteDestroyDirectory(&lSiteDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == 0);
+}
+
+static void TestShardedLayout(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kFlags[]        = { "a", "b", "c", "d", "e", "f" };
+    static const bool                kStates[]       = { true, false, true, true, false, true };
+    static const chkconfig_origin_t  kOrigins[]      =
+    {
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_DEFAULT,
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_STATE
+    };
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_state_cursor_t *       lCursorPointer  = nullptr;
+    chkconfig_flag_state_tuple_t     lFlagStateTuples[2];
+    chkconfig_flag_state_tuple_t *   lFlagStateTuplesPointer;
+    chkconfig_flag_state_tuple_t     lFlagStateTuple;
+    char                             lFlagPath[PATH_MAX];
+    chkconfig_state_t                lState;
+    chkconfig_origin_t               lOrigin;
+    size_t                           lCount;
+    size_t                           i;
+
+    // Test Initialization
+    //
+    // Both directories start out with a flat layout:
+    //
+    //   state:             a=on, b=off
+    //   default:           c=on
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "a", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, "b", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "c", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_SHARDED_LAYOUT,
+                                    true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Positive tests
+
+    // 1.0.0. Migrate the default directory, by way of using it as
+    //        the state directory, and then the state directory to
+    //        the sharded layout.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_migrate_layout(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_migrate_layout(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // Migrating again leaves the layout as it is.
+
+    lStatus = chkconfig_state_migrate_layout(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory,
+                           "a",
+                           PATH_MAX,
+                           &lFlagPath[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = access(lFlagPath, F_OK);
+    NL_TEST_ASSERT(inSuite, (lStatus == -1) && (errno == ENOENT));
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "a", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_STATE);
+
+    // 1.0.1. Forcibly set flags, both one at a time and batched, in
+    //        shards that do not yet exist.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "d", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_IO_QUEUE_DEPTH,
+                                    4);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lFlagStateTuples[0].m_flag  = "e";
+    lFlagStateTuples[0].m_state = false;
+    lFlagStateTuples[1].m_flag  = "f";
+    lFlagStateTuples[1].m_state = true;
+
+    lStatus = chkconfig_state_set_multiple(lContextPointer,
+                                           lFlagStateTuples,
+                                           ElementsOf(lFlagStateTuples));
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0.2. Get, count, copy, and iterate the flags, including
+    //        those from the default directory.
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 5);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = chkconfig_state_get_with_origin(lContextPointer, kFlags[i], &lState, &lOrigin);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lState == kStates[i]);
+        NL_TEST_ASSERT(inSuite, lOrigin == kOrigins[i]);
+    }
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "z", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    lStatus = chkconfig_state_get_count(lContextPointer, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == ElementsOf(kFlags));
+
+    lStatus = chkconfig_state_copy_all_sorted(lContextPointer,
+                                              CHKCONFIG_SORT_ORDER_FLAG,
+                                              &lFlagStateTuplesPointer,
+                                              &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == ElementsOf(kFlags));
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == ElementsOf(kFlags)))
+    {
+        for (i = 0; i < lCount; i++)
+        {
+            NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuplesPointer[i].m_flag, kFlags[i]) == 0);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuplesPointer[i].m_state == kStates[i]);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuplesPointer[i].m_origin == kOrigins[i]);
+        }
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuplesPointer, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_state_cursor_open(lContextPointer, &lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lCount = 0;
+
+    do
+    {
+        lStatus = chkconfig_state_cursor_next(lCursorPointer, &lFlagStateTuple);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr))
+        {
+            i = static_cast<size_t>(lFlagStateTuple.m_flag[0] - 'a');
+
+            NL_TEST_ASSERT(inSuite, i < ElementsOf(kFlags));
+
+            if (i < ElementsOf(kFlags))
+            {
+                NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_state == kStates[i]);
+                NL_TEST_ASSERT(inSuite, lFlagStateTuple.m_origin == kOrigins[i]);
+            }
+
+            lCount++;
+        }
+    } while ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lFlagStateTuple.m_flag != nullptr));
+
+    NL_TEST_ASSERT(inSuite, lCount == ElementsOf(kFlags));
+
+    lStatus = chkconfig_state_cursor_close(&lCursorPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0.3. Migrate both directories back to the flat layout,
+    //        removing every shard.
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_SHARDED_LAYOUT,
+                                    false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_migrate_layout(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_migrate_layout(lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 2.0. Negative tests
+
+    // 2.0.0. Ensure that migrating a null context returns -EINVAL.
+
+    lStatus = chkconfig_state_migrate_layout(nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = DestroyBackingStoreFlag((kOrigins[i] == CHKCONFIG_ORIGIN_DEFAULT) ?
+                                          lTestContext->mDefaultDirectory :
+                                          lTestContext->mStateDirectory,
+                                          kFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+}
+
+/*
+ * Prefix Queries
+ */
+static void TestPrefixQueries(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kFlags[]        = { "net.eth.up", "net.wifi.enabled", "netflix", "disk.cache" };
+    static const bool                kStates[]       = { false, true, true, false };
+    static const chkconfig_origin_t  kOrigins[]      =
+    {
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_DEFAULT,
+        CHKCONFIG_ORIGIN_STATE,
+        CHKCONFIG_ORIGIN_STATE
+    };
+    static const size_t              kByState[]      = { 1, 2, 0 };
+    static constexpr int             kBadOrder       = 42;
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_flag_state_tuple_t *   lFlagStateTuples;
+    size_t                           lCount;
+    bool                             lUseDefault;
+    uint32_t                         lThreads;
+    bool                             lForce;
+    bool                             lMemoryState;
+    size_t                           i;
+
+    // Test Initialization
+    //
+    // The default directory has every "net" flag on and the state
+    // directory overrides some of them, such that a query must form
+    // the union of both.
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "net.eth.up", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "net.wifi.enabled", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        if (kOrigins[i] == CHKCONFIG_ORIGIN_STATE)
+        {
+            lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i], kStates[i]);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    lStatus = chkconfig_state_copy_prefix(nullptr, "net.", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, nullptr, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "net.", CHKCONFIG_SORT_ORDER_FLAG, nullptr, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "net.", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "net.", static_cast<chkconfig_sort_order_t>(kBadOrder), &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. The state directory alone
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "net.", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 1);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 1))
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[0].m_flag, kFlags[0]) == 0);
+        NL_TEST_ASSERT(inSuite, lFlagStateTuples[0].m_state == kStates[0]);
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // 2.0.1. The union of the state and default directories, sorted
+    //        by flag, then by state, with one and with several
+    //        threads.
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (lThreads = 1; lThreads <= 4; lThreads += 3)
+    {
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_THREADS,
+                                        lThreads);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lStatus = chkconfig_state_copy_prefix(lContextPointer, "net.", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lCount == 2);
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 2))
+        {
+            for (i = 0; i < lCount; i++)
+            {
+                NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[i].m_flag, kFlags[i]) == 0);
+                NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == kStates[i]);
+                NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_origin == kOrigins[i]);
+            }
+
+            lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+
+        lStatus = chkconfig_state_copy_prefix(lContextPointer, "net", CHKCONFIG_SORT_ORDER_STATE, &lFlagStateTuples, &lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lCount == ElementsOf(kByState));
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == ElementsOf(kByState)))
+        {
+            for (i = 0; i < lCount; i++)
+            {
+                NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[i].m_flag, kFlags[kByState[i]]) == 0);
+                NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == kStates[kByState[i]]);
+            }
+
+            lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+
+    // 2.0.2. An empty prefix matches every flag, while a prefix no
+    //        flag begins with matches none.
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == ElementsOf(kFlags));
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == ElementsOf(kFlags)))
+    {
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "usb.", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 0);
+
+    // 2.0.3. An in-memory state store in place of the state
+    //        directory
+
+    lMemoryState = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    lMemoryState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lForce = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "disk.cache", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "net.eth.up", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_copy_prefix(lContextPointer, "net.", CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 2))
+    {
+        for (i = 0; i < lCount; i++)
+        {
+            NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[i].m_flag, kFlags[i]) == 0);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == kStates[i]);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_origin == kOrigins[i]);
+        }
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "net.eth.up");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "net.wifi.enabled");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        if (kOrigins[i] == CHKCONFIG_ORIGIN_STATE)
+        {
+            lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i]);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+}
+
+/*
+ * Filtered Queries
+ */
+struct FilterContext
+{
+    const char * mSubstring;
+    size_t       mCalls;
+    bool         mNonFlag;
+};
+
+static bool FilterBySubstring(chkconfig_flag_t inFlag, void *inContext)
+{
+    FilterContext * lFilterContext = static_cast<FilterContext *>(inContext);
+
+    lFilterContext->mCalls++;
+
+    if ((strcmp(inFlag, ".") == 0) || (strcmp(inFlag, "..") == 0) || (strcmp(inFlag, "sub") == 0))
+    {
+        lFilterContext->mNonFlag = true;
+    }
+
+    return (strstr(inFlag, lFilterContext->mSubstring) != nullptr);
+}
+
+static void TestFilteredQueries(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kFlags[]        = { "disk.cache", "net.eth.up", "net.wifi.enabled" };
+    static const bool                kStates[]       = { true, false, true };
+    static constexpr int             kBadOrder       = 42;
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_flag_state_tuple_t *   lFlagStateTuples;
+    FilterContext                    lFilterContext;
+    char                             lSubdirectory[PATH_MAX];
+    size_t                           lCount;
+    int                              lResult;
+    size_t                           i;
+
+    // Test Initialization
+    //
+    // Along with the flags, the state directory has a subdirectory,
+    // which the filter must never be offered.
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i], kStates[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = FlagPathCopy(lTestContext->mStateDirectory,
+                           "sub",
+                           PATH_MAX,
+                           &lSubdirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lResult = mkdir(lSubdirectory, S_IRWXU);
+    NL_TEST_ASSERT(inSuite, lResult == 0);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lFilterContext.mSubstring = ".e";
+    lFilterContext.mCalls     = 0;
+    lFilterContext.mNonFlag   = false;
+
+    // 1.0. Negative tests
+
+    lStatus = chkconfig_state_copy_filtered(nullptr, FilterBySubstring, &lFilterContext, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, nullptr, &lFilterContext, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, FilterBySubstring, &lFilterContext, CHKCONFIG_SORT_ORDER_FLAG, nullptr, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, FilterBySubstring, &lFilterContext, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, FilterBySubstring, &lFilterContext, static_cast<chkconfig_sort_order_t>(kBadOrder), &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    NL_TEST_ASSERT(inSuite, lFilterContext.mCalls == 0);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. The filter is offered each flag, and only flags, once
+    //        and only the flags it accepts are copied, sorted by
+    //        flag.
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, FilterBySubstring, &lFilterContext, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+    NL_TEST_ASSERT(inSuite, lFilterContext.mCalls == ElementsOf(kFlags));
+    NL_TEST_ASSERT(inSuite, !lFilterContext.mNonFlag);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 2))
+    {
+        for (i = 0; i < lCount; i++)
+        {
+            NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[i].m_flag, kFlags[i + 1]) == 0);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == kStates[i + 1]);
+            NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_origin == CHKCONFIG_ORIGIN_STATE);
+        }
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // 2.0.1. Sorted by state
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, FilterBySubstring, &lFilterContext, CHKCONFIG_SORT_ORDER_STATE, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 2);
+
+    if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == 2))
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[0].m_flag, kFlags[2]) == 0);
+        NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[1].m_flag, kFlags[1]) == 0);
+
+        lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    // 2.0.2. A filter that accepts nothing
+
+    lFilterContext.mSubstring = "usb";
+
+    lStatus = chkconfig_state_copy_filtered(lContextPointer, FilterBySubstring, &lFilterContext, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lCount == 0);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lResult = rmdir(lSubdirectory);
+    NL_TEST_ASSERT(inSuite, lResult == 0);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+}
+
+/*
+ * State Queries
+ */
+static void TestStateQueries(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kFlags[]        = { "a.one", "b.two", "c.three", "d.four" };
+    static const bool                kStates[]       = { true, false, true, false };
+    static const chkconfig_origin_t  kOrigins[]      = { CHKCONFIG_ORIGIN_DEFAULT, CHKCONFIG_ORIGIN_STATE, CHKCONFIG_ORIGIN_STATE, CHKCONFIG_ORIGIN_STATE };
+    static constexpr size_t          kMemoryFlags    = 70;
+    static constexpr int             kBadOrder       = 42;
+    static const chkconfig_sort_order_t kOrders[]    = { CHKCONFIG_SORT_ORDER_FLAG, CHKCONFIG_SORT_ORDER_STATE };
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_flag_state_tuple_t *   lFlagStateTuples;
+    bool                             lUseDefault;
+    bool                             lMemoryState;
+    bool                             lForce;
+    bool                             lState;
+    char                             lFlag[16];
+    size_t                           lCount;
+    size_t                           lExpected;
+    size_t                           i;
+    size_t                           j;
+    size_t                           k;
+
+    // Test Initialization
+    //
+    // The "b.two" flag is on in the default directory but is shadowed
+    // by the state directory, where it is off, so it must only ever
+    // be selected as off.
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "a.one", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "b.two", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        if (kOrigins[i] == CHKCONFIG_ORIGIN_STATE)
+        {
+            lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i], kStates[i]);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    lStatus = chkconfig_state_copy_where(nullptr, true, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_where(lContextPointer, true, CHKCONFIG_SORT_ORDER_FLAG, nullptr, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_where(lContextPointer, true, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_copy_where(lContextPointer, true, static_cast<chkconfig_sort_order_t>(kBadOrder), &lFlagStateTuples, &lCount);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. The union of the state and default directories, selected
+    //        by each state in turn and in each order which, since
+    //        every selected flag has the same state, is by flag.
+
+    for (k = 0; k < ElementsOf(kOrders); k++)
+    {
+        for (j = 0; j < 2; j++)
+        {
+            lState    = (j == 0);
+            lExpected = 2;
+
+            lStatus = chkconfig_state_copy_where(lContextPointer, lState, kOrders[k], &lFlagStateTuples, &lCount);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+            NL_TEST_ASSERT(inSuite, lCount == lExpected);
+
+            if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == lExpected))
+            {
+                for (i = 0; i < lCount; i++)
+                {
+                    const size_t lIndex = (i * 2) + j;
+
+                    NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[i].m_flag, kFlags[lIndex]) == 0);
+                    NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == lState);
+                    NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_origin == kOrigins[lIndex]);
+                }
+
+                lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+                NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+            }
+        }
+    }
+
+    // 2.0.1. An in-memory state store in place of the state
+    //        directory, with enough flags to span more than one word
+    //        of the state bitmap.
+
+    lMemoryState = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    lMemoryState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lForce = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < kMemoryFlags; i++)
+    {
+        snprintf(lFlag, sizeof (lFlag), "m.%03zu", i);
+
+        lStatus = chkconfig_state_set(lContextPointer, lFlag, ((i % 3) == 0));
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    for (j = 0; j < 2; j++)
+    {
+        lState    = (j == 0);
+        lExpected = (lState ? (2 + ((kMemoryFlags + 2) / 3)) : (kMemoryFlags - ((kMemoryFlags + 2) / 3)));
+
+        lStatus = chkconfig_state_copy_where(lContextPointer, lState, CHKCONFIG_SORT_ORDER_FLAG, &lFlagStateTuples, &lCount);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lCount == lExpected);
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lCount == lExpected))
+        {
+            for (i = 0; i < lCount; i++)
+            {
+                NL_TEST_ASSERT(inSuite, lFlagStateTuples[i].m_state == lState);
+
+                if (i > 0)
+                {
+                    NL_TEST_ASSERT(inSuite, strcmp(lFlagStateTuples[i - 1].m_flag, lFlagStateTuples[i].m_flag) < 0);
+                }
+            }
+
+            lStatus = chkconfig_flag_state_tuples_destroy(lFlagStateTuples, lCount);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "a.one");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "b.two");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        if (kOrigins[i] == CHKCONFIG_ORIGIN_STATE)
+        {
+            lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i]);
+            NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        }
+    }
+}
+
+/*
+ * State Counts
+ */
+static void TestStateCounts(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kFlags[]        = { "b.two", "c.three", "d.four" };
+    static const bool                kStates[]       = { false, true, false };
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_origin_counts_t        lByOrigin;
+    bool                             lUseDefault;
+    bool                             lMemoryState;
+    bool                             lForce;
+    size_t                           lOn;
+    size_t                           lOff;
+    size_t                           i;
+
+    // Test Initialization
+    //
+    // The "b.two" flag is on in the default directory but is shadowed
+    // by the state directory, where it is off, so it must only ever
+    // be counted once, as off and from the state directory.
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "a.one", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "b.two", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i], kStates[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+
+    lStatus = chkconfig_state_get_counts(nullptr, &lOn, &lOff, &lByOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_get_counts(lContextPointer, nullptr, &lOff, &lByOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_get_counts(lContextPointer, &lOn, nullptr, &lByOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. The state directory alone, with and without the counts
+    //        by origin.
+
+    lStatus = chkconfig_state_get_counts(lContextPointer, &lOn, &lOff, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOn == 1);
+    NL_TEST_ASSERT(inSuite, lOff == 2);
+
+    lStatus = chkconfig_state_get_counts(lContextPointer, &lOn, &lOff, &lByOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOn == 1);
+    NL_TEST_ASSERT(inSuite, lOff == 2);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_default.m_on == 0);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_default.m_off == 0);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_state.m_on == 1);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_state.m_off == 2);
+
+    // 2.0.1. The union of the state and default directories
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_counts(lContextPointer, &lOn, &lOff, &lByOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOn == 2);
+    NL_TEST_ASSERT(inSuite, lOff == 2);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_default.m_on == 1);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_default.m_off == 0);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_state.m_on == 1);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_state.m_off == 2);
+
+    // 2.0.2. An in-memory state store in place of the state
+    //        directory, which shadows "a.one" in the default
+    //        directory.
+
+    lMemoryState = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_MEMORY_STATE,
+                                    lMemoryState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lForce = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "a.one", false);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_set(lContextPointer, "e.five", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_get_counts(lContextPointer, &lOn, &lOff, &lByOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOn == 2);
+    NL_TEST_ASSERT(inSuite, lOff == 1);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_default.m_on == 1);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_default.m_off == 0);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_state.m_on == 1);
+    NL_TEST_ASSERT(inSuite, lByOrigin.m_state.m_off == 1);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "a.one");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "b.two");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+}
+
+/*
+ * State Diff
+ */
+struct DiffEntry
+{
+    char               mFlag[NAME_MAX];
+    chkconfig_diff_t   mDiff;
+    chkconfig_state_t  mState;
+    chkconfig_state_t  mDefaultState;
+};
+
+struct DiffContext
+{
+    DiffEntry          mEntries[8];
+    size_t             mCount;
+};
+
+static void DiffCollect(chkconfig_flag_t inFlag,
+                        chkconfig_diff_t inDiff,
+                        chkconfig_state_t inState,
+                        chkconfig_state_t inDefaultState,
+                        void *inContext)
+{
+    DiffContext * lDiffContext = static_cast<DiffContext *>(inContext);
+
+    if (lDiffContext->mCount < ElementsOf(lDiffContext->mEntries))
+    {
+        DiffEntry & lEntry = lDiffContext->mEntries[lDiffContext->mCount];
+
+        snprintf(lEntry.mFlag, sizeof (lEntry.mFlag), "%s", inFlag);
+
+        lEntry.mDiff         = inDiff;
+        lEntry.mState        = inState;
+        lEntry.mDefaultState = inDefaultState;
+    }
+
+    lDiffContext->mCount++;
+}
+
+static void TestStateDiff(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kDefaultFlags[]  = { "a.one", "b.two", "e.five" };
+    static const bool                kDefaultStates[] = { true, true, true };
+    static const char * const        kStateFlags[]    = { "b.two", "c.three", "e.five" };
+    static const bool                kStateStates[]   = { false, true, true };
+    static const DiffEntry           kExpected[]      = {
+        { "a.one",   CHKCONFIG_DIFF_DEFAULT_ONLY, false, true  },
+        { "b.two",   CHKCONFIG_DIFF_DIFFERS,      false, true  },
+        { "c.three", CHKCONFIG_DIFF_STATE_ONLY,   true,  false },
+        { "e.five",  CHKCONFIG_DIFF_SHADOWS,      true,  true  }
+    };
+    TestContext *                    lTestContext     = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer  = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer  = nullptr;
+    DiffContext                      lDiffContext;
+    uint32_t                         lThreads;
+    size_t                           i;
+
+    // Test Initialization
+
+    for (i = 0; i < ElementsOf(kDefaultFlags); i++)
+    {
+        lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, kDefaultFlags[i], kDefaultStates[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    for (i = 0; i < ElementsOf(kStateFlags); i++)
+    {
+        lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, kStateFlags[i], kStateStates[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lDiffContext.mCount = 0;
+
+    // 1.0. Negative tests
+
+    lStatus = chkconfig_state_diff(nullptr, DiffCollect, &lDiffContext);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_diff(lContextPointer, nullptr, &lDiffContext);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    NL_TEST_ASSERT(inSuite, lDiffContext.mCount == 0);
+
+    // 2.0. Positive tests
+
+    // 2.0.0. Every flag in either directory is reported once, in
+    //        flag order, with the default directory compared even
+    //        though it is not used as a fallback, with one and with
+    //        several threads.
+
+    for (lThreads = 1; lThreads <= 4; lThreads += 3)
+    {
+        lStatus = chkconfig_options_set(lContextPointer,
+                                        lOptionsPointer,
+                                        CHKCONFIG_OPTION_THREADS,
+                                        lThreads);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+        lDiffContext.mCount = 0;
+
+        lStatus = chkconfig_state_diff(lContextPointer, DiffCollect, &lDiffContext);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lDiffContext.mCount == ElementsOf(kExpected));
+
+        if ((lStatus == CHKCONFIG_STATUS_SUCCESS) && (lDiffContext.mCount == ElementsOf(kExpected)))
+        {
+            for (i = 0; i < lDiffContext.mCount; i++)
+            {
+                NL_TEST_ASSERT(inSuite, strcmp(lDiffContext.mEntries[i].mFlag, kExpected[i].mFlag) == 0);
+                NL_TEST_ASSERT(inSuite, lDiffContext.mEntries[i].mDiff == kExpected[i].mDiff);
+                NL_TEST_ASSERT(inSuite, lDiffContext.mEntries[i].mState == kExpected[i].mState);
+                NL_TEST_ASSERT(inSuite, lDiffContext.mEntries[i].mDefaultState == kExpected[i].mDefaultState);
+            }
+        }
+    }
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kDefaultFlags); i++)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, kDefaultFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    for (i = 0; i < ElementsOf(kStateFlags); i++)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, kStateFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+}
+
+/*
+ * State Import
+ */
+static void TestStateImport(nlTestSuite *inSuite, void *inContext)
+{
+    static const char * const        kFlags[]        = { "a.one", "b.two", "c.three" };
+    static const bool                kStates[]       = { true, false, true };
+    static const chkconfig_flag_state_tuple_t kDuplicates[] = {
+        { "a.one", true, CHKCONFIG_ORIGIN_STATE },
+        { "a.one", false, CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t kNullFlags[] = {
+        { nullptr, true, CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t kFirst[] = {
+        { "b.two", true, CHKCONFIG_ORIGIN_STATE },
+        { "a.one", true, CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t kSecond[] = {
+        { "a.one", true, CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t kThird[] = {
+        { "d.four", true, CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t kMixed[] = {
+        { "b.two", true, CHKCONFIG_ORIGIN_STATE },
+        { "c.three", true, CHKCONFIG_ORIGIN_STATE },
+        { "d.four", true, CHKCONFIG_ORIGIN_STATE }
+    };
+    static const chkconfig_flag_state_tuple_t kDefault[] = {
+        { "e.five", false, CHKCONFIG_ORIGIN_STATE }
+    };
+    TestContext *                    lTestContext    = static_cast<TestContext *>(inContext);
+    chkconfig_status_t               lStatus;
+    chkconfig_context_pointer_t      lContextPointer = nullptr;
+    chkconfig_options_pointer_t      lOptionsPointer = nullptr;
+    chkconfig_state_t                lState;
+    chkconfig_origin_t               lOrigin;
+    bool                             lForce;
+    bool                             lUseDefault;
+    size_t                           lChanged;
+    size_t                           i;
+
+    // Test Initialization
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = CreateBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i], kStates[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = CreateBackingStoreFlag(lTestContext->mDefaultDirectory, "e.five", true);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_init(&lContextPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_init(lContextPointer, &lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_STATE_DIRECTORY,
+                                    &lTestContext->mStateDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_DEFAULT_DIRECTORY,
+                                    &lTestContext->mDefaultDirectory[0]);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    // 1.0. Negative tests
+    //
+    // None of these may change the state of any flag.
+
+    lStatus = chkconfig_state_import(nullptr, kFirst, ElementsOf(kFirst), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_import(lContextPointer, nullptr, 1, false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_import(lContextPointer, kDuplicates, ElementsOf(kDuplicates), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    lStatus = chkconfig_state_import(lContextPointer, kNullFlags, ElementsOf(kNullFlags), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -EINVAL);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = chkconfig_state_get(lContextPointer, kFlags[i], &lState);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+        NL_TEST_ASSERT(inSuite, lState == kStates[i]);
+    }
+
+    // 2.0. Positive tests
+
+    // 2.0.0. Only those flags whose state differs are set, the
+    //        tuples need not be sorted, and importing the same
+    //        tuples again changes nothing.
+
+    lStatus = chkconfig_state_import(lContextPointer, kFirst, ElementsOf(kFirst), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lChanged == 1);
+
+    lStatus = chkconfig_state_get(lContextPointer, "b.two", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+
+    lStatus = chkconfig_state_import(lContextPointer, kFirst, ElementsOf(kFirst), false, nullptr);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_import(lContextPointer, kFirst, ElementsOf(kFirst), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lChanged == 0);
+
+    // 2.0.1. With prune, those flags that are on but are not
+    //        imported are set off.
+
+    lStatus = chkconfig_state_import(lContextPointer, kSecond, ElementsOf(kSecond), true, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lChanged == 2);
+
+    lStatus = chkconfig_state_get(lContextPointer, "a.one", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+
+    lStatus = chkconfig_state_get(lContextPointer, "b.two", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+
+    lStatus = chkconfig_state_get(lContextPointer, "c.three", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+
+    // 2.0.2. A flag that does not yet exist is created only with
+    //        force. Without it, nothing at all is set, not even the
+    //        flags that do exist.
+
+    lStatus = chkconfig_state_import(lContextPointer, kThird, ElementsOf(kThird), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+
+    lStatus = chkconfig_state_import(lContextPointer, kMixed, ElementsOf(kMixed), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+
+    lStatus = chkconfig_state_get(lContextPointer, "b.two", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+
+    lStatus = chkconfig_state_get(lContextPointer, "c.three", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "d.four", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_NONE);
+
+    lForce = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_import(lContextPointer, kThird, ElementsOf(kThird), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lChanged == 1);
+
+    lStatus = chkconfig_state_get(lContextPointer, "d.four", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+
+    // 2.0.3. Importing nothing with prune sets every flag off.
+
+    lStatus = chkconfig_state_import(lContextPointer, nullptr, 0, true, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lChanged == 2);
+
+    lStatus = chkconfig_state_get(lContextPointer, "a.one", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+
+    lStatus = chkconfig_state_get(lContextPointer, "d.four", &lState);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == false);
+
+    // 2.0.4. With the default directory, prune leaves a flag only
+    //        there as it is, rather than shadowing it in the state
+    //        directory, and changing such a flag, as for a flag that
+    //        does not exist, requires force.
+
+    lUseDefault = true;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_USE_DEFAULT_DIRECTORY,
+                                    lUseDefault);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_import(lContextPointer, nullptr, 0, true, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lChanged == 0);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "e.five", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    lForce = false;
+
+    lStatus = chkconfig_options_set(lContextPointer,
+                                    lOptionsPointer,
+                                    CHKCONFIG_OPTION_FORCE_STATE,
+                                    lForce);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = chkconfig_state_import(lContextPointer, kDefault, ElementsOf(kDefault), false, &lChanged);
+    NL_TEST_ASSERT(inSuite, lStatus == -ENOENT);
+
+    lStatus = chkconfig_state_get_with_origin(lContextPointer, "e.five", &lState, &lOrigin);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, lState == true);
+    NL_TEST_ASSERT(inSuite, lOrigin == CHKCONFIG_ORIGIN_DEFAULT);
+
+    // Test Finalization
+
+    lStatus = ContextClose(lContextPointer, lOptionsPointer);
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    for (i = 0; i < ElementsOf(kFlags); i++)
+    {
+        lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, kFlags[i]);
+        NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+    }
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mStateDirectory, "d.four");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+
+    lStatus = DestroyBackingStoreFlag(lTestContext->mDefaultDirectory, "e.five");
+    NL_TEST_ASSERT(inSuite, lStatus == CHKCONFIG_STATUS_SUCCESS);
+}
+
 /**
  *  Test Suite. It lists all the test functions.
  *
@@ -1750,6 +5623,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Utility (Origin)",              TestUtilityOrigin),
     NL_TEST_DEF("Utility (Tuples Lifetime)",     TestUtilityTuplesLifetime),
     NL_TEST_DEF("Utility (Tuples Compare)",      TestUtilityTuplesCompare),
+    NL_TEST_DEF("Utility (Tuples Sort)",         TestUtilityTuplesSort),
     NL_TEST_DEF("Context Lifetime Management",   TestContextLifetimeManagement),
     NL_TEST_DEF("Options Lifetime Management",   TestOptionsLifetimeManagement),
     NL_TEST_DEF("Options Mutation",              TestOptionsMutation),
@@ -1757,6 +5631,19 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Flag Observation w/ Defaults",  TestFlagObservationWithDefaults),
     NL_TEST_DEF("Flag Mutation w/o Force",       TestFlagMutationWithoutForce),
     NL_TEST_DEF("Flag Mutation w/ Force",        TestFlagMutationWithForce),
+    NL_TEST_DEF("Shared Context Concurrency",    TestSharedContextConcurrency),
+    NL_TEST_DEF("Async Observation & Mutation",  TestAsyncFlagObservationAndMutation),
+    NL_TEST_DEF("Flag State Log",                TestFlagStateLog),
+    NL_TEST_DEF("Memory State",                  TestMemoryState),
+    NL_TEST_DEF("Layers",                        TestLayers),
+    NL_TEST_DEF("Existence Filters",             TestExistenceFilters),
+    NL_TEST_DEF("Sharded Layout",                TestShardedLayout),
+    NL_TEST_DEF("Prefix Queries",                TestPrefixQueries),
+    NL_TEST_DEF("Filtered Queries",              TestFilteredQueries),
+    NL_TEST_DEF("State Queries",                 TestStateQueries),
+    NL_TEST_DEF("State Counts",                  TestStateCounts),
+    NL_TEST_DEF("State Diff",                    TestStateDiff),
+    NL_TEST_DEF("State Import",                  TestStateImport),
 
     NL_TEST_SENTINEL()
 };